@@ -1,6 +1,7 @@
 load("@com_github_google_flatbuffers//:build_defs.bzl", "flatbuffer_cc_library", "flatbuffer_library_public")
 load("@rules_cc//cc:cc_binary.bzl", "cc_binary")
 load("@rules_cc//cc:cc_library.bzl", "cc_library")
+load("@rules_cc//cc:cc_test.bzl", "cc_test")
 load("@rules_python//python:defs.bzl", "py_library")
 
 _GRAVITY_COMPILATION_DEFINE = {
@@ -47,6 +48,15 @@ def gravity_cc_binary(name, defines = [], deps = [], copts = [], **kargs):
         **kargs
     )
 
+def gravity_cc_test(name, defines = [], deps = [], copts = [], **kargs):
+    cc_test(
+        name = name,
+        deps = deps + ["//source/common/diagnostics:trace", "@googletest//:gtest_main"],
+        copts = calculate_gravity_copts(copts),
+        defines = calculate_gravity_defines(defines),
+        **kargs
+    )
+
 _GRAVITY_DEFAULT_FLATC_ARGS = [
     "--cpp-ptr-type std::unique_ptr",
     "--cpp-std c++17",
@@ -0,0 +1,59 @@
+#include "arena.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+namespace gravity {
+
+auto Arena::allocate(size_t size, size_t alignment) -> std::byte* {
+  assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+  assert(alignment <= alignof(std::max_align_t));
+
+  std::lock_guard lock{ mutex_ };
+
+  auto padding = (alignment - (reinterpret_cast<uintptr_t>(cursor_) & (alignment - 1))) &  // NOLINT
+                 (alignment - 1);
+  if (cursor_ == nullptr || padding + size > remaining_) {
+    // an allocation bigger than a block gets a block of its own
+    auto block_size = std::max(block_size_, size);
+    blocks_.push_back(std::make_unique_for_overwrite<std::byte[]>(block_size));
+    cursor_ = blocks_.back().get();
+    remaining_ = block_size;
+    reserved_ += block_size;
+    padding = 0;
+  }
+
+  auto* allocation = cursor_ + padding;
+  cursor_ = allocation + size;
+  remaining_ -= padding + size;
+  used_ += size;
+  return allocation;
+}
+
+auto Arena::copy(std::span<const std::byte> bytes, size_t alignment) -> std::span<const std::byte> {
+  if (bytes.empty()) {
+    return {};
+  }
+  auto* destination = allocate(bytes.size(), alignment);
+  std::memcpy(destination, bytes.data(), bytes.size());
+  return { destination, bytes.size() };
+}
+
+auto Arena::copy(std::string_view text) -> std::string_view {
+  auto bytes = copy(std::as_bytes(std::span{ text.data(), text.size() }), 1);
+  return { reinterpret_cast<const char*>(bytes.data()), bytes.size() };  // NOLINT
+}
+
+auto Arena::used() const -> size_t {
+  std::lock_guard lock{ mutex_ };
+  return used_;
+}
+
+auto Arena::reserved() const -> size_t {
+  std::lock_guard lock{ mutex_ };
+  return reserved_;
+}
+
+}  // namespace gravity
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace gravity {
+
+// Monotonic allocator for many small objects that share one lifetime. Allocations are bumped out
+// of large blocks and only released together when the Arena is destroyed, so nothing is ever
+// freed individually and neighbouring allocations stay neighbours in memory.
+//
+// Safe to use from several threads.
+class Arena {
+ public:
+  static constexpr size_t DefaultBlockSize{ 64 * 1024 };
+
+  explicit Arena(size_t block_size = DefaultBlockSize) : block_size_{ block_size } {}
+
+  Arena(const Arena&) = delete;
+  auto operator=(const Arena&) -> Arena& = delete;
+
+  ~Arena() = default;
+
+  // alignment is a power of two no larger than alignof(std::max_align_t)
+  auto allocate(size_t size, size_t alignment) -> std::byte*;
+
+  auto copy(std::span<const std::byte> bytes, size_t alignment) -> std::span<const std::byte>;
+  auto copy(std::string_view text) -> std::string_view;
+
+  // bytes handed out, and bytes held in blocks
+  [[nodiscard]] auto used() const -> size_t;
+  [[nodiscard]] auto reserved() const -> size_t;
+
+ private:
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<std::byte[]>> blocks_;
+  std::byte* cursor_ = nullptr;
+  size_t remaining_ = 0;
+  size_t block_size_;
+  size_t used_ = 0;
+  size_t reserved_ = 0;
+};
+
+}  // namespace gravity
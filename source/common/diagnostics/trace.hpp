@@ -22,6 +22,7 @@
   TRACE_EVENT_INSTANT(CATEGORY, __VA_ARGS__, "file", __FILE__, "line", __LINE__)
 #define GRAVITY_TRACE(CATEGORY, ...) \
   TRACE_EVENT(CATEGORY, __VA_ARGS__, "file", __FILE__, "line", __LINE__)
+#define GRAVITY_TRACE_COUNTER(CATEGORY, ...) TRACE_COUNTER(CATEGORY, __VA_ARGS__)
 
 #define GRAVITY_TRACE_BEGIN(CATEGORY, ...) \
   TRACE_EVENT_BEGIN(CATEGORY, __VA_ARGS__, "file", __FILE__, "line", __LINE__)
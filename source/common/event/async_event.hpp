@@ -0,0 +1,109 @@
+#pragma once
+
+#include "boost/asio/associated_executor.hpp"
+#include "boost/asio/async_result.hpp"
+#include "boost/asio/executor_work_guard.hpp"
+#include "boost/asio/post.hpp"
+#include "boost/asio/use_awaitable.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <utility>
+
+namespace gravity {
+
+// Manual-reset event that any number of coroutines can wait on. Waiters are kept in a lock-free
+// intrusive stack and, once the event is set, each one is posted back to its own associated
+// executor (usually the strand it was suspended on), so set() never runs waiter code inline.
+class AsyncEvent {
+ public:
+  AsyncEvent() = default;
+
+  AsyncEvent(const AsyncEvent&) = delete;
+  auto operator=(const AsyncEvent&) -> AsyncEvent& = delete;
+
+  ~AsyncEvent() {
+    auto* state = state_.load(std::memory_order_acquire);
+    assert(state == nullptr || state == this);
+  }
+
+  [[nodiscard]] auto isSet() const noexcept -> bool {
+    return state_.load(std::memory_order_acquire) == this;
+  }
+
+  // Wakes every current waiter. Waiters that arrive after this complete immediately until reset().
+  void set() noexcept {
+    auto* waiters = state_.exchange(this, std::memory_order_acq_rel);
+    if (waiters == this) {
+      return;
+    }
+
+    auto* waiter = static_cast<WaiterBase*>(waiters);
+    while (waiter != nullptr) {
+      auto* next = waiter->next_;
+      waiter->complete();
+      waiter = next;
+    }
+  }
+
+  // Returns the event to the unset state. Has no effect if waiters are pending.
+  void reset() noexcept {
+    void* expected = this;
+    state_.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
+  }
+
+  template <typename CompletionToken = boost::asio::use_awaitable_t<>>
+  auto wait(CompletionToken&& token = {}) {
+    return boost::asio::async_initiate<CompletionToken, void()>(
+        [this](auto handler) {
+          auto* waiter = new Waiter<decltype(handler)>{ std::move(handler) };
+          if (!enqueue(waiter)) {
+            waiter->complete();
+          }
+        },
+        token);
+  }
+
+ private:
+  struct WaiterBase {
+    WaiterBase* next_ = nullptr;
+
+    virtual ~WaiterBase() = default;
+    virtual void complete() = 0;
+  };
+
+  template <typename Handler>
+  struct Waiter final : WaiterBase {
+    using Executor = boost::asio::associated_executor_t<Handler>;
+
+    Handler handler_;
+    boost::asio::executor_work_guard<Executor> work_;
+
+    explicit Waiter(Handler handler)
+        : handler_{ std::move(handler) }, work_{ boost::asio::get_associated_executor(handler_) } {}
+
+    void complete() override {
+      auto handler = std::move(handler_);
+      auto work = std::move(work_);
+      delete this;
+      boost::asio::post(work.get_executor(), std::move(handler));
+    }
+  };
+
+  // nullptr: unset without waiters, this: set, anything else: head of the waiter stack.
+  std::atomic<void*> state_{ nullptr };
+
+  auto enqueue(WaiterBase* waiter) noexcept -> bool {
+    auto* state = state_.load(std::memory_order_acquire);
+    do {
+      if (state == this) {
+        return false;
+      }
+      waiter->next_ = static_cast<WaiterBase*>(state);
+    } while (!state_.compare_exchange_weak(
+        state, waiter, std::memory_order_acq_rel, std::memory_order_acquire));
+    return true;
+  }
+};
+
+}  // namespace gravity
@@ -0,0 +1,122 @@
+#include "source/common/event/async_event.hpp"
+
+#include "benchmark/benchmark.h"
+#include "boost/asio/co_spawn.hpp"
+#include "boost/asio/detached.hpp"
+#include "boost/asio/io_context.hpp"
+#include "boost/asio/post.hpp"
+#include "boost/asio/steady_timer.hpp"
+#include "boost/asio/this_coro.hpp"
+#include "boost/asio/use_awaitable.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <latch>
+#include <thread>
+
+// Wake-up latency of coroutines waiting for a signal from another thread: AsyncEvent against the
+// 50 us steady_timer polling loop it replaced. The waiters run on one io_context thread and the
+// benchmark thread signals them; an iteration is the time from the signal until the last waiter
+// has resumed. The argument is the number of waiters.
+
+namespace gravity {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::chrono::microseconds PollInterval{ 50 };
+
+class WaiterLoop {
+ public:
+  WaiterLoop() : thread_{ [this] { io_context_.run(); } } {}
+
+  WaiterLoop(const WaiterLoop&) = delete;
+  auto operator=(const WaiterLoop&) -> WaiterLoop& = delete;
+
+  ~WaiterLoop() {
+    guard_.reset();
+    thread_.join();
+  }
+
+  auto executor() { return io_context_.get_executor(); }
+
+  // returns once every handler posted so far has run, the waiters are then suspended
+  void drain() {
+    std::promise<void> drained;
+    boost::asio::post(io_context_, [&drained] { drained.set_value(); });
+    drained.get_future().wait();
+  }
+
+ private:
+  boost::asio::io_context io_context_;
+  boost::asio::executor_work_guard<boost::asio::io_context::executor_type> guard_{
+    io_context_.get_executor()
+  };
+  std::thread thread_;
+};
+
+// arm() readies the signal for another round, it runs while nobody waits
+template <typename Arm, typename Wait, typename Signal>
+void measureWakeUp(benchmark::State& state, Arm arm, Wait wait, Signal signal) {
+  WaiterLoop loop;
+  auto waiters = state.range(0);
+
+  for (auto _ : state) {
+    arm();
+
+    std::latch resumed{ waiters };
+    std::atomic<int64_t> last_resume_ns{ 0 };
+    for (int64_t i = 0; i < waiters; ++i) {
+      boost::asio::co_spawn(
+          loop.executor(),
+          [&]() -> boost::asio::awaitable<void> {
+            co_await wait();
+            auto now = Clock::now().time_since_epoch().count();
+            auto last = last_resume_ns.load(std::memory_order_relaxed);
+            while (now > last && !last_resume_ns.compare_exchange_weak(last, now)) {
+            }
+            resumed.count_down();
+          },
+          boost::asio::detached);
+    }
+    loop.drain();
+
+    auto signaled = Clock::now();
+    signal();
+    resumed.wait();
+
+    auto latency = Clock::duration{ last_resume_ns.load() } - signaled.time_since_epoch();
+    state.SetIterationTime(std::chrono::duration<double>(latency).count());
+  }
+}
+
+void BM_WakeUpAsyncEvent(benchmark::State& state) {
+  AsyncEvent event;
+  measureWakeUp(
+      state, [&] { event.reset(); },
+      [&]() -> boost::asio::awaitable<void> { co_await event.wait(); }, [&] { event.set(); });
+}
+
+void BM_WakeUpTimerPolling(benchmark::State& state) {
+  std::atomic<bool> flag{ false };
+  measureWakeUp(
+      state, [&] { flag.store(false, std::memory_order_relaxed); },
+      [&]() -> boost::asio::awaitable<void> {
+        boost::asio::steady_timer timer{ co_await boost::asio::this_coro::executor };
+        while (!flag.load(std::memory_order_acquire)) {
+          timer.expires_after(PollInterval);
+          co_await timer.async_wait(boost::asio::use_awaitable);
+        }
+      },
+      [&] { flag.store(true, std::memory_order_release); });
+}
+
+BENCHMARK(BM_WakeUpAsyncEvent)->ArgName("waiters")->Arg(1)->Arg(16)->Arg(256)->UseManualTime();
+BENCHMARK(BM_WakeUpTimerPolling)->ArgName("waiters")->Arg(1)->Arg(16)->Arg(256)->UseManualTime();
+
+}  // namespace
+
+}  // namespace gravity
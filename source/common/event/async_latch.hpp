@@ -0,0 +1,39 @@
+#pragma once
+
+#include "source/common/event/async_event.hpp"
+
+#include "boost/asio/use_awaitable.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace gravity {
+
+// Single-use countdown a coroutine can await, typically to join a set of coroutines co_spawned on
+// other strands. Completes once countDown() has been called `count` times.
+class AsyncLatch {
+ public:
+  explicit AsyncLatch(size_t count) : remaining_{ count } {
+    if (count == 0) {
+      done_.set();
+    }
+  }
+
+  void countDown() noexcept {
+    if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      done_.set();
+    }
+  }
+
+  template <typename CompletionToken = boost::asio::use_awaitable_t<>>
+  auto wait(CompletionToken&& token = {}) {
+    return done_.wait(std::forward<CompletionToken>(token));
+  }
+
+ private:
+  std::atomic<size_t> remaining_;
+  AsyncEvent done_;
+};
+
+}  // namespace gravity
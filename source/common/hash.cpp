@@ -0,0 +1,328 @@
+#include "hash.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define GRAVITY_HASH_AVX2 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__)
+#define GRAVITY_HASH_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace gravity {
+
+namespace {
+
+constexpr size_t AccumulateKeyOffset = 0;
+constexpr size_t ScrambleKeyOffset = 24;
+constexpr size_t FinalKeyOffset = 32;
+constexpr size_t FinalHighKeyOffset = 40;
+constexpr size_t KeyCount = 48;
+
+// stripe s of a block reads keys [s, s + Lanes), so stripes are not interchangeable inside a block
+static_assert(
+    AccumulateKeyOffset + Hasher::StripesPerBlock + Hasher::Lanes - 1 <= ScrambleKeyOffset);
+
+alignas(64) constexpr std::array<uint64_t, KeyCount> Keys = [] {
+  std::array<uint64_t, KeyCount> keys{};
+  uint64_t state = 0;
+  for (auto& key : keys) {
+    state += 0x9e3779b97f4a7c15ULL;
+    key = mix64(state);
+  }
+  return keys;
+}();
+
+constexpr std::array<uint64_t, Hasher::Lanes> InitialAccumulators{
+  0x00000000c2b2ae3dULL, 0x9e3779b185ebca87ULL, 0xc2b2ae3d27d4eb4fULL, 0x165667b19e3779f9ULL,
+  0x85ebca77c2b2ae63ULL, 0x0000000085ebca77ULL, 0x27d4eb2f165667c5ULL, 0x000000009e3779b1ULL,
+};
+
+constexpr uint64_t Prime32 = 0x9e3779b1ULL;
+constexpr uint64_t Prime64 = 0x9e3779b185ebca87ULL;
+constexpr uint64_t PrimeHigh64 = 0xc2b2ae3d27d4eb4fULL;
+
+using AccumulateFunction = void (*)(
+    uint64_t* accumulators, const std::byte* data, size_t stripes, size_t first_stripe);
+
+struct Kernel {
+  AccumulateFunction accumulate_;
+  std::string_view name_;
+};
+
+auto load64(const std::byte* data) -> uint64_t {
+  uint64_t value;
+  std::memcpy(&value, data, sizeof(value));
+  if constexpr (std::endian::native == std::endian::big) {
+    value = std::byteswap(value);
+  }
+  return value;
+}
+
+// Reference kernel, the vector kernels must match it bit for bit.
+void accumulateScalar(
+    uint64_t* accumulators, const std::byte* data, size_t stripes, size_t first_stripe) {
+  for (size_t stripe = 0; stripe < stripes; ++stripe) {
+    const auto* key = &Keys[AccumulateKeyOffset + first_stripe + stripe];
+    for (size_t lane = 0; lane < Hasher::Lanes; ++lane) {
+      auto value = load64(data + (lane * sizeof(uint64_t)));
+      auto keyed = value ^ key[lane];
+      accumulators[lane ^ 1U] += value;
+      accumulators[lane] += (keyed & 0xffffffffULL) * (keyed >> 32U);
+    }
+    data += Hasher::StripeSize;
+  }
+}
+
+#if GRAVITY_HASH_AVX2
+// clang-cl does not link the compiler-rt CPU model __builtin_cpu_supports reads, so MSVC
+// targets query CPUID directly: AVX2 needs the AVX2 bit, and the OS saving the YMM state.
+auto cpuSupportsAvx2() -> bool {
+#if defined(_MSC_VER)
+  constexpr int OsXsaveBit = 1 << 27;
+  constexpr int AvxBit = 1 << 28;
+  constexpr int Avx2Bit = 1 << 5;
+  constexpr unsigned long long XmmYmmState = 0x6;
+
+  std::array<int, 4> registers{};
+  __cpuid(registers.data(), 0);
+  if (registers[0] < 7) {
+    return false;
+  }
+  __cpuid(registers.data(), 1);
+  if ((registers[2] & (OsXsaveBit | AvxBit)) != (OsXsaveBit | AvxBit)) {
+    return false;
+  }
+  if ((_xgetbv(0) & XmmYmmState) != XmmYmmState) {
+    return false;
+  }
+  __cpuidex(registers.data(), 7, 0);
+  return (registers[1] & Avx2Bit) != 0;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+// NOLINTBEGIN
+__attribute__((target("avx2"))) inline auto accumulateAvx2Half(
+    __m256i accumulator, const std::byte* input, const uint64_t* key) -> __m256i {
+  __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input));
+  __m256i keyed =
+      _mm256_xor_si256(value, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(key)));
+  __m256i product = _mm256_mul_epu32(keyed, _mm256_srli_epi64(keyed, 32));
+  // swap the two 64 bit words of each 128 bit half, lane i receives value[i ^ 1]
+  __m256i swapped = _mm256_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+  return _mm256_add_epi64(accumulator, _mm256_add_epi64(product, swapped));
+}
+
+__attribute__((target("avx2"))) void accumulateAvx2(
+    uint64_t* accumulators, const std::byte* data, size_t stripes, size_t first_stripe) {
+  auto* accumulators_vector = reinterpret_cast<__m256i*>(accumulators);
+  __m256i low = _mm256_loadu_si256(accumulators_vector);
+  __m256i high = _mm256_loadu_si256(accumulators_vector + 1);
+
+  for (size_t stripe = 0; stripe < stripes; ++stripe) {
+    const auto* key = &Keys[AccumulateKeyOffset + first_stripe + stripe];
+    low = accumulateAvx2Half(low, data, key);
+    high = accumulateAvx2Half(high, data + 32, key + 4);
+    data += Hasher::StripeSize;
+  }
+
+  _mm256_storeu_si256(accumulators_vector, low);
+  _mm256_storeu_si256(accumulators_vector + 1, high);
+}
+// NOLINTEND
+#endif
+
+#if GRAVITY_HASH_NEON
+// NOLINTBEGIN
+void accumulateNeon(
+    uint64_t* accumulators, const std::byte* data, size_t stripes, size_t first_stripe) {
+  std::array<uint64x2_t, 4> vectors{};
+  for (size_t i = 0; i < vectors.size(); ++i) {
+    vectors[i] = vld1q_u64(accumulators + (i * 2));
+  }
+
+  for (size_t stripe = 0; stripe < stripes; ++stripe) {
+    const auto* key = &Keys[AccumulateKeyOffset + first_stripe + stripe];
+    for (size_t i = 0; i < vectors.size(); ++i) {
+      uint64x2_t value =
+          vreinterpretq_u64_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(data) + (i * 16)));
+      uint64x2_t keyed = veorq_u64(value, vld1q_u64(key + (i * 2)));
+      uint64x2_t product = vmull_u32(vmovn_u64(keyed), vshrn_n_u64(keyed, 32));
+      uint64x2_t swapped = vextq_u64(value, value, 1);
+      vectors[i] = vaddq_u64(vectors[i], vaddq_u64(product, swapped));
+    }
+    data += Hasher::StripeSize;
+  }
+
+  for (size_t i = 0; i < vectors.size(); ++i) {
+    vst1q_u64(accumulators + (i * 2), vectors[i]);
+  }
+}
+// NOLINTEND
+#endif
+
+auto selectKernel() -> Kernel {
+#if GRAVITY_HASH_AVX2
+  if (cpuSupportsAvx2()) {
+    return { .accumulate_ = accumulateAvx2, .name_ = "avx2" };
+  }
+#elif GRAVITY_HASH_NEON
+  return { .accumulate_ = accumulateNeon, .name_ = "neon" };
+#endif
+  return { .accumulate_ = accumulateScalar, .name_ = "scalar" };
+}
+
+auto kernel() -> const Kernel& {
+  static const Kernel selected = selectKernel();
+  return selected;
+}
+
+void scramble(std::array<uint64_t, Hasher::Lanes>& accumulators) {
+  for (size_t lane = 0; lane < Hasher::Lanes; ++lane) {
+    auto value = accumulators[lane];
+    value ^= value >> 47U;
+    value ^= Keys[ScrambleKeyOffset + lane];
+    accumulators[lane] = value * Prime32;
+  }
+}
+
+auto multiplyFold(uint64_t lhs, uint64_t rhs) -> uint64_t {
+#if defined(__SIZEOF_INT128__)
+  auto product = static_cast<unsigned __int128>(lhs) * rhs;
+  return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64U);
+#else
+  uint64_t lhs_low = lhs & 0xffffffffULL;
+  uint64_t lhs_high = lhs >> 32U;
+  uint64_t rhs_low = rhs & 0xffffffffULL;
+  uint64_t rhs_high = rhs >> 32U;
+
+  uint64_t low_low = lhs_low * rhs_low;
+  uint64_t high_low = lhs_high * rhs_low;
+  uint64_t low_high = lhs_low * rhs_high;
+  uint64_t high_high = lhs_high * rhs_high;
+
+  uint64_t cross = (low_low >> 32U) + (high_low & 0xffffffffULL) + low_high;
+  uint64_t upper = (high_low >> 32U) + (cross >> 32U) + high_high;
+  uint64_t lower = (cross << 32U) | (low_low & 0xffffffffULL);
+  return lower ^ upper;
+#endif
+}
+
+auto avalanche(uint64_t value) -> uint64_t {
+  value ^= value >> 37U;
+  value *= 0x165667919e3779f9ULL;
+  value ^= value >> 32U;
+  return value;
+}
+
+auto merge(
+    const std::array<uint64_t, Hasher::Lanes>& accumulators, size_t key_offset, uint64_t start)
+    -> uint64_t {
+  auto result = start;
+  for (size_t lane = 0; lane < Hasher::Lanes; lane += 2) {
+    result += multiplyFold(
+        accumulators[lane] ^ Keys[key_offset + lane],
+        accumulators[lane + 1] ^ Keys[key_offset + lane + 1]);
+  }
+  return avalanche(result);
+}
+
+}  // namespace
+
+Hasher::Hasher(HashType seed) : accumulators_{ InitialAccumulators }, seed_{ seed } {
+  for (size_t lane = 0; lane < Lanes; ++lane) {
+    accumulators_[lane] ^= seed * Keys[FinalKeyOffset + lane];
+  }
+}
+
+void Hasher::update(std::span<const std::byte> data) {
+  if (data.empty()) {
+    return;
+  }
+  length_ += data.size();
+
+  if (buffered_ > 0) {
+    auto take = std::min(StripeSize - buffered_, data.size());
+    std::memcpy(buffer_.data() + buffered_, data.data(), take);
+    buffered_ += take;
+    data = data.subspan(take);
+
+    if (buffered_ < StripeSize) {
+      return;
+    }
+    consumeStripes(buffer_.data(), 1);
+    buffered_ = 0;
+  }
+
+  auto stripes = data.size() / StripeSize;
+  consumeStripes(data.data(), stripes);
+  data = data.subspan(stripes * StripeSize);
+
+  std::memcpy(buffer_.data(), data.data(), data.size());
+  buffered_ = data.size();
+}
+
+void Hasher::consumeStripes(const std::byte* data, size_t stripes) {
+  const auto& selected = kernel();
+  while (stripes > 0) {
+    auto count = std::min(stripes, StripesPerBlock - stripes_in_block_);
+    selected.accumulate_(accumulators_.data(), data, count, stripes_in_block_);
+
+    stripes_in_block_ += count;
+    stripes -= count;
+    data += count * StripeSize;
+
+    if (stripes_in_block_ == StripesPerBlock) {
+      scramble(accumulators_);
+      stripes_in_block_ = 0;
+    }
+  }
+}
+
+auto Hasher::finalAccumulators() const -> std::array<uint64_t, Lanes> {
+  if (buffered_ == 0) {
+    return accumulators_;
+  }
+
+  // the partial stripe is zero padded, the length mixed in by digest() keeps padding unambiguous
+  Hasher copy{ *this };
+  std::fill(copy.buffer_.begin() + static_cast<ptrdiff_t>(buffered_), copy.buffer_.end(),
+            std::byte{ 0 });
+  copy.consumeStripes(copy.buffer_.data(), 1);
+  return copy.accumulators_;
+}
+
+auto Hasher::digest() const -> HashType {
+  return merge(finalAccumulators(), FinalKeyOffset, (length_ * Prime64) ^ seed_);
+}
+
+auto Hasher::digest128() const -> Hash128 {
+  auto accumulators = finalAccumulators();
+  return { .low_ = merge(accumulators, FinalKeyOffset, (length_ * Prime64) ^ seed_),
+           .high_ = merge(accumulators, FinalHighKeyOffset, ~((length_ * PrimeHigh64) ^ seed_)) };
+}
+
+auto hashKernelName() -> std::string_view { return kernel().name_; }
+
+auto hash(std::span<const std::byte> data, HashType seed) -> HashType {
+  Hasher hasher{ seed };
+  hasher.update(data);
+  return hasher.digest();
+}
+
+auto hash128(std::span<const std::byte> data, HashType seed) -> Hash128 {
+  Hasher hasher{ seed };
+  hasher.update(data);
+  return hasher.digest128();
+}
+
+}  // namespace gravity
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace gravity {
+
+using HashType = uint64_t;
+
+struct Hash128 {
+  HashType low_;
+  HashType high_;
+
+  constexpr auto operator==(const Hash128& other) const -> bool = default;
+};
+
+// Incremental version of hash(). Feeding the same bytes through any number of update() calls,
+// split at any offsets, gives the same digest as hashing them in one go, so data can be hashed
+// chunk by chunk while it is still hot in cache after I/O.
+//
+// The input is consumed in 64 byte stripes by a kernel picked once at runtime (AVX2, NEON or
+// scalar); all kernels produce identical results so digests are stable across machines.
+class Hasher {
+ public:
+  static constexpr size_t StripeSize = 64;
+  static constexpr size_t StripesPerBlock = 16;
+  static constexpr size_t Lanes = StripeSize / sizeof(uint64_t);
+
+  explicit Hasher(HashType seed = 0);
+
+  void update(std::span<const std::byte> data);
+
+  [[nodiscard]] auto digest() const -> HashType;
+  [[nodiscard]] auto digest128() const -> Hash128;
+
+ private:
+  std::array<uint64_t, Lanes> accumulators_;
+  std::array<std::byte, StripeSize> buffer_{};
+  size_t buffered_ = 0;
+  size_t stripes_in_block_ = 0;
+  uint64_t length_ = 0;
+  HashType seed_;
+
+  void consumeStripes(const std::byte* data, size_t stripes);
+  auto finalAccumulators() const -> std::array<uint64_t, Lanes>;
+};
+
+// Name of the stripe kernel selected for this CPU: "avx2", "neon" or "scalar".
+auto hashKernelName() -> std::string_view;
+
+auto hash(std::span<const std::byte> data, HashType seed = 0) -> HashType;
+auto hash128(std::span<const std::byte> data, HashType seed = 0) -> Hash128;
+
+inline auto hash(std::span<const uint8_t> data, HashType seed = 0) -> HashType {
+  return hash(std::as_bytes(data), seed);
+}
+
+inline auto hash(std::span<const uint32_t> data, HashType seed = 0) -> HashType {
+  return hash(std::as_bytes(data), seed);
+}
+
+// splitmix64 finalizer, every input bit affects every output bit
+constexpr auto mix64(HashType value) -> HashType {
+  value ^= value >> 30U;
+  value *= 0xbf58476d1ce4e5b9ULL;
+  value ^= value >> 27U;
+  value *= 0x94d049bb133111ebULL;
+  value ^= value >> 31U;
+  return value;
+}
+
+// Order dependent: hashCombine(a, b) != hashCombine(b, a).
+[[nodiscard]] constexpr auto hashCombine(HashType seed, HashType value) -> HashType {
+  return mix64(seed + 0x9e3779b97f4a7c15ULL + mix64(value));
+}
+
+}  // namespace gravity
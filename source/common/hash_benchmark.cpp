@@ -0,0 +1,96 @@
+#include "source/common/hash.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// Hash throughput against the byte-serial FNV-1a that hash() used to be. The argument is the input
+// size; BM_HasherStreamed feeds the input in StreamChunk pieces the way a resource read does. The
+// label names the stripe kernel picked for this CPU.
+
+namespace gravity {
+
+namespace {
+
+constexpr size_t StreamChunk{ 64 * 1024 };
+
+auto fnv1a(std::span<const std::byte> data) -> HashType {
+  HashType value{ 0xcbf29ce484222325ULL };
+  for (auto byte : data) {
+    value ^= static_cast<HashType>(byte);
+    value *= 0x100000001b3ULL;
+  }
+  return value;
+}
+
+auto randomBytes(size_t size) -> std::vector<std::byte> {
+  std::mt19937_64 generator{ 42 };
+  std::vector<std::byte> bytes(size);
+  std::ranges::generate(bytes, [&] { return static_cast<std::byte>(generator()); });
+  return bytes;
+}
+
+template <typename Function>
+void measure(benchmark::State& state, Function function) {
+  auto bytes = randomBytes(static_cast<size_t>(state.range(0)));
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(function(std::span<const std::byte>{ bytes }));
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes.size()));
+}
+
+void BM_Fnv1a(benchmark::State& state) {
+  measure(state, fnv1a);
+}
+
+void BM_Hash(benchmark::State& state) {
+  state.SetLabel(std::string{ hashKernelName() });
+  measure(state, [](std::span<const std::byte> data) { return hash(data); });
+}
+
+void BM_Hash128(benchmark::State& state) {
+  state.SetLabel(std::string{ hashKernelName() });
+  measure(state, [](std::span<const std::byte> data) { return hash128(data); });
+}
+
+void BM_HasherStreamed(benchmark::State& state) {
+  state.SetLabel(std::string{ hashKernelName() });
+  measure(state, [](std::span<const std::byte> data) {
+    Hasher hasher;
+    while (!data.empty()) {
+      auto chunk = std::min(data.size(), StreamChunk);
+      hasher.update(data.first(chunk));
+      data = data.subspan(chunk);
+    }
+    return hasher.digest();
+  });
+}
+
+void BM_HashCombine(benchmark::State& state) {
+  HashType value{ 0 };
+  for (auto _ : state) {
+    value = hashCombine(value, static_cast<HashType>(state.iterations()));
+    benchmark::DoNotOptimize(value);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+void inputSizes(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgName("bytes")->RangeMultiplier(16)->Range(16, 16 << 20);
+}
+
+BENCHMARK(BM_Fnv1a)->Apply(inputSizes);
+BENCHMARK(BM_Hash)->Apply(inputSizes);
+BENCHMARK(BM_Hash128)->Apply(inputSizes);
+BENCHMARK(BM_HasherStreamed)->Apply(inputSizes);
+BENCHMARK(BM_HashCombine);
+
+}  // namespace
+
+}  // namespace gravity
@@ -0,0 +1,272 @@
+#include "content_hash_index.hpp"
+
+#include "source/common/error.hpp"
+#include "source/common/logging/logger.hpp"
+#include "source/common/mapped_file.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <span>
+#include <type_traits>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+
+#include <cerrno>
+#endif
+
+#undef GRAVITY_MODULE_NAME
+#define GRAVITY_MODULE_NAME "content_hash_index"
+
+namespace gravity {
+
+namespace {
+
+constexpr std::array<char, 8> Magic{ 'G', 'R', 'V', 'H', 'I', 'D', 'X', '1' };
+constexpr uint32_t Version{ 1 };
+
+// the log is compacted on open once it holds this many times more records than live entries
+constexpr size_t CompactionRatio{ 2 };
+constexpr size_t CompactionSlack{ 256 };
+
+struct Header {
+  std::array<char, 8> magic_;
+  uint32_t version_;
+  uint32_t record_size_;
+};
+
+struct Record {
+  uint64_t path_key_;
+  uint64_t size_;
+  int64_t modified_ns_;
+  uint64_t inode_;
+  uint64_t device_;
+  uint64_t content_hash_;
+
+  // covers every field above, a torn append fails the check
+  uint64_t checksum_;
+};
+
+static_assert(std::is_trivially_copyable_v<Header> && sizeof(Header) == 16);
+static_assert(std::is_trivially_copyable_v<Record> && sizeof(Record) == 56);
+
+auto checksum(const Record& record) -> uint64_t {
+  return hash(std::as_bytes(std::span{ &record, 1 }).first(offsetof(Record, checksum_)));
+}
+
+auto makeRecord(HashType path_key, const FileIdentity& identity, HashType content_hash) -> Record {
+  Record record{ .path_key_ = path_key,
+                 .size_ = identity.size_,
+                 .modified_ns_ = identity.modified_ns_,
+                 .inode_ = identity.inode_,
+                 .device_ = identity.device_,
+                 .content_hash_ = content_hash,
+                 .checksum_ = 0 };
+  record.checksum_ = checksum(record);
+  return record;
+}
+
+void writeRecord(std::ofstream& stream, const Record& record) {
+  stream.write(reinterpret_cast<const char*>(&record), sizeof(record));  // NOLINT
+}
+
+}  // namespace
+
+auto FileIdentity::of(const std::string& path) -> std::expected<FileIdentity, std::error_code> {
+#ifdef _WIN32
+  std::error_code error;
+  auto size = std::filesystem::file_size(path, error);
+  if (error) {
+    return std::unexpected(error);
+  }
+
+  auto modified = std::filesystem::last_write_time(path, error);
+  if (error) {
+    return std::unexpected(error);
+  }
+
+  auto modified_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::clock_cast<std::chrono::system_clock>(modified).time_since_epoch());
+
+  return FileIdentity{ .size_ = size, .modified_ns_ = modified_ns.count() };
+#else
+  struct stat file_stat {};
+  if (::stat(path.c_str(), &file_stat) != 0) {
+    return std::unexpected(std::error_code{ errno, std::system_category() });
+  }
+
+#ifdef __APPLE__
+  const auto& modified = file_stat.st_mtimespec;
+#else
+  const auto& modified = file_stat.st_mtim;
+#endif
+
+  return FileIdentity{ .size_ = static_cast<uint64_t>(file_stat.st_size),
+                       .modified_ns_ = (static_cast<int64_t>(modified.tv_sec) * 1'000'000'000) +
+                                       static_cast<int64_t>(modified.tv_nsec),
+                       .inode_ = static_cast<uint64_t>(file_stat.st_ino),
+                       .device_ = static_cast<uint64_t>(file_stat.st_dev) };
+#endif
+}
+
+auto ContentHashIndex::open(const std::string& path)
+    -> std::expected<std::unique_ptr<ContentHashIndex>, std::error_code> {
+  std::unique_ptr<ContentHashIndex> index{ new ContentHashIndex{} };
+
+  size_t records = 0;
+  bool clean = false;
+  {
+    auto mapping = MappedFile::open(path);
+    if (mapping) {
+      auto data = mapping->data();
+
+      Header header{};
+      if (data.size() >= sizeof(Header)) {
+        std::memcpy(&header, data.data(), sizeof(Header));
+      }
+
+      if (header.magic_ == Magic && header.version_ == Version &&
+          header.record_size_ == sizeof(Record)) {
+        auto body = data.subspan(sizeof(Header));
+        for (; body.size() >= sizeof(Record); body = body.subspan(sizeof(Record))) {
+          Record record{};
+          std::memcpy(&record, body.data(), sizeof(Record));
+          if (record.checksum_ != checksum(record)) {
+            break;
+          }
+
+          index->entries_.insert_or_assign(
+              record.path_key_, Entry{ .identity_ = { .size_ = record.size_,
+                                                      .modified_ns_ = record.modified_ns_,
+                                                      .inode_ = record.inode_,
+                                                      .device_ = record.device_ },
+                                       .content_hash_ = record.content_hash_ });
+          ++records;
+        }
+
+        // a leftover means a torn or corrupt record, appending after it would hide later ones
+        clean = body.empty();
+        if (!clean) {
+          LOG_WARN("content hash index has a damaged tail, compacting; path: {}", path);
+        }
+      } else if (!data.empty()) {
+        LOG_WARN("content hash index has an unknown format, starting over; path: {}", path);
+      }
+    } else if (mapping.error() != Error::NotFoundError) {
+      return std::unexpected(mapping.error());
+    }
+  }
+
+  LOG_DEBUG(
+      "content hash index loaded; path: {}, entries: {}, records: {}", path,
+      index->entries_.size(), records);
+
+  if (!clean || records > (CompactionRatio * index->entries_.size()) + CompactionSlack) {
+    if (auto error = index->rewrite(path); error) {
+      return std::unexpected(error);
+    }
+    return index;
+  }
+
+  index->log_.open(path, std::ios::binary | std::ios::app);
+  if (!index->log_) {
+    return std::unexpected(Error::InternalError);
+  }
+
+  return index;
+}
+
+auto ContentHashIndex::find(std::string_view path, const FileIdentity& identity) const
+    -> std::optional<HashType> {
+  auto key = pathKey(path);
+
+  std::lock_guard lock{ mutex_ };
+  auto iterator = entries_.find(key);
+  if (iterator == entries_.end() || iterator->second.identity_ != identity) {
+    return std::nullopt;
+  }
+  return iterator->second.content_hash_;
+}
+
+void ContentHashIndex::store(
+    std::string_view path, const FileIdentity& identity, HashType content_hash) {
+  auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::system_clock::now().time_since_epoch());
+  if (identity.modified_ns_ > (now - RacyWindow).count()) {
+    return;
+  }
+
+  auto key = pathKey(path);
+  Entry entry{ .identity_ = identity, .content_hash_ = content_hash };
+
+  std::lock_guard lock{ mutex_ };
+  auto [iterator, inserted] = entries_.try_emplace(key, entry);
+  if (!inserted) {
+    if (iterator->second.identity_ == identity && iterator->second.content_hash_ == content_hash) {
+      return;
+    }
+    iterator->second = entry;
+  }
+
+  append(key, entry);
+}
+
+auto ContentHashIndex::size() const -> size_t {
+  std::lock_guard lock{ mutex_ };
+  return entries_.size();
+}
+
+auto ContentHashIndex::pathKey(std::string_view path) -> HashType {
+  return hash(std::as_bytes(std::span{ path.data(), path.size() }));
+}
+
+auto ContentHashIndex::rewrite(const std::string& path) -> std::error_code {
+  auto temporary_path = path + ".tmp";
+  {
+    std::ofstream stream{ temporary_path, std::ios::binary | std::ios::trunc };
+
+    Header header{ .magic_ = Magic, .version_ = Version, .record_size_ = sizeof(Record) };
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));  // NOLINT
+
+    for (const auto& [key, entry] : entries_) {
+      writeRecord(stream, makeRecord(key, entry.identity_, entry.content_hash_));
+    }
+
+    stream.flush();
+    if (!stream) {
+      LOG_ERROR("unable to write content hash index; path: {}", temporary_path);
+      return Error::InternalError;
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temporary_path, path, error);
+  if (error) {
+    LOG_ERROR("unable to replace content hash index; path: {}, error: {}", path, error.message());
+    return error;
+  }
+
+  log_.open(path, std::ios::binary | std::ios::app);
+  if (!log_) {
+    return Error::InternalError;
+  }
+  return Error::OK;
+}
+
+void ContentHashIndex::append(HashType key, const Entry& entry) {
+  if (!log_) {
+    return;
+  }
+
+  // one record per store, flushed right away so a crash loses at most the record being written
+  writeRecord(log_, makeRecord(key, entry.identity_, entry.content_hash_));
+  log_.flush();
+
+  if (!log_) {
+    LOG_WARN("content hash index write failed, further updates are kept in memory only");
+  }
+}
+
+}  // namespace gravity
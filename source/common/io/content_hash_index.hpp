@@ -0,0 +1,77 @@
+#pragma once
+
+#include "source/common/hash.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+
+namespace gravity {
+
+// What the filesystem can tell about a file's contents without reading them. Two equal identities
+// are assumed to describe the same bytes.
+struct FileIdentity {
+  uint64_t size_ = 0;
+  int64_t modified_ns_ = 0;
+  uint64_t inode_ = 0;
+  uint64_t device_ = 0;
+
+  static auto of(const std::string& path) -> std::expected<FileIdentity, std::error_code>;
+
+  constexpr auto operator==(const FileIdentity& other) const -> bool = default;
+};
+
+// Persistent path -> (FileIdentity, content hash) map, so unchanged files don't need to be hashed
+// again across runs. The sidecar file is an append-only log of fixed-size, checksummed records:
+// it is mapped and replayed once by open(), and every store() appends a single record. A torn or
+// mostly-superseded log is compacted on open.
+//
+// Safe to use from several threads.
+class ContentHashIndex {
+ public:
+  // Files modified more recently than this are not persisted, a same-size rewrite within the
+  // filesystem's timestamp granularity would otherwise go unnoticed.
+  static constexpr std::chrono::seconds RacyWindow{ 2 };
+
+  static auto open(const std::string& path)
+      -> std::expected<std::unique_ptr<ContentHashIndex>, std::error_code>;
+
+  ContentHashIndex(const ContentHashIndex&) = delete;
+  auto operator=(const ContentHashIndex&) -> ContentHashIndex& = delete;
+
+  ~ContentHashIndex() = default;
+
+  [[nodiscard]] auto find(std::string_view path, const FileIdentity& identity) const
+      -> std::optional<HashType>;
+
+  void store(std::string_view path, const FileIdentity& identity, HashType content_hash);
+
+  [[nodiscard]] auto size() const -> size_t;
+
+ private:
+  struct Entry {
+    FileIdentity identity_;
+    HashType content_hash_;
+  };
+
+  mutable std::mutex mutex_;
+  std::unordered_map<HashType, Entry> entries_;
+  std::ofstream log_;
+
+  ContentHashIndex() = default;
+
+  static auto pathKey(std::string_view path) -> HashType;
+
+  auto rewrite(const std::string& path) -> std::error_code;
+  void append(HashType key, const Entry& entry);
+};
+
+}  // namespace gravity
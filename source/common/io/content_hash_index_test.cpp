@@ -0,0 +1,174 @@
+#include "source/common/io/content_hash_index.hpp"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace gravity {
+
+namespace {
+
+// header and record sizes of the on-disk log
+constexpr size_t HeaderSize{ 16 };
+constexpr size_t RecordSize{ 56 };
+
+auto identity(uint64_t size) -> FileIdentity {
+  // well outside the racy window
+  return { .size_ = size, .modified_ns_ = 1'000'000'000, .inode_ = 7, .device_ = 3 };
+}
+
+class ContentHashIndexTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    directory_ = std::filesystem::temp_directory_path() /
+                 ("gravity_content_hash_index_test_" +
+                  std::string{ ::testing::UnitTest::GetInstance()->current_test_info()->name() });
+    std::filesystem::remove_all(directory_);
+    std::filesystem::create_directories(directory_);
+    path_ = (directory_ / "content_hashes.bin").string();
+  }
+
+  void TearDown() override { std::filesystem::remove_all(directory_); }
+
+  auto open() -> std::unique_ptr<ContentHashIndex> {
+    auto index = ContentHashIndex::open(path_);
+    EXPECT_TRUE(index) << index.error().message();
+    return index ? std::move(*index) : nullptr;
+  }
+
+  // three entries, one record each
+  void populate() {
+    auto index = open();
+    ASSERT_NE(index, nullptr);
+    index->store("a", identity(1), 0xa);
+    index->store("b", identity(2), 0xb);
+    index->store("c", identity(3), 0xc);
+  }
+
+  [[nodiscard]] auto fileSize() const -> size_t { return std::filesystem::file_size(path_); }
+
+  std::filesystem::path directory_;
+  std::string path_;
+};
+
+TEST_F(ContentHashIndexTest, EntriesSurviveReopen) {
+  populate();
+
+  auto index = open();
+  ASSERT_NE(index, nullptr);
+  EXPECT_EQ(index->size(), 3U);
+  EXPECT_EQ(index->find("a", identity(1)), HashType{ 0xa });
+  EXPECT_EQ(index->find("c", identity(3)), HashType{ 0xc });
+  EXPECT_EQ(fileSize(), HeaderSize + (3 * RecordSize));
+}
+
+TEST_F(ContentHashIndexTest, ChangedIdentityMisses) {
+  auto index = open();
+  ASSERT_NE(index, nullptr);
+  index->store("a", identity(1), 0xa);
+
+  EXPECT_FALSE(index->find("a", identity(2)));
+  auto moved = identity(1);
+  moved.inode_ = 8;
+  EXPECT_FALSE(index->find("a", moved));
+  EXPECT_FALSE(index->find("b", identity(1)));
+}
+
+TEST_F(ContentHashIndexTest, RecentlyModifiedFilesAreNotStored) {
+  auto index = open();
+  ASSERT_NE(index, nullptr);
+
+  auto recent = identity(1);
+  recent.modified_ns_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::system_clock::now().time_since_epoch())
+                            .count();
+  index->store("a", recent, 0xa);
+  EXPECT_FALSE(index->find("a", recent));
+  EXPECT_EQ(index->size(), 0U);
+}
+
+TEST_F(ContentHashIndexTest, TornTailIsDroppedAndCompacted) {
+  populate();
+  // half of the last record made it to disk
+  std::filesystem::resize_file(path_, fileSize() - (RecordSize / 2));
+
+  {
+    auto index = open();
+    ASSERT_NE(index, nullptr);
+    EXPECT_EQ(index->size(), 2U);
+    EXPECT_EQ(index->find("a", identity(1)), HashType{ 0xa });
+    EXPECT_EQ(index->find("b", identity(2)), HashType{ 0xb });
+    EXPECT_FALSE(index->find("c", identity(3)));
+    EXPECT_EQ(fileSize(), HeaderSize + (2 * RecordSize));
+
+    // appends land after the compacted records, not after the torn one
+    index->store("c", identity(3), 0xc);
+  }
+
+  auto index = open();
+  ASSERT_NE(index, nullptr);
+  EXPECT_EQ(index->size(), 3U);
+  EXPECT_EQ(index->find("c", identity(3)), HashType{ 0xc });
+}
+
+TEST_F(ContentHashIndexTest, CorruptRecordEndsTheReplay) {
+  populate();
+  {
+    std::fstream stream{ path_, std::ios::binary | std::ios::in | std::ios::out };
+    stream.seekp(static_cast<std::streamoff>(HeaderSize + RecordSize + 8));
+    stream.put('\xff');
+  }
+
+  auto index = open();
+  ASSERT_NE(index, nullptr);
+  // the records after the damaged one can't be trusted to be in order
+  EXPECT_EQ(index->size(), 1U);
+  EXPECT_EQ(index->find("a", identity(1)), HashType{ 0xa });
+  EXPECT_FALSE(index->find("b", identity(2)));
+  EXPECT_EQ(fileSize(), HeaderSize + RecordSize);
+}
+
+TEST_F(ContentHashIndexTest, UnknownFormatStartsOver) {
+  std::ofstream{ path_, std::ios::binary } << "not a content hash index";
+
+  {
+    auto index = open();
+    ASSERT_NE(index, nullptr);
+    EXPECT_EQ(index->size(), 0U);
+    EXPECT_EQ(fileSize(), HeaderSize);
+    index->store("a", identity(1), 0xa);
+  }
+
+  auto index = open();
+  ASSERT_NE(index, nullptr);
+  EXPECT_EQ(index->find("a", identity(1)), HashType{ 0xa });
+}
+
+TEST_F(ContentHashIndexTest, SupersededRecordsAreCompacted) {
+  {
+    auto index = open();
+    ASSERT_NE(index, nullptr);
+    for (uint64_t size = 1; size <= 1000; ++size) {
+      index->store("a", identity(size), size);
+    }
+    // a store that changes nothing appends nothing
+    index->store("a", identity(1000), 1000);
+    EXPECT_EQ(fileSize(), HeaderSize + (1000 * RecordSize));
+  }
+
+  auto index = open();
+  ASSERT_NE(index, nullptr);
+  EXPECT_EQ(index->size(), 1U);
+  EXPECT_EQ(index->find("a", identity(1000)), HashType{ 1000 });
+  EXPECT_EQ(fileSize(), HeaderSize + RecordSize);
+}
+
+}  // namespace
+
+}  // namespace gravity
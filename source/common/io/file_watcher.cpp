@@ -0,0 +1,191 @@
+#include "file_watcher.hpp"
+
+#include "source/common/error.hpp"
+#include "source/common/logging/logger.hpp"
+
+#include "boost/asio/as_tuple.hpp"
+#include "boost/asio/use_awaitable.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <unordered_map>
+
+#include "boost/asio/posix/stream_descriptor.hpp"
+#include "boost/asio/steady_timer.hpp"
+#endif
+
+#undef GRAVITY_MODULE_NAME
+#define GRAVITY_MODULE_NAME "file_watcher"
+
+namespace asio = boost::asio;
+
+namespace gravity {
+
+#ifdef __linux__
+
+namespace {
+
+// moves cover editors and tools that write a temporary and rename it over the target
+constexpr uint32_t WatchMask{ IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE };
+
+constexpr size_t EventBufferSize{ 64 * 1024 };
+
+}  // namespace
+
+struct FileWatcher::Inotify {
+  asio::posix::stream_descriptor descriptor_;
+  asio::steady_timer settle_timer_;
+
+  // watch descriptor -> directory
+  std::unordered_map<int, std::string> directories_;
+
+  Inotify(const asio::any_io_executor& executor, int descriptor)
+      : descriptor_{ executor, descriptor }, settle_timer_{ executor } {}
+
+  // Reads every queued event into changes, stops at the first read that would block.
+  auto drain(FileChanges& changes) -> std::error_code {
+    alignas(inotify_event) std::array<char, EventBufferSize> buffer{};
+
+    while (true) {
+      auto bytes = ::read(descriptor_.native_handle(), buffer.data(), buffer.size());
+      if (bytes < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        if (errno == EAGAIN) {
+          return Error::OK;
+        }
+        return std::error_code{ errno, std::system_category() };
+      }
+
+      for (ssize_t offset = 0; offset < bytes;) {
+        inotify_event event{};
+        std::memcpy(&event, buffer.data() + offset, sizeof(event));
+        const char* name = buffer.data() + offset + sizeof(event);
+        offset += static_cast<ssize_t>(sizeof(event) + event.len);
+
+        if ((event.mask & IN_Q_OVERFLOW) != 0) {
+          changes.overflow_ = true;
+          continue;
+        }
+
+        auto directory = directories_.find(event.wd);
+        if (directory == directories_.end()) {
+          continue;
+        }
+        if ((event.mask & IN_IGNORED) != 0) {
+          LOG_WARN("watched directory is gone; path: {}", directory->second);
+          directories_.erase(directory);
+          continue;
+        }
+        if (event.len == 0 || (event.mask & IN_ISDIR) != 0) {
+          continue;
+        }
+
+        changes.paths_.push_back(directory->second + "/" + name);
+      }
+    }
+  }
+};
+
+auto FileWatcher::create(
+    const asio::any_io_executor& executor, std::span<const std::string> directories)
+    -> std::expected<std::unique_ptr<FileWatcher>, std::error_code> {
+  auto descriptor = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (descriptor < 0) {
+    LOG_ERROR("unable to create inotify instance; error: {}", std::strerror(errno));
+    return std::unexpected(Error::FeatureNotSupported);
+  }
+
+  // owns the descriptor from here on
+  auto inotify = std::make_unique<Inotify>(executor, descriptor);
+
+  for (const auto& directory : directories) {
+    auto watch = ::inotify_add_watch(descriptor, directory.c_str(), WatchMask | IN_ONLYDIR);
+    if (watch < 0) {
+      LOG_ERROR("unable to watch directory; path: {}, error: {}", directory, std::strerror(errno));
+      return std::unexpected(std::error_code{ errno, std::system_category() });
+    }
+    inotify->directories_.try_emplace(watch, directory);
+  }
+
+  LOG_DEBUG("watching directories; count: {}", inotify->directories_.size());
+  return std::unique_ptr<FileWatcher>{ new FileWatcher{ std::move(inotify) } };
+}
+
+auto FileWatcher::next() -> asio::awaitable<std::expected<FileChanges, std::error_code>> {
+  FileChanges changes;
+
+  while (changes.paths_.empty() && !changes.overflow_) {
+    auto [wait_error] = co_await inotify_->descriptor_.async_wait(
+        asio::posix::stream_descriptor::wait_read, asio::as_tuple(asio::use_awaitable));
+    if (wait_error) {
+      co_return std::unexpected(std::error_code{ wait_error });
+    }
+
+    // keep collecting until the burst is over
+    while (true) {
+      if (auto error = inotify_->drain(changes); error) {
+        co_return std::unexpected(error);
+      }
+
+      inotify_->settle_timer_.expires_after(SettleTime);
+      auto [timer_error] =
+          co_await inotify_->settle_timer_.async_wait(asio::as_tuple(asio::use_awaitable));
+      if (timer_error) {
+        co_return std::unexpected(std::error_code{ timer_error });
+      }
+
+      auto size = changes.paths_.size();
+      auto overflow = changes.overflow_;
+      if (auto error = inotify_->drain(changes); error) {
+        co_return std::unexpected(error);
+      }
+      if (changes.paths_.size() == size && changes.overflow_ == overflow) {
+        break;
+      }
+    }
+  }
+
+  std::ranges::sort(changes.paths_);
+  auto duplicates = std::ranges::unique(changes.paths_);
+  changes.paths_.erase(duplicates.begin(), duplicates.end());
+  co_return changes;
+}
+
+void FileWatcher::cancel() {
+  inotify_->descriptor_.cancel();
+  inotify_->settle_timer_.cancel();
+}
+
+#else
+
+struct FileWatcher::Inotify {};
+
+auto FileWatcher::create(
+    const asio::any_io_executor& /*executor*/, std::span<const std::string> /*directories*/)
+    -> std::expected<std::unique_ptr<FileWatcher>, std::error_code> {
+  return std::unexpected(Error::FeatureNotSupported);
+}
+
+auto FileWatcher::next() -> asio::awaitable<std::expected<FileChanges, std::error_code>> {
+  co_return std::unexpected(Error::FeatureNotSupported);
+}
+
+void FileWatcher::cancel() {}
+
+#endif
+
+FileWatcher::FileWatcher(std::unique_ptr<Inotify> inotify) : inotify_{ std::move(inotify) } {}
+
+FileWatcher::~FileWatcher() = default;
+
+}  // namespace gravity
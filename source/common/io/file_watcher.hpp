@@ -0,0 +1,56 @@
+#pragma once
+
+#include "boost/asio/any_io_executor.hpp"
+#include "boost/asio/awaitable.hpp"
+
+#include <chrono>
+#include <expected>
+#include <memory>
+#include <span>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace gravity {
+
+struct FileChanges {
+  // "directory/name" of every file written, moved in or out, or removed; sorted and unique
+  std::vector<std::string> paths_;
+
+  // the kernel dropped events, anything in the watched directories may have changed
+  bool overflow_ = false;
+};
+
+// Watches directories, not recursively, for files that are written, moved or removed. Changes are
+// reported in batches: a batch closes once SettleTime passes without a new event, so a tool
+// writing and renaming many files in a row shows up as one batch instead of one per file.
+//
+// Built on inotify, create() reports FeatureNotSupported on other platforms.
+class FileWatcher {
+ public:
+  static constexpr std::chrono::milliseconds SettleTime{ 100 };
+
+  static auto create(
+      const boost::asio::any_io_executor& executor, std::span<const std::string> directories)
+      -> std::expected<std::unique_ptr<FileWatcher>, std::error_code>;
+
+  FileWatcher(const FileWatcher&) = delete;
+  auto operator=(const FileWatcher&) -> FileWatcher& = delete;
+
+  ~FileWatcher();
+
+  // Completes with the next non-empty batch. One waiter at a time.
+  auto next() -> boost::asio::awaitable<std::expected<FileChanges, std::error_code>>;
+
+  // Fails a pending next() with operation_aborted.
+  void cancel();
+
+ private:
+  struct Inotify;
+
+  std::unique_ptr<Inotify> inotify_;
+
+  explicit FileWatcher(std::unique_ptr<Inotify> inotify);
+};
+
+}  // namespace gravity
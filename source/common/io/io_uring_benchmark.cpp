@@ -0,0 +1,199 @@
+#include "source/common/io/io_uring_engine.hpp"
+
+#include "benchmark/benchmark.h"
+#include "boost/asio/bind_executor.hpp"
+#include "boost/asio/io_context.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Reads a directory of FileCount small files, the access pattern of a level load.
+//
+//   BM_ReadPread             open, pread and close each file in turn on the calling thread
+//   BM_ReadIoUring           every read queued on IoUringEngine at once, completions on one
+//                            io_context
+//   BM_ReadIoUringRegistered as above through a registered file table and one registered buffer
+//
+// The argument selects a cold (1) or warm (0) page cache. Cold runs drop the files from the cache
+// with POSIX_FADV_DONTNEED before every iteration, which needs the files to be clean, so the
+// fixture syncs them after writing.
+
+namespace gravity {
+
+namespace {
+
+constexpr size_t FileCount{ 10'000 };
+constexpr size_t FileSize{ 4096 };
+
+class FileSet {
+ public:
+  FileSet() : directory_{ std::filesystem::temp_directory_path() / "gravity_io_uring_benchmark" } {
+    std::filesystem::remove_all(directory_);
+    std::filesystem::create_directories(directory_);
+
+    std::string contents(FileSize, '\0');
+    for (size_t i = 0; i < FileCount; ++i) {
+      auto path = directory_ / std::to_string(i);
+      std::ranges::fill(contents, static_cast<char>('a' + (i % 26)));
+      std::ofstream{ path, std::ios::binary }.write(contents.data(),
+                                                    static_cast<std::streamsize>(contents.size()));
+      paths_.push_back(path.string());
+    }
+    ::sync();
+  }
+
+  FileSet(const FileSet&) = delete;
+  auto operator=(const FileSet&) -> FileSet& = delete;
+
+  ~FileSet() {
+    std::error_code error_code;
+    std::filesystem::remove_all(directory_, error_code);
+  }
+
+  [[nodiscard]] auto paths() const -> const std::vector<std::string>& { return paths_; }
+
+  void dropFromPageCache() const {
+    for (const auto& path : paths_) {
+      auto descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+      if (descriptor >= 0) {
+        ::posix_fadvise(descriptor, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(descriptor);
+      }
+    }
+  }
+
+ private:
+  std::filesystem::path directory_;
+  std::vector<std::string> paths_;
+};
+
+auto fileSet() -> const FileSet& {
+  static const FileSet files;
+  return files;
+}
+
+// drops the cache outside the timed region for cold runs
+void prepareIteration(benchmark::State& state, const FileSet& files) {
+  if (state.range(0) != 0) {
+    state.PauseTiming();
+    files.dropFromPageCache();
+    state.ResumeTiming();
+  }
+}
+
+void reportThroughput(benchmark::State& state) {
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * FileCount));
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * FileCount * FileSize));
+}
+
+void BM_ReadPread(benchmark::State& state) {
+  const auto& files = fileSet();
+  std::vector<std::byte> storage(FileCount * FileSize);
+
+  for (auto _ : state) {
+    prepareIteration(state, files);
+
+    for (size_t i = 0; i < FileCount; ++i) {
+      auto file = IoUringEngine::openForRead(files.paths()[i]);
+      if (!file) {
+        state.SkipWithError("open failed");
+        return;
+      }
+      auto bytes = ::pread(file->descriptor_, storage.data() + (i * FileSize), file->size_, 0);
+      benchmark::DoNotOptimize(bytes);
+      IoUringEngine::close(*file);
+    }
+  }
+  reportThroughput(state);
+}
+
+void readAll(benchmark::State& state, bool registered) {
+  const auto& files = fileSet();
+
+  auto engine = IoUringEngine::create();
+  if (!engine) {
+    state.SkipWithError("io_uring is not available");
+    return;
+  }
+
+  std::vector<std::byte> storage(FileCount * FileSize);
+  if (registered) {
+    std::span<std::byte> buffer{ storage };
+    if ((*engine)->registerBuffers({ &buffer, 1 })) {
+      state.SkipWithError("registering the buffer failed");
+      return;
+    }
+  }
+
+  boost::asio::io_context io_context;
+  std::vector<IoUringFile> opened(FileCount);
+  std::vector<int> descriptors(FileCount);
+
+  for (auto _ : state) {
+    prepareIteration(state, files);
+
+    for (size_t i = 0; i < FileCount; ++i) {
+      auto file = IoUringEngine::openForRead(files.paths()[i]);
+      if (!file) {
+        state.SkipWithError("open failed");
+        return;
+      }
+      opened[i] = *file;
+      descriptors[i] = file->descriptor_;
+    }
+    if (registered && (*engine)->registerFiles(descriptors)) {
+      state.SkipWithError("registering the files failed");
+      return;
+    }
+
+    size_t failed{ 0 };
+    for (size_t i = 0; i < FileCount; ++i) {
+      IoUringRead request{
+        .file_ = registered ? static_cast<int>(i) : opened[i].descriptor_,
+        .fixed_file_ = registered,
+        .buffer_ = std::span{ storage }.subspan(i * FileSize, opened[i].size_),
+        .offset_ = 0,
+        .buffer_index_ = registered ? 0 : -1,
+      };
+      (*engine)->read(request,
+                      boost::asio::bind_executor(
+                          io_context, [&failed](boost::system::error_code error_code, size_t) {
+                            failed += error_code ? 1 : 0;
+                          }));
+    }
+    io_context.restart();
+    io_context.run();
+
+    for (auto& file : opened) {
+      IoUringEngine::close(file);
+    }
+    if (failed > 0) {
+      state.SkipWithError("a read failed");
+      return;
+    }
+  }
+  reportThroughput(state);
+}
+
+void BM_ReadIoUring(benchmark::State& state) {
+  readAll(state, false);
+}
+
+void BM_ReadIoUringRegistered(benchmark::State& state) {
+  readAll(state, true);
+}
+
+BENCHMARK(BM_ReadPread)->ArgName("cold")->Arg(0)->Arg(1)->UseRealTime();
+BENCHMARK(BM_ReadIoUring)->ArgName("cold")->Arg(0)->Arg(1)->UseRealTime();
+BENCHMARK(BM_ReadIoUringRegistered)->ArgName("cold")->Arg(0)->Arg(1)->UseRealTime();
+
+}  // namespace
+
+}  // namespace gravity
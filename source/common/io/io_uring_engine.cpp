@@ -0,0 +1,434 @@
+#include "io_uring_engine.hpp"
+
+#include "source/common/error.hpp"
+#include "source/common/logging/logger.hpp"
+#include "source/common/utilities.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+#undef GRAVITY_MODULE_NAME
+#define GRAVITY_MODULE_NAME "io_uring"
+
+namespace gravity {
+
+#ifdef __linux__
+
+namespace {
+
+// user_data of the poll request that watches the wake eventfd; operations use their address
+constexpr uint64_t WakeUserData{ 0 };
+
+// a single read SQE is limited to 32 bits of length, callers loop on partial reads anyway
+constexpr size_t MaxReadSize{ size_t{ 1 } << 30U };
+
+auto ioUringSetup(uint32_t entries, io_uring_params* params) -> int {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+auto ioUringEnter(int ring, uint32_t to_submit, uint32_t min_complete, uint32_t flags) -> int {
+  return static_cast<int>(
+      syscall(__NR_io_uring_enter, ring, to_submit, min_complete, flags, nullptr, 0));
+}
+
+auto ioUringRegister(int ring, uint32_t opcode, const void* arguments, uint32_t count) -> int {
+  return static_cast<int>(syscall(__NR_io_uring_register, ring, opcode, arguments, count));
+}
+
+auto lastError() -> std::error_code {
+  return { errno, std::system_category() };
+}
+
+template <typename T>
+auto offsetPointer(void* base, uint32_t offset) -> T* {
+  return reinterpret_cast<T*>(static_cast<std::byte*>(base) + offset);  // NOLINT
+}
+
+}  // namespace
+
+struct IoUringEngine::Ring {
+  int descriptor_ = -1;
+  int wake_descriptor_ = -1;
+
+  void* sq_mapping_ = MAP_FAILED;
+  size_t sq_mapping_size_ = 0;
+  void* cq_mapping_ = MAP_FAILED;
+  size_t cq_mapping_size_ = 0;
+  io_uring_sqe* sqes_ = static_cast<io_uring_sqe*>(MAP_FAILED);
+  size_t sqes_size_ = 0;
+
+  uint32_t* sq_head_ = nullptr;
+  uint32_t* sq_tail_ = nullptr;
+  uint32_t* sq_array_ = nullptr;
+  uint32_t sq_mask_ = 0;
+  uint32_t sq_entries_ = 0;
+
+  uint32_t* cq_head_ = nullptr;
+  uint32_t* cq_tail_ = nullptr;
+  io_uring_cqe* cqes_ = nullptr;
+  uint32_t cq_mask_ = 0;
+  uint32_t cq_entries_ = 0;
+
+  Ring() = default;
+  Ring(const Ring&) = delete;
+  auto operator=(const Ring&) -> Ring& = delete;
+
+  ~Ring() {
+    if (sqes_ != MAP_FAILED) {
+      munmap(sqes_, sqes_size_);
+    }
+    if (cq_mapping_ != MAP_FAILED && cq_mapping_ != sq_mapping_) {
+      munmap(cq_mapping_, cq_mapping_size_);
+    }
+    if (sq_mapping_ != MAP_FAILED) {
+      munmap(sq_mapping_, sq_mapping_size_);
+    }
+    if (wake_descriptor_ >= 0) {
+      ::close(wake_descriptor_);
+    }
+    if (descriptor_ >= 0) {
+      ::close(descriptor_);
+    }
+  }
+
+  [[nodiscard]] auto unsubmitted() const -> uint32_t {
+    return *sq_tail_ - std::atomic_ref{ *sq_head_ }.load(std::memory_order_acquire);
+  }
+
+  [[nodiscard]] auto submissionSpace() const -> uint32_t { return sq_entries_ - unsubmitted(); }
+
+  // The engine thread is the only producer, so the tail can be read without synchronization.
+  template <typename Prepare>
+  void push(Prepare&& prepare) {
+    auto tail = *sq_tail_;
+    auto index = tail & sq_mask_;
+
+    auto& sqe = sqes_[index];  // NOLINT
+    std::memset(&sqe, 0, sizeof(sqe));
+    prepare(sqe);
+
+    sq_array_[index] = index;  // NOLINT
+    std::atomic_ref{ *sq_tail_ }.store(tail + 1, std::memory_order_release);
+  }
+
+  void armWake() {
+    push([this](io_uring_sqe& sqe) {
+      sqe.opcode = IORING_OP_POLL_ADD;
+      sqe.fd = wake_descriptor_;
+      sqe.poll_events = POLLIN;
+      sqe.user_data = WakeUserData;
+    });
+  }
+};
+
+auto IoUringEngine::create(uint32_t queue_depth)
+    -> std::expected<std::unique_ptr<IoUringEngine>, std::error_code> {
+  auto ring = std::make_unique<Ring>();
+
+  io_uring_params params{};
+  ring->descriptor_ = ioUringSetup(queue_depth, &params);
+  if (ring->descriptor_ < 0) {
+    // ENOSYS on old kernels, EPERM when disabled through sysctl or seccomp
+    return std::unexpected(Error::FeatureNotSupported);
+  }
+
+  ring->sq_mapping_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  ring->cq_mapping_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+  bool single_mapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0U;
+  if (single_mapping) {
+    ring->sq_mapping_size_ = std::max(ring->sq_mapping_size_, ring->cq_mapping_size_);
+    ring->cq_mapping_size_ = ring->sq_mapping_size_;
+  }
+
+  ring->sq_mapping_ = mmap(
+      nullptr, ring->sq_mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+      ring->descriptor_, IORING_OFF_SQ_RING);
+  if (ring->sq_mapping_ == MAP_FAILED) {
+    return std::unexpected(lastError());
+  }
+
+  ring->cq_mapping_ = single_mapping ? ring->sq_mapping_
+                                     : mmap(
+                                           nullptr, ring->cq_mapping_size_, PROT_READ | PROT_WRITE,
+                                           MAP_SHARED | MAP_POPULATE, ring->descriptor_,
+                                           IORING_OFF_CQ_RING);
+  if (ring->cq_mapping_ == MAP_FAILED) {
+    return std::unexpected(lastError());
+  }
+
+  ring->sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  ring->sqes_ = static_cast<io_uring_sqe*>(mmap(
+      nullptr, ring->sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+      ring->descriptor_, IORING_OFF_SQES));
+  if (ring->sqes_ == MAP_FAILED) {
+    return std::unexpected(lastError());
+  }
+
+  ring->sq_head_ = offsetPointer<uint32_t>(ring->sq_mapping_, params.sq_off.head);
+  ring->sq_tail_ = offsetPointer<uint32_t>(ring->sq_mapping_, params.sq_off.tail);
+  ring->sq_array_ = offsetPointer<uint32_t>(ring->sq_mapping_, params.sq_off.array);
+  ring->sq_mask_ = *offsetPointer<uint32_t>(ring->sq_mapping_, params.sq_off.ring_mask);
+  ring->sq_entries_ = params.sq_entries;
+
+  ring->cq_head_ = offsetPointer<uint32_t>(ring->cq_mapping_, params.cq_off.head);
+  ring->cq_tail_ = offsetPointer<uint32_t>(ring->cq_mapping_, params.cq_off.tail);
+  ring->cqes_ = offsetPointer<io_uring_cqe>(ring->cq_mapping_, params.cq_off.cqes);
+  ring->cq_mask_ = *offsetPointer<uint32_t>(ring->cq_mapping_, params.cq_off.ring_mask);
+  ring->cq_entries_ = params.cq_entries;
+
+  ring->wake_descriptor_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (ring->wake_descriptor_ < 0) {
+    return std::unexpected(lastError());
+  }
+
+  return std::unique_ptr<IoUringEngine>{ new IoUringEngine{ std::move(ring) } };
+}
+
+auto IoUringEngine::openForRead(const std::string& path)
+    -> std::expected<IoUringFile, std::error_code> {
+  int descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (descriptor < 0) {
+    return std::unexpected(lastError());
+  }
+
+  struct stat file_stat {};
+  if (fstat(descriptor, &file_stat) != 0) {
+    auto error = lastError();
+    ::close(descriptor);
+    return std::unexpected(error);
+  }
+
+  return IoUringFile{ .descriptor_ = descriptor, .size_ = static_cast<size_t>(file_stat.st_size) };
+}
+
+void IoUringEngine::close(IoUringFile& file) {
+  if (file.descriptor_ >= 0) {
+    ::close(file.descriptor_);
+  }
+  file.descriptor_ = -1;
+}
+
+IoUringEngine::IoUringEngine(std::unique_ptr<Ring> ring) : ring_{ std::move(ring) } {
+  thread_ = std::thread{ [this] { run(); } };
+  setThreadName(thread_, "IoUring");
+}
+
+IoUringEngine::~IoUringEngine() {
+  stopped_.store(true, std::memory_order_release);
+  wake();
+  thread_.join();
+}
+
+auto IoUringEngine::registerFiles(std::span<const int> descriptors) -> std::error_code {
+  ioUringRegister(ring_->descriptor_, IORING_UNREGISTER_FILES, nullptr, 0);
+  if (descriptors.empty()) {
+    return Error::OK;
+  }
+
+  if (ioUringRegister(
+          ring_->descriptor_, IORING_REGISTER_FILES, descriptors.data(),
+          static_cast<uint32_t>(descriptors.size())) < 0) {
+    return lastError();
+  }
+  return Error::OK;
+}
+
+auto IoUringEngine::registerBuffers(std::span<const std::span<std::byte>> buffers)
+    -> std::error_code {
+  ioUringRegister(ring_->descriptor_, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+  if (buffers.empty()) {
+    return Error::OK;
+  }
+
+  std::vector<iovec> vectors;
+  vectors.reserve(buffers.size());
+  for (const auto& buffer : buffers) {
+    vectors.push_back(iovec{ .iov_base = buffer.data(), .iov_len = buffer.size() });
+  }
+
+  if (ioUringRegister(
+          ring_->descriptor_, IORING_REGISTER_BUFFERS, vectors.data(),
+          static_cast<uint32_t>(vectors.size())) < 0) {
+    return lastError();
+  }
+  return Error::OK;
+}
+
+/*
+ *  Private
+ */
+
+void IoUringEngine::enqueue(std::unique_ptr<OperationBase> operation) {
+  {
+    std::lock_guard lock{ pending_mutex_ };
+    if (!stopped_.load(std::memory_order_acquire)) {
+      pending_.push_back(std::move(operation));
+    }
+  }
+
+  if (operation) {
+    operation->complete(boost::asio::error::operation_aborted, 0);
+    return;
+  }
+  wake();
+}
+
+void IoUringEngine::wake() {
+  uint64_t value{ 1 };
+  [[maybe_unused]] auto written = ::write(ring_->wake_descriptor_, &value, sizeof(value));
+}
+
+void IoUringEngine::run() {
+  auto& ring = *ring_;
+
+  std::deque<std::unique_ptr<OperationBase>> batch;
+  uint32_t in_flight{ 0 };
+
+  ring.armWake();
+
+  while (true) {
+    {
+      std::lock_guard lock{ pending_mutex_ };
+      std::ranges::move(pending_, std::back_inserter(batch));
+      pending_.clear();
+    }
+
+    if (stopped_.load(std::memory_order_acquire)) {
+      for (auto& operation : batch) {
+        operation->complete(boost::asio::error::operation_aborted, 0);
+      }
+      batch.clear();
+
+      // reads still in the kernel write into caller memory, drain them before tearing down
+      if (in_flight == 0) {
+        break;
+      }
+    }
+
+    // keep one submission slot for re-arming the wake poll and never outrun the completion ring
+    while (!batch.empty() && ring.submissionSpace() > 1 && in_flight + 1 < ring.cq_entries_) {
+      auto* operation = batch.front().release();
+      batch.pop_front();
+
+      ring.push([operation](io_uring_sqe& sqe) {
+        const auto& request = operation->request_;
+
+        sqe.opcode = request.buffer_index_ >= 0 ? IORING_OP_READ_FIXED : IORING_OP_READ;
+        sqe.fd = request.file_;
+        if (request.fixed_file_) {
+          sqe.flags |= IOSQE_FIXED_FILE;
+        }
+        sqe.addr = reinterpret_cast<uint64_t>(request.buffer_.data());  // NOLINT
+        sqe.len = static_cast<uint32_t>(std::min(request.buffer_.size(), MaxReadSize));
+        sqe.off = request.offset_;
+        if (request.buffer_index_ >= 0) {
+          sqe.buf_index = static_cast<uint16_t>(request.buffer_index_);
+        }
+        sqe.user_data = reinterpret_cast<uint64_t>(operation);  // NOLINT
+      });
+      ++in_flight;
+    }
+
+    if (ioUringEnter(ring.descriptor_, ring.unsubmitted(), 1, IORING_ENTER_GETEVENTS) < 0 &&
+        errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+      // the ring itself is unusable, fail whatever has not reached the kernel and stop
+      LOG_ERROR("io_uring_enter failed, error: {}", lastError().message());
+      stopped_.store(true, std::memory_order_release);
+
+      std::lock_guard lock{ pending_mutex_ };
+      std::ranges::move(pending_, std::back_inserter(batch));
+      pending_.clear();
+      for (auto& operation : batch) {
+        operation->complete(boost::asio::error::operation_aborted, 0);
+      }
+      return;
+    }
+
+    auto head = *ring.cq_head_;
+    auto tail = std::atomic_ref{ *ring.cq_tail_ }.load(std::memory_order_acquire);
+
+    for (; head != tail; ++head) {
+      const auto& cqe = ring.cqes_[head & ring.cq_mask_];  // NOLINT
+
+      if (cqe.user_data == WakeUserData) {
+        uint64_t value{ 0 };
+        [[maybe_unused]] auto read = ::read(ring.wake_descriptor_, &value, sizeof(value));
+        ring.armWake();
+        continue;
+      }
+
+      std::unique_ptr<OperationBase> operation{
+        reinterpret_cast<OperationBase*>(cqe.user_data)  // NOLINT
+      };
+      --in_flight;
+
+      if (cqe.res < 0) {
+        operation->complete({ -cqe.res, boost::system::system_category() }, 0);
+      } else {
+        operation->complete({}, static_cast<size_t>(cqe.res));
+      }
+    }
+
+    std::atomic_ref{ *ring.cq_head_ }.store(head, std::memory_order_release);
+  }
+}
+
+#else
+
+struct IoUringEngine::Ring {};
+
+auto IoUringEngine::create(uint32_t /*queue_depth*/)
+    -> std::expected<std::unique_ptr<IoUringEngine>, std::error_code> {
+  return std::unexpected(Error::FeatureNotSupported);
+}
+
+auto IoUringEngine::openForRead(const std::string& /*path*/)
+    -> std::expected<IoUringFile, std::error_code> {
+  return std::unexpected(Error::FeatureNotSupported);
+}
+
+void IoUringEngine::close(IoUringFile& file) {
+  file.descriptor_ = -1;
+}
+
+IoUringEngine::IoUringEngine(std::unique_ptr<Ring> ring) : ring_{ std::move(ring) } {}
+
+IoUringEngine::~IoUringEngine() = default;
+
+auto IoUringEngine::registerFiles(std::span<const int> /*descriptors*/) -> std::error_code {
+  return Error::FeatureNotSupported;
+}
+
+auto IoUringEngine::registerBuffers(std::span<const std::span<std::byte>> /*buffers*/)
+    -> std::error_code {
+  return Error::FeatureNotSupported;
+}
+
+void IoUringEngine::enqueue(std::unique_ptr<OperationBase> operation) {
+  operation->complete(boost::asio::error::operation_not_supported, 0);
+}
+
+void IoUringEngine::run() {}
+
+void IoUringEngine::wake() {}
+
+#endif
+
+}  // namespace gravity
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "boost/asio/associated_executor.hpp"
+#include "boost/asio/async_result.hpp"
+#include "boost/asio/executor_work_guard.hpp"
+#include "boost/asio/post.hpp"
+#include "boost/system/error_code.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <expected>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <system_error>
+#include <thread>
+
+namespace gravity {
+
+struct IoUringFile {
+  int descriptor_ = -1;
+  size_t size_ = 0;
+};
+
+struct IoUringRead {
+  // plain descriptor, or an index into the registered file table when fixed_file_ is set
+  int file_ = -1;
+  bool fixed_file_ = false;
+
+  std::span<std::byte> buffer_;
+  uint64_t offset_ = 0;
+
+  // index of the registered buffer that contains buffer_, or -1 for an unregistered destination
+  int buffer_index_ = -1;
+};
+
+// Batched file reads on top of io_uring. Reads may be issued from any thread; a dedicated
+// submission thread drains everything queued since its last wake-up into the submission ring and
+// hands it to the kernel with a single io_uring_enter. Each completion is posted to the executor
+// associated with its handler. Only available on Linux; create() reports FeatureNotSupported when
+// the kernel (or a seccomp policy) does not provide io_uring.
+class IoUringEngine {
+ public:
+  static constexpr uint32_t DefaultQueueDepth{ 256 };
+
+  static auto create(uint32_t queue_depth = DefaultQueueDepth)
+      -> std::expected<std::unique_ptr<IoUringEngine>, std::error_code>;
+
+  static auto openForRead(const std::string& path) -> std::expected<IoUringFile, std::error_code>;
+  static void close(IoUringFile& file);
+
+  IoUringEngine(const IoUringEngine&) = delete;
+  auto operator=(const IoUringEngine&) -> IoUringEngine& = delete;
+
+  ~IoUringEngine();
+
+  // Replaces the registered file table; IoUringRead::file_ then indexes into `descriptors`.
+  auto registerFiles(std::span<const int> descriptors) -> std::error_code;
+
+  // Replaces the registered buffer table; reads landing entirely inside one of these buffers can
+  // name it through IoUringRead::buffer_index_ and skip the per-read page pinning.
+  auto registerBuffers(std::span<const std::span<std::byte>> buffers) -> std::error_code;
+
+  // Completes with (error, bytes_read).
+  template <typename CompletionToken>
+  auto read(const IoUringRead& request, CompletionToken&& token) {
+    return boost::asio::async_initiate<CompletionToken, void(boost::system::error_code, size_t)>(
+        [this](auto handler, const IoUringRead& request) {
+          enqueue(std::make_unique<Operation<decltype(handler)>>(request, std::move(handler)));
+        },
+        token, request);
+  }
+
+ private:
+  struct OperationBase {
+    IoUringRead request_;
+
+    explicit OperationBase(const IoUringRead& request) : request_{ request } {}
+
+    virtual ~OperationBase() = default;
+    virtual void complete(boost::system::error_code error_code, size_t bytes) = 0;
+  };
+
+  template <typename Handler>
+  struct Operation final : OperationBase {
+    using Executor = boost::asio::associated_executor_t<Handler>;
+
+    Handler handler_;
+    boost::asio::executor_work_guard<Executor> work_;
+
+    Operation(const IoUringRead& request, Handler handler)
+        : OperationBase{ request },
+          handler_{ std::move(handler) },
+          work_{ boost::asio::get_associated_executor(handler_) } {}
+
+    void complete(boost::system::error_code error_code, size_t bytes) override {
+      auto work = std::move(work_);
+      boost::asio::post(
+          work.get_executor(),
+          [handler = std::move(handler_), error_code, bytes]() mutable {
+            std::move(handler)(error_code, bytes);
+          });
+    }
+  };
+
+  struct Ring;
+
+  std::unique_ptr<Ring> ring_;
+
+  std::mutex pending_mutex_;
+  std::deque<std::unique_ptr<OperationBase>> pending_;
+
+  std::atomic<bool> stopped_{ false };
+  std::thread thread_;
+
+  explicit IoUringEngine(std::unique_ptr<Ring> ring);
+
+  void enqueue(std::unique_ptr<OperationBase> operation);
+  void run();
+  void wake();
+};
+
+}  // namespace gravity
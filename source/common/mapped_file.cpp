@@ -0,0 +1,115 @@
+#include "mapped_file.hpp"
+
+#include "source/common/error.hpp"
+
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace gravity {
+
+auto MappedFile::open(const std::string& path) -> std::expected<MappedFile, std::error_code> {
+#ifdef _WIN32
+  HANDLE file = CreateFileA(
+      path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return std::unexpected(Error::NotFoundError);
+  }
+
+  LARGE_INTEGER file_size{};
+  if (GetFileSizeEx(file, &file_size) == 0) {
+    CloseHandle(file);
+    return std::unexpected(Error::InternalError);
+  }
+
+  if (file_size.QuadPart == 0) {
+    CloseHandle(file);
+    return MappedFile{};
+  }
+
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (mapping == nullptr) {
+    return std::unexpected(Error::InternalError);
+  }
+
+  // the view keeps the mapping object alive after its handle is closed
+  void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping);
+  if (view == nullptr) {
+    return std::unexpected(Error::InternalError);
+  }
+
+  return MappedFile{ static_cast<const std::byte*>(view), static_cast<size_t>(file_size.QuadPart) };
+#else
+  int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (file < 0) {
+    return std::unexpected(Error::NotFoundError);
+  }
+
+  struct stat file_stat {};
+  if (fstat(file, &file_stat) != 0) {
+    ::close(file);
+    return std::unexpected(Error::InternalError);
+  }
+
+  if (file_stat.st_size == 0) {
+    ::close(file);
+    return MappedFile{};
+  }
+
+  auto size = static_cast<size_t>(file_stat.st_size);
+  void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+  ::close(file);
+  if (view == MAP_FAILED) {
+    return std::unexpected(Error::InternalError);
+  }
+
+  // resources are consumed front to back (hashing, uploads), let the kernel read ahead
+  madvise(view, size, MADV_SEQUENTIAL);
+  madvise(view, size, MADV_WILLNEED);
+
+  return MappedFile{ static_cast<const std::byte*>(view), size };
+#endif
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_{ std::exchange(other.data_, nullptr) }, size_{ std::exchange(other.size_, 0) } {}
+
+auto MappedFile::operator=(MappedFile&& other) noexcept -> MappedFile& {
+  if (this != &other) {
+    unmap();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+  }
+  return *this;
+}
+
+MappedFile::~MappedFile() {
+  unmap();
+}
+
+void MappedFile::unmap() {
+  if (data_ == nullptr) {
+    return;
+  }
+
+#ifdef _WIN32
+  UnmapViewOfFile(data_);
+#else
+  munmap(const_cast<std::byte*>(data_), size_);  // NOLINT
+#endif
+
+  data_ = nullptr;
+  size_ = 0;
+}
+
+}  // namespace gravity
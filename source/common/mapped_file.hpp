@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <span>
+#include <string>
+#include <system_error>
+
+namespace gravity {
+
+// Read-only view of a whole file mapped into the address space. The view starts on a page
+// boundary and stays valid until the MappedFile is destroyed.
+class MappedFile {
+ public:
+  static auto open(const std::string& path) -> std::expected<MappedFile, std::error_code>;
+
+  MappedFile() = default;
+
+  MappedFile(const MappedFile&) = delete;
+  auto operator=(const MappedFile&) -> MappedFile& = delete;
+
+  MappedFile(MappedFile&& other) noexcept;
+  auto operator=(MappedFile&& other) noexcept -> MappedFile&;
+
+  ~MappedFile();
+
+  [[nodiscard]] auto data() const -> std::span<const std::byte> { return { data_, size_ }; }
+
+ private:
+  const std::byte* data_ = nullptr;
+  size_t size_ = 0;
+
+  MappedFile(const std::byte* data, size_t size) : data_{ data }, size_{ size } {}
+
+  void unmap();
+};
+
+}  // namespace gravity
@@ -27,4 +27,25 @@ Worker::~Worker() {
   }
 }
 
+StealingWorker::StealingWorker(size_t threads, std::string_view name)
+    : context_{ threads }, guard_{ context_.get_executor() } {
+  for (size_t i = 0; i < threads; ++i) {
+    thread_.emplace_back([name = absl::StrCat(name, "-", i), this] {
+      LOG_TRACE("{} run() entered", name);
+      context_.run();
+      LOG_TRACE("{} run() exited", name);
+    });
+    setThreadName(thread_.back(), absl::StrCat(name, "-", i));
+  }
+}
+
+StealingWorker::~StealingWorker() {
+  guard_.reset();
+  for (auto& thread : thread_) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+}
+
 }  // namespace gravity
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "source/common/scheduler/work_stealing_context.hpp"
 #include "source/common/utilities.hpp"
 
 #include "absl/strings/str_cat.h"
@@ -22,14 +23,30 @@ struct Worker {
   ~Worker();
 };
 
+struct StealingWorker {
+  WorkStealingContext context_;
+  boost::asio::executor_work_guard<WorkStealingContext::executor_type> guard_;
+  std::vector<std::thread> thread_;
+
+  StealingWorker(size_t threads, std::string_view name);
+
+  ~StealingWorker();
+};
+
+enum class SchedulerBackend : uint8_t { IoContext, WorkStealing };
+
 template <typename System>
 class StrandGroup {
  public:
   using StrandType = std::array<
       boost::asio::any_io_executor, magic_enum::enum_count<typename System::StrandLanes>()>;
 
-  StrandGroup<System>(boost::asio::io_context::executor_type io_executor, StrandType strands)
-      : io_executor_{ std::move(io_executor) }, strands_{ std::move(strands) } {}
+  StrandGroup<System>(
+      boost::asio::io_context::executor_type io_executor,
+      boost::asio::any_io_executor work_executor, StrandType strands)
+      : io_executor_{ std::move(io_executor) },
+        work_executor_{ std::move(work_executor) },
+        strands_{ std::move(strands) } {}
 
   [[nodiscard]] auto getStrand(System::StrandLanes lane) const -> auto& {
     auto index = magic_enum::enum_index(lane);
@@ -37,10 +54,16 @@ class StrandGroup {
     return strands_[index.value()];
   }
 
-  auto getExecutor() -> boost::asio::io_context::executor_type { return io_executor_; }
+  // The io_context executor, for I/O objects whose completions the io_context threads drive.
+  auto getIoExecutor() -> boost::asio::io_context::executor_type { return io_executor_; }
+
+  // Unserialized executor over the threads the strands run on, for fanning out independent work.
+  // With the work-stealing backend that is the stealing pool, not the io_context.
+  auto getWorkExecutor() -> const boost::asio::any_io_executor& { return work_executor_; }
 
  private:
   boost::asio::io_context::executor_type io_executor_;
+  boost::asio::any_io_executor work_executor_;
   StrandType strands_;
 };
 
@@ -48,8 +71,17 @@ class Scheduler {
  public:
   enum class StrandLanes : uint8_t { Main, _Count };
 
-  Scheduler(size_t workers = std::thread::hardware_concurrency())
-      : workers_{ workers, "Worker" }, strands_{ makeStrands<Scheduler>() } {}
+  // With the work-stealing backend the io_context keeps a single thread to drive I/O completions
+  // while handlers and strands run on the stealing workers.
+  static constexpr size_t IoWorkerThreads{ 1 };
+
+  Scheduler(
+      size_t workers = std::thread::hardware_concurrency(),
+      SchedulerBackend backend = SchedulerBackend::IoContext)
+      : backend_{ backend },
+        workers_{ backend == SchedulerBackend::IoContext ? workers : IoWorkerThreads, "Worker" },
+        stealing_workers_{ backend == SchedulerBackend::WorkStealing ? workers : 0, "Stealer" },
+        strands_{ makeStrands<Scheduler>() } {}
 
   template <typename System>
   auto makeStrands() -> StrandGroup<System> {
@@ -57,16 +89,32 @@ class Scheduler {
 
     for (size_t i = 0; i < strands.size(); ++i) {
       auto lane = static_cast<typename System::StrandLanes>(i);
-      strands[i] = boost::asio::make_strand(workers_.io_context_.get_executor());
+      if (backend_ == SchedulerBackend::WorkStealing) {
+        strands[i] = boost::asio::make_strand(stealing_workers_.context_.get_executor());
+      } else {
+        strands[i] = boost::asio::make_strand(workers_.io_context_.get_executor());
+      }
     }
 
-    return StrandGroup<System>{ workers_.io_context_.get_executor(), strands };
+    boost::asio::any_io_executor work_executor;
+    if (backend_ == SchedulerBackend::WorkStealing) {
+      work_executor = stealing_workers_.context_.get_executor();
+    } else {
+      work_executor = workers_.io_context_.get_executor();
+    }
+
+    return StrandGroup<System>{ workers_.io_context_.get_executor(), std::move(work_executor),
+                                strands };
   }
 
   auto getStrand(StrandLanes lane) -> auto& { return strands_.getStrand(lane); }
 
+  [[nodiscard]] auto getBackend() const -> SchedulerBackend { return backend_; }
+
  private:
+  SchedulerBackend backend_;
   Worker workers_;
+  StealingWorker stealing_workers_;
   StrandGroup<Scheduler> strands_;
 };
 
@@ -0,0 +1,116 @@
+#include "source/common/scheduler/scheduler.hpp"
+
+#include "benchmark/benchmark.h"
+#include "boost/asio/co_spawn.hpp"
+#include "boost/asio/detached.hpp"
+#include "boost/asio/post.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <latch>
+#include <vector>
+
+// Compares the io_context backend against the work-stealing backend of Scheduler.
+//
+//   BM_SpawnThroughput  every coroutine co_spawns two children until the tree is SpawnDepth deep,
+//                       so most spawns come from the worker threads themselves
+//   BM_HandlerLatency   an outside thread posts bursts of handlers and each one records how long
+//                       it waited to start; p50 and p99 are reported as counters
+//
+// The first argument picks the backend (0 io_context, 1 work stealing), the second the workers.
+
+namespace gravity {
+
+namespace {
+
+constexpr size_t SpawnDepth{ 14 };
+constexpr size_t LatencyBurst{ 256 };
+constexpr size_t LatencyBursts{ 64 };
+
+struct BenchmarkSystem {
+  enum class StrandLanes : uint8_t { Main, _Count };
+};
+
+auto backendOf(const benchmark::State& state) -> SchedulerBackend {
+  return state.range(0) == 0 ? SchedulerBackend::IoContext : SchedulerBackend::WorkStealing;
+}
+
+auto spawnTree(boost::asio::any_io_executor executor, size_t depth, std::latch& done)
+    -> boost::asio::awaitable<void> {
+  if (depth > 0) {
+    for (int child = 0; child < 2; ++child) {
+      boost::asio::co_spawn(
+          executor, spawnTree(executor, depth - 1, done), boost::asio::detached);
+    }
+  }
+  done.count_down();
+  co_return;
+}
+
+void BM_SpawnThroughput(benchmark::State& state) {
+  Scheduler scheduler{ static_cast<size_t>(state.range(1)), backendOf(state) };
+  auto executor = scheduler.makeStrands<BenchmarkSystem>().getWorkExecutor();
+
+  constexpr size_t Spawns{ (size_t{ 2 } << SpawnDepth) - 1 };
+  for (auto _ : state) {
+    std::latch done{ static_cast<std::ptrdiff_t>(Spawns) };
+    boost::asio::co_spawn(executor, spawnTree(executor, SpawnDepth, done), boost::asio::detached);
+    done.wait();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * Spawns));
+}
+
+void BM_HandlerLatency(benchmark::State& state) {
+  using Clock = std::chrono::steady_clock;
+
+  Scheduler scheduler{ static_cast<size_t>(state.range(1)), backendOf(state) };
+  auto executor = scheduler.makeStrands<BenchmarkSystem>().getWorkExecutor();
+
+  std::vector<int64_t> latencies_ns;
+  latencies_ns.reserve(LatencyBurst * LatencyBursts * 16);
+  std::vector<int64_t> burst_ns(LatencyBurst);
+
+  for (auto _ : state) {
+    for (size_t burst = 0; burst < LatencyBursts; ++burst) {
+      std::latch done{ static_cast<std::ptrdiff_t>(LatencyBurst) };
+      for (size_t i = 0; i < LatencyBurst; ++i) {
+        boost::asio::post(executor, [&, i, posted = Clock::now()] {
+          burst_ns[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - posted)
+                            .count();
+          done.count_down();
+        });
+      }
+      done.wait();
+      latencies_ns.insert(latencies_ns.end(), burst_ns.begin(), burst_ns.end());
+    }
+  }
+
+  std::ranges::sort(latencies_ns);
+  auto percentile = [&](double fraction) {
+    auto index = static_cast<size_t>(fraction * static_cast<double>(latencies_ns.size() - 1));
+    return static_cast<double>(latencies_ns[index]);
+  };
+  state.counters["p50_ns"] = percentile(0.50);
+  state.counters["p99_ns"] = percentile(0.99);
+  state.SetItemsProcessed(static_cast<int64_t>(latencies_ns.size()));
+}
+
+void backendsAndWorkers(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({ "backend", "workers" });
+  for (int64_t backend : { 0, 1 }) {
+    for (int64_t workers : { 1, 4, 16 }) {
+      benchmark->Args({ backend, workers });
+    }
+  }
+  benchmark->UseRealTime();
+}
+
+BENCHMARK(BM_SpawnThroughput)->Apply(backendsAndWorkers);
+BENCHMARK(BM_HandlerLatency)->Apply(backendsAndWorkers);
+
+}  // namespace
+
+}  // namespace gravity
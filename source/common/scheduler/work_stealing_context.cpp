@@ -0,0 +1,273 @@
+#include "work_stealing_context.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <utility>
+
+namespace gravity {
+
+namespace {
+
+struct ThreadState {
+  const WorkStealingContext* context_ = nullptr;
+  void* queue_ = nullptr;
+};
+
+thread_local ThreadState this_thread_state;
+
+}  // namespace
+
+WorkStealingExecutor::WorkStealingExecutor(WorkStealingContext& context, bool tracked) noexcept
+    : context_{ &context }, tracked_{ tracked } {
+  if (tracked_) {
+    context_->workStarted();
+  }
+}
+
+WorkStealingExecutor::WorkStealingExecutor(const WorkStealingExecutor& other) noexcept
+    : context_{ other.context_ }, tracked_{ other.tracked_ } {
+  if (tracked_) {
+    context_->workStarted();
+  }
+}
+
+WorkStealingExecutor::WorkStealingExecutor(WorkStealingExecutor&& other) noexcept
+    : context_{ other.context_ }, tracked_{ std::exchange(other.tracked_, false) } {}
+
+auto WorkStealingExecutor::operator=(const WorkStealingExecutor& other) noexcept
+    -> WorkStealingExecutor& {
+  if (this != &other) {
+    if (other.tracked_) {
+      other.context_->workStarted();
+    }
+    if (tracked_) {
+      context_->workFinished();
+    }
+    context_ = other.context_;
+    tracked_ = other.tracked_;
+  }
+  return *this;
+}
+
+auto WorkStealingExecutor::operator=(WorkStealingExecutor&& other) noexcept
+    -> WorkStealingExecutor& {
+  if (this != &other) {
+    if (tracked_) {
+      context_->workFinished();
+    }
+    context_ = other.context_;
+    tracked_ = std::exchange(other.tracked_, false);
+  }
+  return *this;
+}
+
+WorkStealingExecutor::~WorkStealingExecutor() {
+  if (tracked_) {
+    context_->workFinished();
+  }
+}
+
+WorkStealingContext::WorkStealingContext(size_t concurrency_hint) {
+  queues_.reserve(concurrency_hint);
+  for (size_t i = 0; i < concurrency_hint; ++i) {
+    queues_.emplace_back(std::make_unique<LocalQueue>());
+  }
+}
+
+WorkStealingContext::~WorkStealingContext() {
+  shutdown();
+}
+
+void WorkStealingContext::run() {
+  auto index = next_queue_.fetch_add(1, std::memory_order_relaxed);
+  LocalQueue* local = index < queues_.size() ? queues_[index].get() : nullptr;
+
+  auto previous_state = std::exchange(this_thread_state, ThreadState{ this, local });
+
+  std::minstd_rand random{ static_cast<std::minstd_rand::result_type>(index + 1) };
+
+  while (!stopped()) {
+    std::optional<Task> task;
+    if (local != nullptr) {
+      task = popLocal(*local);
+    }
+    if (!task) {
+      task = popInjected();
+    }
+    if (!task) {
+      task = steal(random, local);
+    }
+
+    if (task) {
+      queued_.fetch_sub(1, std::memory_order_relaxed);
+      (*task)();
+      task.reset();
+      workFinished();
+      continue;
+    }
+
+    std::unique_lock lock{ idle_mutex_ };
+    if (outstanding_work_.load(std::memory_order_acquire) == 0) {
+      break;
+    }
+    sleeping_.fetch_add(1, std::memory_order_seq_cst);
+    idle_.wait(lock, [this] {
+      return stopped() || queued_.load(std::memory_order_seq_cst) != 0 ||
+             outstanding_work_.load(std::memory_order_acquire) == 0;
+    });
+    sleeping_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  this_thread_state = previous_state;
+}
+
+void WorkStealingContext::stop() {
+  stopped_.store(true, std::memory_order_release);
+  wakeAll();
+}
+
+/*
+ *  Private
+ */
+
+void WorkStealingContext::post(Task task) {
+  workStarted();
+
+  if (this_thread_state.context_ == this && this_thread_state.queue_ != nullptr) {
+    auto& local = *static_cast<LocalQueue*>(this_thread_state.queue_);
+    std::lock_guard lock{ local.mutex_ };
+    if (local.lifo_slot_) {
+      local.tasks_.push_back(std::move(*local.lifo_slot_));
+    }
+    local.lifo_slot_ = std::move(task);
+  } else {
+    std::lock_guard lock{ injection_mutex_ };
+    injection_queue_.push_back(std::move(task));
+  }
+
+  queued_.fetch_add(1, std::memory_order_seq_cst);
+  wakeOne();
+}
+
+auto WorkStealingContext::popLocal(LocalQueue& queue) -> std::optional<Task> {
+  std::lock_guard lock{ queue.mutex_ };
+  if (queue.lifo_slot_) {
+    return std::exchange(queue.lifo_slot_, std::nullopt);
+  }
+  if (queue.tasks_.empty()) {
+    return std::nullopt;
+  }
+  auto task = std::move(queue.tasks_.back());
+  queue.tasks_.pop_back();
+  return task;
+}
+
+auto WorkStealingContext::popInjected() -> std::optional<Task> {
+  std::lock_guard lock{ injection_mutex_ };
+  if (injection_queue_.empty()) {
+    return std::nullopt;
+  }
+  auto task = std::move(injection_queue_.front());
+  injection_queue_.pop_front();
+  return task;
+}
+
+auto WorkStealingContext::steal(std::minstd_rand& random, const LocalQueue* self)
+    -> std::optional<Task> {
+  if (queues_.empty()) {
+    return std::nullopt;
+  }
+
+  auto start = random() % queues_.size();
+  for (size_t i = 0; i < queues_.size(); ++i) {
+    auto& victim = *queues_[(start + i) % queues_.size()];
+    if (&victim == self) {
+      continue;
+    }
+
+    std::unique_lock lock{ victim.mutex_, std::try_to_lock };
+    if (!lock.owns_lock()) {
+      continue;
+    }
+
+    if (!victim.tasks_.empty()) {
+      auto task = std::move(victim.tasks_.front());
+      victim.tasks_.pop_front();
+      return task;
+    }
+
+    // The owner is busy and never got to its freshest task; take it rather than let it starve.
+    if (victim.lifo_slot_) {
+      return std::exchange(victim.lifo_slot_, std::nullopt);
+    }
+  }
+
+  return std::nullopt;
+}
+
+void WorkStealingContext::shutdown() {
+  stop();
+
+  destroyTasks();
+  // services may still hold handlers, and destroying those can post once more
+  execution_context::shutdown();
+  destroyTasks();
+}
+
+void WorkStealingContext::destroyTasks() {
+  while (true) {
+    std::deque<Task> tasks;
+
+    {
+      std::lock_guard lock{ injection_mutex_ };
+      tasks.swap(injection_queue_);
+    }
+
+    for (auto& queue : queues_) {
+      std::lock_guard lock{ queue->mutex_ };
+      std::ranges::move(queue->tasks_, std::back_inserter(tasks));
+      queue->tasks_.clear();
+      if (queue->lifo_slot_) {
+        tasks.push_back(std::move(*std::exchange(queue->lifo_slot_, std::nullopt)));
+      }
+    }
+
+    if (tasks.empty()) {
+      return;
+    }
+
+    // destroyed outside the locks, a handler's destructor may post
+    queued_.fetch_sub(tasks.size(), std::memory_order_relaxed);
+    auto count = tasks.size();
+    tasks.clear();
+    for (size_t i = 0; i < count; ++i) {
+      workFinished();
+    }
+  }
+}
+
+void WorkStealingContext::workStarted() noexcept {
+  outstanding_work_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void WorkStealingContext::workFinished() noexcept {
+  if (outstanding_work_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    wakeAll();
+  }
+}
+
+void WorkStealingContext::wakeOne() {
+  if (sleeping_.load(std::memory_order_seq_cst) == 0) {
+    return;
+  }
+  { std::lock_guard lock{ idle_mutex_ }; }
+  idle_.notify_one();
+}
+
+void WorkStealingContext::wakeAll() {
+  { std::lock_guard lock{ idle_mutex_ }; }
+  idle_.notify_all();
+}
+
+}  // namespace gravity
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "boost/asio/execution.hpp"
+#include "boost/asio/execution_context.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <vector>
+
+namespace gravity {
+
+class WorkStealingContext;
+
+// Standard Asio executor over a WorkStealingContext. It is accepted anywhere an io_context executor
+// is, so make_strand, any_io_executor and co_spawn work unchanged on top of it.
+class WorkStealingExecutor {
+ public:
+  WorkStealingExecutor(WorkStealingContext& context, bool tracked = false) noexcept;
+
+  WorkStealingExecutor(const WorkStealingExecutor& other) noexcept;
+  WorkStealingExecutor(WorkStealingExecutor&& other) noexcept;
+  auto operator=(const WorkStealingExecutor& other) noexcept -> WorkStealingExecutor&;
+  auto operator=(WorkStealingExecutor&& other) noexcept -> WorkStealingExecutor&;
+
+  ~WorkStealingExecutor();
+
+  template <typename Function>
+  void execute(Function&& function) const;
+
+  [[nodiscard]] auto query(boost::asio::execution::context_t /*unused*/) const noexcept
+      -> WorkStealingContext& {
+    return *context_;
+  }
+
+  [[nodiscard]] static constexpr auto query(boost::asio::execution::blocking_t /*unused*/) noexcept
+      -> boost::asio::execution::blocking_t {
+    return boost::asio::execution::blocking.never;
+  }
+
+  [[nodiscard]] static constexpr auto query(
+      boost::asio::execution::relationship_t /*unused*/) noexcept
+      -> boost::asio::execution::relationship_t {
+    return boost::asio::execution::relationship.fork;
+  }
+
+  [[nodiscard]] auto query(boost::asio::execution::outstanding_work_t /*unused*/) const noexcept
+      -> boost::asio::execution::outstanding_work_t {
+    if (tracked_) {
+      return boost::asio::execution::outstanding_work.tracked;
+    }
+    return boost::asio::execution::outstanding_work.untracked;
+  }
+
+  template <typename OtherAllocator>
+  [[nodiscard]] static auto query(
+      boost::asio::execution::allocator_t<OtherAllocator> /*unused*/) noexcept
+      -> std::allocator<void> {
+    return {};
+  }
+
+  [[nodiscard]] auto require(boost::asio::execution::blocking_t::never_t /*unused*/) const
+      -> WorkStealingExecutor {
+    return *this;
+  }
+
+  [[nodiscard]] auto require(boost::asio::execution::outstanding_work_t::tracked_t /*unused*/) const
+      -> WorkStealingExecutor {
+    return { *context_, true };
+  }
+
+  [[nodiscard]] auto require(
+      boost::asio::execution::outstanding_work_t::untracked_t /*unused*/) const
+      -> WorkStealingExecutor {
+    return { *context_, false };
+  }
+
+  friend auto operator==(const WorkStealingExecutor& lhs, const WorkStealingExecutor& rhs) noexcept
+      -> bool {
+    return lhs.context_ == rhs.context_ && lhs.tracked_ == rhs.tracked_;
+  }
+
+  friend auto operator!=(const WorkStealingExecutor& lhs, const WorkStealingExecutor& rhs) noexcept
+      -> bool {
+    return !(lhs == rhs);
+  }
+
+ private:
+  WorkStealingContext* context_;
+  bool tracked_;
+};
+
+// Execution context with one deque per worker thread. Handlers submitted from a worker land in that
+// worker's LIFO slot so the task it just spawned runs next while still hot in cache; the displaced
+// task goes to the back of the worker's deque. Handlers submitted from foreign threads go through a
+// shared injection queue. Idle workers steal from the front of a randomly chosen victim's deque.
+class WorkStealingContext : public boost::asio::execution_context {
+ public:
+  using executor_type = WorkStealingExecutor;
+
+  explicit WorkStealingContext(size_t concurrency_hint);
+
+  WorkStealingContext(const WorkStealingContext&) = delete;
+  auto operator=(const WorkStealingContext&) -> WorkStealingContext& = delete;
+
+  ~WorkStealingContext();
+
+  auto get_executor() noexcept -> executor_type { return executor_type{ *this }; }
+
+  // Runs handlers on the calling thread until the context is stopped or runs out of work. Each of
+  // the first `concurrency_hint` callers owns a local queue; any further callers only steal.
+  void run();
+
+  void stop();
+
+  [[nodiscard]] auto stopped() const noexcept -> bool {
+    return stopped_.load(std::memory_order_acquire);
+  }
+
+ private:
+  friend class WorkStealingExecutor;
+
+  using Task = std::move_only_function<void()>;
+
+  struct alignas(64) LocalQueue {
+    std::mutex mutex_;
+    std::deque<Task> tasks_;
+    std::optional<Task> lifo_slot_;
+  };
+
+  std::vector<std::unique_ptr<LocalQueue>> queues_;
+  std::atomic<size_t> next_queue_{ 0 };
+
+  std::mutex injection_mutex_;
+  std::deque<Task> injection_queue_;
+
+  std::atomic<size_t> outstanding_work_{ 0 };
+  std::atomic<size_t> queued_{ 0 };
+  std::atomic<size_t> sleeping_{ 0 };
+  std::atomic<bool> stopped_{ false };
+
+  std::mutex idle_mutex_;
+  std::condition_variable idle_;
+
+  void post(Task task);
+
+  auto popLocal(LocalQueue& queue) -> std::optional<Task>;
+  auto popInjected() -> std::optional<Task>;
+  auto steal(std::minstd_rand& random, const LocalQueue* self) -> std::optional<Task>;
+
+  // Stops the context and destroys every queued handler while the members they may call back into
+  // (through a tracked executor) are still alive.
+  void shutdown();
+  void destroyTasks();
+
+  void workStarted() noexcept;
+  void workFinished() noexcept;
+  void wakeOne();
+  void wakeAll();
+};
+
+template <typename Function>
+void WorkStealingExecutor::execute(Function&& function) const {
+  context_->post(WorkStealingContext::Task{ std::forward<Function>(function) });
+}
+
+}  // namespace gravity
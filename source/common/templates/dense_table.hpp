@@ -0,0 +1,88 @@
+#pragma once
+
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace gravity {
+
+// Fixed-size table of optional elements addressed by a dense index. Elements sit in one flat
+// array next to an occupancy bitset, a lookup is an indexed load and a bit test, and iterating
+// the occupied elements walks both arrays front to back.
+template <typename T>
+class DenseTable {
+ public:
+  DenseTable() = default;
+  explicit DenseTable(size_t size) { resize(size); }
+
+  // Existing elements below `size` are kept.
+  void resize(size_t size) {
+    elements_.resize(size);
+    occupied_.resize((size + WordBits - 1) / WordBits);
+    if (size % WordBits != 0) {
+      occupied_.back() &= (uint64_t{ 1 } << (size % WordBits)) - 1;
+    }
+  }
+
+  [[nodiscard]] auto size() const -> size_t { return elements_.size(); }
+
+  [[nodiscard]] auto contains(size_t index) const -> bool {
+    assert(index < elements_.size());
+    return (occupied_[index / WordBits] & bit(index)) != 0;
+  }
+
+  [[nodiscard]] auto find(size_t index) -> T* {
+    return contains(index) ? &elements_[index] : nullptr;
+  }
+  [[nodiscard]] auto find(size_t index) const -> const T* {
+    return contains(index) ? &elements_[index] : nullptr;
+  }
+
+  // Replaces whatever the slot held.
+  auto emplace(size_t index, T value) -> T& {
+    assert(index < elements_.size());
+    occupied_[index / WordBits] |= bit(index);
+    elements_[index] = std::move(value);
+    return elements_[index];
+  }
+
+  void erase(size_t index) {
+    assert(index < elements_.size());
+    occupied_[index / WordBits] &= ~bit(index);
+    elements_[index] = T{};
+  }
+
+  [[nodiscard]] auto count() const -> size_t {
+    size_t count = 0;
+    for (auto word : occupied_) {
+      count += static_cast<size_t>(std::popcount(word));
+    }
+    return count;
+  }
+
+  // Calls function(index, element) for every occupied slot in index order.
+  template <typename Function>
+  void forEach(Function&& function) {
+    for (size_t word = 0; word < occupied_.size(); ++word) {
+      for (auto bits = occupied_[word]; bits != 0; bits &= bits - 1) {
+        auto index = (word * WordBits) + static_cast<size_t>(std::countr_zero(bits));
+        function(index, elements_[index]);
+      }
+    }
+  }
+
+ private:
+  static constexpr size_t WordBits{ 64 };
+
+  std::vector<T> elements_;
+  std::vector<uint64_t> occupied_;
+
+  static constexpr auto bit(size_t index) -> uint64_t {
+    return uint64_t{ 1 } << (index % WordBits);
+  }
+};
+
+}  // namespace gravity
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+
+namespace gravity {
+
+// Append-only array whose elements never move. Elements live in fixed-size pages reached through a
+// fixed directory of atomic page pointers, so one owner can keep appending while other threads look
+// up elements whose index was handed to them.
+template <typename T, size_t PageSize = 256, size_t MaxPages = 1024>
+class PagedArray {
+ public:
+  static constexpr size_t Capacity{ PageSize * MaxPages };
+
+  PagedArray() = default;
+
+  PagedArray(const PagedArray&) = delete;
+  auto operator=(const PagedArray&) -> PagedArray& = delete;
+
+  ~PagedArray() {
+    for (auto& page : pages_) {
+      delete page.load(std::memory_order_relaxed);
+    }
+  }
+
+  // Owner only. Appends a default constructed element and returns its index, or nullopt once the
+  // directory is full.
+  auto emplaceBack() -> std::optional<size_t> {
+    if (size_ == Capacity) {
+      return std::nullopt;
+    }
+
+    if (size_ % PageSize == 0) {
+      pages_[size_ / PageSize].store(new Page{}, std::memory_order_release);
+    }
+    return size_++;
+  }
+
+  // Owner only.
+  [[nodiscard]] auto size() const -> size_t { return size_; }
+
+  // Owner only, `index` must be below size().
+  auto operator[](size_t index) -> T& {
+    return (*pages_[index / PageSize].load(std::memory_order_relaxed))[index % PageSize];
+  }
+  auto operator[](size_t index) const -> const T& {
+    return (*pages_[index / PageSize].load(std::memory_order_relaxed))[index % PageSize];
+  }
+
+  // Any thread. Returns nullptr when the page that would hold `index` does not exist yet.
+  [[nodiscard]] auto find(size_t index) const -> const T* {
+    if (index >= Capacity) {
+      return nullptr;
+    }
+
+    const auto* page = pages_[index / PageSize].load(std::memory_order_acquire);
+    return page == nullptr ? nullptr : &(*page)[index % PageSize];
+  }
+
+ private:
+  using Page = std::array<T, PageSize>;
+
+  std::array<std::atomic<Page*>, MaxPages> pages_{};
+  size_t size_ = 0;
+};
+
+}  // namespace gravity
@@ -0,0 +1,82 @@
+#include "source/common/templates/paged_array.hpp"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace gravity {
+
+namespace {
+
+TEST(PagedArrayTest, ElementsKeepTheirAddressAcrossPages) {
+  PagedArray<size_t, 4, 8> array;
+
+  std::vector<const size_t*> addresses;
+  for (size_t i = 0; i < 10; ++i) {
+    auto index = array.emplaceBack();
+    ASSERT_EQ(index, std::optional<size_t>{ i });
+    array[i] = i * 10;
+    addresses.push_back(&array[i]);
+  }
+
+  EXPECT_EQ(array.size(), 10U);
+  for (size_t i = 0; i < 10; ++i) {
+    EXPECT_EQ(array.find(i), addresses[i]);
+    EXPECT_EQ(*array.find(i), i * 10);
+  }
+}
+
+TEST(PagedArrayTest, FindOnlyReachesAllocatedPages) {
+  PagedArray<int, 4, 8> array;
+  EXPECT_EQ(array.find(0), nullptr);
+
+  ASSERT_TRUE(array.emplaceBack());
+  EXPECT_NE(array.find(0), nullptr);
+  // the rest of the first page exists, the second page does not
+  EXPECT_NE(array.find(3), nullptr);
+  EXPECT_EQ(array.find(4), nullptr);
+  EXPECT_EQ(array.find(decltype(array)::Capacity), nullptr);
+}
+
+TEST(PagedArrayTest, EmplaceFailsOnceTheDirectoryIsFull) {
+  PagedArray<int, 2, 2> array;
+  for (size_t i = 0; i < decltype(array)::Capacity; ++i) {
+    ASSERT_TRUE(array.emplaceBack());
+  }
+  EXPECT_FALSE(array.emplaceBack());
+  EXPECT_EQ(array.size(), decltype(array)::Capacity);
+}
+
+TEST(PagedArrayTest, ReadersSeePublishedElementsWhileTheOwnerAppends) {
+  constexpr size_t Count{ 16 * 1024 };
+  PagedArray<std::atomic<size_t>, 64, Count / 64> array;
+  std::atomic<size_t> published{ 0 };
+
+  std::thread reader{ [&] {
+    size_t seen{ 0 };
+    while (seen < Count) {
+      auto limit = published.load(std::memory_order_acquire);
+      for (; seen < limit; ++seen) {
+        const auto* element = array.find(seen);
+        ASSERT_NE(element, nullptr);
+        ASSERT_EQ(element->load(std::memory_order_relaxed), seen + 1);
+      }
+    }
+  } };
+
+  for (size_t i = 0; i < Count; ++i) {
+    auto index = array.emplaceBack();
+    ASSERT_TRUE(index);
+    array[*index].store(i + 1, std::memory_order_relaxed);
+    published.store(i + 1, std::memory_order_release);
+  }
+  reader.join();
+}
+
+}  // namespace
+
+}  // namespace gravity
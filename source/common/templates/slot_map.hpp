@@ -0,0 +1,272 @@
+#pragma once
+
+#include "source/common/templates/paged_array.hpp"
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gravity {
+
+// Index and generation packed into a single integer. The default constructed handle is null and
+// never matches a live element. `Tag` only keeps handles of different tables apart.
+template <
+    typename Tag, std::unsigned_integral Packed = uint64_t, size_t IndexBits = sizeof(Packed) * 4>
+class SlotHandle {
+ public:
+  static_assert(sizeof(Packed) >= sizeof(uint32_t), "use a 32 or 64 bit packed handle");
+  static_assert(IndexBits > 0 && IndexBits < sizeof(Packed) * 8);
+
+  static constexpr size_t GenerationBits{ (sizeof(Packed) * 8) - IndexBits };
+  static constexpr Packed IndexMask{ (Packed{ 1 } << IndexBits) - 1 };
+  static constexpr Packed GenerationMask{ static_cast<Packed>(~Packed{ 0 } >> IndexBits) };
+
+  // the all-ones index is reserved for the null handle
+  static constexpr size_t MaxIndex{ IndexMask - 1 };
+
+  constexpr SlotHandle() = default;
+  constexpr SlotHandle(size_t index, size_t generation)
+      : value_{ static_cast<Packed>(
+            (static_cast<Packed>(generation & GenerationMask) << IndexBits) |
+            (static_cast<Packed>(index) & IndexMask)) } {}
+
+  [[nodiscard]] constexpr auto index() const -> size_t { return value_ & IndexMask; }
+  [[nodiscard]] constexpr auto generation() const -> size_t {
+    return (value_ >> IndexBits) & GenerationMask;
+  }
+
+  [[nodiscard]] constexpr auto isNull() const -> bool { return value_ == NullValue; }
+  [[nodiscard]] constexpr auto value() const -> Packed { return value_; }
+
+  constexpr auto operator==(const SlotHandle& other) const -> bool = default;
+
+ private:
+  static constexpr Packed NullValue{ std::numeric_limits<Packed>::max() };
+
+  Packed value_ = NullValue;
+};
+
+// Generational slot map. Elements are constructed in place in a PagedArray, so their addresses
+// stay fixed from emplace() until erase(), and erasing bumps the slot generation so stale handles
+// are rejected instead of aliasing whatever reuses the slot. Iteration walks a dense array of the
+// live handles; the elements themselves stay in their slots, they are not packed.
+//
+// Members are meant for a single owner (usually a strand). ThreadSafe serializes emplace, erase
+// and extract behind a mutex so several threads may allocate. Other threads never touch elements:
+// a non-void Published adds a value per slot, set with publish(), that findConcurrent() reads from
+// any thread. It lives next to the generation in slot storage that is never destroyed, so reading
+// it races with nothing, not even an erase of the same slot.
+template <
+    typename T, typename Tag = T, bool ThreadSafe = false, typename Handle = SlotHandle<Tag>,
+    typename Published = void>
+class SlotMap {
+  struct NoPublished {};
+
+ public:
+  using HandleType = Handle;
+  using PublishedType = std::conditional_t<std::is_void_v<Published>, NoPublished, Published>;
+
+  SlotMap() = default;
+
+  SlotMap(const SlotMap&) = delete;
+  auto operator=(const SlotMap&) -> SlotMap& = delete;
+
+  // Returns nullopt once every slot addressable by Handle is in use.
+  template <typename... Args>
+  auto emplace(Args&&... arguments) -> std::optional<Handle> {
+    std::lock_guard lock{ mutex_ };
+
+    size_t index = 0;
+    if (!free_list_.empty()) {
+      index = free_list_.back();
+      free_list_.pop_back();
+    } else {
+      if (slots_.size() > Handle::MaxIndex) {
+        return std::nullopt;
+      }
+
+      auto new_index = slots_.emplaceBack();
+      if (!new_index) {
+        return std::nullopt;
+      }
+      index = *new_index;
+    }
+
+    auto& slot = slots_[index];
+    slot.value_.emplace(std::forward<Args>(arguments)...);
+    slot.dense_index_ = dense_.size();
+
+    Handle handle{ index, slot.generation_.load(std::memory_order_relaxed) };
+    dense_.push_back(handle);
+    return handle;
+  }
+
+  // Destroys the element; returns false for a stale or null handle.
+  auto erase(Handle handle) -> bool {
+    std::lock_guard lock{ mutex_ };
+
+    auto* slot = lookup(handle);
+    if (slot == nullptr) {
+      return false;
+    }
+
+    unpublish(*slot);
+    slot->value_.reset();
+    release(handle, *slot);
+    return true;
+  }
+
+  // Moves the element out and frees its slot, so the caller can defer destroying it.
+  auto extract(Handle handle) -> std::optional<T> {
+    std::lock_guard lock{ mutex_ };
+
+    auto* slot = lookup(handle);
+    if (slot == nullptr) {
+      return std::nullopt;
+    }
+
+    unpublish(*slot);
+    std::optional<T> value{ std::move(slot->value_) };
+    slot->value_.reset();
+    release(handle, *slot);
+    return value;
+  }
+
+  [[nodiscard]] auto get(Handle handle) -> T* {
+    auto* slot = lookup(handle);
+    return slot == nullptr ? nullptr : &*slot->value_;
+  }
+
+  [[nodiscard]] auto get(Handle handle) const -> const T* {
+    const auto* slot = lookup(handle);
+    return slot == nullptr ? nullptr : &*slot->value_;
+  }
+
+  [[nodiscard]] auto contains(Handle handle) const -> bool { return lookup(handle) != nullptr; }
+
+  // Owner only. Sets the value findConcurrent() returns for a live element; erase() and extract()
+  // reset it to PublishedType{} before the element is destroyed.
+  void publish(Handle handle, PublishedType value)
+    requires(!std::is_void_v<Published>)
+  {
+    auto* slot = lookup(handle);
+    if (slot != nullptr) {
+      slot->published_.store(value, std::memory_order_release);
+    }
+  }
+
+  // Any thread. The value published for handle, or nullopt for a null or stale handle.
+  [[nodiscard]] auto findConcurrent(Handle handle) const -> std::optional<PublishedType>
+    requires(!std::is_void_v<Published>)
+  {
+    if (handle.isNull()) {
+      return std::nullopt;
+    }
+
+    const auto* slot = slots_.find(handle.index());
+    if (slot == nullptr || !matches(*slot, handle, std::memory_order_acquire)) {
+      return std::nullopt;
+    }
+
+    // A value published for a later generation is ordered after the generation bump that
+    // precedes it, so the second check rejects it.
+    auto value = slot->published_.load(std::memory_order_acquire);
+    if (!matches(*slot, handle, std::memory_order_acquire)) {
+      return std::nullopt;
+    }
+    return value;
+  }
+
+  // Any thread.
+  [[nodiscard]] auto isCurrent(Handle handle) const -> bool {
+    if (handle.isNull()) {
+      return false;
+    }
+
+    const auto* slot = slots_.find(handle.index());
+    return slot != nullptr && matches(*slot, handle, std::memory_order_acquire);
+  }
+
+  // Handles of all live elements, in no particular order. Invalidated by emplace/erase/extract.
+  [[nodiscard]] auto handles() const -> std::span<const Handle> { return dense_; }
+
+  template <typename Function>
+  void forEach(Function&& function) {
+    for (auto handle : dense_) {
+      function(handle, *slots_[handle.index()].value_);
+    }
+  }
+
+  [[nodiscard]] auto size() const -> size_t { return dense_.size(); }
+  [[nodiscard]] auto empty() const -> bool { return dense_.empty(); }
+
+ private:
+  struct Slot {
+    std::optional<T> value_;
+
+    // atomic so findConcurrent/isCurrent can validate handles off the owning thread
+    std::atomic<size_t> generation_ = 0;
+    [[no_unique_address]] std::conditional_t<
+        std::is_void_v<Published>, NoPublished, std::atomic<PublishedType>> published_{};
+    size_t dense_index_ = 0;
+  };
+
+  struct NoLock {
+    void lock() {}
+    void unlock() {}
+  };
+
+  PagedArray<Slot> slots_;
+  std::vector<size_t> free_list_;
+  std::vector<Handle> dense_;
+
+  [[no_unique_address]] mutable std::conditional_t<ThreadSafe, std::mutex, NoLock> mutex_;
+
+  static auto matches(const Slot& slot, Handle handle, std::memory_order order) -> bool {
+    return (slot.generation_.load(order) & Handle::GenerationMask) == handle.generation();
+  }
+
+  auto lookup(Handle handle) const -> const Slot* {
+    if (handle.isNull() || handle.index() >= slots_.size()) {
+      return nullptr;
+    }
+
+    const auto& slot = slots_[handle.index()];
+    if (!slot.value_.has_value() || !matches(slot, handle, std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return &slot;
+  }
+
+  auto lookup(Handle handle) -> Slot* {
+    return const_cast<Slot*>(std::as_const(*this).lookup(handle));  // NOLINT
+  }
+
+  static void unpublish(Slot& slot) {
+    if constexpr (!std::is_void_v<Published>) {
+      slot.published_.store(PublishedType{}, std::memory_order_release);
+    }
+  }
+
+  void release(Handle handle, Slot& slot) {
+    slot.generation_.fetch_add(1, std::memory_order_release);
+
+    // swap-remove keeps the dense array packed
+    auto moved = dense_.back();
+    dense_[slot.dense_index_] = moved;
+    slots_[moved.index()].dense_index_ = slot.dense_index_;
+    dense_.pop_back();
+
+    free_list_.push_back(handle.index());
+  }
+};
+
+}  // namespace gravity
@@ -0,0 +1,208 @@
+#include "source/common/templates/slot_map.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// SlotMap against the hand-written tables it replaced: a vector of slots with an alive flag, a
+// free list, and 16 byte handles of two size_t.
+//
+//   BM_*Churn    erase a random live element and insert a replacement, then look up ChurnLookups
+//                random live handles, with the table holding the argument's element count
+//   BM_*Lookup   random lookups of live handles
+//   BM_*Iterate  visit every live element of a table that had every other element erased
+
+namespace gravity {
+
+namespace {
+
+constexpr size_t ChurnLookups{ 8 };
+constexpr size_t SequenceLength{ 1 << 16 };
+
+// about the size of a Vulkan buffer entry: handle, allocation and allocation info
+struct Payload {
+  std::array<uint64_t, 6> words_{};
+};
+
+class LegacyTable {
+ public:
+  struct Handle {
+    size_t index_ = 0;
+    size_t generation_ = 0;
+  };
+
+  auto insert(const Payload& payload) -> Handle {
+    size_t index{ 0 };
+    if (!free_list_.empty()) {
+      index = free_list_.back();
+      free_list_.pop_back();
+    } else {
+      index = slots_.size();
+      slots_.emplace_back();
+    }
+
+    auto& slot = slots_[index];
+    slot.payload_ = payload;
+    slot.alive_ = true;
+    slot.index_ = index;
+    return Handle{ .index_ = index, .generation_ = slot.generation_ };
+  }
+
+  void erase(Handle handle) {
+    auto& slot = slots_[handle.index_];
+    if (!slot.alive_ || slot.generation_ != handle.generation_) {
+      return;
+    }
+    slot.alive_ = false;
+    slot.generation_++;
+    free_list_.push_back(handle.index_);
+  }
+
+  auto get(Handle handle) -> Payload* {
+    if (handle.index_ >= slots_.size()) {
+      return nullptr;
+    }
+    auto& slot = slots_[handle.index_];
+    return slot.alive_ && slot.generation_ == handle.generation_ ? &slot.payload_ : nullptr;
+  }
+
+  template <typename Function>
+  void forEach(Function&& function) {
+    for (auto& slot : slots_) {
+      if (slot.alive_) {
+        function(slot.payload_);
+      }
+    }
+  }
+
+ private:
+  struct Slot {
+    Payload payload_;
+    size_t generation_ = 0;
+    bool alive_ = true;
+    size_t index_ = 0;
+  };
+
+  std::vector<Slot> slots_;
+  std::vector<size_t> free_list_;
+};
+
+struct PayloadTag {};
+
+template <typename Handle>
+class SlotMapTable {
+ public:
+  auto insert(const Payload& payload) -> Handle { return *map_.emplace(payload); }
+  void erase(Handle handle) { map_.erase(handle); }
+  auto get(Handle handle) -> Payload* { return map_.get(handle); }
+
+  template <typename Function>
+  void forEach(Function&& function) {
+    map_.forEach([&](Handle, Payload& payload) { function(payload); });
+  }
+
+ private:
+  SlotMap<Payload, PayloadTag, false, Handle> map_;
+};
+
+using SlotMap64 = SlotMapTable<SlotHandle<PayloadTag>>;
+using SlotMap32 = SlotMapTable<SlotHandle<PayloadTag, uint32_t, 20>>;
+
+auto randomPositions(size_t count) -> std::vector<size_t> {
+  std::mt19937_64 generator{ 42 };
+  std::uniform_int_distribution<size_t> distribution{ 0, count - 1 };
+
+  std::vector<size_t> positions(SequenceLength);
+  for (auto& position : positions) {
+    position = distribution(generator);
+  }
+  return positions;
+}
+
+template <typename Table>
+void BM_Churn(benchmark::State& state) {
+  auto count = static_cast<size_t>(state.range(0));
+
+  Table table;
+  std::vector<decltype(table.insert({}))> live;
+  for (size_t i = 0; i < count; ++i) {
+    live.push_back(table.insert({}));
+  }
+
+  auto positions = randomPositions(count);
+  size_t cursor{ 0 };
+  auto next = [&] { return positions[cursor++ % SequenceLength]; };
+
+  for (auto _ : state) {
+    auto& victim = live[next()];
+    table.erase(victim);
+    victim = table.insert({});
+
+    for (size_t i = 0; i < ChurnLookups; ++i) {
+      benchmark::DoNotOptimize(table.get(live[next()]));
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+template <typename Table>
+void BM_Lookup(benchmark::State& state) {
+  auto count = static_cast<size_t>(state.range(0));
+
+  Table table;
+  std::vector<decltype(table.insert({}))> live;
+  for (size_t i = 0; i < count; ++i) {
+    live.push_back(table.insert({}));
+  }
+
+  auto positions = randomPositions(count);
+  size_t cursor{ 0 };
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(table.get(live[positions[cursor++ % SequenceLength]]));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+template <typename Table>
+void BM_Iterate(benchmark::State& state) {
+  auto count = static_cast<size_t>(state.range(0));
+
+  Table table;
+  std::vector<decltype(table.insert({}))> live;
+  for (size_t i = 0; i < count; ++i) {
+    live.push_back(table.insert({}));
+  }
+  for (size_t i = 0; i < count; i += 2) {
+    table.erase(live[i]);
+  }
+
+  for (auto _ : state) {
+    uint64_t sum{ 0 };
+    table.forEach([&](const Payload& payload) { sum += payload.words_[0]; });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * (count / 2)));
+}
+
+void tableSizes(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgName("elements")->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 19);
+}
+
+BENCHMARK_TEMPLATE(BM_Churn, LegacyTable)->Apply(tableSizes);
+BENCHMARK_TEMPLATE(BM_Churn, SlotMap64)->Apply(tableSizes);
+BENCHMARK_TEMPLATE(BM_Churn, SlotMap32)->Apply(tableSizes);
+BENCHMARK_TEMPLATE(BM_Lookup, LegacyTable)->Apply(tableSizes);
+BENCHMARK_TEMPLATE(BM_Lookup, SlotMap64)->Apply(tableSizes);
+BENCHMARK_TEMPLATE(BM_Lookup, SlotMap32)->Apply(tableSizes);
+BENCHMARK_TEMPLATE(BM_Iterate, LegacyTable)->Apply(tableSizes);
+BENCHMARK_TEMPLATE(BM_Iterate, SlotMap64)->Apply(tableSizes);
+BENCHMARK_TEMPLATE(BM_Iterate, SlotMap32)->Apply(tableSizes);
+
+}  // namespace
+
+}  // namespace gravity
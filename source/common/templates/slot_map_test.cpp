@@ -0,0 +1,193 @@
+#include "source/common/templates/slot_map.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace gravity {
+
+namespace {
+
+struct TestTag {};
+
+using Handle = SlotHandle<TestTag>;
+
+TEST(SlotHandleTest, PacksIndexAndGeneration) {
+  Handle handle{ 12, 7 };
+  EXPECT_EQ(handle.index(), 12U);
+  EXPECT_EQ(handle.generation(), 7U);
+  EXPECT_FALSE(handle.isNull());
+
+  EXPECT_TRUE(Handle{}.isNull());
+  EXPECT_NE(Handle{}, Handle(0, 0));
+}
+
+TEST(SlotMapTest, ReusedSlotGetsANewGeneration) {
+  SlotMap<std::string, TestTag> map;
+
+  auto first = map.emplace("first");
+  ASSERT_TRUE(first);
+  ASSERT_TRUE(map.erase(*first));
+
+  auto second = map.emplace("second");
+  ASSERT_TRUE(second);
+  EXPECT_EQ(second->index(), first->index());
+  EXPECT_NE(second->generation(), first->generation());
+
+  EXPECT_EQ(map.get(*first), nullptr);
+  EXPECT_FALSE(map.contains(*first));
+  EXPECT_FALSE(map.isCurrent(*first));
+  EXPECT_FALSE(map.erase(*first));
+  ASSERT_NE(map.get(*second), nullptr);
+  EXPECT_EQ(*map.get(*second), "second");
+}
+
+TEST(SlotMapTest, NullHandleNeverMatches) {
+  SlotMap<int, TestTag> map;
+  ASSERT_TRUE(map.emplace(1));
+
+  EXPECT_EQ(map.get(Handle{}), nullptr);
+  EXPECT_FALSE(map.isCurrent(Handle{}));
+  EXPECT_FALSE(map.erase(Handle{}));
+}
+
+TEST(SlotMapTest, GenerationWrapsWithinItsBits) {
+  // four generation bits
+  using SmallHandle = SlotHandle<TestTag, uint32_t, 28>;
+  SlotMap<int, TestTag, false, SmallHandle> map;
+
+  auto first = map.emplace(0);
+  ASSERT_TRUE(first);
+  auto handle = *first;
+  for (size_t generation = 1; generation <= 16; ++generation) {
+    ASSERT_TRUE(map.erase(handle));
+    auto next = map.emplace(static_cast<int>(generation));
+    ASSERT_TRUE(next);
+    EXPECT_EQ(next->generation(), generation % 16);
+    EXPECT_FALSE(map.contains(handle));
+    handle = *next;
+  }
+  // after a full cycle the first handle matches again; that is the cost of small generations
+  EXPECT_TRUE(map.contains(*first));
+}
+
+TEST(SlotMapTest, EmplaceFailsOnceTheIndexBitsAreExhausted) {
+  using TinyHandle = SlotHandle<TestTag, uint32_t, 2>;
+  SlotMap<int, TestTag, false, TinyHandle> map;
+
+  for (size_t i = 0; i <= TinyHandle::MaxIndex; ++i) {
+    ASSERT_TRUE(map.emplace(static_cast<int>(i)));
+  }
+  EXPECT_FALSE(map.emplace(0));
+
+  // a freed slot can be handed out again
+  ASSERT_TRUE(map.erase(map.handles().front()));
+  EXPECT_TRUE(map.emplace(0));
+}
+
+TEST(SlotMapTest, ExtractMovesTheElementOutAndFreesTheSlot) {
+  SlotMap<std::unique_ptr<int>, TestTag> map;
+  auto handle = map.emplace(std::make_unique<int>(42));
+  ASSERT_TRUE(handle);
+
+  auto value = map.extract(*handle);
+  ASSERT_TRUE(value);
+  EXPECT_EQ(**value, 42);
+  EXPECT_FALSE(map.contains(*handle));
+  EXPECT_FALSE(map.extract(*handle));
+  EXPECT_TRUE(map.empty());
+}
+
+TEST(SlotMapTest, HandlesStayDenseAfterErase) {
+  SlotMap<int, TestTag> map;
+  std::vector<Handle> handles;
+  for (int i = 0; i < 8; ++i) {
+    handles.push_back(*map.emplace(i));
+  }
+  ASSERT_TRUE(map.erase(handles[2]));
+  ASSERT_TRUE(map.erase(handles[5]));
+
+  EXPECT_EQ(map.size(), 6U);
+  std::vector<int> values;
+  map.forEach([&](Handle handle, int value) {
+    EXPECT_TRUE(map.contains(handle));
+    values.push_back(value);
+  });
+  std::ranges::sort(values);
+  EXPECT_EQ(values, (std::vector<int>{ 0, 1, 3, 4, 6, 7 }));
+}
+
+TEST(SlotMapTest, PublishedValueIsResetOnErase) {
+  SlotMap<int, TestTag, false, Handle, const int*> map;
+  auto handle = map.emplace(5);
+  ASSERT_TRUE(handle);
+
+  EXPECT_EQ(map.findConcurrent(*handle), std::optional<const int*>{ nullptr });
+  map.publish(*handle, map.get(*handle));
+  EXPECT_EQ(map.findConcurrent(*handle), std::optional<const int*>{ map.get(*handle) });
+
+  ASSERT_TRUE(map.erase(*handle));
+  EXPECT_FALSE(map.findConcurrent(*handle));
+
+  auto reused = map.emplace(6);
+  ASSERT_TRUE(reused);
+  EXPECT_FALSE(map.findConcurrent(*handle));
+  EXPECT_EQ(map.findConcurrent(*reused), std::optional<const int*>{ nullptr });
+}
+
+TEST(SlotMapTest, FindConcurrentNeverReturnsAnotherGenerationsValue) {
+  constexpr size_t Rounds{ 20'000 };
+  // the published value is the generation it was published under
+  SlotMap<int, TestTag, true, Handle, uint64_t> map;
+  std::atomic<uint64_t> current{ 0 };
+  std::atomic<bool> done{ false };
+
+  auto first = map.emplace(0);
+  ASSERT_TRUE(first);
+  map.publish(*first, first->generation() + 1);
+  current.store(first->value(), std::memory_order_release);
+
+  std::vector<std::thread> readers;
+  for (size_t reader = 0; reader < 4; ++reader) {
+    readers.emplace_back([&] {
+      while (!done.load(std::memory_order_acquire)) {
+        auto packed = current.load(std::memory_order_acquire);
+        Handle handle{ packed & Handle::IndexMask, packed >> (64 - Handle::GenerationBits) };
+        auto value = map.findConcurrent(handle);
+        if (value && *value != 0) {
+          ASSERT_EQ(*value, handle.generation() + 1);
+        }
+      }
+    });
+  }
+
+  auto handle = *first;
+  for (size_t round = 0; round < Rounds; ++round) {
+    EXPECT_TRUE(map.erase(handle));
+    auto next = map.emplace(static_cast<int>(round));
+    if (!next) {
+      ADD_FAILURE() << "emplace failed in round " << round;
+      break;
+    }
+    map.publish(*next, next->generation() + 1);
+    current.store(next->value(), std::memory_order_release);
+    handle = *next;
+  }
+
+  done.store(true, std::memory_order_release);
+  for (auto& reader : readers) {
+    reader.join();
+  }
+}
+
+}  // namespace
+
+}  // namespace gravity
@@ -84,4 +84,8 @@ auto getFileExtension(const std::string& filename) -> std::string {
   return filename.substr(pos + 1);
 }
 
+auto normalizePath(const std::string& path) -> std::string {
+  return std::filesystem::path{ path }.lexically_normal().generic_string();
+}
+
 }  // namespace gravity
\ No newline at end of file
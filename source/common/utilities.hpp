@@ -1,7 +1,9 @@
 #pragma once
 
 #include "diagnostics/trace.hpp"
+#include "source/common/hash.hpp"
 
+#include <cstddef>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -39,34 +41,8 @@ void writeFlatBufferToFile(const std::string& filename, std::span<uint8_t> buffe
 
 auto getFileExtension(const std::string& filename) -> std::string;
 
-using HashType = uint64_t;
-
-inline auto hashCombine(size_t lhs, size_t rhs) -> HashType {
-  lhs ^= rhs + 0x9e3779b9 + (lhs << 6) + (lhs >> 2);
-  return lhs;
-}
-
-constexpr HashType fnv_offset_basis = 14695981039346656037ULL;
-constexpr HashType fnv_prime = 1099511628211ULL;
-
-inline auto hash(std::span<const uint32_t> data, HashType offset_basis = fnv_offset_basis)
-    -> HashType {
-  HashType hash = fnv_offset_basis;
-  for (uint32_t word : data) {
-    hash ^= word;
-    hash *= fnv_prime;
-  }
-  return hash;
-}
-
-inline auto hash(std::span<const uint8_t> data, HashType offset_basis = fnv_offset_basis)
-    -> HashType {
-  HashType hash = offset_basis;
-  for (uint8_t byte : data) {
-    hash ^= static_cast<HashType>(byte);
-    hash *= fnv_prime;
-  }
-  return hash;
-}
+// Lexically normal form with '/' separators, so one file has one spelling wherever paths are used
+// as keys.
+auto normalizePath(const std::string& path) -> std::string;
 
 }  // namespace gravity
\ No newline at end of file
@@ -1,344 +1,155 @@
 #include "asset_manager.hpp"
-#include <expected>
 
-#include "boost/json/array.hpp"
-#include "common/asset_types.hpp"
 #include "source/common/error.hpp"
+#include "source/common/event/async_latch.hpp"
 #include "source/common/logging/logger.hpp"
 
-#include "boost/asio.hpp"
-#include "boost/json.hpp"
+#include "boost/asio/post.hpp"
+
+#include <algorithm>
+#include <expected>
+#include <filesystem>
+#include <numeric>
+#include <thread>
+#include <utility>
 
 #undef GRAVITY_MODULE_NAME
 #define GRAVITY_MODULE_NAME "resource_manager"
 
-namespace json = boost::json;
-
 namespace gravity {
 
-static constexpr const char* TypeParameter{ "type" };
-static constexpr const char* NameParameter{ "name" };
-static constexpr const char* IdParameter{ "id" };
-static constexpr const char* StagesParameter{ "stages" };
-static constexpr const char* SpirvParameter{ "spirv" };
-static constexpr const char* MetaParameter{ "meta" };
-static constexpr const char* ShaderParameter{ "shader" };
-static constexpr const char* TexturesParameter{ "textures" };
-static constexpr const char* ParametersParameter{ "parameters" };
-static constexpr const char* AssetParameter{ "asset" };
-static constexpr const char* SamplerParameter{ "sampler" };
-static constexpr const char* ImageParameter{ "image" };
-static constexpr const char* ColourSpaceParameter{ "colour_space" };
-static constexpr const char* MipmapsParameter{ "mipmaps" };
-
-static constexpr const char* SourceParameter{ "source" };
-static constexpr const char* SubmeshesParameter{ "submeshes" };
-static constexpr const char* FirstIndexParameter{ "first_index" };
-static constexpr const char* IndexCountParameter{ "index_count" };
-static constexpr const char* MaterialParameter{ "material" };
-
-static constexpr std::array<RequiredParameters, 1> ShaderRequiredParameters{
-  { { .name_ = StagesParameter, .expected_type_ = ExpectedTypes::List } }
-};
-
-static constexpr std::array<RequiredParameters, 3> ShaderStageRequiredParameters{
-  { { .name_ = SpirvParameter, .expected_type_ = ExpectedTypes::String },
-    { .name_ = MetaParameter, .expected_type_ = ExpectedTypes::String },
-    { .name_ = TypeParameter, .expected_type_ = ExpectedTypes::String } }
-};
-
-static constexpr std::array<RequiredParameters, 2> AssetRequiredParameters{
-  { { .name_ = IdParameter, .expected_type_ = ExpectedTypes::Integer },
-    { .name_ = TypeParameter, .expected_type_ = ExpectedTypes::String } }
-};
-
-static constexpr std::array<RequiredParameters, 2> MaterialRequiredParameters{
-  { { .name_ = TexturesParameter, .expected_type_ = ExpectedTypes::List },
-    { .name_ = ParametersParameter, .expected_type_ = ExpectedTypes::List } }
-};
-
-static constexpr std::array<RequiredParameters, 3> MaterialTextureRequiredParameters{
-  { { .name_ = NameParameter, .expected_type_ = ExpectedTypes::String },
-    { .name_ = AssetParameter, .expected_type_ = ExpectedTypes::Integer },
-    { .name_ = SamplerParameter, .expected_type_ = ExpectedTypes::String } }
-};
-
-static constexpr std::array<RequiredParameters, 3> TextureRequiredParameters{
-  { { .name_ = ImageParameter, .expected_type_ = ExpectedTypes::String },
-    { .name_ = ColourSpaceParameter, .expected_type_ = ExpectedTypes::String },
-    { .name_ = MipmapsParameter, .expected_type_ = ExpectedTypes::Boolean } }
-};
-
-static constexpr std::array<RequiredParameters, 2> MeshRequiredParameters{
-  { { .name_ = SourceParameter, .expected_type_ = ExpectedTypes::String },
-    { .name_ = SubmeshesParameter, .expected_type_ = ExpectedTypes::List } }
-};
-
-static constexpr std::array<RequiredParameters, 4> SubmeshRequiredParameters{
-  { { .name_ = NameParameter, .expected_type_ = ExpectedTypes::String },
-    { .name_ = FirstIndexParameter, .expected_type_ = ExpectedTypes::Integer },
-    { .name_ = IndexCountParameter, .expected_type_ = ExpectedTypes::Integer },
-    { .name_ = MaterialParameter, .expected_type_ = ExpectedTypes::Integer } }
-};
-
 auto AssetManager::initialize() -> boost::asio::awaitable<std::error_code> {
-  LOG_TRACE("initializing asset manager");
-
-  auto executor = co_await boost::asio::this_coro::executor;
-
-  boost::asio::stream_file file{ executor, "resources/assetsdb.json",
-                                 boost::asio::stream_file::read_only };
-  boost::asio::streambuf dynamic_buffer{};
+  LOG_TRACE("initializing asset manager; shards: {}", shards_.size());
 
-  auto [error_code, bytes] = co_await boost::asio::async_read(
-      file, dynamic_buffer, boost::asio::transfer_all(),
-      boost::asio::as_tuple(boost::asio::use_awaitable));
+  std::vector<size_t> all(shards_.size());
+  std::iota(all.begin(), all.end(), 0);
 
-  if (error_code != boost::asio::error::eof && error_code) {
-    LOG_ERROR("asset manager failed to load assets db; error: {}", error_code.message());
-    co_return Error::InternalError;
+  auto shards = co_await openShards(all);
+  if (!shards) {
+    co_return shards.error();
   }
 
-  std::istream input_stream(&dynamic_buffer);
-  auto val = json::parse(input_stream);
-
-  if (!val.is_array()) {
-    LOG_ERROR("asset database is not valid");
-    co_return Error::InternalError;
-  }
-
-  const auto& array = val.as_array();
-
-  for (const auto& item : array) {
-    if (item.is_object()) {
-      const auto& asset = item.as_object();
-
-      if (auto error{ validateRequiredParameters(asset, AssetRequiredParameters) };
-          error != Error::OK) {
-        co_return error;
-      }
-
-      auto asset_id{ asset.at(IdParameter).as_int64() };
-
-      auto asset_type{ assetTypeFromString(asset.at(TypeParameter).as_string()) };
-      if (!asset_type) {
-        LOG_ERROR("invalid asset type");
-        co_return asset_type.error();
-      }
-
-      auto [iterator, inserted] =
-          assets_.emplace(asset_id, AssetDescriptor{ .type = asset_type.value() });
-
-      if (!inserted) {
-        LOG_ERROR("duplicate asset id {}", asset_id);
-        co_return Error::SchemaError;
-      }
-
-      switch (iterator->second.type) {
-        case AssetType::Shader: {
-          auto shader_descriptor_expect{ parseShaderDescriptor(asset) };
-          if (!shader_descriptor_expect) {
-            LOG_ERROR("corrupt asset database");
-            co_return shader_descriptor_expect.error();
-          }
-          iterator->second.data_ = std::move(shader_descriptor_expect.value());
-
-          break;
-        }
-        case AssetType::Texture: {
-          auto texture_descriptor_expect{ parseTextureDescriptor(asset) };
-          if (!texture_descriptor_expect) {
-            LOG_ERROR("corrupt asset database");
-            co_return texture_descriptor_expect.error();
-          }
-          iterator->second.data_ = std::move(texture_descriptor_expect.value());
-
-          break;
-        }
-        case AssetType::Mesh: {
-          auto mesh_descriptor_expect{ parseMeshDescriptor(asset) };
-          if (!mesh_descriptor_expect) {
-            LOG_ERROR("corrupt asset database");
-            co_return mesh_descriptor_expect.error();
-          }
-          iterator->second.data_ = std::move(mesh_descriptor_expect.value());
-
-          break;
-        }
-        case AssetType::Material: {
-          auto material_descriptor_expect{ parseMaterialDescriptor(asset) };
-          if (!material_descriptor_expect) {
-            LOG_ERROR("corrupt asset database");
-            co_return material_descriptor_expect.error();
-          }
-          iterator->second.data_ = std::move(material_descriptor_expect.value());
-
-          break;
-        }
-      }
-    }
+  auto catalog = co_await AssetCatalog::build(
+      std::move(*shards), strands_.getWorkExecutor(), std::thread::hardware_concurrency());
+  if (!catalog) {
+    co_return catalog.error();
   }
 
+  catalog_ = std::move(*catalog);
+  LOG_INFO("asset catalog ready; shards: {}, assets: {}", catalog_.shardCount(), catalog_.size());
   co_return Error::OK;
 }
 
-auto AssetManager::getAsset(AssetId asset_id) const
-    -> std::expected<const AssetDescriptor*, std::error_code> {
-
-  if (!assets_.contains(asset_id)) {
-    return std::unexpected(Error::NotFoundError);
+auto AssetManager::stageReload(std::span<const std::string> changed_paths)
+    -> boost::asio::awaitable<std::expected<std::optional<AssetReload>, std::error_code>> {
+  std::vector<std::filesystem::path> changed_files;
+  for (const auto& path : changed_paths) {
+    changed_files.push_back(std::filesystem::path{ path }.lexically_normal());
   }
-  return &assets_.at(asset_id);
-}
-
-auto AssetManager::validateRequiredParameters(
-    const boost::json::object& object, std::span<const RequiredParameters> parameters)
-    -> std::error_code {
-  for (const auto& parameter : parameters) {
-    if (!object.contains(parameter.name_)) {
-      return Error::SchemaError;
-    }
 
-    switch (parameter.expected_type_) {
-      case ExpectedTypes::String:
-        if (!object.at(parameter.name_).is_string()) {
-          return Error::SchemaError;
-        }
-        break;
-      case ExpectedTypes::Integer:
-        if (!object.at(parameter.name_).is_int64()) {
-          return Error::SchemaError;
-        }
-        break;
-      case ExpectedTypes::List:
-        if (!object.at(parameter.name_).is_array()) {
-          return Error::SchemaError;
-        }
-        break;
-      case ExpectedTypes::Boolean:
-        if (!object.at(parameter.name_).is_bool()) {
-          return Error::SchemaError;
-        }
-        break;
+  std::vector<size_t> changed;
+  for (size_t shard = 0; shard < shards_.size(); ++shard) {
+    auto json_file = std::filesystem::path{ shards_[shard] + AssetShard::JsonExtension };
+    auto compiled_file = std::filesystem::path{ shards_[shard] + AssetShard::CompiledExtension };
+    auto touched = std::ranges::any_of(changed_files, [&](const auto& file) {
+      return file == json_file.lexically_normal() || file == compiled_file.lexically_normal();
+    });
+    if (touched) {
+      changed.push_back(shard);
     }
   }
-  return Error::OK;
-}
 
-auto AssetManager::parseShaderDescriptor(const boost::json::object& asset)
-    -> std::expected<ShaderDescriptor, std::error_code> {
-  if (auto error{ validateRequiredParameters(asset, ShaderRequiredParameters) };
-      error != Error::OK) {
-    return std::unexpected(error);
+  if (changed.empty()) {
+    co_return std::nullopt;
   }
-  const auto& shader_stages{ asset.at(StagesParameter).as_array() };
 
-  ShaderDescriptor shader_descriptor{};
-  for (const auto& shader_stage_object : shader_stages) {
-    if (!shader_stage_object.is_object()) {
-      return std::unexpected(Error::SchemaError);
-    }
-    const auto& shader_stage = shader_stage_object.as_object();
-    if (auto error{ validateRequiredParameters(shader_stage, ShaderStageRequiredParameters) };
-        error != Error::OK) {
-      return std::unexpected(error);
-    }
-
-    auto stage{ assetShaderStageFromString(shader_stage.at(TypeParameter).as_string()) };
-    if (!stage) {
-      return std::unexpected(stage.error());
-    }
-    shader_descriptor.stages_.emplace(
-        stage.value(), ShaderStageDescriptor{
-                           .spirv_path_ = std::string(shader_stage.at(SpirvParameter).as_string()),
-                           .meta_path_ = std::string(shader_stage.at(MetaParameter).as_string()) });
+  auto reopened = co_await openShards(changed);
+  if (!reopened) {
+    co_return std::unexpected(reopened.error());
   }
-  return shader_descriptor;
-}
 
-auto AssetManager::parseMaterialDescriptor(const boost::json::object& asset)
-    -> std::expected<MaterialDescriptor, std::error_code> {
-  if (auto error{ validateRequiredParameters(asset, MaterialRequiredParameters) };
-      error != Error::OK) {
-    return std::unexpected(error);
+  // unchanged shards are shared with the live catalog, not read again
+  std::vector<AssetShard> shards{ catalog_.shards().begin(), catalog_.shards().end() };
+  for (size_t i = 0; i < changed.size(); ++i) {
+    shards[changed[i]] = std::move((*reopened)[i]);
   }
 
-  const auto& textures{ asset.at(TexturesParameter).as_array() };
-
-  MaterialDescriptor material_descriptor{};
+  auto catalog = co_await AssetCatalog::build(
+      std::move(shards), strands_.getWorkExecutor(), std::thread::hardware_concurrency());
+  if (!catalog) {
+    co_return std::unexpected(catalog.error());
+  }
 
-  for (const auto& texture_object : textures) {
-    if (!texture_object.is_object()) {
-      return std::unexpected(Error::SchemaError);
-    }
-    const auto& texture = texture_object.as_object();
+  auto diff = catalog->diff(catalog_, changed);
+  if (!diff) {
+    co_return std::unexpected(diff.error());
+  }
 
-    if (auto error{ validateRequiredParameters(texture, MaterialTextureRequiredParameters) };
-        error != Error::OK) {
-      return std::unexpected(error);
-    }
+  auto remap = catalog->remap(catalog_, *diff);
+  LOG_INFO(
+      "asset catalog reload staged; shards: {}, added: {}, removed: {}, changed: {}",
+      changed.size(), diff->added_.size(), diff->removed_.size(), diff->changed_.size());
 
-    auto& material_texture_descriptor{ material_descriptor.textures_.emplace_back() };
-    material_texture_descriptor.name_ = texture.at(NameParameter).as_string();
-    material_texture_descriptor.texture_asset_ = texture.at(AssetParameter).as_int64();
+  co_return AssetReload{ .catalog_ = std::move(*catalog),
+                         .diff_ = std::move(*diff),
+                         .remap_ = std::move(remap) };
+}
 
-    auto sampler_expect{ samplerTypeFromString(texture.at(SamplerParameter).as_string()) };
-    if (!sampler_expect) {
-      return std::unexpected(sampler_expect.error());
-    }
+void AssetManager::applyReload(AssetReload reload) {
+  retired_catalogs_.push_back(std::move(catalog_));
+  catalog_ = std::move(reload.catalog_);
+}
 
-    material_texture_descriptor.sampler_ = sampler_expect.value();
+auto AssetManager::shardFiles() const -> std::vector<std::string> {
+  std::vector<std::string> files;
+  for (const auto& shard : shards_) {
+    files.push_back(shard + AssetShard::JsonExtension);
+    files.push_back(shard + AssetShard::CompiledExtension);
   }
-
-  return material_descriptor;
+  return files;
 }
 
-auto AssetManager::parseTextureDescriptor(const boost::json::object& asset)
-    -> std::expected<TextureDescriptor, std::error_code> {
-  if (auto error{ validateRequiredParameters(asset, TextureRequiredParameters) };
-      error != Error::OK) {
-    return std::unexpected(error);
-  }
+auto AssetManager::getAsset(AssetId asset_id) const
+    -> std::expected<AssetDescriptor, std::error_code> {
+  return catalog_.find(asset_id);
+}
 
-  return TextureDescriptor{
-    .image_path_ = std::string(asset.at(ImageParameter).as_string()),
-    .color_space_ = std::string(asset.at(ColourSpaceParameter).as_string()),
-    .mipmaps_ = asset.at(MipmapsParameter).as_bool(),
-  };
+auto AssetManager::getDependencies(AssetId asset_id) const
+    -> std::expected<std::span<const AssetId>, std::error_code> {
+  return catalog_.dependencies(asset_id);
 }
 
-auto AssetManager::parseMeshDescriptor(const boost::json::object& asset)
-    -> std::expected<MeshDescriptor, std::error_code> {
-  if (auto error{ validateRequiredParameters(asset, MeshRequiredParameters) }; error != Error::OK) {
-    return std::unexpected(error);
-  }
+/*
+ *  Private
+ */
 
-  const auto& submeshes{ asset.at(SubmeshesParameter).as_array() };
+auto AssetManager::openShards(std::span<const size_t> shards)
+    -> boost::asio::awaitable<std::expected<std::vector<AssetShard>, std::error_code>> {
+  std::vector<std::expected<AssetShard, std::error_code>> opened;
+  opened.reserve(shards.size());
+  for (size_t i = 0; i < shards.size(); ++i) {
+    opened.emplace_back(std::unexpected(Error::InternalError));
+  }
 
-  MeshDescriptor mesh_descriptor{ .source_ = std::string(asset.at(SourceParameter).as_string()) };
-  for (const auto& submesh_object : submeshes) {
-    if (!submesh_object.is_object()) {
-      return std::unexpected(Error::SchemaError);
-    }
-    const auto& submesh = submesh_object.as_object();
+  // reading and indexing a shard is independent of every other shard
+  AsyncLatch latch{ shards.size() };
+  for (size_t i = 0; i < shards.size(); ++i) {
+    boost::asio::post(strands_.getWorkExecutor(), [this, &opened, &latch, &shards, i] {
+      opened[i] = AssetShard::open(shards_[shards[i]], mode_);
+      latch.countDown();
+    });
+  }
+  co_await latch.wait();
 
-    if (auto error{ validateRequiredParameters(submesh, SubmeshRequiredParameters) };
-        error != Error::OK) {
-      return std::unexpected(error);
+  std::vector<AssetShard> result;
+  result.reserve(opened.size());
+  for (auto& shard : opened) {
+    if (!shard) {
+      co_return std::unexpected(shard.error());
     }
-
-    ;
-    mesh_descriptor.submeshes_.emplace_back(
-        SubmeshDescriptor{
-            .name_ = std::string(submesh.at(NameParameter).as_string()),
-            .first_index_ = submesh.at(FirstIndexParameter).as_int64(),
-            .index_count_ = submesh.at(IndexCountParameter).as_int64(),
-            .material_asset_ = submesh.at(MaterialParameter).as_int64(),
-
-        });
+    result.push_back(std::move(*shard));
   }
-
-  return mesh_descriptor;
+  co_return result;
 }
 
-}  // namespace gravity
\ No newline at end of file
+}  // namespace gravity
@@ -1,51 +1,89 @@
 #pragma once
 
-#include "common/asset_types.hpp"
+#include "source/common/scheduler/scheduler.hpp"
+#include "source/rendering/common/asset_catalog.hpp"
 #include "source/rendering/common/asset_types.hpp"
 
 #include "boost/asio/awaitable.hpp"
-#include "boost/json/object.hpp"
 
 #include <cstdint>
 #include <expected>
+#include <optional>
 #include <span>
+#include <string>
 #include <system_error>
-#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace gravity {
 
-enum class ExpectedTypes : uint8_t { String, Integer, Boolean, List };
-
-struct RequiredParameters {
-  const char* name_;
-  ExpectedTypes expected_type_;
+// A catalog rebuilt from changed shards, waiting to replace the live one.
+struct AssetReload {
+  AssetCatalog catalog_;
+  AssetCatalogDiff diff_;
+  AssetIndexRemap remap_;
 };
 
 class AssetManager {
  public:
+  enum class StrandLanes : uint8_t { Main, _Count };
+  using StrandGroup = StrandGroup<AssetManager>;
+
+  static constexpr const char* DefaultShard{ "resources/assetsdb" };
+
+  // Shards are opened concurrently on the scheduler workers and merged into one id index; an id
+  // present in more than one shard fails initialize().
+  explicit AssetManager(
+      StrandGroup strands, std::vector<std::string> shards = { DefaultShard },
+      AssetDatabaseMode mode = AssetDatabaseMode::Compiled)
+      : strands_{ std::move(strands) }, shards_{ std::move(shards) }, mode_{ mode } {}
+
   auto initialize() -> boost::asio::awaitable<std::error_code>;
 
-  [[nodiscard]] auto getAsset(AssetId asset_id) const
-      -> std::expected<const AssetDescriptor*, std::error_code>;
+  // Reopens the shards whose catalog files are among changed_paths and builds a catalog from them
+  // and the shards that did not change, leaving the live catalog untouched so the caller can
+  // retire whatever depends on the old entries first. Holds no value when none of the paths is a
+  // shard file. A shard that fails to open or a catalog that fails to build is reported, the
+  // live catalog stays in place.
+  auto stageReload(std::span<const std::string> changed_paths)
+      -> boost::asio::awaitable<std::expected<std::optional<AssetReload>, std::error_code>>;
 
- private:
-  std::unordered_map<AssetId, AssetDescriptor> assets_;
+  // Makes a staged catalog the live one. Descriptors handed out by the previous catalog stay valid
+  // until releaseRetiredCatalogs().
+  void applyReload(AssetReload reload);
 
-  static auto validateRequiredParameters(
-      const boost::json::object& object, std::span<const RequiredParameters> parameters)
-      -> std::error_code;
+  // Frees the catalogs applyReload() replaced. The caller makes sure no descriptor taken from them
+  // is still in use.
+  void releaseRetiredCatalogs() { retired_catalogs_.clear(); }
 
-  static auto parseShaderDescriptor(const boost::json::object& asset)
-      -> std::expected<ShaderDescriptor, std::error_code>;
+  // Both possible files of every shard, whether they exist or not.
+  [[nodiscard]] auto shardFiles() const -> std::vector<std::string>;
 
-  static auto parseMaterialDescriptor(const boost::json::object& asset)
-      -> std::expected<MaterialDescriptor, std::error_code>;
+  // Descriptors are views into the database, valid until a reload replaces it and the replaced
+  // catalog is released.
+  [[nodiscard]] auto getAsset(AssetId asset_id) const
+      -> std::expected<AssetDescriptor, std::error_code>;
+
+  // Bound of AssetDescriptor::index_ for a type, fixed once initialize() has completed.
+  [[nodiscard]] auto getAssetCount(AssetType type) const -> size_t { return catalog_.count(type); }
+
+  // Assets this one needs loaded first, sorted by id. Every id is present in the catalog and the
+  // edges form a DAG, initialize() rejects catalogs where they don't.
+  [[nodiscard]] auto getDependencies(AssetId asset_id) const
+      -> std::expected<std::span<const AssetId>, std::error_code>;
+
+ private:
+  StrandGroup strands_;
+  std::vector<std::string> shards_;
+  AssetDatabaseMode mode_;
+  AssetCatalog catalog_;
 
-  static auto parseTextureDescriptor(const boost::json::object& asset)
-      -> std::expected<TextureDescriptor, std::error_code>;
+  // replaced catalogs, kept until releaseRetiredCatalogs() so descriptors taken from them stay
+  // valid
+  std::vector<AssetCatalog> retired_catalogs_;
 
-  static auto parseMeshDescriptor(const boost::json::object& asset)
-      -> std::expected<MeshDescriptor, std::error_code>;
+  auto openShards(std::span<const size_t> shards)
+      -> boost::asio::awaitable<std::expected<std::vector<AssetShard>, std::error_code>>;
 };
 
-}  // namespace gravity
\ No newline at end of file
+}  // namespace gravity
@@ -0,0 +1,464 @@
+#include "asset_catalog.hpp"
+
+#include "source/common/error.hpp"
+#include "source/common/event/async_latch.hpp"
+#include "source/common/hash.hpp"
+#include "source/common/logging/logger.hpp"
+
+#include "boost/asio/post.hpp"
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <variant>
+
+#undef GRAVITY_MODULE_NAME
+#define GRAVITY_MODULE_NAME "asset_database"
+
+namespace gravity {
+
+namespace {
+
+auto openCompiled(const std::string& compiled_path, const std::string& json_path)
+    -> std::expected<AssetDatabase, std::error_code> {
+  // a catalog edited after the last compile wins, serving stale descriptors is worse than parsing
+  std::error_code error;
+  auto json_time = std::filesystem::last_write_time(json_path, error);
+  if (!error) {
+    auto compiled_time = std::filesystem::last_write_time(compiled_path, error);
+    if (!error && compiled_time < json_time) {
+      return std::unexpected(Error::FailedPreconditionError);
+    }
+  }
+
+  return AssetDatabase::open(compiled_path);
+}
+
+auto lowerBound(const AssetShard& shard, AssetId asset_id) -> size_t {
+  size_t low = 0;
+  size_t high = shard.size();
+  while (low < high) {
+    auto middle = low + ((high - low) / 2);
+    if (shard.idAt(middle) < asset_id) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+// Every shard contributes evenly spaced samples, so the ranges stay balanced when shards differ
+// in size or cover different parts of the id space.
+auto pickSplitters(std::span<const AssetShard> shards, size_t range_count) -> std::vector<AssetId> {
+  std::vector<AssetId> samples;
+  for (const auto& shard : shards) {
+    for (size_t sample = 0; sample < range_count && shard.size() > 0; ++sample) {
+      samples.push_back(shard.idAt(sample * shard.size() / range_count));
+    }
+  }
+  std::ranges::sort(samples);
+
+  std::vector<AssetId> splitters;
+  for (size_t range = 1; range < range_count; ++range) {
+    splitters.push_back(samples[range * samples.size() / range_count]);
+  }
+
+  auto duplicates = std::ranges::unique(splitters);
+  splitters.erase(duplicates.begin(), duplicates.end());
+  return splitters;
+}
+
+// [begin, end) of every shard that falls into one slice of the id space
+struct MergeRange {
+  std::vector<std::pair<size_t, size_t>> spans_;
+  size_t output_ = 0;
+  size_t size_ = 0;
+  std::optional<AssetId> duplicate_;
+  // (dependent, dependency) of the first edge that does not resolve
+  std::optional<std::pair<AssetId, AssetId>> invalid_edge_;
+  // assets of each type in the range, then the first dense index the range hands out
+  std::array<size_t, AssetTypeCount> type_counts_{};
+};
+
+// Runs task over every range, inline when there is only one.
+template <typename Task>
+auto forEachRange(
+    const boost::asio::any_io_executor& executor, std::span<MergeRange> ranges, const Task& task)
+    -> boost::asio::awaitable<void> {
+  if (ranges.size() == 1) {
+    task(ranges.front());
+    co_return;
+  }
+
+  AsyncLatch latch{ ranges.size() };
+  for (auto& range : ranges) {
+    boost::asio::post(executor, [&task, &range, &latch] {
+      task(range);
+      latch.countDown();
+    });
+  }
+  co_await latch.wait();
+}
+
+auto dependencyType(AssetType type) -> std::optional<AssetType> {
+  switch (type) {
+    case AssetType::Material:
+      return AssetType::Texture;
+    case AssetType::Mesh:
+      return AssetType::Material;
+    default:
+      return std::nullopt;
+  }
+}
+
+// Hash of what an entry describes rather than of how its shard stores it, so an entry hashes the
+// same whether it was read from a compiled or a JSON shard.
+auto contentHash(const AssetDescriptor& descriptor) -> HashType {
+  Hasher hasher;
+  auto add = [&hasher](const auto& value) {
+    hasher.update(std::as_bytes(std::span{ &value, 1 }));
+  };
+  auto add_string = [&hasher, &add](std::string_view text) {
+    add(text.size());
+    hasher.update(std::as_bytes(std::span{ text.data(), text.size() }));
+  };
+
+  add(descriptor.type);
+  if (const auto* shader = std::get_if<ShaderDescriptor>(&descriptor.data_); shader) {
+    for (uint32_t bit = 1; bit <= static_cast<uint32_t>(ShaderStage::TesselationEvaluation);
+         bit <<= 1U) {
+      if (auto stage = shader->find(static_cast<ShaderStage>(bit)); stage) {
+        add(bit);
+        add_string(stage->spirv_path_);
+        add_string(stage->meta_path_);
+      }
+    }
+  } else if (const auto* texture = std::get_if<TextureDescriptor>(&descriptor.data_); texture) {
+    add_string(texture->image_path_);
+    add_string(texture->color_space_);
+    add(texture->mipmaps_);
+  } else if (const auto* material = std::get_if<MaterialDescriptor>(&descriptor.data_); material) {
+    for (size_t index = 0; index < material->textureCount(); ++index) {
+      auto slot = material->texture(index);
+      add_string(slot.name_);
+      add(slot.texture_asset_);
+      add(slot.sampler_);
+    }
+  } else if (const auto* mesh = std::get_if<MeshDescriptor>(&descriptor.data_); mesh) {
+    add_string(mesh->source());
+    for (size_t index = 0; index < mesh->submeshCount(); ++index) {
+      auto submesh = mesh->submesh(index);
+      add_string(submesh.name_);
+      add(submesh.first_index_);
+      add(submesh.index_count_);
+      add(submesh.material_asset_);
+    }
+  }
+  return hasher.digest();
+}
+
+}  // namespace
+
+auto AssetShard::open(const std::string& name, AssetDatabaseMode mode)
+    -> std::expected<AssetShard, std::error_code> {
+  auto json_path = name + JsonExtension;
+
+  if (mode == AssetDatabaseMode::Compiled) {
+    auto compiled_path = name + CompiledExtension;
+    auto database = openCompiled(compiled_path, json_path);
+    if (database) {
+      LOG_INFO(
+          "compiled asset database loaded; path: {}, assets: {}", compiled_path, database->size());
+      return AssetShard{ std::move(*database) };
+    }
+
+    LOG_WARN(
+        "compiled asset database unavailable, falling back to json; path: {}, error: {}",
+        compiled_path, database.error().message());
+  }
+
+  auto catalog = JsonAssetCatalog::open(json_path);
+  if (!catalog) {
+    LOG_ERROR(
+        "asset manager failed to load assets db; path: {}, error: {}", json_path,
+        catalog.error().message());
+    return std::unexpected(catalog.error());
+  }
+
+  LOG_INFO("json asset database indexed; path: {}, assets: {}", json_path, (*catalog)->size());
+  return AssetShard{ std::move(*catalog) };
+}
+
+auto AssetCatalog::build(
+    std::vector<AssetShard> shards, boost::asio::any_io_executor executor, size_t parallelism)
+    -> boost::asio::awaitable<std::expected<AssetCatalog, std::error_code>> {
+  AssetCatalog catalog{};
+  catalog.shards_ = std::move(shards);
+  const auto& catalog_shards = catalog.shards_;
+
+  if (catalog_shards.size() > std::numeric_limits<uint32_t>::max()) {
+    co_return std::unexpected(Error::InvalidArgumentError);
+  }
+
+  size_t total = 0;
+  for (const auto& shard : catalog_shards) {
+    total += shard.size();
+  }
+  catalog.entries_.resize(total);
+
+  auto range_count = std::clamp<size_t>(total / MinMergeRange, 1, std::max<size_t>(parallelism, 1));
+  auto splitters =
+      range_count > 1 ? pickSplitters(catalog_shards, range_count) : std::vector<AssetId>{};
+
+  std::vector<MergeRange> ranges(splitters.size() + 1);
+  size_t output = 0;
+  for (size_t range = 0; range < ranges.size(); ++range) {
+    auto& merge_range = ranges[range];
+    merge_range.output_ = output;
+
+    for (const auto& shard : catalog_shards) {
+      auto begin = range == 0 ? 0 : lowerBound(shard, splitters[range - 1]);
+      auto end = range == splitters.size() ? shard.size() : lowerBound(shard, splitters[range]);
+      merge_range.spans_.emplace_back(begin, end);
+      merge_range.size_ += end - begin;
+    }
+    output += merge_range.size_;
+  }
+
+  auto merge = [&catalog](MergeRange& range) {
+    std::span<Entry> entries{ catalog.entries_.data() + range.output_, range.size_ };
+    auto cursors = range.spans_;
+
+    for (auto& entry : entries) {
+      // shards are few, a linear pick of the smallest head beats a heap
+      size_t best = 0;
+      auto best_id = std::numeric_limits<AssetId>::max();
+      bool found = false;
+      for (size_t shard = 0; shard < cursors.size(); ++shard) {
+        auto [position, end] = cursors[shard];
+        if (position == end) {
+          continue;
+        }
+        auto asset_id = catalog.shards_[shard].idAt(position);
+        if (!found || asset_id < best_id) {
+          best = shard;
+          best_id = asset_id;
+          found = true;
+        }
+      }
+
+      if (&entry != entries.data() && (&entry - 1)->id_ == best_id && !range.duplicate_) {
+        range.duplicate_ = best_id;
+      }
+      auto position = cursors[best].first++;
+      entry = Entry{ .id_ = best_id,
+                     .shard_ = static_cast<uint32_t>(best),
+                     .position_ = static_cast<uint32_t>(position),
+                     .index_ = 0,
+                     .type_ = catalog.shards_[best].typeAt(position) };
+    }
+  };
+
+  co_await forEachRange(executor, ranges, merge);
+
+  // ranges are disjoint in id, so a duplicate pair always lands inside a single range
+  for (const auto& range : ranges) {
+    if (range.duplicate_) {
+      LOG_ERROR("duplicate asset id {}", *range.duplicate_);
+      co_return std::unexpected(Error::SchemaError);
+    }
+  }
+
+  auto check_edges = [&catalog](MergeRange& range) {
+    std::span<const Entry> entries{ catalog.entries_.data() + range.output_, range.size_ };
+    for (const auto& entry : entries) {
+      ++range.type_counts_[static_cast<size_t>(entry.type_)];
+
+      auto expected_type = dependencyType(entry.type_);
+      for (auto dependency_id : catalog.shards_[entry.shard_].dependenciesAt(entry.position_)) {
+        const auto* dependency = catalog.lookup(dependency_id);
+        if (dependency == nullptr || !expected_type || dependency->type_ != *expected_type) {
+          range.invalid_edge_ = std::pair{ entry.id_, dependency_id };
+          return;
+        }
+      }
+    }
+  };
+
+  co_await forEachRange(executor, ranges, check_edges);
+
+  for (const auto& range : ranges) {
+    if (range.invalid_edge_) {
+      LOG_ERROR(
+          "asset depends on a missing or mismatched asset; id: {}, dependency: {}",
+          range.invalid_edge_->first, range.invalid_edge_->second);
+      co_return std::unexpected(Error::SchemaError);
+    }
+  }
+
+  for (auto& range : ranges) {
+    for (size_t type = 0; type < AssetTypeCount; ++type) {
+      auto first = catalog.type_counts_[type];
+      catalog.type_counts_[type] += range.type_counts_[type];
+      range.type_counts_[type] = first;
+    }
+  }
+
+  auto number = [&catalog](MergeRange& range) {
+    auto next = range.type_counts_;
+    for (auto& entry : std::span{ catalog.entries_.data() + range.output_, range.size_ }) {
+      entry.index_ = static_cast<uint32_t>(next[static_cast<size_t>(entry.type_)]++);
+    }
+  };
+
+  co_await forEachRange(executor, ranges, number);
+
+  LOG_DEBUG(
+      "asset catalog merged; shards: {}, assets: {}, ranges: {}", catalog_shards.size(), total,
+      ranges.size());
+  co_return catalog;
+}
+
+auto AssetCatalog::find(AssetId asset_id) const
+    -> std::expected<AssetDescriptor, std::error_code> {
+  const auto* entry = lookup(asset_id);
+  if (entry == nullptr) {
+    return std::unexpected(Error::NotFoundError);
+  }
+  auto descriptor = shards_[entry->shard_].decodeAt(entry->position_);
+  if (descriptor) {
+    descriptor->index_ = entry->index_;
+  }
+  return descriptor;
+}
+
+auto AssetCatalog::dependencies(AssetId asset_id) const
+    -> std::expected<std::span<const AssetId>, std::error_code> {
+  const auto* entry = lookup(asset_id);
+  if (entry == nullptr) {
+    return std::unexpected(Error::NotFoundError);
+  }
+  return shards_[entry->shard_].dependenciesAt(entry->position_);
+}
+
+auto AssetCatalog::diff(const AssetCatalog& previous, std::span<const size_t> shards) const
+    -> std::expected<AssetCatalogDiff, std::error_code> {
+  if (previous.shards_.size() != shards_.size()) {
+    return std::unexpected(Error::InvalidArgumentError);
+  }
+
+  AssetCatalogDiff diff;
+  for (auto shard_index : shards) {
+    const auto& before = previous.shards_[shard_index];
+    const auto& after = shards_[shard_index];
+
+    // both versions are sorted by id, one merge pass pairs them up
+    size_t old_position = 0;
+    size_t new_position = 0;
+    while (old_position < before.size() || new_position < after.size()) {
+      if (new_position == after.size() ||
+          (old_position < before.size() &&
+           before.idAt(old_position) < after.idAt(new_position))) {
+        diff.removed_.push_back(before.idAt(old_position++));
+        continue;
+      }
+      if (old_position == before.size() || after.idAt(new_position) < before.idAt(old_position)) {
+        diff.added_.push_back(after.idAt(new_position++));
+        continue;
+      }
+
+      auto asset_id = after.idAt(new_position);
+      auto next = after.decodeAt(new_position++);
+      if (!next) {
+        LOG_ERROR("changed asset failed to decode; id: {}", asset_id);
+        return std::unexpected(next.error());
+      }
+      auto last = before.decodeAt(old_position++);
+      if (!last || contentHash(*last) != contentHash(*next)) {
+        diff.changed_.push_back(asset_id);
+      }
+    }
+  }
+
+  std::ranges::sort(diff.added_);
+  std::ranges::sort(diff.removed_);
+
+  // an asset that moved between two of the shards is neither new nor gone
+  std::vector<AssetId> moved;
+  std::ranges::set_intersection(diff.added_, diff.removed_, std::back_inserter(moved));
+  if (!moved.empty()) {
+    auto keep = [&moved](std::vector<AssetId>& ids) {
+      std::vector<AssetId> kept;
+      std::ranges::set_difference(ids, moved, std::back_inserter(kept));
+      ids = std::move(kept);
+    };
+    keep(diff.added_);
+    keep(diff.removed_);
+    diff.changed_.insert(diff.changed_.end(), moved.begin(), moved.end());
+  }
+  std::ranges::sort(diff.changed_);
+
+  return diff;
+}
+
+auto AssetCatalog::remap(const AssetCatalog& previous, const AssetCatalogDiff& diff) const
+    -> AssetIndexRemap {
+  AssetIndexRemap remap;
+
+  // a type keeps its numbering unless an id of that type came or went
+  std::array<bool, AssetTypeCount> renumbered{};
+  for (auto asset_id : diff.added_) {
+    renumbered[static_cast<size_t>(lookup(asset_id)->type_)] = true;
+  }
+  for (auto asset_id : diff.removed_) {
+    renumbered[static_cast<size_t>(previous.lookup(asset_id)->type_)] = true;
+  }
+  // a changed asset may have changed its type as well
+  for (auto asset_id : diff.changed_) {
+    auto old_type = previous.lookup(asset_id)->type_;
+    auto new_type = lookup(asset_id)->type_;
+    if (old_type != new_type) {
+      renumbered[static_cast<size_t>(old_type)] = true;
+      renumbered[static_cast<size_t>(new_type)] = true;
+    }
+  }
+
+  for (size_t type = 0; type < AssetTypeCount; ++type) {
+    if (renumbered[type]) {
+      remap.indices_[type].assign(previous.type_counts_[type], AssetIndexRemap::Unmapped);
+    }
+  }
+
+  // both entry lists are in id order, walk them together
+  auto next = entries_.begin();
+  for (const auto& entry : previous.entries_) {
+    auto& indices = remap.indices_[static_cast<size_t>(entry.type_)];
+    if (indices.empty()) {
+      continue;
+    }
+
+    next = std::ranges::lower_bound(next, entries_.end(), entry.id_, {}, &Entry::id_);
+    if (next != entries_.end() && next->id_ == entry.id_ && next->type_ == entry.type_) {
+      indices[entry.index_] = next->index_;
+    }
+  }
+
+  return remap;
+}
+
+auto AssetCatalog::lookup(AssetId asset_id) const -> const Entry* {
+  auto entry = std::ranges::lower_bound(entries_, asset_id, {}, &Entry::id_);
+  if (entry == entries_.end() || entry->id_ != asset_id) {
+    return nullptr;
+  }
+  return &*entry;
+}
+
+}  // namespace gravity
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "source/rendering/common/asset_database.hpp"
+#include "source/rendering/common/asset_types.hpp"
+#include "source/rendering/common/json_asset_catalog.hpp"
+
+#include "boost/asio/any_io_executor.hpp"
+#include "boost/asio/awaitable.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace gravity {
+
+enum class AssetDatabaseMode : uint8_t {
+  // map the image produced by compile_asset_database, falls back to Json when it is missing or
+  // older than the catalog
+  Compiled,
+  // index the JSON catalog on start, entries are parsed on their first lookup
+  Json,
+};
+
+// One file of the asset catalog, typically a content package. A shard named "path/name" is read
+// from "path/name.bin" when compiled and from "path/name.json" otherwise.
+//
+// Copies share the opened file, a catalog rebuilt after some shards changed keeps the others.
+class AssetShard {
+ public:
+  static constexpr const char* CompiledExtension{ ".bin" };
+  static constexpr const char* JsonExtension{ ".json" };
+
+  static auto open(const std::string& name, AssetDatabaseMode mode)
+      -> std::expected<AssetShard, std::error_code>;
+
+  explicit AssetShard(AssetDatabase database)
+      : database_{ std::make_shared<const AssetDatabase>(std::move(database)) } {}
+  explicit AssetShard(std::unique_ptr<JsonAssetCatalog> catalog) : catalog_{ std::move(catalog) } {}
+
+  [[nodiscard]] auto size() const -> size_t {
+    return catalog_ ? catalog_->size() : database_->size();
+  }
+
+  [[nodiscard]] auto idAt(size_t position) const -> AssetId {
+    return catalog_ ? catalog_->idAt(position) : database_->idAt(position);
+  }
+
+  [[nodiscard]] auto typeAt(size_t position) const -> AssetType {
+    return catalog_ ? catalog_->typeAt(position) : database_->typeAt(position);
+  }
+
+  [[nodiscard]] auto dependenciesAt(size_t position) const -> std::span<const AssetId> {
+    return catalog_ ? catalog_->dependenciesAt(position) : database_->dependenciesAt(position);
+  }
+
+  [[nodiscard]] auto decodeAt(size_t position) const
+      -> std::expected<AssetDescriptor, std::error_code> {
+    return catalog_ ? catalog_->decodeAt(position) : database_->decodeAt(position);
+  }
+
+ private:
+  std::shared_ptr<const AssetDatabase> database_;
+  std::shared_ptr<const JsonAssetCatalog> catalog_;
+};
+
+// Ids whose entries differ between two versions of a catalog, each list sorted.
+struct AssetCatalogDiff {
+  std::vector<AssetId> added_;
+  std::vector<AssetId> removed_;
+  std::vector<AssetId> changed_;
+
+  [[nodiscard]] auto empty() const -> bool {
+    return added_.empty() && removed_.empty() && changed_.empty();
+  }
+};
+
+// Per type, the new AssetDescriptor::index_ of every old one, or Unmapped when the asset is gone.
+// An empty table means the numbering of that type did not change.
+struct AssetIndexRemap {
+  static constexpr uint32_t Unmapped{ std::numeric_limits<uint32_t>::max() };
+
+  std::array<std::vector<uint32_t>, AssetTypeCount> indices_;
+};
+
+// Single id index over any number of shards. Each shard is already sorted by id, build() merges
+// them on the given executor: the id space is cut into ranges at sampled splitters, every range
+// is merged from all shards into its own slice of the index by a separate task, and duplicate ids,
+// which can only meet inside one range, are collected per range and reduced at the end.
+//
+// The same ranges then check the dependency edges against the merged index: every dependency
+// must exist and have the type its dependent refers to (materials use textures, meshes use
+// materials). Edges only point one step down that chain, so a built catalog is always acyclic.
+// Finally every asset is numbered densely within its type, in id order, so per-type state can
+// live in flat arrays instead of maps keyed by id.
+class AssetCatalog {
+ public:
+  // below this many assets per task the merge runs inline on the calling coroutine
+  static constexpr size_t MinMergeRange{ 32 * 1024 };
+
+  static auto build(
+      std::vector<AssetShard> shards, boost::asio::any_io_executor executor, size_t parallelism)
+      -> boost::asio::awaitable<std::expected<AssetCatalog, std::error_code>>;
+
+  [[nodiscard]] auto find(AssetId asset_id) const
+      -> std::expected<AssetDescriptor, std::error_code>;
+
+  // Direct dependencies of an asset, sorted by id. All of them are present in the catalog.
+  [[nodiscard]] auto dependencies(AssetId asset_id) const
+      -> std::expected<std::span<const AssetId>, std::error_code>;
+
+  [[nodiscard]] auto size() const -> size_t { return entries_.size(); }
+  [[nodiscard]] auto shardCount() const -> size_t { return shards_.size(); }
+  [[nodiscard]] auto shards() const -> std::span<const AssetShard> { return shards_; }
+
+  // Compares the given shards against the same shards of previous, the others are assumed to be
+  // unchanged. Both catalogs must have the same shard count. Entries present in both versions are
+  // decoded and compared by content, so the cost follows the size of the compared shards; an entry
+  // that fails to decode in this catalog fails the diff.
+  [[nodiscard]] auto diff(const AssetCatalog& previous, std::span<const size_t> shards) const
+      -> std::expected<AssetCatalogDiff, std::error_code>;
+
+  // Maps the dense indices of previous onto this catalog's, only needed for the types whose set
+  // of ids changed.
+  [[nodiscard]] auto remap(const AssetCatalog& previous, const AssetCatalogDiff& diff) const
+      -> AssetIndexRemap;
+
+  // Number of assets of a type, the bound of AssetDescriptor::index_.
+  [[nodiscard]] auto count(AssetType type) const -> size_t {
+    return type_counts_[static_cast<size_t>(type)];
+  }
+
+ private:
+  struct Entry {
+    AssetId id_;
+    uint32_t shard_;
+    uint32_t position_;
+    uint32_t index_;
+    AssetType type_;
+  };
+
+  std::vector<AssetShard> shards_;
+  std::vector<Entry> entries_;
+  std::array<size_t, AssetTypeCount> type_counts_{};
+
+  auto lookup(AssetId asset_id) const -> const Entry*;
+};
+
+}  // namespace gravity
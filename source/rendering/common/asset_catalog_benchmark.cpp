@@ -0,0 +1,193 @@
+#include "source/rendering/common/asset_catalog.hpp"
+
+#include "source/common/error.hpp"
+#include "source/common/event/async_latch.hpp"
+#include "source/common/scheduler/scheduler.hpp"
+#include "source/rendering/common/asset_database.hpp"
+#include "source/rendering/common/asset_database_compiler.hpp"
+#include "source/rendering/common/synthetic_catalog.hpp"
+
+#include "benchmark/benchmark.h"
+#include "boost/asio/co_spawn.hpp"
+#include "boost/asio/detached.hpp"
+#include "boost/asio/post.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <string>
+#include <vector>
+
+// Catalog startup on AssetCount synthetic assets spread over shards, by scheduler worker count.
+// Ids are dealt to the shards round robin, so every shard covers the whole id range and each
+// merge range reads from all of them.
+//
+//   BM_Build         AssetCatalog::build over shards already bound in memory: merge, duplicate
+//                    reduction, edge checks and type numbering
+//   BM_OpenAndBuild  what AssetManager::initialize does in Json mode: every shard file read and
+//                    indexed on the workers, then the build
+//
+// BM_Build takes the shard count and the workers, BM_OpenAndBuild the workers over
+// OpenShardCount shards. build() gets one task per worker.
+
+namespace gravity {
+
+namespace {
+
+constexpr size_t AssetCount{ 1'000'000 };
+constexpr size_t OpenShardCount{ 64 };
+
+struct BenchmarkSystem {
+  enum class StrandLanes : uint8_t { Main, _Count };
+};
+
+auto shardIds(size_t shard, size_t shard_count) -> std::vector<AssetId> {
+  std::vector<AssetId> ids;
+  ids.reserve((AssetCount / shard_count) + 1);
+  for (auto id = static_cast<AssetId>(shard + 1); id <= static_cast<AssetId>(AssetCount);
+       id += static_cast<AssetId>(shard_count)) {
+    ids.push_back(id);
+  }
+  return ids;
+}
+
+// keeps only the latest shard count, a million compiled assets is a few hundred megabytes
+auto compiledShards(size_t shard_count) -> const std::vector<AssetShard>& {
+  static size_t cached_count{ 0 };
+  static std::vector<AssetShard> shards;
+
+  if (cached_count != shard_count) {
+    shards.clear();
+    for (size_t shard = 0; shard < shard_count; ++shard) {
+      auto image = compileAssetDatabase(syntheticCatalogJson(shardIds(shard, shard_count)));
+      if (!image) {
+        continue;
+      }
+      if (auto database = AssetDatabase::fromImage(std::move(*image)); database) {
+        shards.emplace_back(std::move(*database));
+      }
+    }
+    cached_count = shard_count;
+  }
+  return shards;
+}
+
+class ShardFiles {
+ public:
+  ShardFiles()
+      : directory_{ std::filesystem::temp_directory_path() / "gravity_asset_catalog_benchmark" } {
+    std::filesystem::create_directories(directory_);
+    for (size_t shard = 0; shard < OpenShardCount; ++shard) {
+      auto name = (directory_ / ("shard_" + std::to_string(shard))).string();
+      std::ofstream{ name + AssetShard::JsonExtension, std::ios::binary }
+          << syntheticCatalogJson(shardIds(shard, OpenShardCount));
+      names_.push_back(name);
+    }
+  }
+
+  ShardFiles(const ShardFiles&) = delete;
+  auto operator=(const ShardFiles&) -> ShardFiles& = delete;
+
+  ~ShardFiles() {
+    std::error_code error_code;
+    std::filesystem::remove_all(directory_, error_code);
+  }
+
+  [[nodiscard]] auto names() const -> const std::vector<std::string>& { return names_; }
+
+ private:
+  std::filesystem::path directory_;
+  std::vector<std::string> names_;
+};
+
+// runs the coroutine on the scheduler and blocks until it has finished
+auto runOn(boost::asio::any_io_executor executor,
+           boost::asio::awaitable<std::expected<AssetCatalog, std::error_code>> work)
+    -> std::expected<AssetCatalog, std::error_code> {
+  std::promise<std::expected<AssetCatalog, std::error_code>> done;
+  boost::asio::co_spawn(
+      executor,
+      [&]() -> boost::asio::awaitable<void> { done.set_value(co_await std::move(work)); },
+      boost::asio::detached);
+  return done.get_future().get();
+}
+
+auto openAndBuild(
+    const std::vector<std::string>& names, boost::asio::any_io_executor executor,
+    size_t parallelism) -> boost::asio::awaitable<std::expected<AssetCatalog, std::error_code>> {
+  std::vector<std::expected<AssetShard, std::error_code>> opened(
+      names.size(), std::unexpected(Error::InternalError));
+
+  AsyncLatch latch{ names.size() };
+  for (size_t i = 0; i < names.size(); ++i) {
+    boost::asio::post(executor, [&, i] {
+      opened[i] = AssetShard::open(names[i], AssetDatabaseMode::Json);
+      latch.countDown();
+    });
+  }
+  co_await latch.wait();
+
+  std::vector<AssetShard> shards;
+  for (auto& shard : opened) {
+    if (!shard) {
+      co_return std::unexpected(shard.error());
+    }
+    shards.push_back(std::move(*shard));
+  }
+  co_return co_await AssetCatalog::build(std::move(shards), executor, parallelism);
+}
+
+void BM_Build(benchmark::State& state) {
+  const auto& shards = compiledShards(static_cast<size_t>(state.range(0)));
+  auto workers = static_cast<size_t>(state.range(1));
+
+  Scheduler scheduler{ workers };
+  auto executor = scheduler.makeStrands<BenchmarkSystem>().getWorkExecutor();
+
+  for (auto _ : state) {
+    auto catalog = runOn(executor, AssetCatalog::build(shards, executor, workers));
+    if (!catalog || catalog->size() != AssetCount) {
+      state.SkipWithError("building the catalog failed");
+      return;
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * AssetCount));
+}
+
+void BM_OpenAndBuild(benchmark::State& state) {
+  static const ShardFiles files;
+  auto workers = static_cast<size_t>(state.range(0));
+
+  Scheduler scheduler{ workers };
+  auto executor = scheduler.makeStrands<BenchmarkSystem>().getWorkExecutor();
+
+  for (auto _ : state) {
+    auto catalog = runOn(executor, openAndBuild(files.names(), executor, workers));
+    if (!catalog || catalog->size() != AssetCount) {
+      state.SkipWithError("opening the catalog failed");
+      return;
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * AssetCount));
+}
+
+BENCHMARK(BM_Build)
+    ->ArgNames({ "shards", "workers" })
+    ->ArgsProduct({ { 1, 16, 64 }, { 1, 2, 4, 8, 16 } })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_OpenAndBuild)
+    ->ArgName("workers")
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->Arg(16)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace gravity
@@ -0,0 +1,184 @@
+#include "source/rendering/common/asset_catalog.hpp"
+
+#include "source/common/error.hpp"
+#include "source/rendering/common/json_asset_catalog.hpp"
+#include "source/rendering/common/synthetic_catalog.hpp"
+
+#include "boost/asio/co_spawn.hpp"
+#include "boost/asio/thread_pool.hpp"
+#include "boost/asio/use_future.hpp"
+#include "gtest/gtest.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace gravity {
+
+namespace {
+
+constexpr auto Unmapped = AssetIndexRemap::Unmapped;
+
+// the synthetic entry of id with its vertex stage pointed elsewhere
+auto editedShaderJson(AssetId id) -> std::string {
+  auto json = syntheticAssetJson(id);
+  auto stage = "shaders/" + std::to_string(id) + ".vert.spv";
+  return json.replace(json.find(stage), stage.size(), "shaders/edited.vert.spv");
+}
+
+auto textureJson(AssetId id) -> std::string {
+  return R"({"id":)" + std::to_string(id) +
+         R"(,"type":"texture","image":"textures/retyped.png","colour_space":"srgb",)"
+         R"("mipmaps":true})";
+}
+
+// synthetic entries by id plus hand-written JSON objects; the catalog sorts them by id
+struct ShardContents {
+  std::vector<AssetId> ids_;
+  std::vector<std::string> extra_ = {};
+};
+
+auto shardOf(const ShardContents& contents) -> AssetShard {
+  auto json = syntheticCatalogJson(contents.ids_);
+  for (const auto& entry : contents.extra_) {
+    json.insert(json.size() - 1, (json.size() > 2 ? "," : "") + entry);
+  }
+
+  auto catalog = JsonAssetCatalog::build(std::move(json));
+  EXPECT_TRUE(catalog) << catalog.error().message();
+  return AssetShard{ std::move(*catalog) };
+}
+
+auto ids(AssetId first, AssetId last) -> std::vector<AssetId> {
+  std::vector<AssetId> range;
+  for (auto id = first; id <= last; ++id) {
+    range.push_back(id);
+  }
+  return range;
+}
+
+class AssetCatalogDiffTest : public ::testing::Test {
+ protected:
+  auto build(const std::vector<ShardContents>& contents) -> AssetCatalog {
+    std::vector<AssetShard> shards;
+    for (const auto& shard : contents) {
+      shards.push_back(shardOf(shard));
+    }
+
+    auto catalog = boost::asio::co_spawn(
+                       pool_, AssetCatalog::build(std::move(shards), pool_.get_executor(), 2),
+                       boost::asio::use_future)
+                       .get();
+    EXPECT_TRUE(catalog) << catalog.error().message();
+    // throws on failure, which fails the test
+    return std::move(catalog).value();
+  }
+
+  boost::asio::thread_pool pool_{ 2 };
+};
+
+TEST_F(AssetCatalogDiffTest, UnchangedShardsDiffEmpty) {
+  auto previous = build({ { .ids_ = ids(1, 8) }, { .ids_ = ids(9, 12) } });
+  auto next = build({ { .ids_ = ids(1, 8) }, { .ids_ = ids(9, 12) } });
+
+  std::vector<size_t> shards{ 0, 1 };
+  auto diff = next.diff(previous, shards);
+  ASSERT_TRUE(diff);
+  EXPECT_TRUE(diff->empty());
+}
+
+TEST_F(AssetCatalogDiffTest, ReportsAddedRemovedAndChangedIds) {
+  auto previous = build({ { .ids_ = ids(1, 4) }, { .ids_ = { 5, 6 } } });
+  auto next = build({ { .ids_ = ids(1, 3), .extra_ = { editedShaderJson(4) } },
+                      { .ids_ = { 5, 8 } } });
+
+  std::vector<size_t> shards{ 0, 1 };
+  auto diff = next.diff(previous, shards);
+  ASSERT_TRUE(diff);
+  EXPECT_EQ(diff->added_, std::vector<AssetId>{ 8 });
+  EXPECT_EQ(diff->removed_, std::vector<AssetId>{ 6 });
+  EXPECT_EQ(diff->changed_, std::vector<AssetId>{ 4 });
+}
+
+TEST_F(AssetCatalogDiffTest, OnlyTheListedShardsAreCompared) {
+  auto previous = build({ { .ids_ = ids(1, 4) }, { .ids_ = { 5, 6 } } });
+  auto next = build({ { .ids_ = ids(1, 3), .extra_ = { editedShaderJson(4) } },
+                      { .ids_ = { 5, 6, 8 } } });
+
+  std::vector<size_t> shards{ 1 };
+  auto diff = next.diff(previous, shards);
+  ASSERT_TRUE(diff);
+  EXPECT_EQ(diff->added_, std::vector<AssetId>{ 8 });
+  EXPECT_TRUE(diff->removed_.empty());
+  EXPECT_TRUE(diff->changed_.empty());
+}
+
+TEST_F(AssetCatalogDiffTest, AssetMovedBetweenShardsIsChanged) {
+  auto previous = build({ { .ids_ = { 1, 2 } }, { .ids_ = { 5 } } });
+  auto next = build({ { .ids_ = { 1 } }, { .ids_ = { 2, 5 } } });
+
+  std::vector<size_t> shards{ 0, 1 };
+  auto diff = next.diff(previous, shards);
+  ASSERT_TRUE(diff);
+  EXPECT_TRUE(diff->added_.empty());
+  EXPECT_TRUE(diff->removed_.empty());
+  EXPECT_EQ(diff->changed_, std::vector<AssetId>{ 2 });
+}
+
+TEST_F(AssetCatalogDiffTest, ShardCountMismatchFails) {
+  auto previous = build({ { .ids_ = ids(1, 4) } });
+  auto next = build({ { .ids_ = ids(1, 4) }, { .ids_ = { 5 } } });
+
+  std::vector<size_t> shards{ 0 };
+  auto diff = next.diff(previous, shards);
+  ASSERT_FALSE(diff);
+  EXPECT_EQ(diff.error(), Error::InvalidArgumentError);
+}
+
+TEST_F(AssetCatalogDiffTest, RemapRenumbersOnlyTypesThatLostAssets) {
+  // drops texture 5, material 6 and mesh 7; the shaders stay as they were
+  auto previous = build({ { .ids_ = ids(1, 12) } });
+  auto kept = ids(1, 4);
+  kept.insert(kept.end(), { 8, 9, 10, 11, 12 });
+  auto next = build({ { .ids_ = kept } });
+
+  std::vector<size_t> shards{ 0 };
+  auto diff = next.diff(previous, shards);
+  ASSERT_TRUE(diff);
+  EXPECT_EQ(diff->removed_, (std::vector<AssetId>{ 5, 6, 7 }));
+
+  auto remap = next.remap(previous, *diff);
+  EXPECT_TRUE(remap.indices_[static_cast<size_t>(AssetType::Shader)].empty());
+  for (auto type : { AssetType::Texture, AssetType::Material, AssetType::Mesh }) {
+    EXPECT_EQ(
+        remap.indices_[static_cast<size_t>(type)], (std::vector<uint32_t>{ 0, Unmapped, 1 }));
+  }
+}
+
+TEST_F(AssetCatalogDiffTest, RemapFollowsAnAssetThatChangedType) {
+  // shader 4 becomes a texture and sorts between textures 1 and 5
+  auto previous = build({ { .ids_ = ids(1, 8) } });
+  auto next = build({ { .ids_ = { 1, 2, 3, 5, 6, 7, 8 }, .extra_ = { textureJson(4) } } });
+
+  std::vector<size_t> shards{ 0 };
+  auto diff = next.diff(previous, shards);
+  ASSERT_TRUE(diff);
+  EXPECT_EQ(diff->changed_, std::vector<AssetId>{ 4 });
+
+  auto remap = next.remap(previous, *diff);
+  EXPECT_EQ(
+      remap.indices_[static_cast<size_t>(AssetType::Shader)],
+      (std::vector<uint32_t>{ Unmapped, 0 }));
+  EXPECT_EQ(
+      remap.indices_[static_cast<size_t>(AssetType::Texture)], (std::vector<uint32_t>{ 0, 2 }));
+  EXPECT_TRUE(remap.indices_[static_cast<size_t>(AssetType::Material)].empty());
+  EXPECT_EQ(next.count(AssetType::Texture), 3U);
+}
+
+}  // namespace
+
+}  // namespace gravity
@@ -0,0 +1,166 @@
+#include "source/rendering/common/asset_catalog.hpp"
+
+#include "source/common/error.hpp"
+#include "source/rendering/common/json_asset_catalog.hpp"
+#include "source/rendering/common/synthetic_catalog.hpp"
+
+#include "boost/asio/co_spawn.hpp"
+#include "boost/asio/thread_pool.hpp"
+#include "boost/asio/use_future.hpp"
+#include "gtest/gtest.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace gravity {
+
+namespace {
+
+auto shardFromJson(std::string json) -> AssetShard {
+  auto catalog = JsonAssetCatalog::build(std::move(json));
+  EXPECT_TRUE(catalog) << catalog.error().message();
+  return AssetShard{ std::move(*catalog) };
+}
+
+auto shardOf(const std::vector<AssetId>& ids) -> AssetShard {
+  return shardFromJson(syntheticCatalogJson(ids));
+}
+
+// ids 1 to count dealt round robin, so every shard covers the whole id range
+auto dealtShards(size_t count, size_t shard_count) -> std::vector<AssetShard> {
+  std::vector<std::vector<AssetId>> ids(shard_count);
+  for (size_t id = 1; id <= count; ++id) {
+    ids[id % shard_count].push_back(static_cast<AssetId>(id));
+  }
+
+  std::vector<AssetShard> shards;
+  for (const auto& shard_ids : ids) {
+    shards.push_back(shardOf(shard_ids));
+  }
+  return shards;
+}
+
+class AssetCatalogTest : public ::testing::Test {
+ protected:
+  auto build(std::vector<AssetShard> shards, size_t parallelism)
+      -> std::expected<AssetCatalog, std::error_code> {
+    return boost::asio::co_spawn(
+               pool_,
+               AssetCatalog::build(std::move(shards), pool_.get_executor(), parallelism),
+               boost::asio::use_future)
+        .get();
+  }
+
+  boost::asio::thread_pool pool_{ 4 };
+};
+
+TEST_F(AssetCatalogTest, MergesShardsInIdOrder) {
+  auto catalog = build(dealtShards(400, 3), 4);
+  ASSERT_TRUE(catalog) << catalog.error().message();
+  EXPECT_EQ(catalog->size(), 400U);
+  EXPECT_EQ(catalog->shardCount(), 3U);
+
+  for (size_t type = 0; type < AssetTypeCount; ++type) {
+    EXPECT_EQ(catalog->count(static_cast<AssetType>(type)), 100U);
+  }
+
+  for (AssetId id = 1; id <= 400; ++id) {
+    auto asset = catalog->find(id);
+    ASSERT_TRUE(asset) << id;
+    // one asset of each type per group of four ids, numbered in id order
+    EXPECT_EQ(asset->index_, static_cast<uint32_t>((id - 1) / 4)) << id;
+  }
+
+  auto dependencies = catalog->dependencies(2);
+  ASSERT_TRUE(dependencies);
+  EXPECT_EQ(std::vector<AssetId>(dependencies->begin(), dependencies->end()),
+            std::vector<AssetId>{ 1 });
+  EXPECT_EQ(catalog->find(401).error(), Error::NotFoundError);
+}
+
+TEST_F(AssetCatalogTest, ParallelMergeMatchesSerialMerge) {
+  constexpr size_t Count{ 4 * AssetCatalog::MinMergeRange };
+
+  auto serial = build(dealtShards(Count, 8), 1);
+  auto parallel = build(dealtShards(Count, 8), 4);
+  ASSERT_TRUE(serial);
+  ASSERT_TRUE(parallel);
+  ASSERT_EQ(parallel->size(), Count);
+
+  for (auto id = AssetId{ 1 }; id <= static_cast<AssetId>(Count); id += 97) {
+    auto reference = serial->find(id);
+    auto asset = parallel->find(id);
+    ASSERT_TRUE(reference);
+    ASSERT_TRUE(asset);
+    EXPECT_EQ(asset->type, reference->type) << id;
+    EXPECT_EQ(asset->index_, reference->index_) << id;
+  }
+}
+
+TEST_F(AssetCatalogTest, EmptyCatalog) {
+  auto catalog = build({}, 4);
+  ASSERT_TRUE(catalog);
+  EXPECT_EQ(catalog->size(), 0U);
+  EXPECT_EQ(catalog->find(1).error(), Error::NotFoundError);
+}
+
+TEST_F(AssetCatalogTest, DuplicateIdAcrossShardsFails) {
+  std::vector<AssetShard> shards;
+  shards.push_back(shardOf({ 1, 2, 3, 4 }));
+  shards.push_back(shardOf({ 4, 5 }));
+
+  auto catalog = build(std::move(shards), 4);
+  ASSERT_FALSE(catalog);
+  EXPECT_EQ(catalog.error(), Error::SchemaError);
+}
+
+TEST_F(AssetCatalogTest, DuplicateIdInsideAParallelRangeFails) {
+  constexpr size_t Count{ 4 * AssetCatalog::MinMergeRange };
+
+  auto shards = dealtShards(Count, 4);
+  shards.push_back(shardOf({ static_cast<AssetId>(Count / 2) }));
+
+  auto catalog = build(std::move(shards), 4);
+  ASSERT_FALSE(catalog);
+  EXPECT_EQ(catalog.error(), Error::SchemaError);
+}
+
+TEST_F(AssetCatalogTest, DependencyInAnotherShardResolves) {
+  std::vector<AssetShard> shards;
+  shards.push_back(shardOf({ 1 }));
+  shards.push_back(shardOf({ 2, 3 }));
+
+  EXPECT_TRUE(build(std::move(shards), 4));
+}
+
+TEST_F(AssetCatalogTest, MissingDependencyFails) {
+  // material 2 uses texture 1
+  std::vector<AssetShard> shards;
+  shards.push_back(shardOf({ 2 }));
+
+  auto catalog = build(std::move(shards), 4);
+  ASSERT_FALSE(catalog);
+  EXPECT_EQ(catalog.error(), Error::SchemaError);
+}
+
+TEST_F(AssetCatalogTest, DependencyOfTheWrongTypeFails) {
+  // a mesh whose submesh material is a texture
+  std::vector<AssetShard> shards;
+  shards.push_back(shardOf({ 1 }));
+  shards.push_back(shardFromJson(
+      R"([{"id":3,"type":"mesh","source":"meshes/3.gltf","submeshes":)"
+      R"([{"name":"body","first_index":0,"index_count":36,"material":1}]}])"));
+
+  auto catalog = build(std::move(shards), 4);
+  ASSERT_FALSE(catalog);
+  EXPECT_EQ(catalog.error(), Error::SchemaError);
+}
+
+}  // namespace
+
+}  // namespace gravity
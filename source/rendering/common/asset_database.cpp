@@ -0,0 +1,239 @@
+#include "asset_database.hpp"
+
+#include "source/common/error.hpp"
+#include "source/common/logging/logger.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#undef GRAVITY_MODULE_NAME
+#define GRAVITY_MODULE_NAME "asset_database"
+
+namespace gravity {
+
+namespace {
+
+auto sectionFits(uint64_t offset, uint64_t size, size_t image_size) -> bool {
+  return offset <= image_size && size <= image_size - offset;
+}
+
+template <typename Record>
+auto viewAs(std::span<const std::byte> bytes, size_t count) -> std::span<const Record> {
+  // records are trivially copyable and the image keeps them aligned, they are used in place
+  return { reinterpret_cast<const Record*>(bytes.data()), count };  // NOLINT
+}
+
+template <typename Record>
+auto recordArray(std::span<const std::byte> records, size_t offset, size_t count)
+    -> std::expected<std::span<const Record>, std::error_code> {
+  if (offset > records.size() || count > (records.size() - offset) / sizeof(Record)) {
+    return std::unexpected(Error::SchemaError);
+  }
+  return viewAs<Record>(records.subspan(offset), count);
+}
+
+auto checkString(std::string_view strings, AssetStringRecord record) -> bool {
+  return sectionFits(record.offset_, record.size_, strings.size());
+}
+
+}  // namespace
+
+auto decodeAssetRecord(
+    AssetType type, std::span<const std::byte> records, size_t offset, std::string_view strings)
+    -> std::expected<AssetDescriptor, std::error_code> {
+  switch (type) {
+    case AssetType::Shader: {
+      auto header = recordArray<ShaderRecord>(records, offset, 1);
+      if (!header) {
+        return std::unexpected(header.error());
+      }
+      auto stage_mask = header->front().stage_mask_;
+      if (stage_mask > std::numeric_limits<std::underlying_type_t<ShaderStage>>::max()) {
+        return std::unexpected(Error::SchemaError);
+      }
+      auto stages = recordArray<ShaderStageRecord>(
+          records, offset + sizeof(ShaderRecord), static_cast<size_t>(std::popcount(stage_mask)));
+      if (!stages) {
+        return std::unexpected(stages.error());
+      }
+
+      auto remaining = stage_mask;
+      for (const auto& stage : *stages) {
+        // records are in bit order, each one the lowest stage not seen yet
+        auto lowest = 1U << static_cast<uint32_t>(std::countr_zero(remaining));
+        if (stage.stage_ != lowest || !checkString(strings, stage.spirv_path_) ||
+            !checkString(strings, stage.meta_path_)) {
+          return std::unexpected(Error::SchemaError);
+        }
+        remaining &= remaining - 1;
+      }
+      return AssetDescriptor{ .type = type,
+                              .data_ = ShaderDescriptor{ stage_mask, *stages, strings } };
+    }
+    case AssetType::Material: {
+      auto header = recordArray<MaterialRecord>(records, offset, 1);
+      if (!header) {
+        return std::unexpected(header.error());
+      }
+      auto textures = recordArray<MaterialTextureRecord>(
+          records, offset + sizeof(MaterialRecord), header->front().texture_count_);
+      if (!textures) {
+        return std::unexpected(textures.error());
+      }
+      for (const auto& texture : *textures) {
+        if (!checkString(strings, texture.name_)) {
+          return std::unexpected(Error::SchemaError);
+        }
+      }
+      return AssetDescriptor{ .type = type, .data_ = MaterialDescriptor{ *textures, strings } };
+    }
+    case AssetType::Texture: {
+      auto record = recordArray<TextureRecord>(records, offset, 1);
+      if (!record) {
+        return std::unexpected(record.error());
+      }
+      const auto& texture = record->front();
+      if (!checkString(strings, texture.image_path_) ||
+          !checkString(strings, texture.color_space_)) {
+        return std::unexpected(Error::SchemaError);
+      }
+      TextureDescriptor descriptor{
+        .image_path_ = resolveAssetString(strings, texture.image_path_),
+        .color_space_ = resolveAssetString(strings, texture.color_space_),
+        .mipmaps_ = texture.mipmaps_ != 0,
+      };
+      return AssetDescriptor{ .type = type, .data_ = descriptor };
+    }
+    case AssetType::Mesh: {
+      auto header = recordArray<MeshRecord>(records, offset, 1);
+      if (!header) {
+        return std::unexpected(header.error());
+      }
+      const auto& mesh = header->front();
+      auto submeshes =
+          recordArray<SubmeshRecord>(records, offset + sizeof(MeshRecord), mesh.submesh_count_);
+      if (!submeshes) {
+        return std::unexpected(submeshes.error());
+      }
+      if (!checkString(strings, mesh.source_)) {
+        return std::unexpected(Error::SchemaError);
+      }
+      for (const auto& submesh : *submeshes) {
+        if (!checkString(strings, submesh.name_)) {
+          return std::unexpected(Error::SchemaError);
+        }
+      }
+      return AssetDescriptor{
+        .type = type,
+        .data_ = MeshDescriptor{ resolveAssetString(strings, mesh.source_), *submeshes, strings }
+      };
+    }
+  }
+
+  return std::unexpected(Error::SchemaError);
+}
+
+auto AssetDatabase::open(const std::string& path) -> std::expected<AssetDatabase, std::error_code> {
+  auto mapping = MappedFile::open(path);
+  if (!mapping) {
+    return std::unexpected(mapping.error());
+  }
+
+  AssetDatabase database{};
+  database.mapping_ = std::move(*mapping);
+  if (auto error = database.bind(database.mapping_.data()); error) {
+    LOG_ERROR("invalid compiled asset database; path: {}", path);
+    return std::unexpected(error);
+  }
+
+  LOG_DEBUG("compiled asset database mapped; path: {}, assets: {}", path, database.size());
+  return database;
+}
+
+auto AssetDatabase::fromImage(std::vector<std::byte> image)
+    -> std::expected<AssetDatabase, std::error_code> {
+  AssetDatabase database{};
+  database.image_ = std::move(image);
+  if (auto error = database.bind(database.image_); error) {
+    LOG_ERROR("invalid asset database image");
+    return std::unexpected(error);
+  }
+  return database;
+}
+
+auto AssetDatabase::find(AssetId asset_id) const
+    -> std::expected<AssetDescriptor, std::error_code> {
+  auto entry = std::ranges::lower_bound(index_, asset_id, {}, &AssetIndexRecord::id_);
+  if (entry == index_.end() || entry->id_ != asset_id) {
+    return std::unexpected(Error::NotFoundError);
+  }
+  return decodeAt(static_cast<size_t>(entry - index_.begin()));
+}
+
+auto AssetDatabase::decodeAt(size_t position) const
+    -> std::expected<AssetDescriptor, std::error_code> {
+  const auto& entry = index_[position];
+  auto descriptor = decodeAssetRecord(
+      static_cast<AssetType>(entry.type_), records_, entry.record_offset_, strings_);
+  if (!descriptor) {
+    LOG_ERROR("corrupt record in compiled asset database; id: {}", entry.id_);
+  }
+  return descriptor;
+}
+
+auto AssetDatabase::bind(std::span<const std::byte> image) -> std::error_code {
+  AssetDatabaseHeader header{};
+  if (image.size() < sizeof(header)) {
+    return Error::SchemaError;
+  }
+  std::memcpy(&header, image.data(), sizeof(header));
+
+  if (header.magic_ != Magic) {
+    return Error::SchemaError;
+  }
+  if (header.version_ != Version) {
+    LOG_ERROR("unsupported asset database version; version: {}, expected: {}", header.version_,
+              Version);
+    return Error::FeatureNotSupported;
+  }
+
+  auto index_size = static_cast<uint64_t>(header.asset_count_) * sizeof(AssetIndexRecord);
+  if (!sectionFits(header.index_offset_, index_size, image.size()) ||
+      !sectionFits(header.records_offset_, header.records_size_, image.size()) ||
+      !sectionFits(header.strings_offset_, header.strings_size_, image.size()) ||
+      header.dependency_count_ > image.size() / sizeof(AssetId) ||
+      !sectionFits(
+          header.dependencies_offset_, header.dependency_count_ * sizeof(AssetId), image.size()) ||
+      header.index_offset_ % AssetRecordAlignment != 0 ||
+      header.records_offset_ % AssetRecordAlignment != 0 ||
+      header.dependencies_offset_ % AssetRecordAlignment != 0) {
+    return Error::SchemaError;
+  }
+
+  auto index = viewAs<AssetIndexRecord>(image.subspan(header.index_offset_), header.asset_count_);
+
+  // one pass over the index so lookups can trust the ordering, the types and the ranges
+  for (size_t i = 0; i < index.size(); ++i) {
+    if ((i > 0 && index[i - 1].id_ >= index[i].id_) || index[i].type_ >= AssetTypeCount ||
+        index[i].record_offset_ >= header.records_size_ ||
+        index[i].record_offset_ % AssetRecordAlignment != 0 ||
+        static_cast<uint64_t>(index[i].first_dependency_) + index[i].dependency_count_ >
+            header.dependency_count_) {
+      return Error::SchemaError;
+    }
+  }
+
+  index_ = index;
+  records_ = image.subspan(header.records_offset_, header.records_size_);
+  dependencies_ =
+      viewAs<AssetId>(image.subspan(header.dependencies_offset_), header.dependency_count_);
+  strings_ = { reinterpret_cast<const char*>(image.data() + header.strings_offset_),  // NOLINT
+               header.strings_size_ };
+  return Error::OK;
+}
+
+}  // namespace gravity
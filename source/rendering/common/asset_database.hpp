@@ -0,0 +1,79 @@
+#pragma once
+
+#include "source/common/mapped_file.hpp"
+#include "source/rendering/common/asset_records.hpp"
+#include "source/rendering/common/asset_types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace gravity {
+
+// Builds the descriptor view of the record at offset, checking that the record, its element array
+// and every string it references lie inside records and strings.
+auto decodeAssetRecord(
+    AssetType type, std::span<const std::byte> records, size_t offset, std::string_view strings)
+    -> std::expected<AssetDescriptor, std::error_code>;
+
+// Read side of a compiled asset database. The image is either mapped from disk or handed over in
+// memory; its layout is checked once when it is bound, after which find() is a binary search over
+// the id index and returns descriptors that point straight into the image, nothing is copied or
+// allocated per asset.
+class AssetDatabase {
+ public:
+  static constexpr std::array<char, 8> Magic{ 'G', 'R', 'V', 'A', 'D', 'B', '0', '1' };
+  static constexpr uint32_t Version{ 3 };
+
+  // The file stays mapped, so it must only be replaced by renaming a new image over it as
+  // compile_asset_database does; truncating it in place faults on the next lookup.
+  static auto open(const std::string& path) -> std::expected<AssetDatabase, std::error_code>;
+  static auto fromImage(std::vector<std::byte> image)
+      -> std::expected<AssetDatabase, std::error_code>;
+
+  AssetDatabase() = default;
+
+  AssetDatabase(const AssetDatabase&) = delete;
+  auto operator=(const AssetDatabase&) -> AssetDatabase& = delete;
+
+  AssetDatabase(AssetDatabase&&) noexcept = default;
+  auto operator=(AssetDatabase&&) noexcept -> AssetDatabase& = default;
+
+  ~AssetDatabase() = default;
+
+  [[nodiscard]] auto find(AssetId asset_id) const
+      -> std::expected<AssetDescriptor, std::error_code>;
+
+  [[nodiscard]] auto size() const -> size_t { return index_.size(); }
+
+  // Positions follow id order, 0 <= position < size().
+  [[nodiscard]] auto idAt(size_t position) const -> AssetId { return index_[position].id_; }
+  [[nodiscard]] auto typeAt(size_t position) const -> AssetType {
+    return static_cast<AssetType>(index_[position].type_);
+  }
+  [[nodiscard]] auto dependenciesAt(size_t position) const -> std::span<const AssetId> {
+    return dependencies_.subspan(
+        index_[position].first_dependency_, index_[position].dependency_count_);
+  }
+  [[nodiscard]] auto decodeAt(size_t position) const
+      -> std::expected<AssetDescriptor, std::error_code>;
+
+ private:
+  MappedFile mapping_;
+  std::vector<std::byte> image_;
+
+  std::span<const AssetIndexRecord> index_;
+  std::span<const std::byte> records_;
+  std::span<const AssetId> dependencies_;
+  std::string_view strings_;
+
+  auto bind(std::span<const std::byte> image) -> std::error_code;
+};
+
+}  // namespace gravity
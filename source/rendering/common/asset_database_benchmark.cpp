@@ -0,0 +1,198 @@
+#include "source/rendering/common/asset_database.hpp"
+#include "source/rendering/common/asset_database_compiler.hpp"
+#include "source/rendering/common/json_asset_catalog.hpp"
+#include "source/rendering/common/synthetic_catalog.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+// Startup and lookup cost of a synthetic catalog in the three forms the runtime can serve:
+//
+//   Compiled  AssetDatabase mapping the image written by compile_asset_database
+//   Json      JsonAssetCatalog, which indexes the text on open and compiles assets on first find
+//   Eager     the whole document parsed and validated up front, as AssetManager used to at startup
+//
+// The argument is the number of assets, ids 1 to count of syntheticAssetJson().
+
+namespace gravity {
+
+namespace {
+
+class CatalogFiles {
+ public:
+  explicit CatalogFiles(size_t count) {
+    auto directory = std::filesystem::temp_directory_path() / "gravity_asset_database_benchmark";
+    std::filesystem::create_directories(directory);
+    json_path_ = (directory / (std::to_string(count) + ".json")).string();
+    image_path_ = (directory / (std::to_string(count) + ".gadb")).string();
+
+    ids_.resize(count);
+    std::ranges::generate(ids_, [id = AssetId{ 0 }]() mutable { return ++id; });
+
+    auto json = syntheticCatalogJson(ids_);
+    std::ofstream{ json_path_, std::ios::binary } << json;
+
+    auto image = compileAssetDatabase(json);
+    if (image) {
+      std::ofstream{ image_path_, std::ios::binary }.write(
+          reinterpret_cast<const char*>(image->data()),  // NOLINT
+          static_cast<std::streamsize>(image->size()));
+    }
+
+    std::ranges::shuffle(ids_, std::mt19937_64{ 42 });
+  }
+
+  CatalogFiles(const CatalogFiles&) = delete;
+  auto operator=(const CatalogFiles&) -> CatalogFiles& = delete;
+
+  ~CatalogFiles() {
+    std::error_code error_code;
+    std::filesystem::remove(json_path_, error_code);
+    std::filesystem::remove(image_path_, error_code);
+  }
+
+  [[nodiscard]] auto jsonPath() const -> const std::string& { return json_path_; }
+  [[nodiscard]] auto imagePath() const -> const std::string& { return image_path_; }
+
+  // every id once, shuffled
+  [[nodiscard]] auto ids() const -> const std::vector<AssetId>& { return ids_; }
+
+ private:
+  std::string json_path_;
+  std::string image_path_;
+  std::vector<AssetId> ids_;
+};
+
+auto catalogFiles(const benchmark::State& state) -> const CatalogFiles& {
+  static std::map<size_t, CatalogFiles> files;
+  auto count = static_cast<size_t>(state.range(0));
+  return files.try_emplace(count, count).first->second;
+}
+
+void BM_OpenCompiled(benchmark::State& state) {
+  const auto& files = catalogFiles(state);
+
+  for (auto _ : state) {
+    auto database = AssetDatabase::open(files.imagePath());
+    if (!database) {
+      state.SkipWithError("opening the image failed");
+      return;
+    }
+    benchmark::DoNotOptimize(database->size());
+  }
+}
+
+void BM_OpenJson(benchmark::State& state) {
+  const auto& files = catalogFiles(state);
+
+  for (auto _ : state) {
+    auto catalog = JsonAssetCatalog::open(files.jsonPath());
+    if (!catalog) {
+      state.SkipWithError("opening the catalog failed");
+      return;
+    }
+    benchmark::DoNotOptimize((*catalog)->size());
+  }
+}
+
+void BM_OpenEager(benchmark::State& state) {
+  const auto& files = catalogFiles(state);
+
+  for (auto _ : state) {
+    std::ifstream stream{ files.jsonPath(), std::ios::binary };
+    std::string json{ std::istreambuf_iterator<char>{ stream }, {} };
+
+    auto image = compileAssetDatabase(json);
+    if (!image) {
+      state.SkipWithError("compiling the catalog failed");
+      return;
+    }
+    auto database = AssetDatabase::fromImage(std::move(*image));
+    benchmark::DoNotOptimize(database);
+  }
+}
+
+template <typename Catalog>
+void findRandom(benchmark::State& state, const Catalog& catalog, const std::vector<AssetId>& ids) {
+  size_t cursor{ 0 };
+  for (auto _ : state) {
+    auto asset = catalog.find(ids[cursor++ % ids.size()]);
+    benchmark::DoNotOptimize(asset);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+void BM_FindCompiled(benchmark::State& state) {
+  const auto& files = catalogFiles(state);
+
+  auto database = AssetDatabase::open(files.imagePath());
+  if (!database) {
+    state.SkipWithError("opening the image failed");
+    return;
+  }
+  findRandom(state, *database, files.ids());
+}
+
+// every asset looked up once on a freshly opened catalog, so each find compiles its asset
+void BM_FindJsonFirst(benchmark::State& state) {
+  const auto& files = catalogFiles(state);
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto catalog = JsonAssetCatalog::open(files.jsonPath());
+    if (!catalog) {
+      state.SkipWithError("opening the catalog failed");
+      return;
+    }
+    state.ResumeTiming();
+
+    for (auto id : files.ids()) {
+      auto asset = (*catalog)->find(id);
+      benchmark::DoNotOptimize(asset);
+    }
+
+    state.PauseTiming();
+    catalog->reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * files.ids().size()));
+}
+
+void BM_FindJsonRepeat(benchmark::State& state) {
+  const auto& files = catalogFiles(state);
+
+  auto catalog = JsonAssetCatalog::open(files.jsonPath());
+  if (!catalog) {
+    state.SkipWithError("opening the catalog failed");
+    return;
+  }
+  for (auto id : files.ids()) {
+    benchmark::DoNotOptimize((*catalog)->find(id));
+  }
+  findRandom(state, **catalog, files.ids());
+}
+
+void catalogSizes(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgName("assets")->Arg(10'000)->Arg(200'000);
+}
+
+BENCHMARK(BM_OpenCompiled)->Apply(catalogSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_OpenJson)->Apply(catalogSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_OpenEager)->Apply(catalogSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FindCompiled)->Apply(catalogSizes);
+BENCHMARK(BM_FindJsonFirst)->Apply(catalogSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FindJsonRepeat)->Apply(catalogSizes);
+
+}  // namespace
+
+}  // namespace gravity
@@ -0,0 +1,510 @@
+#include "asset_database_compiler.hpp"
+
+#include "source/common/error.hpp"
+#include "source/common/logging/logger.hpp"
+#include "source/rendering/common/asset_database.hpp"
+#include "source/rendering/common/asset_records.hpp"
+#include "source/rendering/common/asset_types.hpp"
+
+#include "boost/json.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#undef GRAVITY_MODULE_NAME
+#define GRAVITY_MODULE_NAME "asset_database"
+
+namespace json = boost::json;
+
+namespace gravity {
+
+namespace {
+
+enum class ExpectedTypes : uint8_t { String, Integer, Boolean, List };
+
+struct RequiredParameters {
+  const char* name_;
+  ExpectedTypes expected_type_;
+};
+
+constexpr const char* TypeParameter{ "type" };
+constexpr const char* NameParameter{ "name" };
+constexpr const char* IdParameter{ "id" };
+constexpr const char* StagesParameter{ "stages" };
+constexpr const char* SpirvParameter{ "spirv" };
+constexpr const char* MetaParameter{ "meta" };
+constexpr const char* TexturesParameter{ "textures" };
+constexpr const char* ParametersParameter{ "parameters" };
+constexpr const char* AssetParameter{ "asset" };
+constexpr const char* SamplerParameter{ "sampler" };
+constexpr const char* ImageParameter{ "image" };
+constexpr const char* ColourSpaceParameter{ "colour_space" };
+constexpr const char* MipmapsParameter{ "mipmaps" };
+
+constexpr const char* SourceParameter{ "source" };
+constexpr const char* SubmeshesParameter{ "submeshes" };
+constexpr const char* FirstIndexParameter{ "first_index" };
+constexpr const char* IndexCountParameter{ "index_count" };
+constexpr const char* MaterialParameter{ "material" };
+
+constexpr std::array<RequiredParameters, 1> ShaderRequiredParameters{
+  { { .name_ = StagesParameter, .expected_type_ = ExpectedTypes::List } }
+};
+
+constexpr std::array<RequiredParameters, 3> ShaderStageRequiredParameters{
+  { { .name_ = SpirvParameter, .expected_type_ = ExpectedTypes::String },
+    { .name_ = MetaParameter, .expected_type_ = ExpectedTypes::String },
+    { .name_ = TypeParameter, .expected_type_ = ExpectedTypes::String } }
+};
+
+constexpr std::array<RequiredParameters, 2> AssetRequiredParameters{
+  { { .name_ = IdParameter, .expected_type_ = ExpectedTypes::Integer },
+    { .name_ = TypeParameter, .expected_type_ = ExpectedTypes::String } }
+};
+
+constexpr std::array<RequiredParameters, 2> MaterialRequiredParameters{
+  { { .name_ = TexturesParameter, .expected_type_ = ExpectedTypes::List },
+    { .name_ = ParametersParameter, .expected_type_ = ExpectedTypes::List } }
+};
+
+constexpr std::array<RequiredParameters, 3> MaterialTextureRequiredParameters{
+  { { .name_ = NameParameter, .expected_type_ = ExpectedTypes::String },
+    { .name_ = AssetParameter, .expected_type_ = ExpectedTypes::Integer },
+    { .name_ = SamplerParameter, .expected_type_ = ExpectedTypes::String } }
+};
+
+constexpr std::array<RequiredParameters, 3> TextureRequiredParameters{
+  { { .name_ = ImageParameter, .expected_type_ = ExpectedTypes::String },
+    { .name_ = ColourSpaceParameter, .expected_type_ = ExpectedTypes::String },
+    { .name_ = MipmapsParameter, .expected_type_ = ExpectedTypes::Boolean } }
+};
+
+constexpr std::array<RequiredParameters, 2> MeshRequiredParameters{
+  { { .name_ = SourceParameter, .expected_type_ = ExpectedTypes::String },
+    { .name_ = SubmeshesParameter, .expected_type_ = ExpectedTypes::List } }
+};
+
+constexpr std::array<RequiredParameters, 4> SubmeshRequiredParameters{
+  { { .name_ = NameParameter, .expected_type_ = ExpectedTypes::String },
+    { .name_ = FirstIndexParameter, .expected_type_ = ExpectedTypes::Integer },
+    { .name_ = IndexCountParameter, .expected_type_ = ExpectedTypes::Integer },
+    { .name_ = MaterialParameter, .expected_type_ = ExpectedTypes::Integer } }
+};
+
+auto validateRequiredParameters(
+    const json::object& object, std::span<const RequiredParameters> parameters) -> std::error_code {
+  for (const auto& parameter : parameters) {
+    if (!object.contains(parameter.name_)) {
+      return Error::SchemaError;
+    }
+
+    switch (parameter.expected_type_) {
+      case ExpectedTypes::String:
+        if (!object.at(parameter.name_).is_string()) {
+          return Error::SchemaError;
+        }
+        break;
+      case ExpectedTypes::Integer:
+        if (!object.at(parameter.name_).is_int64()) {
+          return Error::SchemaError;
+        }
+        break;
+      case ExpectedTypes::List:
+        if (!object.at(parameter.name_).is_array()) {
+          return Error::SchemaError;
+        }
+        break;
+      case ExpectedTypes::Boolean:
+        if (!object.at(parameter.name_).is_bool()) {
+          return Error::SchemaError;
+        }
+        break;
+    }
+  }
+  return Error::OK;
+}
+
+// Accumulates record and string bytes, strings are deduplicated since most paths and names
+// repeat across assets.
+class RecordWriter {
+ public:
+  auto string(std::string_view value) -> std::expected<AssetStringRecord, std::error_code> {
+    if (auto iterator = string_offsets_.find(std::string{ value });
+        iterator != string_offsets_.end()) {
+      return iterator->second;
+    }
+
+    if (strings_.size() + value.size() > std::numeric_limits<uint32_t>::max()) {
+      LOG_ERROR("asset database string section exceeds 4 GiB");
+      return std::unexpected(Error::FailedPreconditionError);
+    }
+
+    AssetStringRecord record{ .offset_ = static_cast<uint32_t>(strings_.size()),
+                              .size_ = static_cast<uint32_t>(value.size()) };
+    strings_.append(value);
+    string_offsets_.emplace(value, record);
+    return record;
+  }
+
+  template <typename Record>
+  void append(std::span<const Record> records) {
+    static_assert(sizeof(Record) % AssetRecordAlignment == 0);
+    auto bytes = std::as_bytes(records);
+    records_.insert(records_.end(), bytes.begin(), bytes.end());
+  }
+
+  template <typename Record>
+  void append(const Record& record) {
+    append(std::span{ &record, 1 });
+  }
+
+  void dependency(AssetId asset_id) { dependencies_.push_back(asset_id); }
+
+  // sorts and deduplicates the dependencies added since first, returns how many remain
+  auto closeDependencies(size_t first) -> size_t {
+    auto tail = dependencies_.begin() + static_cast<ptrdiff_t>(first);
+    std::sort(tail, dependencies_.end());
+    dependencies_.erase(std::unique(tail, dependencies_.end()), dependencies_.end());
+    return dependencies_.size() - first;
+  }
+
+  [[nodiscard]] auto records() const -> const std::vector<std::byte>& { return records_; }
+  [[nodiscard]] auto dependencies() const -> const std::vector<AssetId>& { return dependencies_; }
+  [[nodiscard]] auto strings() const -> const std::string& { return strings_; }
+
+  auto takeRecords() -> std::vector<std::byte> { return std::move(records_); }
+  auto takeStrings() -> std::string { return std::move(strings_); }
+
+ private:
+  std::vector<std::byte> records_;
+  std::vector<AssetId> dependencies_;
+  std::string strings_;
+  std::unordered_map<std::string, AssetStringRecord> string_offsets_;
+};
+
+struct AssetKey {
+  AssetId id_;
+  AssetType type_;
+};
+
+auto compileShader(const json::object& asset, RecordWriter& writer) -> std::error_code {
+  if (auto error{ validateRequiredParameters(asset, ShaderRequiredParameters) };
+      error != Error::OK) {
+    return error;
+  }
+  const auto& shader_stages{ asset.at(StagesParameter).as_array() };
+
+  std::vector<ShaderStageRecord> stages;
+  stages.reserve(shader_stages.size());
+  for (const auto& shader_stage_object : shader_stages) {
+    if (!shader_stage_object.is_object()) {
+      return Error::SchemaError;
+    }
+    const auto& shader_stage = shader_stage_object.as_object();
+    if (auto error{ validateRequiredParameters(shader_stage, ShaderStageRequiredParameters) };
+        error != Error::OK) {
+      return error;
+    }
+
+    auto stage{ assetShaderStageFromString(shader_stage.at(TypeParameter).as_string()) };
+    if (!stage) {
+      return stage.error();
+    }
+
+    // the first entry for a stage wins
+    if (std::ranges::find(stages, static_cast<uint8_t>(*stage), &ShaderStageRecord::stage_) !=
+        stages.end()) {
+      continue;
+    }
+
+    auto spirv_path = writer.string(shader_stage.at(SpirvParameter).as_string());
+    auto meta_path = writer.string(shader_stage.at(MetaParameter).as_string());
+    if (!spirv_path || !meta_path) {
+      return Error::FailedPreconditionError;
+    }
+
+    stages.push_back(ShaderStageRecord{ .spirv_path_ = *spirv_path,
+                                        .meta_path_ = *meta_path,
+                                        .stage_ = static_cast<uint8_t>(*stage),
+                                        .padding_ = {} });
+  }
+
+  uint32_t stage_mask = 0;
+  for (const auto& stage : stages) {
+    stage_mask |= stage.stage_;
+  }
+  std::ranges::sort(stages, {}, &ShaderStageRecord::stage_);
+
+  writer.append(ShaderRecord{ .stage_mask_ = stage_mask, .padding_ = 0 });
+  writer.append(std::span<const ShaderStageRecord>{ stages });
+  return Error::OK;
+}
+
+auto compileMaterial(const json::object& asset, RecordWriter& writer) -> std::error_code {
+  if (auto error{ validateRequiredParameters(asset, MaterialRequiredParameters) };
+      error != Error::OK) {
+    return error;
+  }
+
+  const auto& material_textures{ asset.at(TexturesParameter).as_array() };
+
+  std::vector<MaterialTextureRecord> textures;
+  textures.reserve(material_textures.size());
+  for (const auto& texture_object : material_textures) {
+    if (!texture_object.is_object()) {
+      return Error::SchemaError;
+    }
+    const auto& texture = texture_object.as_object();
+
+    if (auto error{ validateRequiredParameters(texture, MaterialTextureRequiredParameters) };
+        error != Error::OK) {
+      return error;
+    }
+
+    auto sampler_expect{ samplerTypeFromString(texture.at(SamplerParameter).as_string()) };
+    if (!sampler_expect) {
+      return sampler_expect.error();
+    }
+
+    auto name = writer.string(texture.at(NameParameter).as_string());
+    if (!name) {
+      return name.error();
+    }
+
+    writer.dependency(texture.at(AssetParameter).as_int64());
+    textures.push_back(MaterialTextureRecord{
+        .name_ = *name,
+        .texture_asset_ = texture.at(AssetParameter).as_int64(),
+        .sampler_ = static_cast<uint8_t>(*sampler_expect),
+        .padding_ = {},
+    });
+  }
+
+  writer.append(
+      MaterialRecord{ .texture_count_ = static_cast<uint32_t>(textures.size()), .padding_ = 0 });
+  writer.append(std::span<const MaterialTextureRecord>{ textures });
+  return Error::OK;
+}
+
+auto compileTexture(const json::object& asset, RecordWriter& writer) -> std::error_code {
+  if (auto error{ validateRequiredParameters(asset, TextureRequiredParameters) };
+      error != Error::OK) {
+    return error;
+  }
+
+  auto image_path = writer.string(asset.at(ImageParameter).as_string());
+  auto color_space = writer.string(asset.at(ColourSpaceParameter).as_string());
+  if (!image_path || !color_space) {
+    return Error::FailedPreconditionError;
+  }
+
+  writer.append(TextureRecord{
+      .image_path_ = *image_path,
+      .color_space_ = *color_space,
+      .mipmaps_ = static_cast<uint8_t>(asset.at(MipmapsParameter).as_bool()),
+      .padding_ = {},
+  });
+  return Error::OK;
+}
+
+auto compileMesh(const json::object& asset, RecordWriter& writer) -> std::error_code {
+  if (auto error{ validateRequiredParameters(asset, MeshRequiredParameters) }; error != Error::OK) {
+    return error;
+  }
+
+  const auto& mesh_submeshes{ asset.at(SubmeshesParameter).as_array() };
+
+  auto source = writer.string(asset.at(SourceParameter).as_string());
+  if (!source) {
+    return source.error();
+  }
+
+  std::vector<SubmeshRecord> submeshes;
+  submeshes.reserve(mesh_submeshes.size());
+  for (const auto& submesh_object : mesh_submeshes) {
+    if (!submesh_object.is_object()) {
+      return Error::SchemaError;
+    }
+    const auto& submesh = submesh_object.as_object();
+
+    if (auto error{ validateRequiredParameters(submesh, SubmeshRequiredParameters) };
+        error != Error::OK) {
+      return error;
+    }
+
+    auto name = writer.string(submesh.at(NameParameter).as_string());
+    if (!name) {
+      return name.error();
+    }
+
+    writer.dependency(submesh.at(MaterialParameter).as_int64());
+    submeshes.push_back(SubmeshRecord{
+        .name_ = *name,
+        .first_index_ = submesh.at(FirstIndexParameter).as_int64(),
+        .index_count_ = submesh.at(IndexCountParameter).as_int64(),
+        .material_asset_ = submesh.at(MaterialParameter).as_int64(),
+    });
+  }
+
+  writer.append(MeshRecord{ .source_ = *source,
+                            .submesh_count_ = static_cast<uint32_t>(submeshes.size()),
+                            .padding_ = 0 });
+  writer.append(std::span<const SubmeshRecord>{ submeshes });
+  return Error::OK;
+}
+
+auto compileAssetObject(const json::object& asset, RecordWriter& writer)
+    -> std::expected<AssetKey, std::error_code> {
+  if (auto error{ validateRequiredParameters(asset, AssetRequiredParameters) };
+      error != Error::OK) {
+    return std::unexpected(error);
+  }
+
+  auto asset_id{ asset.at(IdParameter).as_int64() };
+
+  auto asset_type{ assetTypeFromString(asset.at(TypeParameter).as_string()) };
+  if (!asset_type) {
+    LOG_ERROR("invalid asset type; id: {}", asset_id);
+    return std::unexpected(asset_type.error());
+  }
+
+  std::error_code error;
+  switch (*asset_type) {
+    case AssetType::Shader:
+      error = compileShader(asset, writer);
+      break;
+    case AssetType::Texture:
+      error = compileTexture(asset, writer);
+      break;
+    case AssetType::Mesh:
+      error = compileMesh(asset, writer);
+      break;
+    case AssetType::Material:
+      error = compileMaterial(asset, writer);
+      break;
+  }
+
+  if (error) {
+    LOG_ERROR("corrupt asset database; id: {}", asset_id);
+    return std::unexpected(error);
+  }
+  return AssetKey{ .id_ = asset_id, .type_ = *asset_type };
+}
+
+auto assembleImage(std::vector<AssetIndexRecord>& index, const RecordWriter& writer)
+    -> std::expected<std::vector<std::byte>, std::error_code> {
+  std::ranges::sort(index, {}, &AssetIndexRecord::id_);
+  auto duplicate = std::ranges::adjacent_find(
+      index, [](const auto& lhs, const auto& rhs) { return lhs.id_ == rhs.id_; });
+  if (duplicate != index.end()) {
+    LOG_ERROR("duplicate asset id {}", duplicate->id_);
+    return std::unexpected(Error::SchemaError);
+  }
+
+  auto index_bytes = std::as_bytes(std::span{ index });
+  const auto& records = writer.records();
+  auto dependency_bytes = std::as_bytes(std::span{ writer.dependencies() });
+  const auto& strings = writer.strings();
+
+  AssetDatabaseHeader header{ .magic_ = AssetDatabase::Magic,
+                              .version_ = AssetDatabase::Version,
+                              .asset_count_ = static_cast<uint32_t>(index.size()),
+                              .index_offset_ = sizeof(AssetDatabaseHeader),
+                              .records_offset_ = sizeof(AssetDatabaseHeader) + index_bytes.size(),
+                              .records_size_ = records.size(),
+                              .strings_offset_ = 0,
+                              .strings_size_ = strings.size(),
+                              .dependencies_offset_ = 0,
+                              .dependency_count_ = writer.dependencies().size() };
+  header.dependencies_offset_ = header.records_offset_ + header.records_size_;
+  header.strings_offset_ = header.dependencies_offset_ + dependency_bytes.size();
+
+  std::vector<std::byte> image(header.strings_offset_ + header.strings_size_);
+  std::memcpy(image.data(), &header, sizeof(header));
+  std::ranges::copy(index_bytes, image.begin() + static_cast<ptrdiff_t>(header.index_offset_));
+  std::ranges::copy(records, image.begin() + static_cast<ptrdiff_t>(header.records_offset_));
+  std::ranges::copy(
+      dependency_bytes, image.begin() + static_cast<ptrdiff_t>(header.dependencies_offset_));
+  std::ranges::copy(
+      std::as_bytes(std::span{ strings }),
+      image.begin() + static_cast<ptrdiff_t>(header.strings_offset_));
+  return image;
+}
+
+}  // namespace
+
+auto compileAssetDatabase(std::string_view json)
+    -> std::expected<std::vector<std::byte>, std::error_code> {
+  boost::system::error_code parse_error;
+  auto value = json::parse(json, parse_error);
+  if (parse_error) {
+    LOG_ERROR("asset database is not valid json; error: {}", parse_error.message());
+    return std::unexpected(Error::SchemaError);
+  }
+
+  if (!value.is_array()) {
+    LOG_ERROR("asset database is not valid");
+    return std::unexpected(Error::SchemaError);
+  }
+
+  RecordWriter writer{};
+  std::vector<AssetIndexRecord> index;
+  index.reserve(value.as_array().size());
+
+  for (const auto& item : value.as_array()) {
+    if (!item.is_object()) {
+      continue;
+    }
+
+    auto record_offset = writer.records().size();
+    auto first_dependency = writer.dependencies().size();
+    if (record_offset > std::numeric_limits<uint32_t>::max() ||
+        first_dependency > std::numeric_limits<uint32_t>::max()) {
+      LOG_ERROR("asset database record or dependency section exceeds its 32 bit range");
+      return std::unexpected(Error::FailedPreconditionError);
+    }
+
+    auto key = compileAssetObject(item.as_object(), writer);
+    if (!key) {
+      return std::unexpected(key.error());
+    }
+
+    auto dependency_count = static_cast<uint32_t>(writer.closeDependencies(first_dependency));
+    index.push_back(AssetIndexRecord{ .id_ = key->id_,
+                                      .record_offset_ = static_cast<uint32_t>(record_offset),
+                                      .type_ = static_cast<uint8_t>(key->type_),
+                                      .padding_ = {},
+                                      .first_dependency_ = static_cast<uint32_t>(first_dependency),
+                                      .dependency_count_ = dependency_count });
+  }
+
+  return assembleImage(index, writer);
+}
+
+auto compileAsset(std::string_view asset_json) -> std::expected<CompiledAsset, std::error_code> {
+  boost::system::error_code parse_error;
+  auto value = json::parse(asset_json, parse_error);
+  if (parse_error || !value.is_object()) {
+    LOG_ERROR("asset entry is not a valid json object");
+    return std::unexpected(Error::SchemaError);
+  }
+
+  RecordWriter writer{};
+  auto key = compileAssetObject(value.as_object(), writer);
+  if (!key) {
+    return std::unexpected(key.error());
+  }
+
+  return CompiledAsset{ .id_ = key->id_,
+                        .type_ = key->type_,
+                        .record_ = writer.takeRecords(),
+                        .strings_ = writer.takeStrings() };
+}
+
+}  // namespace gravity
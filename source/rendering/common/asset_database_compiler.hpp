@@ -0,0 +1,31 @@
+#pragma once
+
+#include "source/rendering/common/asset_types.hpp"
+
+#include <cstddef>
+#include <expected>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace gravity {
+
+// Validates a JSON asset catalog (the resources/assetsdb.json schema) and lays it out as a compiled
+// asset database image, ready to be written to disk or bound with AssetDatabase::fromImage().
+auto compileAssetDatabase(std::string_view json)
+    -> std::expected<std::vector<std::byte>, std::error_code>;
+
+// A single catalog entry compiled on its own: record_ holds the asset's record followed by its
+// element array, and its string references are relative to strings_.
+struct CompiledAsset {
+  AssetId id_;
+  AssetType type_;
+  std::vector<std::byte> record_;
+  std::string strings_;
+};
+
+// Compiles one asset object, the text of a single element of the catalog array.
+auto compileAsset(std::string_view asset_json) -> std::expected<CompiledAsset, std::error_code>;
+
+}  // namespace gravity
@@ -0,0 +1,287 @@
+#include "source/rendering/common/asset_database.hpp"
+
+#include "source/common/error.hpp"
+#include "source/rendering/common/asset_records.hpp"
+#include "source/rendering/common/asset_types.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <variant>
+#include <vector>
+
+namespace gravity {
+
+namespace {
+
+constexpr std::string_view Strings{ "vertmetafragmetaalbedotextures/1.pngsrgbmeshes/3.gltfbody" };
+constexpr AssetStringRecord Vert{ 0, 4 };
+constexpr AssetStringRecord Meta{ 4, 4 };
+constexpr AssetStringRecord Frag{ 8, 4 };
+constexpr AssetStringRecord Albedo{ 16, 6 };
+constexpr AssetStringRecord Image{ 22, 14 };
+constexpr AssetStringRecord Srgb{ 36, 4 };
+constexpr AssetStringRecord Source{ 40, 13 };
+constexpr AssetStringRecord Body{ 53, 4 };
+
+constexpr AssetStringRecord PastTheEnd{ 50, 8 };
+constexpr AssetStringRecord Wrapping{ std::numeric_limits<uint32_t>::max() - 2, 8 };
+
+template <typename T>
+void append(std::vector<std::byte>& bytes, const T& value) {
+  auto size = bytes.size();
+  bytes.resize(size + sizeof(T));
+  std::memcpy(bytes.data() + size, &value, sizeof(T));
+}
+
+auto decode(AssetType type, const std::vector<std::byte>& records, size_t offset = 0)
+    -> std::expected<AssetDescriptor, std::error_code> {
+  return decodeAssetRecord(type, records, offset, Strings);
+}
+
+auto decodeError(AssetType type, const std::vector<std::byte>& records, size_t offset = 0)
+    -> std::error_code {
+  auto descriptor = decode(type, records, offset);
+  return descriptor ? std::error_code{} : descriptor.error();
+}
+
+auto shaderRecords(std::vector<ShaderStageRecord> stages, uint32_t stage_mask)
+    -> std::vector<std::byte> {
+  std::vector<std::byte> records;
+  append(records, ShaderRecord{ .stage_mask_ = stage_mask, .padding_ = 0 });
+  for (const auto& stage : stages) {
+    append(records, stage);
+  }
+  return records;
+}
+
+auto stage(ShaderStage stage, AssetStringRecord spirv, AssetStringRecord meta)
+    -> ShaderStageRecord {
+  return { .spirv_path_ = spirv,
+           .meta_path_ = meta,
+           .stage_ = static_cast<uint8_t>(stage),
+           .padding_ = {} };
+}
+
+constexpr uint32_t VertexAndFragment{ static_cast<uint32_t>(ShaderStage::Vertex) |
+                                      static_cast<uint32_t>(ShaderStage::Fragment) };
+
+auto materialRecords(uint32_t texture_count, AssetStringRecord name) -> std::vector<std::byte> {
+  std::vector<std::byte> records;
+  append(records, MaterialRecord{ .texture_count_ = texture_count, .padding_ = 0 });
+  append(records, MaterialTextureRecord{ .name_ = name,
+                                         .texture_asset_ = 1,
+                                         .sampler_ = 0,
+                                         .padding_ = {} });
+  return records;
+}
+
+auto meshRecords(uint32_t submesh_count, AssetStringRecord source, AssetStringRecord name)
+    -> std::vector<std::byte> {
+  std::vector<std::byte> records;
+  append(records, MeshRecord{ .source_ = source, .submesh_count_ = submesh_count, .padding_ = 0 });
+  append(records, SubmeshRecord{ .name_ = name,
+                                 .first_index_ = 0,
+                                 .index_count_ = 36,
+                                 .material_asset_ = 2 });
+  return records;
+}
+
+auto textureRecords(AssetStringRecord image, AssetStringRecord color_space)
+    -> std::vector<std::byte> {
+  std::vector<std::byte> records;
+  append(records, TextureRecord{ .image_path_ = image,
+                                 .color_space_ = color_space,
+                                 .mipmaps_ = 1,
+                                 .padding_ = {} });
+  return records;
+}
+
+TEST(DecodeAssetRecordTest, DecodesEveryType) {
+  auto shader_records = shaderRecords(
+      { stage(ShaderStage::Vertex, Vert, Meta), stage(ShaderStage::Fragment, Frag, Meta) },
+      VertexAndFragment);
+  auto shader = decode(AssetType::Shader, shader_records);
+  ASSERT_TRUE(shader);
+  const auto& stages = std::get<ShaderDescriptor>(shader->data_);
+  EXPECT_EQ(stages.find(ShaderStage::Fragment)->spirv_path_, "frag");
+  EXPECT_FALSE(stages.find(ShaderStage::Compute));
+
+  // descriptors view the records, which have to outlive them
+  auto material_records = materialRecords(1, Albedo);
+  auto material = decode(AssetType::Material, material_records);
+  ASSERT_TRUE(material);
+  EXPECT_EQ(std::get<MaterialDescriptor>(material->data_).texture(0).name_, "albedo");
+
+  auto mesh_records = meshRecords(1, Source, Body);
+  auto mesh = decode(AssetType::Mesh, mesh_records);
+  ASSERT_TRUE(mesh);
+  EXPECT_EQ(std::get<MeshDescriptor>(mesh->data_).source(), "meshes/3.gltf");
+  EXPECT_EQ(std::get<MeshDescriptor>(mesh->data_).submesh(0).name_, "body");
+
+  auto texture_records = textureRecords(Image, Srgb);
+  auto texture = decode(AssetType::Texture, texture_records);
+  ASSERT_TRUE(texture);
+  EXPECT_EQ(std::get<TextureDescriptor>(texture->data_).image_path_, "textures/1.png");
+}
+
+TEST(DecodeAssetRecordTest, RejectsRecordsPastTheSection) {
+  auto records = textureRecords(Image, Srgb);
+  EXPECT_EQ(decodeError(AssetType::Texture, records, 8), Error::SchemaError);
+  EXPECT_EQ(decodeError(AssetType::Texture, records, records.size() + 8), Error::SchemaError);
+  EXPECT_EQ(decodeError(AssetType::Shader, {}), Error::SchemaError);
+  EXPECT_EQ(decodeError(static_cast<AssetType>(AssetTypeCount), records), Error::SchemaError);
+}
+
+TEST(DecodeAssetRecordTest, RejectsElementArraysPastTheSection) {
+  // the mask promises two stages, only one follows
+  EXPECT_EQ(
+      decodeError(
+          AssetType::Shader, shaderRecords({ stage(ShaderStage::Vertex, Vert, Meta) },
+                                           VertexAndFragment)),
+      Error::SchemaError);
+  EXPECT_EQ(decodeError(AssetType::Material, materialRecords(2, Albedo)), Error::SchemaError);
+  EXPECT_EQ(
+      decodeError(
+          AssetType::Material, materialRecords(std::numeric_limits<uint32_t>::max(), Albedo)),
+      Error::SchemaError);
+  EXPECT_EQ(decodeError(AssetType::Mesh, meshRecords(2, Source, Body)), Error::SchemaError);
+}
+
+TEST(DecodeAssetRecordTest, RejectsStringsPastTheSection) {
+  for (auto bad : { PastTheEnd, Wrapping }) {
+    EXPECT_EQ(
+        decodeError(
+            AssetType::Shader, shaderRecords({ stage(ShaderStage::Vertex, Vert, bad) },
+                                             static_cast<uint32_t>(ShaderStage::Vertex))),
+        Error::SchemaError);
+    EXPECT_EQ(decodeError(AssetType::Material, materialRecords(1, bad)), Error::SchemaError);
+    EXPECT_EQ(decodeError(AssetType::Mesh, meshRecords(1, bad, Body)), Error::SchemaError);
+    EXPECT_EQ(decodeError(AssetType::Mesh, meshRecords(1, Source, bad)), Error::SchemaError);
+    EXPECT_EQ(decodeError(AssetType::Texture, textureRecords(Image, bad)), Error::SchemaError);
+  }
+}
+
+TEST(DecodeAssetRecordTest, RejectsMismatchedShaderStages) {
+  // stage records out of bit order
+  EXPECT_EQ(
+      decodeError(
+          AssetType::Shader,
+          shaderRecords(
+              { stage(ShaderStage::Fragment, Frag, Meta), stage(ShaderStage::Vertex, Vert, Meta) },
+              VertexAndFragment)),
+      Error::SchemaError);
+  // a mask bit beyond any stage
+  EXPECT_EQ(decodeError(AssetType::Shader, shaderRecords({}, 1U << 12U)), Error::SchemaError);
+}
+
+// A one-texture image: header, index, records, no dependencies, strings.
+class AssetDatabaseImageTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    header_ = { .magic_ = AssetDatabase::Magic,
+                .version_ = AssetDatabase::Version,
+                .asset_count_ = 1,
+                .index_offset_ = sizeof(AssetDatabaseHeader),
+                .records_offset_ = sizeof(AssetDatabaseHeader) + sizeof(AssetIndexRecord),
+                .records_size_ = sizeof(TextureRecord),
+                .strings_offset_ = sizeof(AssetDatabaseHeader) + sizeof(AssetIndexRecord) +
+                                   sizeof(TextureRecord),
+                .strings_size_ = Strings.size(),
+                .dependencies_offset_ = sizeof(AssetDatabaseHeader),
+                .dependency_count_ = 0 };
+    index_ = { .id_ = 1,
+               .record_offset_ = 0,
+               .type_ = static_cast<uint8_t>(AssetType::Texture),
+               .padding_ = {},
+               .first_dependency_ = 0,
+               .dependency_count_ = 0 };
+  }
+
+  [[nodiscard]] auto image() const -> std::vector<std::byte> {
+    std::vector<std::byte> bytes;
+    append(bytes, header_);
+    append(bytes, index_);
+    for (auto byte : textureRecords(Image, Srgb)) {
+      bytes.push_back(byte);
+    }
+    for (auto character : Strings) {
+      bytes.push_back(static_cast<std::byte>(character));
+    }
+    return bytes;
+  }
+
+  [[nodiscard]] auto bindError() const -> std::error_code {
+    auto database = AssetDatabase::fromImage(image());
+    return database ? std::error_code{} : database.error();
+  }
+
+  AssetDatabaseHeader header_{};
+  AssetIndexRecord index_{};
+};
+
+TEST_F(AssetDatabaseImageTest, BindsAValidImage) {
+  auto database = AssetDatabase::fromImage(image());
+  ASSERT_TRUE(database);
+  auto texture = database->find(1);
+  ASSERT_TRUE(texture);
+  EXPECT_EQ(std::get<TextureDescriptor>(texture->data_).color_space_, "srgb");
+  EXPECT_EQ(database->find(2).error(), Error::NotFoundError);
+}
+
+TEST_F(AssetDatabaseImageTest, RejectsAForeignHeader) {
+  EXPECT_EQ(AssetDatabase::fromImage({}).error(), Error::SchemaError);
+
+  header_.magic_[0] = 'X';
+  EXPECT_EQ(bindError(), Error::SchemaError);
+
+  SetUp();
+  header_.version_ = AssetDatabase::Version + 1;
+  EXPECT_EQ(bindError(), Error::FeatureNotSupported);
+}
+
+TEST_F(AssetDatabaseImageTest, RejectsSectionsPastTheImage) {
+  header_.asset_count_ = 1'000'000;
+  EXPECT_EQ(bindError(), Error::SchemaError);
+
+  SetUp();
+  header_.strings_size_ = Strings.size() + 1;
+  EXPECT_EQ(bindError(), Error::SchemaError);
+
+  SetUp();
+  header_.records_offset_ = std::numeric_limits<uint64_t>::max() - 4;
+  EXPECT_EQ(bindError(), Error::SchemaError);
+
+  SetUp();
+  header_.dependency_count_ = std::numeric_limits<uint64_t>::max() / sizeof(AssetId) + 1;
+  EXPECT_EQ(bindError(), Error::SchemaError);
+
+  SetUp();
+  header_.records_offset_ += 4;
+  header_.records_size_ -= 4;
+  EXPECT_EQ(bindError(), Error::SchemaError);
+}
+
+TEST_F(AssetDatabaseImageTest, RejectsIndexEntriesOutOfRange) {
+  index_.type_ = AssetTypeCount;
+  EXPECT_EQ(bindError(), Error::SchemaError);
+
+  SetUp();
+  index_.record_offset_ = sizeof(TextureRecord);
+  EXPECT_EQ(bindError(), Error::SchemaError);
+
+  SetUp();
+  index_.dependency_count_ = 1;
+  EXPECT_EQ(bindError(), Error::SchemaError);
+}
+
+}  // namespace
+
+}  // namespace gravity
@@ -0,0 +1,326 @@
+#include "source/rendering/common/asset_database.hpp"
+#include "source/rendering/common/asset_database_compiler.hpp"
+#include "source/rendering/common/asset_types.hpp"
+#include "source/rendering/common/json_asset_catalog.hpp"
+#include "source/rendering/common/synthetic_catalog.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <malloc.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+// Per-asset memory and lookup cost of the descriptor views against the heap-owning descriptors
+// they replaced, which are reproduced in `legacy` below and kept in an unordered_map by id the
+// way AssetManager used to.
+//
+//   BM_Footprint*  heap growth while the assets are loaded, divided by the asset count, measured
+//                  by counting every operator new in this binary. For the decoded JSON catalog
+//                  it is the growth of the first find of every asset, which lands in its Arena.
+//   BM_Lookup*     find a random id and read one field behind the descriptor, a stage path,
+//                  texture, submesh or image path depending on the type
+//
+// The argument is the number of assets, ids 1 to count of syntheticAssetJson().
+
+namespace {
+
+std::atomic<int64_t> heap_bytes{ 0 };
+std::atomic<int64_t> heap_allocations{ 0 };
+
+}  // namespace
+
+auto operator new(size_t size) -> void* {
+  auto* memory = std::malloc(size == 0 ? 1 : size);  // NOLINT
+  if (memory == nullptr) {
+    throw std::bad_alloc{};
+  }
+  heap_bytes.fetch_add(static_cast<int64_t>(malloc_usable_size(memory)), std::memory_order_relaxed);
+  heap_allocations.fetch_add(1, std::memory_order_relaxed);
+  return memory;
+}
+
+void operator delete(void* memory) noexcept {
+  if (memory != nullptr) {
+    heap_bytes.fetch_sub(
+        static_cast<int64_t>(malloc_usable_size(memory)), std::memory_order_relaxed);
+    std::free(memory);  // NOLINT
+  }
+}
+
+void operator delete(void* memory, size_t /*size*/) noexcept {
+  operator delete(memory);
+}
+
+namespace gravity {
+
+namespace {
+
+namespace legacy {
+
+struct ShaderStageDescriptor {
+  std::string spirv_path_;
+  std::string meta_path_;
+};
+
+struct ShaderDescriptor {
+  std::unordered_map<ShaderStage, ShaderStageDescriptor> stages_;
+};
+
+struct MaterialTextureDescriptor {
+  std::string name_;
+  AssetId texture_asset_;
+  SamplerType sampler_;
+};
+
+struct MaterialDescriptor {
+  std::vector<MaterialTextureDescriptor> textures_;
+};
+
+struct SubmeshDescriptor {
+  std::string name_;
+  int64_t first_index_;
+  int64_t index_count_;
+  AssetId material_asset_;
+};
+
+struct MeshDescriptor {
+  std::string source_;
+  std::vector<SubmeshDescriptor> submeshes_;
+};
+
+struct TextureDescriptor {
+  std::string image_path_;
+  std::string color_space_;
+
+  bool mipmaps_;
+};
+
+struct AssetDescriptor {
+  AssetType type;
+  std::variant<ShaderDescriptor, MaterialDescriptor, TextureDescriptor, MeshDescriptor> data_;
+};
+
+// the same asset syntheticAssetJson() describes
+auto makeAsset(AssetId id) -> AssetDescriptor {
+  auto key = std::to_string(id);
+  switch (id % 4) {
+    case 1:
+      return { .type = AssetType::Texture,
+               .data_ = TextureDescriptor{ .image_path_ = "textures/" + key + ".png",
+                                           .color_space_ = "srgb",
+                                           .mipmaps_ = true } };
+    case 2: {
+      MaterialDescriptor material;
+      material.textures_.push_back(
+          { .name_ = "albedo", .texture_asset_ = id - 1, .sampler_ = SamplerType::LinearWrap });
+      return { .type = AssetType::Material, .data_ = std::move(material) };
+    }
+    case 3: {
+      MeshDescriptor mesh{ .source_ = "meshes/" + key + ".gltf", .submeshes_ = {} };
+      mesh.submeshes_.push_back(
+          { .name_ = "body", .first_index_ = 0, .index_count_ = 36, .material_asset_ = id - 1 });
+      return { .type = AssetType::Mesh, .data_ = std::move(mesh) };
+    }
+    default: {
+      ShaderDescriptor shader;
+      shader.stages_[ShaderStage::Vertex] = { .spirv_path_ = "shaders/" + key + ".vert.spv",
+                                              .meta_path_ = "shaders/" + key + ".vert.json" };
+      shader.stages_[ShaderStage::Fragment] = { .spirv_path_ = "shaders/" + key + ".frag.spv",
+                                                .meta_path_ = "shaders/" + key + ".frag.json" };
+      return { .type = AssetType::Shader, .data_ = std::move(shader) };
+    }
+  }
+}
+
+auto touch(const AssetDescriptor& asset) -> int64_t {
+  switch (asset.type) {
+    case AssetType::Shader: {
+      const auto& stages = std::get<ShaderDescriptor>(asset.data_).stages_;
+      return static_cast<int64_t>(stages.at(ShaderStage::Vertex).spirv_path_.size());
+    }
+    case AssetType::Texture:
+      return static_cast<int64_t>(std::get<TextureDescriptor>(asset.data_).image_path_.size());
+    case AssetType::Mesh:
+      return std::get<MeshDescriptor>(asset.data_).submeshes_[0].index_count_;
+    case AssetType::Material:
+      return std::get<MaterialDescriptor>(asset.data_).textures_[0].texture_asset_;
+  }
+  return 0;
+}
+
+}  // namespace legacy
+
+auto touch(const AssetDescriptor& asset) -> int64_t {
+  switch (asset.type) {
+    case AssetType::Shader:
+      return static_cast<int64_t>(
+          std::get<ShaderDescriptor>(asset.data_).find(ShaderStage::Vertex)->spirv_path_.size());
+    case AssetType::Texture:
+      return static_cast<int64_t>(std::get<TextureDescriptor>(asset.data_).image_path_.size());
+    case AssetType::Mesh:
+      return std::get<MeshDescriptor>(asset.data_).submesh(0).index_count_;
+    case AssetType::Material:
+      return std::get<MaterialDescriptor>(asset.data_).texture(0).texture_asset_;
+  }
+  return 0;
+}
+
+auto assetIds(const benchmark::State& state) -> std::vector<AssetId> {
+  std::vector<AssetId> ids(static_cast<size_t>(state.range(0)));
+  std::ranges::generate(ids, [id = AssetId{ 0 }]() mutable { return ++id; });
+  return ids;
+}
+
+auto shuffled(std::vector<AssetId> ids) -> std::vector<AssetId> {
+  std::ranges::shuffle(ids, std::mt19937_64{ 42 });
+  return ids;
+}
+
+class HeapGrowth {
+ public:
+  HeapGrowth()
+      : bytes_{ heap_bytes.load(std::memory_order_relaxed) },
+        allocations_{ heap_allocations.load(std::memory_order_relaxed) } {}
+
+  void report(benchmark::State& state, size_t assets) const {
+    auto count = static_cast<double>(assets);
+    state.counters["bytes_per_asset"] =
+        static_cast<double>(heap_bytes.load(std::memory_order_relaxed) - bytes_) / count;
+    state.counters["allocations_per_asset"] =
+        static_cast<double>(heap_allocations.load(std::memory_order_relaxed) - allocations_) /
+        count;
+  }
+
+ private:
+  int64_t bytes_;
+  int64_t allocations_;
+};
+
+void BM_FootprintLegacy(benchmark::State& state) {
+  auto ids = assetIds(state);
+
+  for (auto _ : state) {
+    HeapGrowth growth;
+    std::unordered_map<AssetId, legacy::AssetDescriptor> assets;
+    for (auto id : ids) {
+      assets.emplace(id, legacy::makeAsset(id));
+    }
+    growth.report(state, ids.size());
+  }
+}
+
+void BM_FootprintCompiled(benchmark::State& state) {
+  auto ids = assetIds(state);
+  auto json = syntheticCatalogJson(ids);
+
+  for (auto _ : state) {
+    // the parse is freed again, what remains is the image
+    HeapGrowth growth;
+    auto image = compileAssetDatabase(json);
+    if (!image) {
+      state.SkipWithError("compiling the catalog failed");
+      return;
+    }
+    auto database = AssetDatabase::fromImage(std::move(*image));
+    growth.report(state, ids.size());
+    benchmark::DoNotOptimize(database);
+  }
+}
+
+void BM_FootprintJsonDecoded(benchmark::State& state) {
+  auto ids = assetIds(state);
+  auto json = syntheticCatalogJson(ids);
+
+  for (auto _ : state) {
+    auto catalog = JsonAssetCatalog::build(json);
+    if (!catalog) {
+      state.SkipWithError("indexing the catalog failed");
+      return;
+    }
+
+    HeapGrowth growth;
+    for (auto id : ids) {
+      benchmark::DoNotOptimize((*catalog)->find(id));
+    }
+    growth.report(state, ids.size());
+    state.counters["arena_bytes_per_asset"] =
+        static_cast<double>((*catalog)->decodedBytes()) / static_cast<double>(ids.size());
+  }
+}
+
+void BM_LookupLegacy(benchmark::State& state) {
+  auto ids = assetIds(state);
+
+  std::unordered_map<AssetId, legacy::AssetDescriptor> assets;
+  for (auto id : ids) {
+    assets.emplace(id, legacy::makeAsset(id));
+  }
+
+  auto order = shuffled(ids);
+  size_t cursor{ 0 };
+  for (auto _ : state) {
+    auto iterator = assets.find(order[cursor++ % order.size()]);
+    benchmark::DoNotOptimize(legacy::touch(iterator->second));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+template <typename Catalog>
+void lookup(benchmark::State& state, const Catalog& catalog, const std::vector<AssetId>& order) {
+  size_t cursor{ 0 };
+  for (auto _ : state) {
+    auto asset = catalog.find(order[cursor++ % order.size()]);
+    benchmark::DoNotOptimize(touch(*asset));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+void BM_LookupCompiled(benchmark::State& state) {
+  auto ids = assetIds(state);
+  auto image = compileAssetDatabase(syntheticCatalogJson(ids));
+  auto database = image ? AssetDatabase::fromImage(std::move(*image))
+                        : std::unexpected(image.error());
+  if (!database) {
+    state.SkipWithError("compiling the catalog failed");
+    return;
+  }
+  lookup(state, *database, shuffled(ids));
+}
+
+void BM_LookupJsonDecoded(benchmark::State& state) {
+  auto ids = assetIds(state);
+  auto catalog = JsonAssetCatalog::build(syntheticCatalogJson(ids));
+  if (!catalog) {
+    state.SkipWithError("indexing the catalog failed");
+    return;
+  }
+  for (auto id : ids) {
+    benchmark::DoNotOptimize((*catalog)->find(id));
+  }
+  lookup(state, **catalog, shuffled(ids));
+}
+
+void catalogSizes(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgName("assets")->Arg(10'000)->Arg(200'000);
+}
+
+BENCHMARK(BM_FootprintLegacy)->Apply(catalogSizes)->Iterations(1);
+BENCHMARK(BM_FootprintCompiled)->Apply(catalogSizes)->Iterations(1);
+BENCHMARK(BM_FootprintJsonDecoded)->Apply(catalogSizes)->Iterations(1);
+BENCHMARK(BM_LookupLegacy)->Apply(catalogSizes);
+BENCHMARK(BM_LookupCompiled)->Apply(catalogSizes);
+BENCHMARK(BM_LookupJsonDecoded)->Apply(catalogSizes);
+
+}  // namespace
+
+}  // namespace gravity
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+namespace gravity {
+
+// On-disk layout of a compiled asset database. The image is a header followed by four sections:
+//
+//   index         AssetIndexRecord[asset_count_], sorted by id
+//   records       one record per asset, 8 byte aligned, optionally followed by its element array
+//   dependencies  int64_t asset ids, each asset's direct dependencies sorted and deduplicated
+//   strings       deduplicated path and name bytes, referenced by (offset, size), not null
+//                 terminated
+//
+// All integers are little endian and every record is trivially copyable, so a mapped image is
+// read in place without a decoding step.
+
+struct AssetStringRecord {
+  uint32_t offset_;
+  uint32_t size_;
+};
+
+struct AssetDatabaseHeader {
+  std::array<char, 8> magic_;
+  uint32_t version_;
+  uint32_t asset_count_;
+  uint64_t index_offset_;
+  uint64_t records_offset_;
+  uint64_t records_size_;
+  uint64_t strings_offset_;
+  uint64_t strings_size_;
+  uint64_t dependencies_offset_;
+  uint64_t dependency_count_;
+};
+
+struct AssetIndexRecord {
+  int64_t id_;
+  // relative to the records section
+  uint32_t record_offset_;
+  uint8_t type_;
+  std::array<uint8_t, 3> padding_;
+  // range of the dependencies section
+  uint32_t first_dependency_;
+  uint32_t dependency_count_;
+};
+
+struct ShaderStageRecord {
+  AssetStringRecord spirv_path_;
+  AssetStringRecord meta_path_;
+  uint8_t stage_;
+  std::array<uint8_t, 7> padding_;
+};
+
+// Followed by one ShaderStageRecord per bit set in stage_mask_, in bit order: the record of a
+// stage is found by counting the stages below it instead of searching.
+struct ShaderRecord {
+  uint32_t stage_mask_;
+  uint32_t padding_;
+};
+
+struct MaterialTextureRecord {
+  AssetStringRecord name_;
+  int64_t texture_asset_;
+  uint8_t sampler_;
+  std::array<uint8_t, 7> padding_;
+};
+
+// followed by texture_count_ MaterialTextureRecord
+struct MaterialRecord {
+  uint32_t texture_count_;
+  uint32_t padding_;
+};
+
+struct SubmeshRecord {
+  AssetStringRecord name_;
+  int64_t first_index_;
+  int64_t index_count_;
+  int64_t material_asset_;
+};
+
+// followed by submesh_count_ SubmeshRecord
+struct MeshRecord {
+  AssetStringRecord source_;
+  uint32_t submesh_count_;
+  uint32_t padding_;
+};
+
+struct TextureRecord {
+  AssetStringRecord image_path_;
+  AssetStringRecord color_space_;
+  uint8_t mipmaps_;
+  std::array<uint8_t, 7> padding_;
+};
+
+constexpr size_t AssetRecordAlignment = 8;
+
+static_assert(
+    std::is_trivially_copyable_v<AssetDatabaseHeader> && sizeof(AssetDatabaseHeader) == 72);
+static_assert(std::is_trivially_copyable_v<AssetIndexRecord> && sizeof(AssetIndexRecord) == 24);
+static_assert(sizeof(ShaderStageRecord) == 24 && sizeof(ShaderRecord) == 8);
+static_assert(sizeof(MaterialTextureRecord) == 24 && sizeof(MaterialRecord) == 8);
+static_assert(sizeof(SubmeshRecord) == 32 && sizeof(MeshRecord) == 16);
+static_assert(sizeof(TextureRecord) == 24);
+
+// Resolves a string reference against the strings section, the caller has checked its bounds.
+inline auto resolveAssetString(std::string_view strings, AssetStringRecord record)
+    -> std::string_view {
+  return strings.substr(record.offset_, record.size_);
+}
+
+}  // namespace gravity
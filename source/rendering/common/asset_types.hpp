@@ -1,17 +1,19 @@
 #pragma once
 
 #include "source/common/error.hpp"
+#include "source/rendering/common/asset_records.hpp"
 #include "source/rendering/common/rendering_type.hpp"
 
+#include <bit>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <expected>
-#include <string>
+#include <optional>
+#include <span>
 #include <string_view>
 #include <system_error>
-#include <unordered_map>
 #include <variant>
-#include <vector>
 
 namespace gravity {
 
@@ -19,6 +21,8 @@ using AssetId = int64_t;
 
 enum class AssetType : uint8_t { Shader, Texture, Mesh, Material };
 
+constexpr size_t AssetTypeCount{ 4 };
+
 inline auto assetTypeFromString(std::string_view str) -> std::expected<AssetType, std::error_code> {
   if (str == "shader") {
     return AssetType::Shader;
@@ -68,46 +72,113 @@ inline auto samplerTypeFromString(std::string_view str)
   return std::unexpected(Error::SchemaError);
 }
 
+// The descriptors below are views into a compiled asset database (see asset_records.hpp), they
+// are cheap to copy and stay valid until the catalog that returned them is released.
+
 struct ShaderStageDescriptor {
-  std::string spirv_path_;
-  std::string meta_path_;
+  std::string_view spirv_path_;
+  std::string_view meta_path_;
 };
 
-struct ShaderDescriptor {
-  std::unordered_map<ShaderStage, ShaderStageDescriptor> stages_;
+class ShaderDescriptor {
+ public:
+  ShaderDescriptor() = default;
+  ShaderDescriptor(
+      uint32_t stage_mask, std::span<const ShaderStageRecord> stages, std::string_view strings)
+      : stage_mask_{ stage_mask }, stages_{ stages }, strings_{ strings } {}
+
+  [[nodiscard]] auto find(ShaderStage stage) const -> std::optional<ShaderStageDescriptor> {
+    auto bit = static_cast<uint32_t>(stage);
+    if ((stage_mask_ & bit) == 0) {
+      return std::nullopt;
+    }
+
+    const auto& record = stages_[std::popcount(stage_mask_ & (bit - 1))];
+    return ShaderStageDescriptor{
+      .spirv_path_ = resolveAssetString(strings_, record.spirv_path_),
+      .meta_path_ = resolveAssetString(strings_, record.meta_path_),
+    };
+  }
+
+  [[nodiscard]] auto stageCount() const -> size_t { return stages_.size(); }
+
+ private:
+  uint32_t stage_mask_ = 0;
+  std::span<const ShaderStageRecord> stages_;
+  std::string_view strings_;
 };
 
 struct MaterialTextureDescriptor {
-  std::string name_;
+  std::string_view name_;
   AssetId texture_asset_;
   SamplerType sampler_;
 };
 
-struct MaterialDescriptor {
-  std::vector<MaterialTextureDescriptor> textures_;
+class MaterialDescriptor {
+ public:
+  MaterialDescriptor() = default;
+  MaterialDescriptor(std::span<const MaterialTextureRecord> textures, std::string_view strings)
+      : textures_{ textures }, strings_{ strings } {}
+
+  [[nodiscard]] auto textureCount() const -> size_t { return textures_.size(); }
+
+  [[nodiscard]] auto texture(size_t index) const -> MaterialTextureDescriptor {
+    assert(index < textures_.size());
+    const auto& record = textures_[index];
+    return { .name_ = resolveAssetString(strings_, record.name_),
+             .texture_asset_ = record.texture_asset_,
+             .sampler_ = static_cast<SamplerType>(record.sampler_) };
+  }
+
+ private:
+  std::span<const MaterialTextureRecord> textures_;
+  std::string_view strings_;
 };
 
 struct SubmeshDescriptor {
-  std::string name_;
+  std::string_view name_;
   int64_t first_index_;
   int64_t index_count_;
   AssetId material_asset_;
 };
 
-struct MeshDescriptor {
-  std::string source_;
-  std::vector<SubmeshDescriptor> submeshes_;
+class MeshDescriptor {
+ public:
+  MeshDescriptor() = default;
+  MeshDescriptor(
+      std::string_view source, std::span<const SubmeshRecord> submeshes, std::string_view strings)
+      : source_{ source }, submeshes_{ submeshes }, strings_{ strings } {}
+
+  [[nodiscard]] auto source() const -> std::string_view { return source_; }
+
+  [[nodiscard]] auto submeshCount() const -> size_t { return submeshes_.size(); }
+
+  [[nodiscard]] auto submesh(size_t index) const -> SubmeshDescriptor {
+    assert(index < submeshes_.size());
+    const auto& record = submeshes_[index];
+    return { .name_ = resolveAssetString(strings_, record.name_),
+             .first_index_ = record.first_index_,
+             .index_count_ = record.index_count_,
+             .material_asset_ = record.material_asset_ };
+  }
+
+ private:
+  std::string_view source_;
+  std::span<const SubmeshRecord> submeshes_;
+  std::string_view strings_;
 };
 
 struct TextureDescriptor {
-  std::string image_path_;
-  std::string color_space_;
+  std::string_view image_path_;
+  std::string_view color_space_;
 
   bool mipmaps_;
 };
 
 struct AssetDescriptor {
   AssetType type;
+  // dense per type, 0 <= index_ < AssetManager::getAssetCount(type), set by the AssetCatalog
+  uint32_t index_ = 0;
   std::variant<ShaderDescriptor, MaterialDescriptor, TextureDescriptor, MeshDescriptor> data_;
 };
 
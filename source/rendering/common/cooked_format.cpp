@@ -0,0 +1,163 @@
+#include "cooked_format.hpp"
+
+#include "source/common/error.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+namespace gravity {
+
+namespace {
+
+auto regionFits(uint64_t offset, uint64_t size, size_t total) -> bool {
+  return offset <= total && size <= total - offset;
+}
+
+template <typename Record>
+auto viewAs(std::span<const std::byte> bytes, size_t count) -> std::span<const Record> {
+  // cooked records are trivially copyable and kept aligned, they are used in place
+  return { reinterpret_cast<const Record*>(bytes.data()), count };  // NOLINT
+}
+
+// kind header at the start of data_, followed by count records
+template <typename Header, typename Record>
+auto headerAndRecords(std::span<const std::byte> data, uint32_t Header::* count_field)
+    -> std::expected<std::pair<const Header*, std::span<const Record>>, std::error_code> {
+  if (data.size() < sizeof(Header)) {
+    return std::unexpected(Error::SchemaError);
+  }
+  const auto* header = viewAs<Header>(data, 1).data();
+  auto count = header->*count_field;
+  if (count > (data.size() - sizeof(Header)) / sizeof(Record)) {
+    return std::unexpected(Error::SchemaError);
+  }
+  return std::pair{ header, viewAs<Record>(data.subspan(sizeof(Header)), count) };
+}
+
+}  // namespace
+
+auto isCookedResource(std::span<const std::byte> data) -> bool {
+  return data.size() >= sizeof(CookedMagic) &&
+         std::ranges::equal(
+             data.first(sizeof(CookedMagic)), std::as_bytes(std::span{ CookedMagic }));
+}
+
+auto parseCookedResource(std::span<const std::byte> data)
+    -> std::expected<CookedResource, std::error_code> {
+  if (data.size() < sizeof(CookedFileHeader) ||
+      reinterpret_cast<uintptr_t>(data.data()) % alignof(CookedFileHeader) != 0) {  // NOLINT
+    return std::unexpected(Error::SchemaError);
+  }
+
+  const auto* header = viewAs<CookedFileHeader>(data, 1).data();
+  if (header->magic_ != CookedMagic) {
+    return std::unexpected(Error::SchemaError);
+  }
+  if (header->version_ != CookedVersion) {
+    return std::unexpected(Error::FeatureNotSupported);
+  }
+  if (header->kind_ != CookedKind::Image && header->kind_ != CookedKind::Mesh) {
+    return std::unexpected(Error::SchemaError);
+  }
+  if (header->payload_offset_ < sizeof(CookedFileHeader) ||
+      header->payload_offset_ % CookedPayloadAlignment != 0 ||
+      !regionFits(header->payload_offset_, header->payload_size_, data.size())) {
+    return std::unexpected(Error::SchemaError);
+  }
+
+  return CookedResource{
+    .header_ = header,
+    .data_ = data.subspan(sizeof(CookedFileHeader)),
+    .payload_ = data.subspan(header->payload_offset_, header->payload_size_),
+  };
+}
+
+auto cookedImage(const CookedResource& resource) -> std::expected<CookedImage, std::error_code> {
+  if (resource.header_->kind_ != CookedKind::Image) {
+    return std::unexpected(Error::InvalidArgumentError);
+  }
+
+  auto parsed = headerAndRecords<CookedImageHeader, CookedMipRecord>(
+      resource.data_, &CookedImageHeader::mip_count_);
+  if (!parsed) {
+    return std::unexpected(parsed.error());
+  }
+
+  auto [header, mips] = *parsed;
+  if (mips.empty()) {
+    return std::unexpected(Error::SchemaError);
+  }
+  for (const auto& mip : mips) {
+    if (mip.offset_ % CookedRegionAlignment != 0 ||
+        !regionFits(mip.offset_, mip.size_, resource.payload_.size()) ||
+        mip.size_ != uint64_t{ mip.width_ } * mip.height_ * 4) {
+      return std::unexpected(Error::SchemaError);
+    }
+  }
+
+  return CookedImage{ .header_ = header, .mips_ = mips, .payload_ = resource.payload_ };
+}
+
+auto cookedMesh(const CookedResource& resource) -> std::expected<CookedMesh, std::error_code> {
+  if (resource.header_->kind_ != CookedKind::Mesh) {
+    return std::unexpected(Error::InvalidArgumentError);
+  }
+
+  auto parsed = headerAndRecords<CookedMeshHeader, CookedSubmeshRecord>(
+      resource.data_, &CookedMeshHeader::submesh_count_);
+  if (!parsed) {
+    return std::unexpected(parsed.error());
+  }
+
+  auto [header, submeshes] = *parsed;
+  auto index_size = header->index_type_ == CookedIndexType::Uint16 ? sizeof(uint16_t)
+                    : header->index_type_ == CookedIndexType::Uint32 ? sizeof(uint32_t)
+                                                                      : 0;
+  auto vertex_bytes = uint64_t{ header->vertex_count_ } * header->vertex_stride_;
+  auto index_bytes = uint64_t{ header->index_count_ } * index_size;
+  if (index_size == 0 || header->vertex_stride_ != sizeof(CookedVertex) ||
+      header->vertex_offset_ % CookedRegionAlignment != 0 ||
+      header->index_offset_ % CookedRegionAlignment != 0 ||
+      !regionFits(header->vertex_offset_, vertex_bytes, resource.payload_.size()) ||
+      !regionFits(header->index_offset_, index_bytes, resource.payload_.size())) {
+    return std::unexpected(Error::SchemaError);
+  }
+  for (const auto& submesh : submeshes) {
+    if (!regionFits(submesh.first_index_, submesh.index_count_, header->index_count_)) {
+      return std::unexpected(Error::SchemaError);
+    }
+  }
+
+  return CookedMesh{
+    .header_ = header,
+    .submeshes_ = submeshes,
+    .vertices_ = resource.payload_.subspan(header->vertex_offset_, vertex_bytes),
+    .indices_ = resource.payload_.subspan(header->index_offset_, index_bytes),
+  };
+}
+
+auto assembleCookedFile(
+    CookedKind kind, HashType source_key, std::span<const std::byte> metadata,
+    std::span<const std::byte> payload) -> std::vector<std::byte> {
+  auto metadata_end = sizeof(CookedFileHeader) + metadata.size();
+  auto payload_offset =
+      (metadata_end + CookedPayloadAlignment - 1) / CookedPayloadAlignment * CookedPayloadAlignment;
+
+  CookedFileHeader header{ .magic_ = CookedMagic,
+                           .version_ = CookedVersion,
+                           .kind_ = kind,
+                           .padding_ = {},
+                           .source_key_ = source_key,
+                           .payload_offset_ = payload_offset,
+                           .payload_size_ = payload.size() };
+
+  std::vector<std::byte> file(payload_offset + payload.size());
+  std::memcpy(file.data(), &header, sizeof(header));
+  std::ranges::copy(metadata, file.begin() + sizeof(CookedFileHeader));
+  std::ranges::copy(payload, file.begin() + static_cast<ptrdiff_t>(payload_offset));
+  return file;
+}
+
+}  // namespace gravity
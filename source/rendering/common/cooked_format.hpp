@@ -0,0 +1,162 @@
+#pragma once
+
+#include "source/common/hash.hpp"
+#include "source/rendering/common/asset_types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+namespace gravity {
+
+// Layout of the GPU-ready payloads written by the cook tool. A cooked file is
+//
+//   CookedFileHeader | kind header | element records | padding | payload
+//
+// The payload starts on CookedPayloadAlignment and every region inside it (mip levels, vertex and
+// index streams) on CookedRegionAlignment, so it can be copied into staging memory as one block
+// and each region handed to the device by offset. All integers are little endian.
+//
+// The cooked file of "path/source.ext" is "path/source.ext.cooked".
+
+constexpr const char* CookedExtension{ ".cooked" };
+// The cook tool keeps the content hashes of the sources it read in "<first shard>.cookindex", a
+// loader opening it finds an unchanged source's key without reading the source.
+constexpr const char* CookIndexExtension{ ".cookindex" };
+constexpr std::array<char, 8> CookedMagic{ 'G', 'R', 'V', 'C', 'O', 'O', 'K', '1' };
+// bumped whenever the layout or a cooking step changes, older files are cooked again
+constexpr uint32_t CookedVersion{ 1 };
+
+constexpr size_t CookedPayloadAlignment{ 256 };
+constexpr size_t CookedRegionAlignment{ 16 };
+
+enum class CookedKind : uint8_t { Image = 1, Mesh };
+
+struct CookedFileHeader {
+  std::array<char, 8> magic_;
+  uint32_t version_;
+  CookedKind kind_;
+  std::array<uint8_t, 3> padding_;
+  // cookedSourceKey() of the source it was cooked from
+  HashType source_key_;
+  uint64_t payload_offset_;
+  uint64_t payload_size_;
+};
+
+// The one staleness rule shared by the cook tool and the loader: a cooked file is current while
+// its source_key_ equals the key of the source's content hash and the options it is cooked with.
+[[nodiscard]] constexpr auto cookedSourceKey(HashType content_hash, HashType options_key)
+    -> HashType {
+  return hashCombine(hashCombine(content_hash, CookedVersion), options_key);
+}
+
+// options key of an image, meshes have no options and use 0
+[[nodiscard]] constexpr auto cookedImageOptionsKey(bool srgb, bool mipmaps) -> HashType {
+  return (srgb ? 1U : 0U) | (mipmaps ? 2U : 0U);
+}
+
+// options key a texture's image is cooked with
+[[nodiscard]] constexpr auto cookedImageOptionsKey(const TextureDescriptor& texture) -> HashType {
+  return cookedImageOptionsKey(texture.color_space_ == "srgb", texture.mipmaps_);
+}
+
+enum class CookedImageFormat : uint8_t { Rgba8Unorm = 1, Rgba8Srgb };
+
+// followed by mip_count_ CookedMipRecord, largest level first
+struct CookedImageHeader {
+  uint32_t width_;
+  uint32_t height_;
+  uint32_t mip_count_;
+  CookedImageFormat format_;
+  std::array<uint8_t, 3> padding_;
+};
+
+struct CookedMipRecord {
+  // relative to the payload
+  uint64_t offset_;
+  uint64_t size_;
+  uint32_t width_;
+  uint32_t height_;
+};
+
+enum class CookedIndexType : uint8_t { Uint16 = 1, Uint32 };
+
+// followed by submesh_count_ CookedSubmeshRecord
+struct CookedMeshHeader {
+  uint32_t vertex_count_;
+  uint32_t index_count_;
+  uint32_t vertex_stride_;
+  uint32_t submesh_count_;
+  // relative to the payload
+  uint64_t vertex_offset_;
+  uint64_t index_offset_;
+  std::array<float, 3> bounds_min_;
+  std::array<float, 3> bounds_max_;
+  CookedIndexType index_type_;
+  std::array<uint8_t, 7> padding_;
+};
+
+struct CookedSubmeshRecord {
+  uint32_t first_index_;
+  uint32_t index_count_;
+  // index of the material slot in the source model
+  uint32_t material_index_;
+  uint32_t padding_;
+};
+
+// Interleaved vertex stream: the normal is octahedron encoded into two snorm16 values.
+struct CookedVertex {
+  std::array<float, 3> position_;
+  std::array<int16_t, 2> normal_;
+  std::array<float, 2> uv_;
+};
+
+static_assert(std::is_trivially_copyable_v<CookedFileHeader> && sizeof(CookedFileHeader) == 40);
+static_assert(sizeof(CookedImageHeader) == 16 && sizeof(CookedMipRecord) == 24);
+static_assert(sizeof(CookedMeshHeader) == 64 && sizeof(CookedSubmeshRecord) == 16);
+static_assert(sizeof(CookedVertex) == 24);
+
+struct CookedImage {
+  const CookedImageHeader* header_;
+  std::span<const CookedMipRecord> mips_;
+  std::span<const std::byte> payload_;
+};
+
+struct CookedMesh {
+  const CookedMeshHeader* header_;
+  std::span<const CookedSubmeshRecord> submeshes_;
+  std::span<const std::byte> vertices_;
+  std::span<const std::byte> indices_;
+};
+
+// Validated view of a cooked file, pointing into the bytes it was parsed from. Those must start
+// on an 8 byte boundary.
+struct CookedResource {
+  const CookedFileHeader* header_;
+  // everything after the file header, kind headers and records included
+  std::span<const std::byte> data_;
+  std::span<const std::byte> payload_;
+};
+
+// Checks the header and that the payload lies inside data; the kind specific parts are checked by
+// cookedImage() and cookedMesh().
+auto parseCookedResource(std::span<const std::byte> data)
+    -> std::expected<CookedResource, std::error_code>;
+
+auto cookedImage(const CookedResource& resource) -> std::expected<CookedImage, std::error_code>;
+auto cookedMesh(const CookedResource& resource) -> std::expected<CookedMesh, std::error_code>;
+
+// Lays out a cooked file from the kind header with its records and an already laid out payload.
+auto assembleCookedFile(
+    CookedKind kind, HashType source_key, std::span<const std::byte> metadata,
+    std::span<const std::byte> payload) -> std::vector<std::byte>;
+
+// Cheap check of the leading bytes, no bounds validation.
+auto isCookedResource(std::span<const std::byte> data) -> bool;
+
+}  // namespace gravity
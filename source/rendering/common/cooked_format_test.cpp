@@ -0,0 +1,260 @@
+#include "source/rendering/common/cooked_format.hpp"
+
+#include "source/common/error.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+namespace gravity {
+
+namespace {
+
+template <typename T>
+void append(std::vector<std::byte>& bytes, const T& value) {
+  auto size = bytes.size();
+  bytes.resize(size + sizeof(T));
+  std::memcpy(bytes.data() + size, &value, sizeof(T));
+}
+
+template <typename T>
+void overwrite(std::vector<std::byte>& bytes, size_t offset, const T& value) {
+  std::memcpy(bytes.data() + offset, &value, sizeof(T));
+}
+
+auto fileHeader(const std::vector<std::byte>& file) -> CookedFileHeader {
+  CookedFileHeader header{};
+  std::memcpy(&header, file.data(), sizeof(header));
+  return header;
+}
+
+// a 4x4 image with its 2x2 mip
+auto imageFile(std::vector<CookedMipRecord> mips = { { .offset_ = 0,
+                                                       .size_ = 64,
+                                                       .width_ = 4,
+                                                       .height_ = 4 },
+                                                     { .offset_ = 64,
+                                                       .size_ = 16,
+                                                       .width_ = 2,
+                                                       .height_ = 2 } })
+    -> std::vector<std::byte> {
+  std::vector<std::byte> metadata;
+  append(metadata, CookedImageHeader{ .width_ = 4,
+                                      .height_ = 4,
+                                      .mip_count_ = static_cast<uint32_t>(mips.size()),
+                                      .format_ = CookedImageFormat::Rgba8Srgb,
+                                      .padding_ = {} });
+  for (const auto& mip : mips) {
+    append(metadata, mip);
+  }
+  std::vector<std::byte> payload(80, std::byte{ 0x7f });
+  return assembleCookedFile(CookedKind::Image, 42, metadata, payload);
+}
+
+// 3 vertices and 6 uint16 indices in two submeshes
+auto meshFile(CookedMeshHeader header, std::vector<CookedSubmeshRecord> submeshes)
+    -> std::vector<std::byte> {
+  header.submesh_count_ = static_cast<uint32_t>(submeshes.size());
+  std::vector<std::byte> metadata;
+  append(metadata, header);
+  for (const auto& submesh : submeshes) {
+    append(metadata, submesh);
+  }
+  std::vector<std::byte> payload(96, std::byte{ 0 });
+  return assembleCookedFile(CookedKind::Mesh, 7, metadata, payload);
+}
+
+auto meshHeader() -> CookedMeshHeader {
+  return { .vertex_count_ = 3,
+           .index_count_ = 6,
+           .vertex_stride_ = sizeof(CookedVertex),
+           .submesh_count_ = 0,
+           .vertex_offset_ = 0,
+           .index_offset_ = 80,
+           .bounds_min_ = {},
+           .bounds_max_ = {},
+           .index_type_ = CookedIndexType::Uint16,
+           .padding_ = {} };
+}
+
+auto twoSubmeshes() -> std::vector<CookedSubmeshRecord> {
+  return { { .first_index_ = 0, .index_count_ = 3, .material_index_ = 0, .padding_ = 0 },
+           { .first_index_ = 3, .index_count_ = 3, .material_index_ = 1, .padding_ = 0 } };
+}
+
+auto parseError(const std::vector<std::byte>& file) -> std::error_code {
+  auto resource = parseCookedResource(file);
+  return resource ? std::error_code{} : resource.error();
+}
+
+auto imageError(const std::vector<std::byte>& file) -> std::error_code {
+  auto resource = parseCookedResource(file);
+  if (!resource) {
+    return resource.error();
+  }
+  auto image = cookedImage(*resource);
+  return image ? std::error_code{} : image.error();
+}
+
+auto meshError(const std::vector<std::byte>& file) -> std::error_code {
+  auto resource = parseCookedResource(file);
+  if (!resource) {
+    return resource.error();
+  }
+  auto mesh = cookedMesh(*resource);
+  return mesh ? std::error_code{} : mesh.error();
+}
+
+TEST(CookedFormatTest, AssembledImageParses) {
+  auto file = imageFile();
+  EXPECT_TRUE(isCookedResource(file));
+  EXPECT_EQ(file.size() % CookedPayloadAlignment, 80U);
+
+  auto resource = parseCookedResource(file);
+  ASSERT_TRUE(resource);
+  EXPECT_EQ(resource->header_->source_key_, 42U);
+  EXPECT_EQ(resource->payload_.size(), 80U);
+
+  auto image = cookedImage(*resource);
+  ASSERT_TRUE(image);
+  ASSERT_EQ(image->mips_.size(), 2U);
+  EXPECT_EQ(image->mips_[1].width_, 2U);
+  EXPECT_EQ(cookedMesh(*resource).error(), Error::InvalidArgumentError);
+}
+
+TEST(CookedFormatTest, AssembledMeshParses) {
+  auto file = meshFile(meshHeader(), twoSubmeshes());
+  auto resource = parseCookedResource(file);
+  ASSERT_TRUE(resource);
+
+  auto mesh = cookedMesh(*resource);
+  ASSERT_TRUE(mesh);
+  EXPECT_EQ(mesh->submeshes_.size(), 2U);
+  EXPECT_EQ(mesh->vertices_.size(), 3 * sizeof(CookedVertex));
+  EXPECT_EQ(mesh->indices_.size(), 6 * sizeof(uint16_t));
+  EXPECT_EQ(cookedImage(*resource).error(), Error::InvalidArgumentError);
+}
+
+TEST(CookedFormatTest, RejectsShortOrMisalignedData) {
+  auto file = imageFile();
+  EXPECT_EQ(parseError({ file.begin(), file.begin() + sizeof(CookedFileHeader) - 1 }),
+            Error::SchemaError);
+
+  std::vector<std::byte> shifted(file.size() + 1);
+  std::memcpy(shifted.data() + 1, file.data(), file.size());
+  EXPECT_EQ(parseCookedResource(std::span{ shifted }.subspan(1)).error(), Error::SchemaError);
+}
+
+TEST(CookedFormatTest, RejectsForeignHeaders) {
+  auto file = imageFile();
+
+  auto bad_magic = file;
+  bad_magic[0] = std::byte{ 'X' };
+  EXPECT_FALSE(isCookedResource(bad_magic));
+  EXPECT_EQ(parseError(bad_magic), Error::SchemaError);
+
+  auto header = fileHeader(file);
+  auto old_version = file;
+  header.version_ = CookedVersion + 1;
+  overwrite(old_version, 0, header);
+  EXPECT_EQ(parseError(old_version), Error::FeatureNotSupported);
+
+  header = fileHeader(file);
+  auto unknown_kind = file;
+  header.kind_ = static_cast<CookedKind>(9);
+  overwrite(unknown_kind, 0, header);
+  EXPECT_EQ(parseError(unknown_kind), Error::SchemaError);
+}
+
+TEST(CookedFormatTest, RejectsPayloadOutsideTheFile) {
+  auto file = imageFile();
+
+  auto truncated = file;
+  truncated.pop_back();
+  EXPECT_EQ(parseError(truncated), Error::SchemaError);
+
+  auto header = fileHeader(file);
+  auto oversized = file;
+  header.payload_size_ = UINT64_MAX;
+  overwrite(oversized, 0, header);
+  EXPECT_EQ(parseError(oversized), Error::SchemaError);
+
+  header = fileHeader(file);
+  auto unaligned = file;
+  header.payload_offset_ += CookedRegionAlignment;
+  header.payload_size_ -= CookedRegionAlignment;
+  overwrite(unaligned, 0, header);
+  EXPECT_EQ(parseError(unaligned), Error::SchemaError);
+
+  header = fileHeader(file);
+  auto inside_header = file;
+  header.payload_offset_ = 0;
+  overwrite(inside_header, 0, header);
+  EXPECT_EQ(parseError(inside_header), Error::SchemaError);
+}
+
+TEST(CookedFormatTest, RejectsBadMipRecords) {
+  EXPECT_EQ(imageError(imageFile({})), Error::SchemaError);
+  // past the payload
+  EXPECT_EQ(imageError(imageFile({ { .offset_ = 32, .size_ = 64, .width_ = 4, .height_ = 4 } })),
+            Error::SchemaError);
+  // offset wraps around
+  EXPECT_EQ(
+      imageError(imageFile(
+          { { .offset_ = UINT64_MAX - 15, .size_ = 64, .width_ = 4, .height_ = 4 } })),
+      Error::SchemaError);
+  // size does not match the extent
+  EXPECT_EQ(imageError(imageFile({ { .offset_ = 0, .size_ = 64, .width_ = 8, .height_ = 8 } })),
+            Error::SchemaError);
+  // unaligned region
+  EXPECT_EQ(imageError(imageFile({ { .offset_ = 4, .size_ = 16, .width_ = 2, .height_ = 2 } })),
+            Error::SchemaError);
+
+  // more mip records than the metadata holds
+  auto file = imageFile();
+  CookedImageHeader header{};
+  std::memcpy(&header, file.data() + sizeof(CookedFileHeader), sizeof(header));
+  header.mip_count_ = 1'000'000;
+  overwrite(file, sizeof(CookedFileHeader), header);
+  EXPECT_EQ(imageError(file), Error::SchemaError);
+}
+
+TEST(CookedFormatTest, RejectsBadMeshLayouts) {
+  auto header = meshHeader();
+  header.vertex_stride_ = 16;
+  EXPECT_EQ(meshError(meshFile(header, twoSubmeshes())), Error::SchemaError);
+
+  header = meshHeader();
+  header.index_type_ = static_cast<CookedIndexType>(3);
+  EXPECT_EQ(meshError(meshFile(header, twoSubmeshes())), Error::SchemaError);
+
+  header = meshHeader();
+  header.vertex_count_ = 5;
+  EXPECT_EQ(meshError(meshFile(header, twoSubmeshes())), Error::SchemaError);
+
+  header = meshHeader();
+  header.index_offset_ = 88;
+  EXPECT_EQ(meshError(meshFile(header, twoSubmeshes())), Error::SchemaError);
+
+  header = meshHeader();
+  header.index_count_ = UINT32_MAX;
+  EXPECT_EQ(meshError(meshFile(header, twoSubmeshes())), Error::SchemaError);
+}
+
+TEST(CookedFormatTest, RejectsSubmeshesOutsideTheIndices) {
+  auto submeshes = twoSubmeshes();
+  submeshes[1].index_count_ = 4;
+  EXPECT_EQ(meshError(meshFile(meshHeader(), submeshes)), Error::SchemaError);
+
+  submeshes = twoSubmeshes();
+  submeshes[1].first_index_ = UINT32_MAX;
+  EXPECT_EQ(meshError(meshFile(meshHeader(), submeshes)), Error::SchemaError);
+}
+
+}  // namespace
+
+}  // namespace gravity
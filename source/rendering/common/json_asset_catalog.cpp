@@ -0,0 +1,426 @@
+#include "json_asset_catalog.hpp"
+
+#include "source/common/error.hpp"
+#include "source/common/logging/logger.hpp"
+#include "source/rendering/common/asset_database.hpp"
+#include "source/rendering/common/asset_database_compiler.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#undef GRAVITY_MODULE_NAME
+#define GRAVITY_MODULE_NAME "asset_database"
+
+namespace gravity {
+
+namespace {
+
+constexpr std::string_view IdKey{ "id" };
+constexpr std::string_view TypeKey{ "type" };
+constexpr std::string_view TexturesKey{ "textures" };
+constexpr std::string_view TextureAssetKey{ "asset" };
+constexpr std::string_view SubmeshesKey{ "submeshes" };
+constexpr std::string_view SubmeshMaterialKey{ "material" };
+
+// Just enough of a JSON tokenizer to walk the catalog's top level. Values that are not needed
+// for the index are skipped by matching brackets and strings, their contents are checked by the
+// full parser when the asset is decoded.
+class CatalogScanner {
+ public:
+  explicit CatalogScanner(std::string_view text) : text_{ text } {}
+
+  [[nodiscard]] auto position() const -> size_t { return position_; }
+
+  auto peek() -> char {
+    skipWhitespace();
+    return position_ < text_.size() ? text_[position_] : '\0';
+  }
+
+  auto consume(char expected) -> bool {
+    if (peek() != expected) {
+      return false;
+    }
+    ++position_;
+    return true;
+  }
+
+  // raw contents between the quotes, escapes are left as they are
+  auto scanString() -> std::optional<std::string_view> {
+    if (!consume('"')) {
+      return std::nullopt;
+    }
+
+    auto begin = position_;
+    while (position_ < text_.size()) {
+      auto character = text_[position_];
+      if (character == '\\') {
+        position_ += 2;
+        continue;
+      }
+      if (character == '"') {
+        return text_.substr(begin, position_++ - begin);
+      }
+      ++position_;
+    }
+    return std::nullopt;
+  }
+
+  auto scanInteger() -> std::optional<int64_t> {
+    skipWhitespace();
+
+    int64_t value = 0;
+    const auto* begin = text_.data() + position_;
+    auto [end, error] = std::from_chars(begin, text_.data() + text_.size(), value);
+    if (error != std::errc{} || end == begin) {
+      return std::nullopt;
+    }
+    position_ = static_cast<size_t>(end - text_.data());
+
+    // 1.5 or 1e3 are numbers but not the integer the schema asks for
+    if (position_ < text_.size() && (text_[position_] == '.' || text_[position_] == 'e' ||
+                                     text_[position_] == 'E')) {
+      return std::nullopt;
+    }
+    return value;
+  }
+
+  auto skipValue() -> bool {
+    auto character = peek();
+    if (character == '"') {
+      return scanString().has_value();
+    }
+
+    if (character == '{' || character == '[') {
+      size_t depth = 0;
+      while (position_ < text_.size()) {
+        character = text_[position_];
+        if (character == '"') {
+          if (!scanString()) {
+            return false;
+          }
+          continue;
+        }
+
+        ++position_;
+        if (character == '{' || character == '[') {
+          ++depth;
+        } else if ((character == '}' || character == ']') && --depth == 0) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    auto begin = position_;
+    while (position_ < text_.size() && !isDelimiter(text_[position_])) {
+      ++position_;
+    }
+    return position_ != begin;
+  }
+
+ private:
+  std::string_view text_;
+  size_t position_ = 0;
+
+  static auto isDelimiter(char character) -> bool {
+    return character == ',' || character == ']' || character == '}' || character == ' ' ||
+           character == '\t' || character == '\n' || character == '\r';
+  }
+
+  void skipWhitespace() {
+    while (position_ < text_.size() && (text_[position_] == ' ' || text_[position_] == '\t' ||
+                                        text_[position_] == '\n' || text_[position_] == '\r')) {
+      ++position_;
+    }
+  }
+};
+
+struct ScannedAsset {
+  std::optional<AssetId> id_;
+  std::optional<AssetType> type_;
+  // referenced asset ids, which list is a dependency depends on the type
+  std::vector<AssetId>* textures_;
+  std::vector<AssetId>* materials_;
+};
+
+// Collects the integer `field` of every object in an array of objects. Anything that does not
+// fit is skipped, the full parser reports it when the asset is decoded.
+auto scanReferences(CatalogScanner& scanner, std::string_view field, std::vector<AssetId>& out)
+    -> bool {
+  if (scanner.peek() != '[') {
+    return scanner.skipValue();
+  }
+  scanner.consume('[');
+  if (scanner.consume(']')) {
+    return true;
+  }
+
+  do {
+    if (!scanner.consume('{')) {
+      if (!scanner.skipValue()) {
+        return false;
+      }
+      continue;
+    }
+    if (scanner.consume('}')) {
+      continue;
+    }
+
+    do {
+      auto key = scanner.scanString();
+      if (!key || !scanner.consume(':')) {
+        return false;
+      }
+
+      std::optional<int64_t> reference;
+      if (*key == field) {
+        reference = scanner.scanInteger();
+      }
+      if (reference) {
+        out.push_back(*reference);
+      } else if (!scanner.skipValue()) {
+        return false;
+      }
+    } while (scanner.consume(','));
+
+    if (!scanner.consume('}')) {
+      return false;
+    }
+  } while (scanner.consume(','));
+
+  return scanner.consume(']');
+}
+
+auto scanAsset(CatalogScanner& scanner, ScannedAsset& asset) -> std::error_code {
+
+  if (!scanner.consume('{')) {
+    return Error::SchemaError;
+  }
+  if (scanner.consume('}')) {
+    return Error::OK;
+  }
+
+  do {
+    auto key = scanner.scanString();
+    if (!key || !scanner.consume(':')) {
+      return Error::SchemaError;
+    }
+
+    if (*key == IdKey) {
+      asset.id_ = scanner.scanInteger();
+      if (!asset.id_) {
+        return Error::SchemaError;
+      }
+    } else if (*key == TypeKey) {
+      auto type = scanner.scanString();
+      if (!type) {
+        return Error::SchemaError;
+      }
+      auto asset_type = assetTypeFromString(*type);
+      if (!asset_type) {
+        LOG_ERROR("invalid asset type; type: {}", *type);
+        return asset_type.error();
+      }
+      asset.type_ = *asset_type;
+    } else if (*key == TexturesKey) {
+      if (!scanReferences(scanner, TextureAssetKey, *asset.textures_)) {
+        return Error::SchemaError;
+      }
+    } else if (*key == SubmeshesKey) {
+      if (!scanReferences(scanner, SubmeshMaterialKey, *asset.materials_)) {
+        return Error::SchemaError;
+      }
+    } else if (!scanner.skipValue()) {
+      return Error::SchemaError;
+    }
+  } while (scanner.consume(','));
+
+  if (!scanner.consume('}')) {
+    return Error::SchemaError;
+  }
+  return Error::OK;
+}
+
+}  // namespace
+
+auto JsonAssetCatalog::open(const std::string& path)
+    -> std::expected<std::unique_ptr<JsonAssetCatalog>, std::error_code> {
+  std::ifstream input{ path, std::ios::binary };
+  if (!input) {
+    LOG_ERROR("unable to open asset catalog; path: {}", path);
+    return std::unexpected(Error::NotFoundError);
+  }
+  std::string json{ std::istreambuf_iterator<char>{ input }, std::istreambuf_iterator<char>{} };
+  if (input.bad()) {
+    LOG_ERROR("unable to read asset catalog; path: {}", path);
+    return std::unexpected(Error::UnavailableError);
+  }
+
+  auto catalog = build(std::move(json));
+  if (!catalog) {
+    LOG_ERROR("unable to index asset catalog; path: {}", path);
+  }
+  return catalog;
+}
+
+auto JsonAssetCatalog::build(std::string json)
+    -> std::expected<std::unique_ptr<JsonAssetCatalog>, std::error_code> {
+  std::unique_ptr<JsonAssetCatalog> catalog{ new JsonAssetCatalog{} };
+  catalog->json_ = std::move(json);
+  catalog->text_ = catalog->json_;
+
+  if (auto error = catalog->index(); error) {
+    return std::unexpected(error);
+  }
+  return catalog;
+}
+
+auto JsonAssetCatalog::index() -> std::error_code {
+  CatalogScanner scanner{ text_ };
+  if (!scanner.consume('[')) {
+    LOG_ERROR("asset database is not valid");
+    return Error::SchemaError;
+  }
+
+  // scratch lists reused across entries
+  std::vector<AssetId> textures;
+  std::vector<AssetId> materials;
+
+  if (!scanner.consume(']')) {
+    do {
+      if (scanner.peek() != '{') {
+        // entries that are not objects were never assets, they are skipped
+        if (!scanner.skipValue()) {
+          LOG_ERROR("asset database is not valid json; offset: {}", scanner.position());
+          return Error::SchemaError;
+        }
+        continue;
+      }
+
+      auto begin = scanner.position();
+      textures.clear();
+      materials.clear();
+      ScannedAsset asset{ .id_ = std::nullopt,
+                          .type_ = std::nullopt,
+                          .textures_ = &textures,
+                          .materials_ = &materials };
+      if (auto error = scanAsset(scanner, asset); error) {
+        LOG_ERROR("asset database is not valid json; offset: {}", scanner.position());
+        return error;
+      }
+      if (!asset.id_ || !asset.type_) {
+        LOG_ERROR("asset is missing its id or type; offset: {}", begin);
+        return Error::SchemaError;
+      }
+
+      auto size = scanner.position() - begin;
+      auto first_dependency = dependencies_.size();
+      if (size > std::numeric_limits<uint32_t>::max() ||
+          first_dependency > std::numeric_limits<uint32_t>::max()) {
+        return Error::FailedPreconditionError;
+      }
+
+      // same edges as the compiled database: materials reference textures, meshes materials
+      if (*asset.type_ == AssetType::Material) {
+        dependencies_.insert(dependencies_.end(), textures.begin(), textures.end());
+      } else if (*asset.type_ == AssetType::Mesh) {
+        dependencies_.insert(dependencies_.end(), materials.begin(), materials.end());
+      }
+      auto tail = dependencies_.begin() + static_cast<ptrdiff_t>(first_dependency);
+      std::sort(tail, dependencies_.end());
+      dependencies_.erase(std::unique(tail, dependencies_.end()), dependencies_.end());
+
+      auto dependency_count = dependencies_.size() - first_dependency;
+      entries_.push_back(Entry{ .id_ = *asset.id_,
+                                .offset_ = begin,
+                                .size_ = static_cast<uint32_t>(size),
+                                .type_ = *asset.type_,
+                                .first_dependency_ = static_cast<uint32_t>(first_dependency),
+                                .dependency_count_ = static_cast<uint32_t>(dependency_count) });
+    } while (scanner.consume(','));
+
+    if (!scanner.consume(']')) {
+      LOG_ERROR("asset database is not valid json; offset: {}", scanner.position());
+      return Error::SchemaError;
+    }
+  }
+
+  if (scanner.peek() != '\0') {
+    LOG_ERROR("trailing data after asset database; offset: {}", scanner.position());
+    return Error::SchemaError;
+  }
+
+  std::ranges::sort(entries_, {}, &Entry::id_);
+  auto duplicate = std::ranges::adjacent_find(
+      entries_, [](const auto& lhs, const auto& rhs) { return lhs.id_ == rhs.id_; });
+  if (duplicate != entries_.end()) {
+    LOG_ERROR("duplicate asset id {}", duplicate->id_);
+    return Error::SchemaError;
+  }
+
+  decoded_ = std::make_unique<std::atomic<const DecodedAsset*>[]>(entries_.size());
+
+  LOG_DEBUG("json asset catalog indexed; assets: {}", entries_.size());
+  return Error::OK;
+}
+
+auto JsonAssetCatalog::find(AssetId asset_id) const
+    -> std::expected<AssetDescriptor, std::error_code> {
+  auto entry = std::ranges::lower_bound(entries_, asset_id, {}, &Entry::id_);
+  if (entry == entries_.end() || entry->id_ != asset_id) {
+    return std::unexpected(Error::NotFoundError);
+  }
+  return decodeAt(static_cast<size_t>(entry - entries_.begin()));
+}
+
+auto JsonAssetCatalog::decodeAt(size_t position) const
+    -> std::expected<AssetDescriptor, std::error_code> {
+  auto asset = decode(position);
+  if (!asset) {
+    return std::unexpected(asset.error());
+  }
+
+  return decodeAssetRecord(entries_[position].type_, (*asset)->record_, 0, (*asset)->strings_);
+}
+
+auto JsonAssetCatalog::decode(size_t position) const
+    -> std::expected<const DecodedAsset*, std::error_code> {
+  auto& slot = decoded_[position];
+  if (const auto* asset = slot.load(std::memory_order_acquire); asset != nullptr) {
+    return asset;
+  }
+
+  const auto& entry = entries_[position];
+  auto compiled = compileAsset(text_.substr(entry.offset_, entry.size_));
+  if (!compiled) {
+    return std::unexpected(compiled.error());
+  }
+  if (compiled->id_ != entry.id_ || compiled->type_ != entry.type_) {
+    LOG_ERROR("asset entry disagrees with the catalog index; id: {}", entry.id_);
+    return std::unexpected(Error::SchemaError);
+  }
+
+  // the loser of a race leaves its copy in the arena, first lookups racing is rare
+  const auto* decoded = new (arena_.allocate(sizeof(DecodedAsset), alignof(DecodedAsset)))
+      DecodedAsset{ .record_ = arena_.copy(compiled->record_, AssetRecordAlignment),
+                    .strings_ = arena_.copy(compiled->strings_) };
+
+  const DecodedAsset* published = nullptr;
+  if (!slot.compare_exchange_strong(
+          published, decoded, std::memory_order_acq_rel, std::memory_order_acquire)) {
+    // another thread decoded it first, use theirs so every view points at the same bytes
+    return published;
+  }
+
+  decoded_count_.fetch_add(1, std::memory_order_relaxed);
+  return decoded;
+}
+
+}  // namespace gravity
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "source/common/arena.hpp"
+#include "source/rendering/common/asset_types.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace gravity {
+
+// Asset catalog served straight from the JSON text. Opening it only scans the top level array for
+// each asset's id, type and byte range; an asset is parsed and compiled the first time it is
+// looked up and the result is published for every later lookup, so startup cost does not depend
+// on the size of the entries and sessions only pay for the assets they use.
+//
+// Errors inside an entry are therefore reported by the first find() of that asset. find() is safe
+// to call from several threads, racing first lookups of one asset may both compile it and only
+// one result is kept.
+//
+// Decoded records and their strings are copied into an arena owned by the catalog, so a decoded
+// asset costs no heap allocation of its own and descriptors stay valid until the catalog goes.
+class JsonAssetCatalog {
+ public:
+  // Reads the whole file rather than mapping it: catalogs are hand edited, and an editor saving
+  // in place would truncate pages that a mapping, kept alive by retired catalogs, still views.
+  static auto open(const std::string& path)
+      -> std::expected<std::unique_ptr<JsonAssetCatalog>, std::error_code>;
+  static auto build(std::string json)
+      -> std::expected<std::unique_ptr<JsonAssetCatalog>, std::error_code>;
+
+  JsonAssetCatalog(const JsonAssetCatalog&) = delete;
+  auto operator=(const JsonAssetCatalog&) -> JsonAssetCatalog& = delete;
+
+  ~JsonAssetCatalog() = default;
+
+  [[nodiscard]] auto find(AssetId asset_id) const
+      -> std::expected<AssetDescriptor, std::error_code>;
+
+  [[nodiscard]] auto size() const -> size_t { return entries_.size(); }
+
+  // Positions follow id order, 0 <= position < size().
+  [[nodiscard]] auto idAt(size_t position) const -> AssetId { return entries_[position].id_; }
+  [[nodiscard]] auto typeAt(size_t position) const -> AssetType { return entries_[position].type_; }
+  // Direct dependencies, sorted and unique. Taken from the index scan, so they are known before
+  // the asset is decoded.
+  [[nodiscard]] auto dependenciesAt(size_t position) const -> std::span<const AssetId> {
+    const auto& entry = entries_[position];
+    return std::span{ dependencies_ }.subspan(entry.first_dependency_, entry.dependency_count_);
+  }
+  [[nodiscard]] auto decodeAt(size_t position) const
+      -> std::expected<AssetDescriptor, std::error_code>;
+  [[nodiscard]] auto decodedCount() const -> size_t {
+    return decoded_count_.load(std::memory_order_relaxed);
+  }
+  [[nodiscard]] auto decodedBytes() const -> size_t { return arena_.used(); }
+
+ private:
+  struct Entry {
+    AssetId id_;
+    uint64_t offset_;
+    uint32_t size_;
+    AssetType type_;
+    uint32_t first_dependency_;
+    uint32_t dependency_count_;
+  };
+
+  std::string json_;
+  std::string_view text_;
+  std::vector<Entry> entries_;
+  std::vector<AssetId> dependencies_;
+
+  struct DecodedAsset {
+    std::span<const std::byte> record_;
+    std::string_view strings_;
+  };
+
+  mutable Arena arena_;
+  std::unique_ptr<std::atomic<const DecodedAsset*>[]> decoded_;
+  mutable std::atomic<size_t> decoded_count_{ 0 };
+
+  JsonAssetCatalog() = default;
+
+  auto index() -> std::error_code;
+
+  auto decode(size_t position) const -> std::expected<const DecodedAsset*, std::error_code>;
+};
+
+}  // namespace gravity
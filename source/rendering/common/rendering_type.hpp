@@ -107,4 +107,44 @@ enum class VertexInputRate : uint8_t {
   Instance,
 };
 
+enum class PrimitiveTopology : uint8_t {
+  PointList,
+  LineList,
+  LineStrip,
+  TriangleList,
+  TriangleStrip,
+};
+
+enum class CullMode : uint8_t {
+  None,
+  Front,
+  Back,
+};
+
+enum class FrontFace : uint8_t {
+  CounterClockwise,
+  Clockwise,
+};
+
+enum class BlendFactor : uint8_t {
+  Zero,
+  One,
+  SourceColor,
+  OneMinusSourceColor,
+  DestinationColor,
+  OneMinusDestinationColor,
+  SourceAlpha,
+  OneMinusSourceAlpha,
+  DestinationAlpha,
+  OneMinusDestinationAlpha,
+};
+
+enum class BlendOperation : uint8_t {
+  Add,
+  Subtract,
+  ReverseSubtract,
+  Min,
+  Max,
+};
+
 }  // namespace gravity
\ No newline at end of file
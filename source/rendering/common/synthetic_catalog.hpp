@@ -0,0 +1,47 @@
+#pragma once
+
+#include "source/rendering/common/asset_types.hpp"
+
+#include <span>
+#include <string>
+
+namespace gravity {
+
+// Catalog entries for benchmarks and tests. The type follows the id in groups of four: texture,
+// material, mesh, shader, starting at id 1. A material uses the texture one id below it and a
+// mesh the material one id below it, so a catalog holding every id from 1 up is complete.
+inline auto syntheticAssetJson(AssetId id) -> std::string {
+  auto key = std::to_string(id);
+  auto previous = std::to_string(id - 1);
+  switch (id % 4) {
+    case 1:
+      return R"({"id":)" + key + R"(,"type":"texture","image":"textures/)" + key +
+             R"(.png","colour_space":"srgb","mipmaps":true})";
+    case 2:
+      return R"({"id":)" + key + R"(,"type":"material","textures":[{"name":"albedo","asset":)" +
+             previous + R"(,"sampler":"linear_wrap"}],"parameters":[]})";
+    case 3:
+      return R"({"id":)" + key + R"(,"type":"mesh","source":"meshes/)" + key +
+             R"(.gltf","submeshes":[{"name":"body","first_index":0,"index_count":36,"material":)" +
+             previous + "}]}";
+    default:
+      return R"({"id":)" + key + R"(,"type":"shader","stages":[{"spirv":"shaders/)" + key +
+             R"(.vert.spv","meta":"shaders/)" + key +
+             R"(.vert.json","type":"vertex"},{"spirv":"shaders/)" + key +
+             R"(.frag.spv","meta":"shaders/)" + key + R"(.frag.json","type":"fragment"}]})";
+  }
+}
+
+inline auto syntheticCatalogJson(std::span<const AssetId> ids) -> std::string {
+  std::string json{ "[" };
+  for (auto id : ids) {
+    if (json.size() > 1) {
+      json += ",\n";
+    }
+    json += syntheticAssetJson(id);
+  }
+  json += "]";
+  return json;
+}
+
+}  // namespace gravity
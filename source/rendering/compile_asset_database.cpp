@@ -0,0 +1,93 @@
+#include "source/common/logging/logger.hpp"
+#include "source/rendering/asset_manager.hpp"
+#include "source/rendering/common/asset_catalog.hpp"
+#include "source/rendering/common/asset_database.hpp"
+#include "source/rendering/common/asset_database_compiler.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <span>
+#include <string>
+#include <utility>
+
+#undef GRAVITY_MODULE_NAME
+#define GRAVITY_MODULE_NAME "compile_asset_database"
+
+using namespace gravity;
+
+namespace boost {
+
+void throw_exception(const std::exception& e, const boost::source_location&) {
+  std::cerr << "Boost exception: " << e.what() << "\n";
+  std::abort();
+}
+
+void throw_exception(const std::exception& e) {
+  std::cerr << "Boost exception: " << e.what() << "\n";
+  std::abort();
+}
+
+}  // namespace boost
+
+// Usage: compile_asset_database [input.json] [output.bin]
+// Defaults to the default shard's paths, so running it from the project root refreshes the image
+// picked up by AssetDatabaseMode::Compiled. Run it once per shard for a sharded catalog.
+auto main(int argc, char** argv) -> int {
+  if (auto err = setupAsyncLogger(); err) {
+    return err.value();
+  }
+
+  auto arguments = std::span{ argv, static_cast<size_t>(argc) }.subspan(1);
+  if (arguments.size() > 2) {
+    std::cerr << "usage: compile_asset_database [input.json] [output.bin]\n";
+    return 1;
+  }
+
+  std::string default_shard{ AssetManager::DefaultShard };
+  std::string input_path =
+      !arguments.empty() ? arguments[0] : default_shard + AssetShard::JsonExtension;
+  std::string output_path =
+      arguments.size() > 1 ? arguments[1] : default_shard + AssetShard::CompiledExtension;
+
+  std::ifstream input{ input_path, std::ios::binary };
+  if (!input) {
+    LOG_ERROR("unable to open asset catalog; path: {}", input_path);
+    return 1;
+  }
+  std::string json{ std::istreambuf_iterator<char>{ input }, std::istreambuf_iterator<char>{} };
+
+  auto image = compileAssetDatabase(json);
+  if (!image) {
+    LOG_ERROR("asset catalog compilation failed; error: {}", image.error().message());
+    return 1;
+  }
+
+  // written next to the target and renamed, a running AssetManager never maps a partial image
+  auto temporary_path = output_path + ".tmp";
+  {
+    std::ofstream output{ temporary_path, std::ios::binary | std::ios::trunc };
+    output.write(
+        reinterpret_cast<const char*>(image->data()),  // NOLINT
+        static_cast<std::streamsize>(image->size()));
+    output.flush();
+    if (!output) {
+      LOG_ERROR("unable to write compiled asset database; path: {}", temporary_path);
+      return 1;
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temporary_path, output_path, error);
+  if (error) {
+    LOG_ERROR("unable to replace compiled asset database; path: {}, error: {}", output_path,
+              error.message());
+    return 1;
+  }
+
+  auto assets = AssetDatabase::fromImage(std::move(*image));
+  LOG_INFO("compiled asset database written; path: {}, assets: {}", output_path,
+           assets ? assets->size() : 0);
+  return 0;
+}
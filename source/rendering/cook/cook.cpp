@@ -0,0 +1,253 @@
+#include "source/common/hash.hpp"
+#include "source/common/io/content_hash_index.hpp"
+#include "source/common/logging/logger.hpp"
+#include "source/common/mapped_file.hpp"
+#include "source/common/utilities.hpp"
+#include "source/rendering/asset_manager.hpp"
+#include "source/rendering/common/asset_catalog.hpp"
+#include "source/rendering/common/asset_types.hpp"
+#include "source/rendering/common/cooked_format.hpp"
+#include "source/rendering/cook/image_cooker.hpp"
+#include "source/rendering/cook/mesh_cooker.hpp"
+
+#include "boost/asio/post.hpp"
+#include "boost/asio/thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#undef GRAVITY_MODULE_NAME
+#define GRAVITY_MODULE_NAME "cook"
+
+using namespace gravity;
+
+namespace boost {
+
+void throw_exception(const std::exception& e, const boost::source_location&) {
+  std::cerr << "Boost exception: " << e.what() << "\n";
+  std::abort();
+}
+
+void throw_exception(const std::exception& e) {
+  std::cerr << "Boost exception: " << e.what() << "\n";
+  std::abort();
+}
+
+}  // namespace boost
+
+namespace {
+
+struct CookJob {
+  CookedKind kind_;
+  std::string path_;
+  ImageCookOptions image_options_;
+};
+
+struct CookCounters {
+  std::atomic<size_t> cooked_ = 0;
+  std::atomic<size_t> skipped_ = 0;
+  std::atomic<size_t> failed_ = 0;
+};
+
+// One job per source file, a file referenced by several assets is cooked once. Two textures
+// asking for different options on the same image are reported, the first one wins. Paths are
+// normalized as ResourceManager normalizes them, so it finds the index entries written here.
+auto collectJobs(const AssetShard& shard, std::unordered_map<std::string, CookJob>& jobs) -> bool {
+  for (size_t position = 0; position < shard.size(); ++position) {
+    auto type = shard.typeAt(position);
+    if (type != AssetType::Texture && type != AssetType::Mesh) {
+      continue;
+    }
+
+    auto asset = shard.decodeAt(position);
+    if (!asset) {
+      LOG_ERROR(
+          "unable to decode asset; id: {}, error: {}", shard.idAt(position),
+          asset.error().message());
+      return false;
+    }
+
+    CookJob job{};
+    if (const auto* texture = std::get_if<TextureDescriptor>(&asset->data_); texture) {
+      job = CookJob{ .kind_ = CookedKind::Image,
+                     .path_ = normalizePath(std::string{ texture->image_path_ }),
+                     .image_options_ = { .srgb_ = texture->color_space_ == "srgb",
+                                         .mipmaps_ = texture->mipmaps_ } };
+    } else if (const auto* mesh = std::get_if<MeshDescriptor>(&asset->data_); mesh) {
+      job = CookJob{ .kind_ = CookedKind::Mesh,
+                     .path_ = normalizePath(std::string{ mesh->source() }) };
+    } else {
+      continue;
+    }
+
+    auto [iterator, inserted] = jobs.try_emplace(job.path_, job);
+    if (!inserted && iterator->second.image_options_.key() != job.image_options_.key()) {
+      LOG_WARN("source cooked with conflicting options; path: {}", job.path_);
+    }
+  }
+  return true;
+}
+
+void writeCooked(
+    const std::string& path, std::span<const std::byte> cooked, CookCounters& counters) {
+  // written next to the target and renamed, a loading ResourceManager never maps a partial file
+  auto temporary_path = path + ".tmp";
+  {
+    std::ofstream output{ temporary_path, std::ios::binary | std::ios::trunc };
+    output.write(
+        reinterpret_cast<const char*>(cooked.data()),  // NOLINT
+        static_cast<std::streamsize>(cooked.size()));
+    output.flush();
+    if (!output) {
+      LOG_ERROR("unable to write cooked file; path: {}", temporary_path);
+      counters.failed_++;
+      return;
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temporary_path, path, error);
+  if (error) {
+    LOG_ERROR("unable to replace cooked file; path: {}, error: {}", path, error.message());
+    counters.failed_++;
+    return;
+  }
+  counters.cooked_++;
+}
+
+void cook(const CookJob& job, ContentHashIndex* index, bool force, CookCounters& counters) {
+  auto source = MappedFile::open(job.path_);
+  if (!source) {
+    LOG_ERROR("unable to open source; path: {}, error: {}", job.path_, source.error().message());
+    counters.failed_++;
+    return;
+  }
+
+  std::optional<FileIdentity> identity;
+  std::optional<HashType> content_hash;
+  if (index != nullptr) {
+    if (auto file_identity = FileIdentity::of(job.path_); file_identity) {
+      identity = *file_identity;
+      content_hash = index->find(job.path_, *identity);
+    }
+  }
+  if (!content_hash) {
+    content_hash = hash(source->data());
+    if (identity) {
+      index->store(job.path_, *identity, *content_hash);
+    }
+  }
+
+  auto source_key = cookedSourceKey(
+      *content_hash, job.kind_ == CookedKind::Image ? job.image_options_.key() : 0);
+
+  auto cooked_path = job.path_ + CookedExtension;
+  if (!force) {
+    if (auto existing = MappedFile::open(cooked_path); existing) {
+      auto parsed = parseCookedResource(existing->data());
+      if (parsed && parsed->header_->source_key_ == source_key) {
+        LOG_DEBUG("cooked file is up to date; path: {}", cooked_path);
+        counters.skipped_++;
+        return;
+      }
+    }
+  }
+
+  auto cooked = job.kind_ == CookedKind::Image
+                    ? cookImage(source->data(), job.image_options_, source_key)
+                    : cookMesh(job.path_, source_key);
+  if (!cooked) {
+    LOG_ERROR("unable to cook source; path: {}, error: {}", job.path_, cooked.error().message());
+    counters.failed_++;
+    return;
+  }
+
+  writeCooked(cooked_path, *cooked, counters);
+}
+
+}  // namespace
+
+// Usage: cook [shard...] [--jobs N] [--force]
+// Cooks the image of every texture and the source of every mesh in the given catalog shards
+// (defaults to the default shard) into a "<source>.cooked" file next to it, which ResourceManager
+// then loads instead of the source. Sources whose content and options are unchanged since their
+// last cook are skipped unless --force is given.
+auto main(int argc, char** argv) -> int {
+  if (auto err = setupAsyncLogger(); err) {
+    return err.value();
+  }
+
+  std::vector<std::string> shards;
+  size_t job_count = std::max(std::thread::hardware_concurrency(), 1U);
+  bool force = false;
+
+  auto arguments = std::span{ argv, static_cast<size_t>(argc) }.subspan(1);
+  for (size_t i = 0; i < arguments.size(); ++i) {
+    std::string_view argument{ arguments[i] };
+    if (argument == "--force") {
+      force = true;
+    } else if (argument == "--jobs" && i + 1 < arguments.size()) {
+      std::string_view value{ arguments[++i] };
+      auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), job_count);
+      if (error != std::errc{} || end != value.data() + value.size() || job_count == 0) {
+        std::cerr << "usage: cook [shard...] [--jobs N] [--force]\n";
+        return 1;
+      }
+    } else if (argument.starts_with("--")) {
+      std::cerr << "usage: cook [shard...] [--jobs N] [--force]\n";
+      return 1;
+    } else {
+      shards.emplace_back(argument);
+    }
+  }
+  if (shards.empty()) {
+    shards.emplace_back(AssetManager::DefaultShard);
+  }
+
+  std::unordered_map<std::string, CookJob> jobs;
+  for (const auto& name : shards) {
+    auto shard = AssetShard::open(name, AssetDatabaseMode::Json);
+    if (!shard) {
+      LOG_ERROR("unable to open asset shard; name: {}, error: {}", name, shard.error().message());
+      return 1;
+    }
+    if (!collectJobs(*shard, jobs)) {
+      return 1;
+    }
+  }
+
+  // a missing index only costs rehashing every source
+  auto index = ContentHashIndex::open(shards.front() + CookIndexExtension);
+  if (!index) {
+    LOG_WARN("unable to open content hash index; error: {}", index.error().message());
+  }
+  auto* index_pointer = index ? index->get() : nullptr;
+
+  CookCounters counters;
+  {
+    boost::asio::thread_pool pool{ job_count };
+    for (const auto& [path, job] : jobs) {
+      boost::asio::post(pool, [&job, index_pointer, force, &counters] {
+        cook(job, index_pointer, force, counters);
+      });
+    }
+    pool.join();
+  }
+
+  LOG_INFO(
+      "cooking finished; sources: {}, cooked: {}, up to date: {}, failed: {}", jobs.size(),
+      counters.cooked_.load(), counters.skipped_.load(), counters.failed_.load());
+  return counters.failed_ == 0 ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+#include "image_cooker.hpp"
+
+#include "source/common/error.hpp"
+#include "source/common/logging/logger.hpp"
+#include "source/rendering/common/cooked_format.hpp"
+
+#include "stb_image.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+
+#undef GRAVITY_MODULE_NAME
+#define GRAVITY_MODULE_NAME "cook"
+
+namespace gravity {
+
+namespace {
+
+constexpr size_t TexelSize{ 4 };
+
+struct MipLevel {
+  uint32_t width_;
+  uint32_t height_;
+  std::vector<uint8_t> texels_;
+};
+
+const std::array<float, 256> SrgbToLinear = [] {
+  std::array<float, 256> table{};
+  for (size_t value = 0; value < table.size(); ++value) {
+    auto encoded = static_cast<float>(value) / 255.0F;
+    table[value] = encoded <= 0.04045F ? encoded / 12.92F
+                                       : std::pow((encoded + 0.055F) / 1.055F, 2.4F);
+  }
+  return table;
+}();
+
+auto linearToSrgb(float linear) -> uint8_t {
+  auto encoded = linear <= 0.0031308F ? linear * 12.92F
+                                      : (1.055F * std::pow(linear, 1.0F / 2.4F)) - 0.055F;
+  return static_cast<uint8_t>(std::clamp(std::lround(encoded * 255.0F), 0L, 255L));
+}
+
+// 2x2 box filter, an odd edge repeats its last row or column
+auto downsample(const MipLevel& source, bool srgb) -> MipLevel {
+  MipLevel level{ .width_ = std::max(source.width_ / 2, 1U),
+                  .height_ = std::max(source.height_ / 2, 1U),
+                  .texels_ = {} };
+  level.texels_.resize(size_t{ level.width_ } * level.height_ * TexelSize);
+
+  for (uint32_t y = 0; y < level.height_; ++y) {
+    std::array<uint32_t, 2> rows{ std::min(y * 2, source.height_ - 1),
+                                  std::min((y * 2) + 1, source.height_ - 1) };
+    for (uint32_t x = 0; x < level.width_; ++x) {
+      std::array<uint32_t, 2> columns{ std::min(x * 2, source.width_ - 1),
+                                       std::min((x * 2) + 1, source.width_ - 1) };
+
+      std::array<float, TexelSize> sum{};
+      for (auto row : rows) {
+        for (auto column : columns) {
+          const auto* texel =
+              &source.texels_[((size_t{ row } * source.width_) + column) * TexelSize];
+          for (size_t channel = 0; channel < TexelSize; ++channel) {
+            // alpha is linear in both encodings
+            sum[channel] += srgb && channel < 3 ? SrgbToLinear[texel[channel]]
+                                                : static_cast<float>(texel[channel]) / 255.0F;
+          }
+        }
+      }
+
+      auto* texel = &level.texels_[((size_t{ y } * level.width_) + x) * TexelSize];
+      for (size_t channel = 0; channel < TexelSize; ++channel) {
+        auto average = sum[channel] / 4.0F;
+        texel[channel] = srgb && channel < 3
+                             ? linearToSrgb(average)
+                             : static_cast<uint8_t>(std::lround(average * 255.0F));
+      }
+    }
+  }
+  return level;
+}
+
+auto alignUp(uint64_t value, uint64_t alignment) -> uint64_t {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+auto cookImage(
+    std::span<const std::byte> source, const ImageCookOptions& options, HashType source_key)
+    -> std::expected<std::vector<std::byte>, std::error_code> {
+  if (source.size() > static_cast<size_t>(std::numeric_limits<int>::max())) {
+    return std::unexpected(Error::InvalidArgumentError);
+  }
+
+  int width = 0;
+  int height = 0;
+  int channels = 0;
+  std::unique_ptr<stbi_uc, decltype(&stbi_image_free)> decoded{
+    stbi_load_from_memory(
+        reinterpret_cast<const stbi_uc*>(source.data()),  // NOLINT
+        static_cast<int>(source.size()), &width, &height, &channels, TexelSize),
+    &stbi_image_free
+  };
+  if (!decoded) {
+    LOG_ERROR("unable to decode image; reason: {}", stbi_failure_reason());
+    return std::unexpected(Error::SchemaError);
+  }
+
+  std::vector<MipLevel> levels;
+  levels.push_back(MipLevel{ .width_ = static_cast<uint32_t>(width),
+                             .height_ = static_cast<uint32_t>(height),
+                             .texels_ = {} });
+  levels.front().texels_.assign(
+      decoded.get(), decoded.get() + (size_t{ levels.front().width_ } * height * TexelSize));
+  decoded.reset();
+
+  while (options.mipmaps_ && (levels.back().width_ > 1 || levels.back().height_ > 1)) {
+    levels.push_back(downsample(levels.back(), options.srgb_));
+  }
+
+  CookedImageHeader header{ .width_ = levels.front().width_,
+                            .height_ = levels.front().height_,
+                            .mip_count_ = static_cast<uint32_t>(levels.size()),
+                            .format_ = options.srgb_ ? CookedImageFormat::Rgba8Srgb
+                                                     : CookedImageFormat::Rgba8Unorm,
+                            .padding_ = {} };
+
+  std::vector<CookedMipRecord> mips;
+  uint64_t payload_size = 0;
+  for (const auto& level : levels) {
+    payload_size = alignUp(payload_size, CookedRegionAlignment);
+    mips.push_back(CookedMipRecord{ .offset_ = payload_size,
+                                    .size_ = level.texels_.size(),
+                                    .width_ = level.width_,
+                                    .height_ = level.height_ });
+    payload_size += level.texels_.size();
+  }
+
+  std::vector<std::byte> payload(payload_size);
+  for (size_t level = 0; level < levels.size(); ++level) {
+    std::memcpy(payload.data() + mips[level].offset_, levels[level].texels_.data(),
+                levels[level].texels_.size());
+  }
+
+  std::vector<std::byte> metadata(sizeof(header) + (mips.size() * sizeof(CookedMipRecord)));
+  std::memcpy(metadata.data(), &header, sizeof(header));
+  std::memcpy(metadata.data() + sizeof(header), mips.data(), mips.size() * sizeof(CookedMipRecord));
+
+  return assembleCookedFile(CookedKind::Image, source_key, metadata, payload);
+}
+
+}  // namespace gravity
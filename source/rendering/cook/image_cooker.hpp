@@ -0,0 +1,30 @@
+#pragma once
+
+#include "source/common/hash.hpp"
+#include "source/rendering/common/cooked_format.hpp"
+
+#include <cstddef>
+#include <expected>
+#include <span>
+#include <system_error>
+#include <vector>
+
+namespace gravity {
+
+struct ImageCookOptions {
+  // texels are sRGB encoded, mips are filtered in linear space
+  bool srgb_ = true;
+  bool mipmaps_ = true;
+
+  [[nodiscard]] auto key() const -> HashType {
+    return cookedImageOptionsKey(srgb_, mipmaps_);
+  }
+};
+
+// Decodes an image file (anything stb_image reads) to RGBA8 and writes a cooked image with its
+// full mip chain, see cooked_format.hpp.
+auto cookImage(
+    std::span<const std::byte> source, const ImageCookOptions& options, HashType source_key)
+    -> std::expected<std::vector<std::byte>, std::error_code>;
+
+}  // namespace gravity
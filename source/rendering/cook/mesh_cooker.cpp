@@ -0,0 +1,190 @@
+#include "mesh_cooker.hpp"
+
+#include "source/common/error.hpp"
+#include "source/common/logging/logger.hpp"
+#include "source/rendering/common/cooked_format.hpp"
+
+#include "assimp/Importer.hpp"
+#include "assimp/postprocess.h"
+#include "assimp/scene.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+
+#undef GRAVITY_MODULE_NAME
+#define GRAVITY_MODULE_NAME "cook"
+
+namespace gravity {
+
+namespace {
+
+// ImproveCacheLocality reorders each mesh's triangles for the post-transform cache, the vertex
+// stream is then laid out in first use order by remapVertices()
+constexpr unsigned int ImportFlags{ aiProcess_Triangulate | aiProcess_JoinIdenticalVertices |
+                                    aiProcess_GenSmoothNormals | aiProcess_PreTransformVertices |
+                                    aiProcess_SortByPType | aiProcess_ImproveCacheLocality };
+
+constexpr uint32_t Unmapped{ std::numeric_limits<uint32_t>::max() };
+
+auto toSnorm16(float value) -> int16_t {
+  return static_cast<int16_t>(std::lround(std::clamp(value, -1.0F, 1.0F) * 32767.0F));
+}
+
+auto encodeOctahedral(const aiVector3D& normal) -> std::array<int16_t, 2> {
+  auto length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+  if (length == 0.0F) {
+    return { 0, 0 };
+  }
+
+  auto x = normal.x / length;
+  auto y = normal.y / length;
+  if (normal.z < 0.0F) {
+    auto folded_x = (1.0F - std::abs(y)) * (x >= 0.0F ? 1.0F : -1.0F);
+    auto folded_y = (1.0F - std::abs(x)) * (y >= 0.0F ? 1.0F : -1.0F);
+    x = folded_x;
+    y = folded_y;
+  }
+  return { toSnorm16(x), toSnorm16(y) };
+}
+
+// Renumbers the vertices referenced by indices in the order they are first used, so the vertex
+// fetch walks the stream forward. Unreferenced vertices are dropped.
+void remapVertices(std::vector<CookedVertex>& vertices, std::vector<uint32_t>& indices) {
+  std::vector<uint32_t> remap(vertices.size(), Unmapped);
+  std::vector<CookedVertex> ordered;
+  ordered.reserve(vertices.size());
+
+  for (auto& index : indices) {
+    if (remap[index] == Unmapped) {
+      remap[index] = static_cast<uint32_t>(ordered.size());
+      ordered.push_back(vertices[index]);
+    }
+    index = remap[index];
+  }
+  vertices = std::move(ordered);
+}
+
+auto alignUp(uint64_t value, uint64_t alignment) -> uint64_t {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+auto cookMesh(const std::string& path, HashType source_key)
+    -> std::expected<std::vector<std::byte>, std::error_code> {
+  Assimp::Importer importer;
+  const auto* scene = importer.ReadFile(path, ImportFlags);
+  if (scene == nullptr || (scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) != 0) {
+    LOG_ERROR("unable to import model; path: {}, reason: {}", path, importer.GetErrorString());
+    return std::unexpected(Error::SchemaError);
+  }
+
+  std::vector<CookedVertex> vertices;
+  std::vector<uint32_t> indices;
+  std::vector<CookedSubmeshRecord> submeshes;
+
+  for (const auto* mesh : std::span{ scene->mMeshes, scene->mNumMeshes }) {
+    // points and lines are sorted into meshes of their own and skipped
+    if ((mesh->mPrimitiveTypes & aiPrimitiveType_TRIANGLE) == 0) {
+      continue;
+    }
+
+    auto base_vertex = vertices.size();
+    if (base_vertex + mesh->mNumVertices > Unmapped) {
+      return std::unexpected(Error::InvalidArgumentError);
+    }
+
+    for (unsigned int vertex = 0; vertex < mesh->mNumVertices; ++vertex) {
+      const auto& position = mesh->mVertices[vertex];
+      CookedVertex cooked{ .position_ = { position.x, position.y, position.z },
+                           .normal_ = { 0, 0 },
+                           .uv_ = { 0.0F, 0.0F } };
+      if (mesh->HasNormals()) {
+        cooked.normal_ = encodeOctahedral(mesh->mNormals[vertex]);
+      }
+      if (mesh->HasTextureCoords(0)) {
+        cooked.uv_ = { mesh->mTextureCoords[0][vertex].x, mesh->mTextureCoords[0][vertex].y };
+      }
+      vertices.push_back(cooked);
+    }
+
+    CookedSubmeshRecord submesh{ .first_index_ = static_cast<uint32_t>(indices.size()),
+                                 .index_count_ = 0,
+                                 .material_index_ = mesh->mMaterialIndex,
+                                 .padding_ = 0 };
+    for (const auto& face : std::span{ mesh->mFaces, mesh->mNumFaces }) {
+      if (face.mNumIndices != 3) {
+        continue;
+      }
+      for (auto index : std::span{ face.mIndices, face.mNumIndices }) {
+        indices.push_back(static_cast<uint32_t>(base_vertex + index));
+      }
+    }
+    submesh.index_count_ = static_cast<uint32_t>(indices.size()) - submesh.first_index_;
+    submeshes.push_back(submesh);
+  }
+
+  if (indices.empty()) {
+    LOG_ERROR("model has no triangles; path: {}", path);
+    return std::unexpected(Error::SchemaError);
+  }
+
+  remapVertices(vertices, indices);
+
+  auto index_type = vertices.size() <= std::numeric_limits<uint16_t>::max() + 1
+                        ? CookedIndexType::Uint16
+                        : CookedIndexType::Uint32;
+  CookedMeshHeader header{ .vertex_count_ = static_cast<uint32_t>(vertices.size()),
+                           .index_count_ = static_cast<uint32_t>(indices.size()),
+                           .vertex_stride_ = sizeof(CookedVertex),
+                           .submesh_count_ = static_cast<uint32_t>(submeshes.size()),
+                           .vertex_offset_ = 0,
+                           .index_offset_ = 0,
+                           .bounds_min_ = vertices.front().position_,
+                           .bounds_max_ = vertices.front().position_,
+                           .index_type_ = index_type,
+                           .padding_ = {} };
+  for (const auto& vertex : vertices) {
+    for (size_t axis = 0; axis < 3; ++axis) {
+      header.bounds_min_[axis] = std::min(header.bounds_min_[axis], vertex.position_[axis]);
+      header.bounds_max_[axis] = std::max(header.bounds_max_[axis], vertex.position_[axis]);
+    }
+  }
+
+  auto vertex_bytes = vertices.size() * sizeof(CookedVertex);
+  auto index_size = header.index_type_ == CookedIndexType::Uint16 ? sizeof(uint16_t)
+                                                                   : sizeof(uint32_t);
+  header.index_offset_ = alignUp(vertex_bytes, CookedRegionAlignment);
+
+  std::vector<std::byte> payload(header.index_offset_ + (indices.size() * index_size));
+  std::memcpy(payload.data(), vertices.data(), vertex_bytes);
+  if (header.index_type_ == CookedIndexType::Uint16) {
+    auto* destination = payload.data() + header.index_offset_;
+    for (auto index : indices) {
+      auto narrow = static_cast<uint16_t>(index);
+      std::memcpy(destination, &narrow, sizeof(narrow));
+      destination += sizeof(narrow);
+    }
+  } else {
+    std::memcpy(payload.data() + header.index_offset_, indices.data(),
+                indices.size() * sizeof(uint32_t));
+  }
+
+  std::vector<std::byte> metadata(
+      sizeof(header) + (submeshes.size() * sizeof(CookedSubmeshRecord)));
+  std::memcpy(metadata.data(), &header, sizeof(header));
+  std::memcpy(metadata.data() + sizeof(header), submeshes.data(),
+              submeshes.size() * sizeof(CookedSubmeshRecord));
+
+  LOG_DEBUG(
+      "mesh cooked; path: {}, vertices: {}, indices: {}, submeshes: {}", path, vertices.size(),
+      indices.size(), submeshes.size());
+  return assembleCookedFile(CookedKind::Mesh, source_key, metadata, payload);
+}
+
+}  // namespace gravity
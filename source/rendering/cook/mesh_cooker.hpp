@@ -0,0 +1,21 @@
+#pragma once
+
+#include "source/common/hash.hpp"
+
+#include <cstddef>
+#include <expected>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace gravity {
+
+// Imports a model file (anything assimp reads) and writes a cooked mesh: one interleaved
+// CookedVertex stream and one index stream shared by every submesh, the indices reordered for the
+// post-transform cache and the vertices for fetch locality, see cooked_format.hpp.
+//
+// Takes a path rather than bytes, model formats may reference sibling files.
+auto cookMesh(const std::string& path, HashType source_key)
+    -> std::expected<std::vector<std::byte>, std::error_code>;
+
+}  // namespace gravity
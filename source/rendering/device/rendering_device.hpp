@@ -1,5 +1,6 @@
 #pragma once
 
+#include "source/common/templates/slot_map.hpp"
 #include "source/common/utilities.hpp"
 #include "source/rendering/common/rendering_type.hpp"
 
@@ -9,6 +10,7 @@
 #include <expected>
 #include <span>
 #include <system_error>
+#include <vector>
 
 namespace gravity {
 
@@ -35,31 +37,34 @@ struct ImageDescriptor {
   ImageUsage usage_ = ImageUsage::Sampled;
 };
 
-struct BufferHandle {
-  size_t index_;
-  size_t generation_;
-};
+struct BufferTag;
+using BufferHandle = SlotHandle<BufferTag>;
 
-struct ImageHandle {
-  size_t index_;
-  size_t generation_;
-};
+struct ImageTag;
+using ImageHandle = SlotHandle<ImageTag>;
 
 struct VertexAttribute {
   uint32_t location;
   VertexFormat format;
   uint32_t offset;
+  uint32_t binding = 0;
+
+  auto operator==(const VertexAttribute& other) const -> bool = default;
 };
 
 struct VertexBinding {
   uint32_t binding;
   uint32_t stride;
   VertexInputRate input_rate;
+
+  auto operator==(const VertexBinding& other) const -> bool = default;
 };
 
 struct VertexLayout {
   std::vector<VertexBinding> bindings;
   std::vector<VertexAttribute> attributes;
+
+  auto operator==(const VertexLayout& other) const -> bool = default;
 };
 
 struct SamplerDescriptor {
@@ -83,10 +88,8 @@ struct SamplerDescriptor {
   bool compare_enabled_ = false;
 };
 
-struct SamplerHandle {
-  size_t index_;
-  size_t generation_;
-};
+struct SamplerTag;
+using SamplerHandle = SlotHandle<SamplerTag>;
 
 struct ShaderModuleDescriptor {
   ShaderStage stage_ = ShaderStage::Vertex;
@@ -94,26 +97,97 @@ struct ShaderModuleDescriptor {
   HashType hash_;
 };
 
-struct ShaderModuleHandle {
-  size_t index_ = 0;
-  size_t generation_ = 0;
+struct ShaderModuleTag;
+using ShaderModuleHandle = SlotHandle<ShaderModuleTag>;
+
+struct BlendState {
+  bool enabled_ = false;
+
+  BlendFactor source_color_ = BlendFactor::One;
+  BlendFactor destination_color_ = BlendFactor::Zero;
+  BlendOperation color_operation_ = BlendOperation::Add;
+
+  BlendFactor source_alpha_ = BlendFactor::One;
+  BlendFactor destination_alpha_ = BlendFactor::Zero;
+  BlendOperation alpha_operation_ = BlendOperation::Add;
+
+  auto operator==(const BlendState& other) const -> bool = default;
+};
+
+struct DepthState {
+  bool test_enabled_ = false;
+  bool write_enabled_ = false;
+  CompareOperation compare_operation_ = CompareOperation::LessOrEqual;
+
+  auto operator==(const DepthState& other) const -> bool = default;
+};
+
+// Formats of the attachments a pipeline renders into, one blend state per color target.
+struct RenderTargetLayout {
+  std::vector<Format> color_formats_;
+  std::vector<BlendState> blend_states_;
+  Format depth_format_ = Format::Undefined;
+  ImageSamples samples_ = ImageSamples::S1;
+
+  auto operator==(const RenderTargetLayout& other) const -> bool = default;
+};
+
+// One shader module per stage. Viewport and scissor are dynamic state.
+struct GraphicsPipelineDescriptor {
+  std::vector<ShaderModuleHandle> shaders_;
+  VertexLayout vertex_layout_;
+  RenderTargetLayout render_targets_;
+  DepthState depth_state_;
+  PrimitiveTopology topology_ = PrimitiveTopology::TriangleList;
+  CullMode cull_mode_ = CullMode::Back;
+  FrontFace front_face_ = FrontFace::CounterClockwise;
+  // bytes of push constants visible to every stage
+  uint32_t push_constant_size_ = 0;
+
+  auto operator==(const GraphicsPipelineDescriptor& other) const -> bool = default;
+};
+
+struct ComputePipelineDescriptor {
+  ShaderModuleHandle shader_;
+  uint32_t push_constant_size_ = 0;
+
+  auto operator==(const ComputePipelineDescriptor& other) const -> bool = default;
 };
 
+struct PipelineTag;
+using PipelineHandle = SlotHandle<PipelineTag>;
+
+enum class PipelineStatus : uint8_t { Compiling, Ready, Failed };
+
 class RenderingDevice {
  public:
   virtual ~RenderingDevice() = default;
 
   virtual auto initialize() -> boost::asio::awaitable<std::error_code> = 0;
+  // Waits for background work (pipeline compiles, deferred destruction, the GPU) and releases the
+  // device's resources. The owner co_awaits it once before destroying the device, whether
+  // initialize() succeeded or not; the destructor itself never blocks.
+  virtual auto shutdown() -> boost::asio::awaitable<void> = 0;
 
   virtual auto createBuffer(const BufferDescriptor& descriptor)
       -> boost::asio::awaitable<std::expected<BufferHandle, std::error_code>> = 0;
   virtual auto destroyBuffer(BufferHandle buffer_handle)
       -> boost::asio::awaitable<std::error_code> = 0;
+  // Copies data through the staging ring. Uploads are batched and recorded ahead of the next
+  // submitted frame, so that frame sees them; data can be released once this completes. A full
+  // ring waits for frames to retire their uploads, before the first frame it fails instead.
+  virtual auto upload(BufferHandle buffer_handle, std::span<const std::byte> data, size_t offset)
+      -> boost::asio::awaitable<std::error_code> = 0;
 
   virtual auto createImage(const ImageDescriptor& descriptor)
       -> boost::asio::awaitable<std::expected<ImageHandle, std::error_code>> = 0;
   virtual auto destroyImage(ImageHandle image_handle)
       -> boost::asio::awaitable<std::error_code> = 0;
+  // Replaces one mip level of one layer with tightly packed texels and leaves the image ready
+  // for sampling.
+  virtual auto upload(
+      ImageHandle image_handle, std::span<const std::byte> data, uint32_t mip_level,
+      uint32_t layer) -> boost::asio::awaitable<std::error_code> = 0;
 
   virtual auto createSampler(const SamplerDescriptor& descriptor)
       -> boost::asio::awaitable<std::expected<SamplerHandle, std::error_code>> = 0;
@@ -124,6 +198,22 @@ class RenderingDevice {
       -> boost::asio::awaitable<std::expected<ShaderModuleHandle, std::error_code>> = 0;
   virtual auto destroyShaderModule(ShaderModuleHandle shader_handle)
       -> boost::asio::awaitable<std::error_code> = 0;
+
+  // Pipelines compile in the background: the handle is returned once compilation is queued, and
+  // identical descriptors share one pipeline, including one that is still compiling.
+  virtual auto createGraphicsPipeline(const GraphicsPipelineDescriptor& descriptor)
+      -> boost::asio::awaitable<std::expected<PipelineHandle, std::error_code>> = 0;
+  virtual auto createComputePipeline(const ComputePipelineDescriptor& descriptor)
+      -> boost::asio::awaitable<std::expected<PipelineHandle, std::error_code>> = 0;
+  // Completes once the pipeline has compiled, with the compilation error if it failed.
+  virtual auto waitPipeline(PipelineHandle pipeline_handle)
+      -> boost::asio::awaitable<std::error_code> = 0;
+  // Never blocks, so a frame can skip or substitute draws whose pipeline is not ready yet. Safe
+  // from any thread, even for a handle that is being destroyed; stale handles report Failed.
+  [[nodiscard]] virtual auto tryGetPipeline(PipelineHandle pipeline_handle) const
+      -> PipelineStatus = 0;
+  virtual auto destroyPipeline(PipelineHandle pipeline_handle)
+      -> boost::asio::awaitable<std::error_code> = 0;
 };
 
 }  // namespace gravity
\ No newline at end of file
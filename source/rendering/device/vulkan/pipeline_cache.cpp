@@ -0,0 +1,152 @@
+#include "pipeline_cache.hpp"
+
+#include "source/common/error.hpp"
+#include "source/common/hash.hpp"
+#include "source/common/logging/logger.hpp"
+#include "source/common/mapped_file.hpp"
+
+#include "vulkan/vulkan_core.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+
+#undef GRAVITY_MODULE_NAME
+#define GRAVITY_MODULE_NAME "vulkan"
+
+namespace gravity {
+
+namespace {
+
+constexpr std::array<char, 8> Magic{ 'G', 'R', 'V', 'P', 'C', 'A', 'C', 'H' };
+constexpr uint32_t Version{ 1 };
+
+// Written in front of the driver's blob. The checksum keeps a damaged file away from the driver,
+// not every implementation validates the data it is handed.
+struct Header {
+  std::array<char, 8> magic_;
+  uint32_t version_;
+  uint32_t padding_;
+  uint64_t size_;
+  uint64_t checksum_;
+};
+
+static_assert(std::is_trivially_copyable_v<Header> && sizeof(Header) == 32);
+
+auto matchesDevice(
+    std::span<const std::byte> data, const vk::PhysicalDeviceProperties& properties) -> bool {
+  VkPipelineCacheHeaderVersionOne header{};
+  if (data.size() < sizeof(header)) {
+    return false;
+  }
+  std::memcpy(&header, data.data(), sizeof(header));
+
+  return header.headerSize >= sizeof(header) && header.headerSize <= data.size() &&
+         header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+         header.vendorID == properties.vendorID && header.deviceID == properties.deviceID &&
+         std::ranges::equal(header.pipelineCacheUUID, properties.pipelineCacheUUID);
+}
+
+}  // namespace
+
+auto loadPipelineCacheData(
+    const std::string& path, const vk::PhysicalDeviceProperties& properties)
+    -> std::vector<std::byte> {
+  auto mapping = MappedFile::open(path);
+  if (!mapping) {
+    if (mapping.error() != Error::NotFoundError) {
+      LOG_WARN(
+          "unable to read pipeline cache, starting cold; path: {}, error: {}", path,
+          mapping.error().message());
+    }
+    return {};
+  }
+
+  auto data = mapping->data();
+
+  Header header{};
+  if (data.size() >= sizeof(Header)) {
+    std::memcpy(&header, data.data(), sizeof(Header));
+  }
+
+  auto body = data.subspan(std::min(data.size(), sizeof(Header)));
+  if (header.magic_ != Magic || header.version_ != Version || header.size_ != body.size() ||
+      body.size() > PipelineCacheMaxSize || header.checksum_ != hash(body)) {
+    LOG_WARN("pipeline cache is damaged or has an unknown format, starting cold; path: {}", path);
+    return {};
+  }
+
+  if (!matchesDevice(body, properties)) {
+    LOG_INFO(
+        "pipeline cache was written for another device or driver, starting cold; path: {}", path);
+    return {};
+  }
+
+  return { body.begin(), body.end() };
+}
+
+auto savePipelineCacheData(const std::string& path, std::span<const std::byte> data)
+    -> std::error_code {
+  if (data.size() > PipelineCacheMaxSize) {
+    LOG_WARN(
+        "pipeline cache exceeds the size cap, not saving; size: {}, cap: {}", data.size(),
+        PipelineCacheMaxSize);
+    return Error::FailedPreconditionError;
+  }
+
+  auto temporary_path = path + ".tmp";
+  {
+    std::ofstream stream{ temporary_path, std::ios::binary | std::ios::trunc };
+
+    Header header{ .magic_ = Magic,
+                   .version_ = Version,
+                   .padding_ = 0,
+                   .size_ = data.size(),
+                   .checksum_ = hash(data) };
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));  // NOLINT
+    stream.write(reinterpret_cast<const char*>(data.data()), std::ssize(data));  // NOLINT
+
+    stream.flush();
+    if (!stream) {
+      LOG_ERROR("unable to write pipeline cache; path: {}", temporary_path);
+      return Error::InternalError;
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temporary_path, path, error);
+  if (error) {
+    LOG_ERROR("unable to replace pipeline cache; path: {}, error: {}", path, error.message());
+    return error;
+  }
+
+  LOG_DEBUG("pipeline cache saved; path: {}, size: {}", path, data.size());
+  return Error::OK;
+}
+
+void PipelineCreationStatistics::record(std::chrono::nanoseconds duration) {
+  count_.fetch_add(1, std::memory_order_relaxed);
+  total_ns_.fetch_add(duration.count(), std::memory_order_relaxed);
+
+  auto max = max_ns_.load(std::memory_order_relaxed);
+  while (duration.count() > max &&
+         !max_ns_.compare_exchange_weak(max, duration.count(), std::memory_order_relaxed)) {
+  }
+}
+
+void PipelineCreationStatistics::report(bool warm) const {
+  auto count = count_.load(std::memory_order_relaxed);
+  auto total_ns = total_ns_.load(std::memory_order_relaxed);
+
+  LOG_INFO(
+      "pipeline creation; cache: {}, pipelines: {}, total_ms: {:.3f}, average_us: {:.1f}, "
+      "max_us: {:.1f}",
+      warm ? "warm" : "cold", count, static_cast<double>(total_ns) / 1e6,
+      count == 0 ? 0.0 : static_cast<double>(total_ns) / static_cast<double>(count) / 1e3,
+      static_cast<double>(max_ns_.load(std::memory_order_relaxed)) / 1e3);
+}
+
+}  // namespace gravity
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "vulkan/vulkan_raii.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace gravity {
+
+// Pipeline cache blobs larger than this are neither loaded nor saved.
+constexpr size_t PipelineCacheMaxSize{ 64ULL * 1024 * 1024 };
+
+// Reads a pipeline cache saved by savePipelineCacheData(). Returns an empty blob, so the caller
+// starts with a cold cache, when the file is missing, damaged, or was written by another driver
+// or device: the Vulkan header's vendor id, device id and pipelineCacheUUID have to match the
+// properties of the device the cache is created on.
+auto loadPipelineCacheData(
+    const std::string& path, const vk::PhysicalDeviceProperties& properties)
+    -> std::vector<std::byte>;
+
+// Writes the blob next to path and renames it into place, a crash never leaves a torn cache.
+auto savePipelineCacheData(const std::string& path, std::span<const std::byte> data)
+    -> std::error_code;
+
+// Pipeline creation times, reported along with whether the cache started warm so a run can be
+// compared against a cold one. Safe to record from any thread.
+class PipelineCreationStatistics {
+ public:
+  void record(std::chrono::nanoseconds duration);
+
+  // pipelines recorded so far
+  [[nodiscard]] auto count() const -> size_t { return count_.load(std::memory_order_relaxed); }
+
+  void report(bool warm) const;
+
+ private:
+  std::atomic<size_t> count_{ 0 };
+  std::atomic<int64_t> total_ns_{ 0 };
+  std::atomic<int64_t> max_ns_{ 0 };
+};
+
+}  // namespace gravity
@@ -0,0 +1,71 @@
+#include "staging_ring.hpp"
+
+namespace gravity {
+
+namespace {
+
+auto alignUp(size_t value, size_t alignment) -> size_t {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+auto StagingRing::allocate(size_t size, size_t alignment) -> std::optional<size_t> {
+  if (size == 0 || size > capacity_) {
+    return std::nullopt;
+  }
+
+  auto take = [this](size_t offset, size_t size) {
+    auto end = offset + size;
+    // padding and a skipped tail count as used until the range is retired
+    auto bytes = end >= head_ ? end - head_ : (capacity_ - head_) + end;
+    used_ += bytes;
+    open_bytes_ += bytes;
+    head_ = end == capacity_ ? 0 : end;
+    return offset;
+  };
+
+  auto offset = alignUp(head_, alignment);
+
+  if (used_ == 0 || head_ > tail_) {
+    // free space is [head_, capacity_) followed by [0, tail_)
+    if (offset + size <= capacity_) {
+      return take(offset, size);
+    }
+    // skip the tail and wrap around
+    if (size <= tail_) {
+      return take(0, size);
+    }
+    return std::nullopt;
+  }
+
+  // wrapped or full: free space is [head_, tail_)
+  if (head_ < tail_ && offset + size <= tail_) {
+    return take(offset, size);
+  }
+  return std::nullopt;
+}
+
+void StagingRing::close(uint64_t timeline_value) {
+  if (open_bytes_ == 0) {
+    return;
+  }
+  closed_.push_back(
+      Range{ .end_ = head_, .bytes_ = open_bytes_, .timeline_value_ = timeline_value });
+  open_bytes_ = 0;
+}
+
+void StagingRing::retire(uint64_t completed_value) {
+  while (!closed_.empty() && closed_.front().timeline_value_ <= completed_value) {
+    tail_ = closed_.front().end_;
+    used_ -= closed_.front().bytes_;
+    closed_.pop_front();
+  }
+
+  if (used_ == 0) {
+    head_ = 0;
+    tail_ = 0;
+  }
+}
+
+}  // namespace gravity
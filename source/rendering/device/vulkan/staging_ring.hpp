@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+
+namespace gravity {
+
+// Offset bookkeeping for a persistently mapped staging buffer used as a ring. Allocations are
+// handed out in submission order; close() tags everything allocated since the previous close with
+// the timeline value of the submit that reads it, and retire() frees the oldest ranges once the
+// GPU has reached their value. Space lost when an allocation wraps around is freed with it.
+class StagingRing {
+ public:
+  explicit StagingRing(size_t capacity) : capacity_{ capacity } {}
+
+  // Returns the offset of size bytes aligned to alignment, or nullopt until enough is retired.
+  auto allocate(size_t size, size_t alignment) -> std::optional<size_t>;
+
+  void close(uint64_t timeline_value);
+  void retire(uint64_t completed_value);
+
+  [[nodiscard]] auto capacity() const -> size_t { return capacity_; }
+  [[nodiscard]] auto used() const -> size_t { return used_; }
+  // bytes allocated since the last close()
+  [[nodiscard]] auto pending() const -> size_t { return open_bytes_; }
+
+ private:
+  struct Range {
+    size_t end_;
+    size_t bytes_;
+    uint64_t timeline_value_;
+  };
+
+  size_t capacity_;
+
+  // live bytes are [tail_, head_), wrapping at capacity_; used_ tells full from empty
+  size_t head_ = 0;
+  size_t tail_ = 0;
+  size_t used_ = 0;
+
+  size_t open_bytes_ = 0;
+  std::deque<Range> closed_;
+};
+
+}  // namespace gravity
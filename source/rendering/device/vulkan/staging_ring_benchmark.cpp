@@ -0,0 +1,402 @@
+#include "source/rendering/device/vulkan/staging_ring.hpp"
+
+#include "benchmark/benchmark.h"
+#include "vulkan/vulkan_core.h"
+
+#define VMA_IMPLEMENTATION
+#include "vma/vk_mem_alloc.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+// Many small buffer uploads on a headless Vulkan device, the way VulkanRenderingDevice records
+// them against the staging buffer per upload that it replaced. An iteration uploads
+// UploadsPerFrame chunks of the argument's size, dealt round robin over DestinationCount
+// device-local buffers, and waits for the GPU to finish them.
+//
+//   BM_UploadStagingRing      StagingRing over one persistently mapped buffer, one
+//                             vkCmdCopyBuffer per destination with a region per upload, one submit
+//   BM_UploadStagingBuffers   a fresh mapped staging buffer per upload, copies recorded into one
+//                             submit, staging buffers destroyed once it completes
+//   BM_UploadStagingSubmits   a fresh staging buffer and its own submit and wait per upload
+//
+// Skipped when no Vulkan 1.2 device is available.
+
+namespace gravity {
+
+namespace {
+
+constexpr size_t UploadsPerFrame{ 1024 };
+constexpr size_t DestinationCount{ 64 };
+constexpr size_t DestinationSize{ 4 * 1024 * 1024 };
+constexpr size_t StagingRingSize{ 32 * 1024 * 1024 };
+constexpr size_t UploadAlignment{ 16 };
+
+struct Buffer {
+  VkBuffer buffer_ = VK_NULL_HANDLE;
+  VmaAllocation allocation_ = VK_NULL_HANDLE;
+  VmaAllocationInfo allocation_info_{};
+};
+
+// Instance, device, allocator, one queue with a command buffer, a timeline semaphore and the
+// destination buffers; just enough to time transfers.
+class HeadlessDevice {
+ public:
+  static auto create() -> std::unique_ptr<HeadlessDevice> {
+    auto device = std::unique_ptr<HeadlessDevice>{ new HeadlessDevice };
+    return device->initialize() ? std::move(device) : nullptr;
+  }
+
+  HeadlessDevice(const HeadlessDevice&) = delete;
+  auto operator=(const HeadlessDevice&) -> HeadlessDevice& = delete;
+
+  ~HeadlessDevice() {
+    if (device_ != VK_NULL_HANDLE) {
+      vkDeviceWaitIdle(device_);
+      for (auto& destination : destinations_) {
+        vmaDestroyBuffer(allocator_, destination.buffer_, destination.allocation_);
+      }
+      vkDestroySemaphore(device_, timeline_, nullptr);
+      vkDestroyCommandPool(device_, command_pool_, nullptr);
+      if (allocator_ != VK_NULL_HANDLE) {
+        vmaDestroyAllocator(allocator_);
+      }
+      vkDestroyDevice(device_, nullptr);
+    }
+    if (instance_ != VK_NULL_HANDLE) {
+      vkDestroyInstance(instance_, nullptr);
+    }
+  }
+
+  [[nodiscard]] auto allocator() const -> VmaAllocator { return allocator_; }
+  [[nodiscard]] auto commandBuffer() const -> VkCommandBuffer { return command_buffer_; }
+  [[nodiscard]] auto destination(size_t index) const -> VkBuffer {
+    return destinations_[index].buffer_;
+  }
+
+  auto createStaging(size_t size) -> Buffer {
+    VkBufferCreateInfo buffer_create_info{ .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+                                           .size = size,
+                                           .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT };
+    VmaAllocationCreateInfo allocation_create_info{
+      .flags = VMA_ALLOCATION_CREATE_MAPPED_BIT |
+               VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT,
+      .usage = VMA_MEMORY_USAGE_AUTO,
+    };
+
+    Buffer buffer;
+    vmaCreateBuffer(
+        allocator_, &buffer_create_info, &allocation_create_info, &buffer.buffer_,
+        &buffer.allocation_, &buffer.allocation_info_);
+    return buffer;
+  }
+
+  void destroy(const Buffer& buffer) {
+    vmaDestroyBuffer(allocator_, buffer.buffer_, buffer.allocation_);
+  }
+
+  void begin() {
+    vkResetCommandBuffer(command_buffer_, 0);
+    VkCommandBufferBeginInfo begin_info{ .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+                                         .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT };
+    vkBeginCommandBuffer(command_buffer_, &begin_info);
+  }
+
+  // Submits what was recorded since begin(), signalling the returned timeline value.
+  auto submit() -> uint64_t {
+    vkEndCommandBuffer(command_buffer_);
+
+    auto signal_value = ++timeline_value_;
+    VkTimelineSemaphoreSubmitInfo timeline_info{
+      .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+      .signalSemaphoreValueCount = 1,
+      .pSignalSemaphoreValues = &signal_value,
+    };
+    VkSubmitInfo submit_info{ .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+                              .pNext = &timeline_info,
+                              .commandBufferCount = 1,
+                              .pCommandBuffers = &command_buffer_,
+                              .signalSemaphoreCount = 1,
+                              .pSignalSemaphores = &timeline_ };
+    vkQueueSubmit(queue_, 1, &submit_info, VK_NULL_HANDLE);
+    return signal_value;
+  }
+
+  void wait(uint64_t value) {
+    VkSemaphoreWaitInfo wait_info{ .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+                                   .semaphoreCount = 1,
+                                   .pSemaphores = &timeline_,
+                                   .pValues = &value };
+    vkWaitSemaphores(device_, &wait_info, UINT64_MAX);
+  }
+
+ private:
+  VkInstance instance_ = VK_NULL_HANDLE;
+  VkPhysicalDevice physical_device_ = VK_NULL_HANDLE;
+  VkDevice device_ = VK_NULL_HANDLE;
+  VkQueue queue_ = VK_NULL_HANDLE;
+  VmaAllocator allocator_ = VK_NULL_HANDLE;
+  VkCommandPool command_pool_ = VK_NULL_HANDLE;
+  VkCommandBuffer command_buffer_ = VK_NULL_HANDLE;
+  VkSemaphore timeline_ = VK_NULL_HANDLE;
+  uint64_t timeline_value_ = 0;
+  std::vector<Buffer> destinations_;
+
+  HeadlessDevice() = default;
+
+  auto initialize() -> bool {
+    VkApplicationInfo application_info{ .sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
+                                        .pApplicationName = "staging_ring_benchmark",
+                                        .apiVersion = VK_API_VERSION_1_2 };
+    VkInstanceCreateInfo instance_create_info{ .sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
+                                               .pApplicationInfo = &application_info };
+    if (vkCreateInstance(&instance_create_info, nullptr, &instance_) != VK_SUCCESS) {
+      return false;
+    }
+
+    uint32_t device_count{ 0 };
+    vkEnumeratePhysicalDevices(instance_, &device_count, nullptr);
+    std::vector<VkPhysicalDevice> physical_devices(device_count);
+    vkEnumeratePhysicalDevices(instance_, &device_count, physical_devices.data());
+
+    // any queue that can copy; graphics and compute queues implicitly can
+    constexpr VkQueueFlags CopyQueue{ VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT |
+                                      VK_QUEUE_TRANSFER_BIT };
+    uint32_t queue_family{ UINT32_MAX };
+    for (auto physical_device : physical_devices) {
+      uint32_t family_count{ 0 };
+      vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &family_count, nullptr);
+      std::vector<VkQueueFamilyProperties> families(family_count);
+      vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &family_count, families.data());
+
+      auto family = std::ranges::find_if(families, [](const VkQueueFamilyProperties& properties) {
+        return (properties.queueFlags & CopyQueue) != 0;
+      });
+      if (family != families.end()) {
+        physical_device_ = physical_device;
+        queue_family = static_cast<uint32_t>(family - families.begin());
+        break;
+      }
+    }
+    if (physical_device_ == VK_NULL_HANDLE) {
+      return false;
+    }
+
+    float priority{ 1.0F };
+    VkDeviceQueueCreateInfo queue_create_info{ .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+                                               .queueFamilyIndex = queue_family,
+                                               .queueCount = 1,
+                                               .pQueuePriorities = &priority };
+    VkPhysicalDeviceVulkan12Features features_12{
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+      .timelineSemaphore = VK_TRUE,
+    };
+    VkDeviceCreateInfo device_create_info{ .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+                                           .pNext = &features_12,
+                                           .queueCreateInfoCount = 1,
+                                           .pQueueCreateInfos = &queue_create_info };
+    if (vkCreateDevice(physical_device_, &device_create_info, nullptr, &device_) != VK_SUCCESS) {
+      return false;
+    }
+    vkGetDeviceQueue(device_, queue_family, 0, &queue_);
+
+    VmaAllocatorCreateInfo allocator_create_info{ .physicalDevice = physical_device_,
+                                                  .device = device_,
+                                                  .instance = instance_,
+                                                  .vulkanApiVersion = VK_API_VERSION_1_2 };
+    if (vmaCreateAllocator(&allocator_create_info, &allocator_) != VK_SUCCESS) {
+      return false;
+    }
+
+    VkCommandPoolCreateInfo pool_create_info{
+      .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+      .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+      .queueFamilyIndex = queue_family,
+    };
+    if (vkCreateCommandPool(device_, &pool_create_info, nullptr, &command_pool_) != VK_SUCCESS) {
+      return false;
+    }
+    VkCommandBufferAllocateInfo command_buffer_info{
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+      .commandPool = command_pool_,
+      .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+      .commandBufferCount = 1,
+    };
+    if (vkAllocateCommandBuffers(device_, &command_buffer_info, &command_buffer_) != VK_SUCCESS) {
+      return false;
+    }
+
+    VkSemaphoreTypeCreateInfo timeline_type{ .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+                                             .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+                                             .initialValue = 0 };
+    VkSemaphoreCreateInfo semaphore_create_info{ .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+                                                 .pNext = &timeline_type };
+    if (vkCreateSemaphore(device_, &semaphore_create_info, nullptr, &timeline_) != VK_SUCCESS) {
+      return false;
+    }
+
+    VkBufferCreateInfo destination_create_info{ .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+                                                .size = DestinationSize,
+                                                .usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+                                                         VK_BUFFER_USAGE_VERTEX_BUFFER_BIT };
+    VmaAllocationCreateInfo destination_allocation{
+      .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+    };
+    destinations_.resize(DestinationCount);
+    for (auto& destination : destinations_) {
+      if (vmaCreateBuffer(
+              allocator_, &destination_create_info, &destination_allocation, &destination.buffer_,
+              &destination.allocation_, &destination.allocation_info_) != VK_SUCCESS) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+auto headlessDevice() -> HeadlessDevice* {
+  static auto device = HeadlessDevice::create();
+  return device.get();
+}
+
+// upload i lands in destination i % DestinationCount, after the earlier uploads to it
+auto destinationOffset(size_t upload, size_t size) -> VkDeviceSize {
+  return static_cast<VkDeviceSize>(((upload / DestinationCount) * size) % DestinationSize);
+}
+
+void reportThroughput(benchmark::State& state, size_t size) {
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * UploadsPerFrame));
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * UploadsPerFrame * size));
+}
+
+void BM_UploadStagingRing(benchmark::State& state) {
+  auto* device = headlessDevice();
+  if (device == nullptr) {
+    state.SkipWithError("no Vulkan 1.2 device");
+    return;
+  }
+
+  auto size = static_cast<size_t>(state.range(0));
+  std::vector<std::byte> data(size, std::byte{ 0x5a });
+
+  auto staging = device->createStaging(StagingRingSize);
+  auto* mapped = static_cast<std::byte*>(staging.allocation_info_.pMappedData);
+  StagingRing ring{ StagingRingSize };
+
+  std::vector<std::vector<VkBufferCopy>> regions(DestinationCount);
+  for (auto _ : state) {
+    for (auto& destination_regions : regions) {
+      destination_regions.clear();
+    }
+
+    for (size_t upload = 0; upload < UploadsPerFrame; ++upload) {
+      auto offset = ring.allocate(size, UploadAlignment);
+      if (!offset) {
+        state.SkipWithError("the staging ring is too small for a frame");
+        device->destroy(staging);
+        return;
+      }
+      std::memcpy(mapped + *offset, data.data(), size);
+      regions[upload % DestinationCount].push_back(VkBufferCopy{
+          .srcOffset = *offset, .dstOffset = destinationOffset(upload, size), .size = size });
+    }
+    vmaFlushAllocation(device->allocator(), staging.allocation_, 0, VK_WHOLE_SIZE);
+
+    device->begin();
+    for (size_t destination = 0; destination < DestinationCount; ++destination) {
+      vkCmdCopyBuffer(
+          device->commandBuffer(), staging.buffer_, device->destination(destination),
+          static_cast<uint32_t>(regions[destination].size()), regions[destination].data());
+    }
+    auto value = device->submit();
+    ring.close(value);
+
+    device->wait(value);
+    ring.retire(value);
+  }
+
+  device->destroy(staging);
+  reportThroughput(state, size);
+}
+
+void BM_UploadStagingBuffers(benchmark::State& state) {
+  auto* device = headlessDevice();
+  if (device == nullptr) {
+    state.SkipWithError("no Vulkan 1.2 device");
+    return;
+  }
+
+  auto size = static_cast<size_t>(state.range(0));
+  std::vector<std::byte> data(size, std::byte{ 0x5a });
+
+  std::vector<Buffer> stagings;
+  stagings.reserve(UploadsPerFrame);
+  for (auto _ : state) {
+    device->begin();
+    for (size_t upload = 0; upload < UploadsPerFrame; ++upload) {
+      auto staging = device->createStaging(size);
+      std::memcpy(staging.allocation_info_.pMappedData, data.data(), size);
+      vmaFlushAllocation(device->allocator(), staging.allocation_, 0, VK_WHOLE_SIZE);
+
+      VkBufferCopy region{
+          .srcOffset = 0, .dstOffset = destinationOffset(upload, size), .size = size };
+      vkCmdCopyBuffer(
+          device->commandBuffer(), staging.buffer_, device->destination(upload % DestinationCount),
+          1, &region);
+      stagings.push_back(staging);
+    }
+    device->wait(device->submit());
+
+    for (const auto& staging : stagings) {
+      device->destroy(staging);
+    }
+    stagings.clear();
+  }
+  reportThroughput(state, size);
+}
+
+void BM_UploadStagingSubmits(benchmark::State& state) {
+  auto* device = headlessDevice();
+  if (device == nullptr) {
+    state.SkipWithError("no Vulkan 1.2 device");
+    return;
+  }
+
+  auto size = static_cast<size_t>(state.range(0));
+  std::vector<std::byte> data(size, std::byte{ 0x5a });
+
+  for (auto _ : state) {
+    for (size_t upload = 0; upload < UploadsPerFrame; ++upload) {
+      auto staging = device->createStaging(size);
+      std::memcpy(staging.allocation_info_.pMappedData, data.data(), size);
+      vmaFlushAllocation(device->allocator(), staging.allocation_, 0, VK_WHOLE_SIZE);
+
+      device->begin();
+      VkBufferCopy region{
+          .srcOffset = 0, .dstOffset = destinationOffset(upload, size), .size = size };
+      vkCmdCopyBuffer(
+          device->commandBuffer(), staging.buffer_, device->destination(upload % DestinationCount),
+          1, &region);
+      device->wait(device->submit());
+
+      device->destroy(staging);
+    }
+  }
+  reportThroughput(state, size);
+}
+
+void uploadSizes(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgName("bytes")->Arg(256)->Arg(4096)->Arg(16384)->Unit(benchmark::kMicrosecond);
+}
+
+BENCHMARK(BM_UploadStagingRing)->Apply(uploadSizes)->UseRealTime();
+BENCHMARK(BM_UploadStagingBuffers)->Apply(uploadSizes)->UseRealTime();
+BENCHMARK(BM_UploadStagingSubmits)->Apply(uploadSizes)->UseRealTime();
+
+}  // namespace
+
+}  // namespace gravity
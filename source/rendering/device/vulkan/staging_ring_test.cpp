@@ -0,0 +1,165 @@
+#include "source/rendering/device/vulkan/staging_ring.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <vector>
+
+namespace gravity {
+
+namespace {
+
+TEST(StagingRingTest, AllocatesInOrderWithAlignment) {
+  StagingRing ring{ 256 };
+
+  EXPECT_EQ(ring.allocate(10, 1), std::optional<size_t>{ 0 });
+  EXPECT_EQ(ring.allocate(10, 16), std::optional<size_t>{ 16 });
+  EXPECT_EQ(ring.allocate(4, 4), std::optional<size_t>{ 28 });
+  // alignment padding counts as used
+  EXPECT_EQ(ring.used(), 32U);
+  EXPECT_EQ(ring.pending(), 32U);
+
+  ring.close(1);
+  EXPECT_EQ(ring.pending(), 0U);
+  EXPECT_EQ(ring.used(), 32U);
+}
+
+TEST(StagingRingTest, RejectsEmptyAndOversizedAllocations) {
+  StagingRing ring{ 64 };
+  EXPECT_FALSE(ring.allocate(0, 1));
+  EXPECT_FALSE(ring.allocate(65, 1));
+  EXPECT_EQ(ring.allocate(64, 1), std::optional<size_t>{ 0 });
+}
+
+TEST(StagingRingTest, FullRingWaitsForTheTimeline) {
+  StagingRing ring{ 64 };
+  ASSERT_TRUE(ring.allocate(64, 1));
+  EXPECT_FALSE(ring.allocate(1, 1));
+
+  ring.close(5);
+  ring.retire(4);
+  EXPECT_FALSE(ring.allocate(1, 1));
+
+  ring.retire(5);
+  EXPECT_EQ(ring.used(), 0U);
+  EXPECT_EQ(ring.allocate(64, 1), std::optional<size_t>{ 0 });
+}
+
+TEST(StagingRingTest, OpenAllocationsAreNotRetired) {
+  StagingRing ring{ 64 };
+  ASSERT_TRUE(ring.allocate(16, 1));
+  ring.close(1);
+  ASSERT_TRUE(ring.allocate(16, 1));
+
+  // the second allocation has no timeline value yet
+  ring.retire(100);
+  EXPECT_EQ(ring.used(), 16U);
+  EXPECT_EQ(ring.pending(), 16U);
+
+  // closing with nothing allocated adds no range
+  ring.close(2);
+  ring.close(3);
+  ring.retire(2);
+  EXPECT_EQ(ring.used(), 0U);
+}
+
+TEST(StagingRingTest, WrapsAroundAndFreesTheSkippedTail) {
+  StagingRing ring{ 100 };
+  EXPECT_EQ(ring.allocate(60, 1), std::optional<size_t>{ 0 });
+  ring.close(1);
+  EXPECT_EQ(ring.allocate(30, 1), std::optional<size_t>{ 60 });
+  ring.close(2);
+  ring.retire(1);
+  EXPECT_EQ(ring.used(), 30U);
+
+  // does not fit in [90, 100), wraps to the front and charges the 10 skipped bytes
+  EXPECT_EQ(ring.allocate(20, 1), std::optional<size_t>{ 0 });
+  EXPECT_EQ(ring.used(), 60U);
+  EXPECT_EQ(ring.allocate(40, 1), std::optional<size_t>{ 20 });
+  EXPECT_EQ(ring.used(), 100U);
+  EXPECT_FALSE(ring.allocate(1, 1));
+  ring.close(3);
+
+  ring.retire(2);
+  EXPECT_EQ(ring.used(), 70U);
+  EXPECT_FALSE(ring.allocate(40, 1));
+  EXPECT_EQ(ring.allocate(30, 1), std::optional<size_t>{ 60 });
+
+  ring.close(4);
+  ring.retire(4);
+  EXPECT_EQ(ring.used(), 0U);
+  EXPECT_EQ(ring.allocate(100, 1), std::optional<size_t>{ 0 });
+}
+
+TEST(StagingRingTest, WrapFailsWhileTheFrontIsInUse) {
+  StagingRing ring{ 100 };
+  ASSERT_TRUE(ring.allocate(50, 1));
+  ring.close(1);
+  ASSERT_TRUE(ring.allocate(40, 1));
+  ring.close(2);
+
+  // [90, 100) is too small and [0, 50) has not been retired
+  EXPECT_FALSE(ring.allocate(20, 1));
+  ring.retire(1);
+  EXPECT_EQ(ring.allocate(20, 1), std::optional<size_t>{ 0 });
+}
+
+// Random frames against a model of the live allocations: nothing handed out may overlap an
+// allocation whose submit has not completed.
+TEST(StagingRingTest, LiveAllocationsNeverOverlap) {
+  struct Live {
+    size_t offset_;
+    size_t size_;
+    uint64_t timeline_value_;
+  };
+
+  constexpr size_t Capacity{ 4096 };
+  StagingRing ring{ Capacity };
+  std::vector<Live> live;
+  std::mt19937 random{ 7 };
+  std::uniform_int_distribution<size_t> sizes{ 1, 700 };
+  std::uniform_int_distribution<int> alignment_shift{ 0, 6 };
+
+  uint64_t submitted{ 0 };
+  uint64_t completed{ 0 };
+  size_t allocations{ 0 };
+  for (size_t frame = 0; frame < 20'000; ++frame) {
+    for (auto uploads = random() % 6; uploads > 0; --uploads) {
+      auto size = sizes(random);
+      auto alignment = size_t{ 1 } << alignment_shift(random);
+      auto offset = ring.allocate(size, alignment);
+      if (!offset) {
+        continue;
+      }
+      ++allocations;
+
+      ASSERT_EQ(*offset % alignment, 0U);
+      ASSERT_LE(*offset + size, Capacity);
+      for (const auto& other : live) {
+        ASSERT_TRUE(*offset + size <= other.offset_ || other.offset_ + other.size_ <= *offset)
+            << "frame " << frame << ": [" << *offset << ", " << *offset + size
+            << ") overlaps [" << other.offset_ << ", " << other.offset_ + other.size_ << ")";
+      }
+      live.push_back({ .offset_ = *offset, .size_ = size, .timeline_value_ = submitted + 1 });
+    }
+
+    ring.close(++submitted);
+
+    // the GPU lags up to three submits behind
+    completed = std::max(completed, submitted - std::min<uint64_t>(submitted, random() % 4));
+    ring.retire(completed);
+    std::erase_if(live, [&](const Live& entry) { return entry.timeline_value_ <= completed; });
+  }
+
+  ring.retire(submitted);
+  EXPECT_EQ(ring.used(), 0U);
+  EXPECT_GT(allocations, 10'000U);
+}
+
+}  // namespace
+
+}  // namespace gravity
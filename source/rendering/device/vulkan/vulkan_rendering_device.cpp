@@ -1,7 +1,10 @@
 #include "vulkan_rendering_device.hpp"
 
+#include "boost/asio/as_tuple.hpp"
 #include "boost/asio/co_spawn.hpp"
+#include "boost/asio/detached.hpp"
 #include "boost/asio/use_awaitable.hpp"
+#include "source/common/diagnostics/trace.hpp"
 #include "source/common/logging/logger.hpp"
 #include "source/common/templates/bitmask.hpp"
 #include "source/platform/window/window_context.hpp"
@@ -21,11 +24,15 @@
 #include "vma/vk_mem_alloc.h"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <chrono>
 #include <cstddef>
+#include <cstring>
 #include <expected>
 #include <system_error>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #undef GRAVITY_MODULE_NAME
@@ -417,6 +424,57 @@ auto findGraphicsAndPresentQueueFamilyIndex(vk::PhysicalDevice device, vk::Surfa
   return std::unexpected(gravity::Error::InternalError);
 }
 
+// First uploads are submitted to the transfer queue once this much is staged, or with the next
+// frame, whichever comes first.
+constexpr size_t TransferBatchSize{ 4ULL * 1024 * 1024 };
+
+// Prefers a transfer-only family, usually backed by the DMA engines, then a compute family
+// without graphics; both can copy. The present family is skipped so no two threads ever submit
+// to one queue. Uploads copy whole subresources, which any minImageTransferGranularity allows.
+auto findTransferQueueFamilyIndex(
+    const std::vector<vk::QueueFamilyProperties>& queue_family_properties,
+    uint32_t graphics_queue_family_index, uint32_t present_queue_family_index)
+    -> std::optional<uint32_t> {
+  auto find = [&](auto&& matches) -> std::optional<uint32_t> {
+    for (uint32_t index = 0; index < queue_family_properties.size(); index++) {
+      if (index != graphics_queue_family_index && index != present_queue_family_index &&
+          queue_family_properties[index].queueCount > 0 &&
+          matches(queue_family_properties[index].queueFlags)) {
+        return index;
+      }
+    }
+    return std::nullopt;
+  };
+
+  if (auto index = find([](vk::QueueFlags flags) {
+        return (flags & vk::QueueFlagBits::eTransfer) &&
+               !(flags & (vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute));
+      })) {
+    return index;
+  }
+
+  return find([](vk::QueueFlags flags) {
+    return (flags & vk::QueueFlagBits::eCompute) && !(flags & vk::QueueFlagBits::eGraphics);
+  });
+}
+
+// Frees pending entries the GPU has finished with, oldest first, until budget runs out. Entries are
+// queued in timeline order, so the walk ends at the first one still in flight.
+template <typename T, typename Free>
+auto collectCompleted(std::vector<T>& pending, uint64_t completed, size_t& budget, Free&& free)
+    -> size_t {
+  auto end = pending.begin();
+  while (end != pending.end() && budget > 0 && end->fence_value_ <= completed) {
+    free(end->resource_);
+    ++end;
+    --budget;
+  }
+
+  auto count = static_cast<size_t>(std::distance(pending.begin(), end));
+  pending.erase(pending.begin(), end);
+  return count;
+}
+
 auto getRequiredDeviceExtensions(std::unordered_set<std::string>& enabled_instance_extension)
     -> std::unordered_map<std::string, bool> {
   std::unordered_map<std::string, bool> extensions;
@@ -519,10 +577,23 @@ auto getRequiredDeviceFeatures(const vk::PhysicalDevice& physical_device)
 
   device_features.vulkan_12_features_.sType = vk::StructureType::ePhysicalDeviceVulkan12Features;
 
+  device_features.vulkan_13_features_.sType = vk::StructureType::ePhysicalDeviceVulkan13Features;
+
   // Vulkan-Hpp requires you to use getFeatures2 for extended features
   vk::PhysicalDeviceFeatures2 features{};
   features.pNext = &device_features.vulkan_12_features_;
+  device_features.vulkan_12_features_.pNext = &device_features.vulkan_13_features_;
   physical_device.getFeatures2(&features);
+  // the chain points into this frame, initializeLogicalDevice links the returned copy again
+  device_features.vulkan_12_features_.pNext = nullptr;
+
+  // pipelines are built against attachment formats instead of render passes
+  auto dynamic_rendering = device_features.vulkan_13_features_.dynamicRendering;
+  device_features.vulkan_13_features_ = vk::PhysicalDeviceVulkan13Features{};
+  device_features.vulkan_13_features_.dynamicRendering = dynamic_rendering;
+  if (dynamic_rendering == VK_FALSE) {
+    LOG_WARN("dynamicRendering feature not supported by this device");
+  }
 
   // Enable timelineSemaphore only if supported
   if (device_features.vulkan_12_features_.timelineSemaphore != 0U) {
@@ -794,6 +865,228 @@ auto toVulkan(ShaderStage usage) -> VkShaderStageFlags {
   return flags;
 }
 
+auto toVulkan(VertexFormat vertex_format) -> VkFormat {
+  switch (vertex_format) {
+    case VertexFormat::Float1:
+      return VK_FORMAT_R32_SFLOAT;
+    case VertexFormat::Float2:
+      return VK_FORMAT_R32G32_SFLOAT;
+    case VertexFormat::Float3:
+      return VK_FORMAT_R32G32B32_SFLOAT;
+    case VertexFormat::Float4:
+      return VK_FORMAT_R32G32B32A32_SFLOAT;
+    case VertexFormat::Uint32:
+      return VK_FORMAT_R32_UINT;
+  }
+}
+
+auto toVulkan(VertexInputRate input_rate) -> VkVertexInputRate {
+  switch (input_rate) {
+    case VertexInputRate::Vertex:
+      return VK_VERTEX_INPUT_RATE_VERTEX;
+    case VertexInputRate::Instance:
+      return VK_VERTEX_INPUT_RATE_INSTANCE;
+  }
+}
+
+auto toVulkan(PrimitiveTopology topology) -> VkPrimitiveTopology {
+  switch (topology) {
+    case PrimitiveTopology::PointList:
+      return VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+    case PrimitiveTopology::LineList:
+      return VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
+    case PrimitiveTopology::LineStrip:
+      return VK_PRIMITIVE_TOPOLOGY_LINE_STRIP;
+    case PrimitiveTopology::TriangleList:
+      return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    case PrimitiveTopology::TriangleStrip:
+      return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+  }
+}
+
+auto toVulkan(CullMode cull_mode) -> VkCullModeFlags {
+  switch (cull_mode) {
+    case CullMode::None:
+      return VK_CULL_MODE_NONE;
+    case CullMode::Front:
+      return VK_CULL_MODE_FRONT_BIT;
+    case CullMode::Back:
+      return VK_CULL_MODE_BACK_BIT;
+  }
+}
+
+auto toVulkan(FrontFace front_face) -> VkFrontFace {
+  switch (front_face) {
+    case FrontFace::CounterClockwise:
+      return VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    case FrontFace::Clockwise:
+      return VK_FRONT_FACE_CLOCKWISE;
+  }
+}
+
+auto toVulkan(BlendFactor blend_factor) -> VkBlendFactor {
+  switch (blend_factor) {
+    case BlendFactor::Zero:
+      return VK_BLEND_FACTOR_ZERO;
+    case BlendFactor::One:
+      return VK_BLEND_FACTOR_ONE;
+    case BlendFactor::SourceColor:
+      return VK_BLEND_FACTOR_SRC_COLOR;
+    case BlendFactor::OneMinusSourceColor:
+      return VK_BLEND_FACTOR_ONE_MINUS_SRC_COLOR;
+    case BlendFactor::DestinationColor:
+      return VK_BLEND_FACTOR_DST_COLOR;
+    case BlendFactor::OneMinusDestinationColor:
+      return VK_BLEND_FACTOR_ONE_MINUS_DST_COLOR;
+    case BlendFactor::SourceAlpha:
+      return VK_BLEND_FACTOR_SRC_ALPHA;
+    case BlendFactor::OneMinusSourceAlpha:
+      return VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    case BlendFactor::DestinationAlpha:
+      return VK_BLEND_FACTOR_DST_ALPHA;
+    case BlendFactor::OneMinusDestinationAlpha:
+      return VK_BLEND_FACTOR_ONE_MINUS_DST_ALPHA;
+  }
+}
+
+auto toVulkan(BlendOperation blend_operation) -> VkBlendOp {
+  switch (blend_operation) {
+    case BlendOperation::Add:
+      return VK_BLEND_OP_ADD;
+    case BlendOperation::Subtract:
+      return VK_BLEND_OP_SUBTRACT;
+    case BlendOperation::ReverseSubtract:
+      return VK_BLEND_OP_REVERSE_SUBTRACT;
+    case BlendOperation::Min:
+      return VK_BLEND_OP_MIN;
+    case BlendOperation::Max:
+      return VK_BLEND_OP_MAX;
+  }
+}
+
+// bytes per texel of the formats toVulkan(Format) produces, 0 for formats uploads do not support
+auto texelSize(VkFormat format) -> size_t {
+  switch (format) {
+    case VK_FORMAT_R8G8B8A8_UNORM:
+    case VK_FORMAT_R8G8B8A8_SNORM:
+    case VK_FORMAT_R8G8B8A8_SRGB:
+      return 4;
+    case VK_FORMAT_R32G32_SFLOAT:
+      return 8;
+    case VK_FORMAT_R32G32B32_SFLOAT:
+      return 12;
+    case VK_FORMAT_R32G32B32A32_UINT:
+      return 16;
+    default:
+      return 0;
+  }
+}
+
+auto hasStencil(Format format) -> bool {
+  return format == Format::Depth24UnsignedNormalizedStencil8UnsignedInteger ||
+         format == Format::Depth32SignedFloatStencil8UnsignedInt;
+}
+
+// Every field takes part, so two descriptors only share a key when they build the same pipeline
+// (up to collisions, which the caller rules out by comparing descriptors).
+auto pipelineKey(const GraphicsPipelineDescriptor& descriptor) -> HashType {
+  HashType key{ 1 };
+  auto mix = [&key](auto value) { key = hashCombine(key, static_cast<HashType>(value)); };
+
+  mix(descriptor.shaders_.size());
+  for (auto shader : descriptor.shaders_) {
+    mix(shader.value());
+  }
+
+  mix(descriptor.vertex_layout_.bindings.size());
+  for (const auto& binding : descriptor.vertex_layout_.bindings) {
+    mix(binding.binding);
+    mix(binding.stride);
+    mix(binding.input_rate);
+  }
+
+  mix(descriptor.vertex_layout_.attributes.size());
+  for (const auto& attribute : descriptor.vertex_layout_.attributes) {
+    mix(attribute.location);
+    mix(attribute.format);
+    mix(attribute.offset);
+    mix(attribute.binding);
+  }
+
+  const auto& render_targets = descriptor.render_targets_;
+  mix(render_targets.color_formats_.size());
+  for (auto format : render_targets.color_formats_) {
+    mix(format);
+  }
+
+  mix(render_targets.blend_states_.size());
+  for (const auto& blend : render_targets.blend_states_) {
+    mix(blend.enabled_);
+    mix(blend.source_color_);
+    mix(blend.destination_color_);
+    mix(blend.color_operation_);
+    mix(blend.source_alpha_);
+    mix(blend.destination_alpha_);
+    mix(blend.alpha_operation_);
+  }
+
+  mix(render_targets.depth_format_);
+  mix(render_targets.samples_);
+
+  mix(descriptor.depth_state_.test_enabled_);
+  mix(descriptor.depth_state_.write_enabled_);
+  mix(descriptor.depth_state_.compare_operation_);
+
+  mix(descriptor.topology_);
+  mix(descriptor.cull_mode_);
+  mix(descriptor.front_face_);
+  mix(descriptor.push_constant_size_);
+
+  return key;
+}
+
+auto pipelineKey(const ComputePipelineDescriptor& descriptor) -> HashType {
+  return hashCombine(
+      hashCombine(2, descriptor.shader_.value()), descriptor.push_constant_size_);
+}
+
+auto pipelineShaders(const GraphicsPipelineDescriptor& descriptor)
+    -> std::vector<ShaderModuleHandle> {
+  return descriptor.shaders_;
+}
+
+auto pipelineShaders(const ComputePipelineDescriptor& descriptor)
+    -> std::vector<ShaderModuleHandle> {
+  return { descriptor.shader_ };
+}
+
+auto validatePipeline(const GraphicsPipelineDescriptor& descriptor) -> std::error_code {
+  const auto& render_targets = descriptor.render_targets_;
+  if (descriptor.shaders_.empty()) {
+    LOG_ERROR("graphics pipeline without shaders");
+    return Error::InvalidArgumentError;
+  }
+
+  if (!render_targets.blend_states_.empty() &&
+      render_targets.blend_states_.size() != render_targets.color_formats_.size()) {
+    LOG_ERROR(
+        "graphics pipeline blend states do not match its color targets; blend_states: {}, "
+        "color_targets: {}",
+        render_targets.blend_states_.size(), render_targets.color_formats_.size());
+    return Error::InvalidArgumentError;
+  }
+
+  return Error::OK;
+}
+
+auto validatePipeline(const ComputePipelineDescriptor& descriptor) -> std::error_code {
+  if (descriptor.shader_.isNull()) {
+    LOG_ERROR("compute pipeline without a shader");
+    return Error::InvalidArgumentError;
+  }
+  return Error::OK;
+}
+
 }  // namespace
 
 namespace gravity {
@@ -809,47 +1102,83 @@ auto operator==(
 }
 
 VulkanRenderingDevice::~VulkanRenderingDevice() {
-  sync();
-
-  for (auto& buffer : buffers_) {
-    auto result = boost::asio::co_spawn(
-        strands_.getStrand(StrandLanes::Buffer),
-        doDestroyBuffer({ .index_ = buffer.index_, .generation_ = buffer.generation_ }),
-        boost::asio::use_future);
-    result.wait();
+  // everything that waits on a strand or the GPU was done by shutdown(), the RAII handles go away
+  // with their members
+  if (memory_allocator_ != nullptr) {
+    vmaDestroyAllocator(memory_allocator_);
   }
+}
+
+auto VulkanRenderingDevice::shutdown() -> boost::asio::awaitable<void> {
+  co_await stopPipelineCacheSaver();
+
+  // compiling pipelines run on the worker threads and write back into this device
+  co_await co_spawn(
+      strands_.getStrand(StrandLanes::Pipeline),
+      [this] -> boost::asio::awaitable<void> {
+        if (pipelines_compiling_ > 0) {
+          co_await pipelines_idle_->wait();
+        }
+      },
+      use_awaitable);
+
+  // a collection scheduled by the last frame is queued on the Cleanup strand ahead of this
+  co_await co_spawn(
+      strands_.getStrand(StrandLanes::Cleanup),
+      [this] -> boost::asio::awaitable<void> {
+        if (collection_scheduled_) {
+          co_await collector_idle_->wait();
+        }
+      },
+      use_awaitable);
 
-  for (auto& image : images_) {
-    auto result = boost::asio::co_spawn(
-        strands_.getStrand(StrandLanes::Buffer),
-        doDestroyImage({ .index_ = image.index_, .generation_ = image.generation_ }),
-        boost::asio::use_future);
-    result.wait();
+  if (device_) {
+    sync();
   }
+  fence_waiter_.join();
+
+  savePipelineCache();
+  pipeline_statistics_.report(pipeline_cache_warm_);
 
-  for (auto& shader_module : shader_modules_) {
-    auto result = boost::asio::co_spawn(
-        strands_.getStrand(StrandLanes::Buffer),
-        doDestroyShader(
-            { .index_ = shader_module.index_, .generation_ = shader_module.generation_ }),
-        boost::asio::use_future);
-    result.wait();
+  if (memory_allocator_ == nullptr) {
+    co_return;
   }
 
-  auto result = boost::asio::co_spawn(
+  // Samplers and shader modules are RAII handles and go away with their slot maps, buffers and
+  // images are VMA allocations and have to be handed back explicitly.
+  co_await co_spawn(
       strands_.getStrand(StrandLanes::Buffer),
       [this] -> boost::asio::awaitable<void> {
+        // destroying erases from the slot maps, walk copies of the live handles
+        std::vector<BufferHandle> buffer_handles{ buffers_.handles().begin(),
+                                                  buffers_.handles().end() };
+        for (auto buffer_handle : buffer_handles) {
+          co_await doDestroyBuffer(buffer_handle);
+        }
+
+        std::vector<ImageHandle> image_handles{ images_.handles().begin(),
+                                                images_.handles().end() };
+        for (auto image_handle : image_handles) {
+          co_await doDestroyImage(image_handle);
+        }
+
         collectPendingDestroy();
-        co_return;
+
+        if (staging_buffer_.buffer_ != VK_NULL_HANDLE) {
+          freeBuffer(staging_buffer_);
+        }
       },
-      boost::asio::use_future);
-  result.wait();
+      use_awaitable);
 
   vmaDestroyAllocator(memory_allocator_);
+  memory_allocator_ = nullptr;
 }
 
-VulkanRenderingDevice::VulkanRenderingDevice(WindowContext& window_context, StrandGroup strands)
-    : window_context_{ window_context }, strands_{ std::move(strands) } {}
+VulkanRenderingDevice::VulkanRenderingDevice(
+    WindowContext& window_context, StrandGroup strands, std::string pipeline_cache_path)
+    : window_context_{ window_context },
+      strands_{ std::move(strands) },
+      pipeline_cache_path_{ std::move(pipeline_cache_path) } {}
 
 auto VulkanRenderingDevice::initialize() -> boost::asio::awaitable<std::error_code> {
   co_return co_await co_spawn(
@@ -862,10 +1191,7 @@ auto VulkanRenderingDevice::prepareBuffers() -> boost::asio::awaitable<std::erro
   auto executor = co_await boost::asio::this_coro::executor;
   auto& sync = frames_.at(current_frame_);
 
-  while (device_->waitForFences({ *sync.in_flight_ }, VK_TRUE, 0) == vk::Result::eTimeout) {
-    co_await boost::asio::steady_timer(executor, WaitDuration)
-        .async_wait(boost::asio::use_awaitable);
-  }
+  co_await sync.in_flight_signaled_->wait();
 
   while (true) {
     auto [result, image_index]{ swapchain_resources_.swapchain_->acquireNextImage(
@@ -873,17 +1199,14 @@ auto VulkanRenderingDevice::prepareBuffers() -> boost::asio::awaitable<std::erro
 
     if (result == vk::Result::eSuccess || result == vk::Result::eSuboptimalKHR) {
       if (frames_in_flight_[image_index] != nullptr) {
-        while (device_->waitForFences({ *frames_in_flight_[image_index] }, VK_TRUE, 0) ==
-               vk::Result::eTimeout) {
-          co_await boost::asio::steady_timer(executor, WaitDuration)
-              .async_wait(boost::asio::use_awaitable);
-        }
+        co_await frames_in_flight_[image_index]->in_flight_signaled_->wait();
       }
-      frames_in_flight_[image_index] = &(*sync.in_flight_);
+      frames_in_flight_[image_index] = &sync;
 
       swapchain_resources_.current_buffer_ = image_index;
 
       device_->resetFences({ *sync.in_flight_ });
+      sync.in_flight_signaled_->reset();
       sync.command_pool_->reset();
       sync.command_buffers_.clear();
 
@@ -911,12 +1234,15 @@ auto VulkanRenderingDevice::prepareBuffers() -> boost::asio::awaitable<std::erro
 auto VulkanRenderingDevice::swapBuffers() -> boost::asio::awaitable<std::error_code> {
   std::vector<vk::SubmitInfo> submit_info_list;
 
-  vk::PipelineStageFlags wait_destination_stage_mask{
-    vk::PipelineStageFlagBits::eColorAttachmentOutput
-  };
-
   auto& sync = frames_.at(current_frame_);
 
+  if (auto error{ co_await co_spawn(
+          strands_.getStrand(StrandLanes::Buffer), recordUploads(sync),
+          boost::asio::use_awaitable) };
+      error) {
+    co_return error;
+  }
+
   vk::Semaphore image_available = **sync.image_available_;
   vk::Semaphore render_finished = **sync.render_finished_;
   vk::Semaphore timeline_semaphore = **timeline_semaphore_;
@@ -924,19 +1250,42 @@ auto VulkanRenderingDevice::swapBuffers() -> boost::asio::awaitable<std::error_c
   std::vector<vk::CommandBuffer> command_buffers{ sync.command_buffers_.begin(),
                                                   sync.command_buffers_.end() };
 
+  std::vector<vk::Semaphore> wait_semaphores{ image_available };
+  std::vector<vk::PipelineStageFlags> wait_destination_stage_masks{
+    vk::PipelineStageFlagBits::eColorAttachmentOutput
+  };
+  // binary semaphores ignore their value
+  std::vector<uint64_t> wait_values{ 0 };
+
+  if (sync.transfer_wait_value_ != 0) {
+    // uploads copied on the transfer queue, acquired at the start of this submit
+    wait_semaphores.push_back(**transfer_semaphore_);
+    wait_destination_stage_masks.emplace_back(vk::PipelineStageFlagBits::eAllCommands);
+    wait_values.push_back(sync.transfer_wait_value_);
+  }
+
   auto& submit_info{ submit_info_list.emplace_back(
-      image_available, wait_destination_stage_mask, command_buffers, render_finished) };
+      wait_semaphores, wait_destination_stage_masks, command_buffers, render_finished) };
 
-  vk::TimelineSemaphoreSubmitInfo timeline_submit_info{ 0, nullptr, 1, &timeline_value_ };
+  vk::TimelineSemaphoreSubmitInfo timeline_submit_info{
+    static_cast<uint32_t>(wait_values.size()), wait_values.data(), 1, &timeline_value_
+  };
 
   submit_info.pNext = &timeline_submit_info;
   submit_info.signalSemaphoreCount = 1;
   submit_info.pSignalSemaphores = &timeline_semaphore;
 
   graphics_queue_->submit(submit_info, *sync.in_flight_);
+  signalWhenComplete(sync);
 
   ++timeline_value_;
 
+  if (!collection_scheduled_.exchange(true)) {
+    co_spawn(
+        strands_.getStrand(StrandLanes::Cleanup), collectPendingDestroyIncrementally(),
+        boost::asio::detached);
+  }
+
   vk::SwapchainKHR swapchain = **swapchain_resources_.swapchain_;
   vk::PresentInfoKHR present_info{ render_finished, swapchain,
                                    swapchain_resources_.current_buffer_ };
@@ -977,6 +1326,14 @@ auto VulkanRenderingDevice::destroyBuffer(BufferHandle buffer_handle)
       boost::asio::use_awaitable);
 }
 
+auto VulkanRenderingDevice::upload(
+    BufferHandle buffer_handle, std::span<const std::byte> data, size_t offset)
+    -> boost::asio::awaitable<std::error_code> {
+  co_return co_await co_spawn(
+      strands_.getStrand(StrandLanes::Buffer), doUploadBuffer(buffer_handle, data, offset),
+      boost::asio::use_awaitable);
+}
+
 auto VulkanRenderingDevice::createImage(const ImageDescriptor& descriptor)
     -> boost::asio::awaitable<std::expected<ImageHandle, std::error_code>> {
   co_return co_await co_spawn(
@@ -991,6 +1348,14 @@ auto VulkanRenderingDevice::destroyImage(ImageHandle image_handle)
       boost::asio::use_awaitable);
 }
 
+auto VulkanRenderingDevice::upload(
+    ImageHandle image_handle, std::span<const std::byte> data, uint32_t mip_level, uint32_t layer)
+    -> boost::asio::awaitable<std::error_code> {
+  co_return co_await co_spawn(
+      strands_.getStrand(StrandLanes::Buffer),
+      doUploadImage(image_handle, data, mip_level, layer), boost::asio::use_awaitable);
+}
+
 auto VulkanRenderingDevice::createSampler(const SamplerDescriptor& descriptor)
     -> boost::asio::awaitable<std::expected<SamplerHandle, std::error_code>> {
   co_return co_await co_spawn(
@@ -1019,11 +1384,43 @@ auto VulkanRenderingDevice::destroyShaderModule(ShaderModuleHandle shader_handle
       boost::asio::use_awaitable);
 }
 
+auto VulkanRenderingDevice::createGraphicsPipeline(const GraphicsPipelineDescriptor& descriptor)
+    -> boost::asio::awaitable<std::expected<PipelineHandle, std::error_code>> {
+  co_return co_await co_spawn(
+      strands_.getStrand(StrandLanes::Pipeline), doCreatePipeline(descriptor),
+      boost::asio::use_awaitable);
+}
+
+auto VulkanRenderingDevice::createComputePipeline(const ComputePipelineDescriptor& descriptor)
+    -> boost::asio::awaitable<std::expected<PipelineHandle, std::error_code>> {
+  co_return co_await co_spawn(
+      strands_.getStrand(StrandLanes::Pipeline), doCreatePipeline(descriptor),
+      boost::asio::use_awaitable);
+}
+
+auto VulkanRenderingDevice::waitPipeline(PipelineHandle pipeline_handle)
+    -> boost::asio::awaitable<std::error_code> {
+  co_return co_await co_spawn(
+      strands_.getStrand(StrandLanes::Pipeline), doWaitPipeline(pipeline_handle),
+      boost::asio::use_awaitable);
+}
+
+auto VulkanRenderingDevice::tryGetPipeline(PipelineHandle pipeline_handle) const
+    -> PipelineStatus {
+  // reads only the published status, the slot may be released concurrently
+  return pipelines_.findConcurrent(pipeline_handle).value_or(PipelineStatus::Failed);
+}
+
+auto VulkanRenderingDevice::destroyPipeline(PipelineHandle pipeline_handle)
+    -> boost::asio::awaitable<std::error_code> {
+  co_return co_await co_spawn(
+      strands_.getStrand(StrandLanes::Pipeline), doDestroyPipeline(pipeline_handle),
+      boost::asio::use_awaitable);
+}
+
 auto VulkanRenderingDevice::ShaderHash::operator()(const ShaderModuleDescriptor& descriptor) const
     -> HashType {
-  HashType hash = std::hash<int>{}(static_cast<int>(descriptor.stage_));
-  hashCombine(hash, descriptor.hash_);
-  return hash;
+  return hashCombine(static_cast<HashType>(descriptor.stage_), descriptor.hash_);
 }
 
 auto VulkanRenderingDevice::doInitialize() -> boost::asio::awaitable<std::error_code> {
@@ -1055,6 +1452,10 @@ auto VulkanRenderingDevice::doInitialize() -> boost::asio::awaitable<std::error_
     co_return error;
   }
 
+  if (auto error{ co_await initializeStagingRing() }; error) {
+    co_return error;
+  }
+
   if (auto error{ co_await initializeDescriptorSetAllocator() }; error) {
     co_return error;
   }
@@ -1152,65 +1553,44 @@ auto VulkanRenderingDevice::doCreateBuffer(BufferDescriptor descriptor)
     co_return std::unexpected(Error::InternalError);
   }
 
-  size_t slot_index{ 0 };
-  if (!buffer_free_list_.empty()) {
-    slot_index = buffer_free_list_.back();
-    buffer_free_list_.pop_back();
-  } else {
-    buffers_.emplace_back();
-    slot_index = buffers_.size() - 1;
+  auto buffer_handle{ buffers_.emplace(buffer) };
+  if (!buffer_handle) [[unlikely]] {
+    LOG_ERROR("created buffer failed, out of buffer slots; size: {}", descriptor.size_);
+    freeBuffer(buffer);
+    co_return std::unexpected(Error::UnavailableError);
   }
-  buffers_[slot_index].index_ = slot_index;
-  buffers_[slot_index].buffer_ = buffer;
 
   LOG_DEBUG(
       "created buffer success; size: {}, usage: {}, visibility: {}, index: {}, generation: {}, "
       "buffer_allocator_size: {}",
       descriptor.size_, magic_enum::enum_name(descriptor.usage_),
-      magic_enum::enum_name(descriptor.visibility_), buffers_[slot_index].index_,
-      buffers_[slot_index].generation_, buffers_.size());
+      magic_enum::enum_name(descriptor.visibility_), buffer_handle->index(),
+      buffer_handle->generation(), buffers_.size());
 
-  co_return BufferHandle{ .index_ = buffers_[slot_index].index_,
-                          .generation_ = buffers_[slot_index].generation_ };
+  co_return *buffer_handle;
 }
 
 auto VulkanRenderingDevice::doDestroyBuffer(BufferHandle buffer_handle)
     -> boost::asio::awaitable<std::error_code> {
   LOG_DEBUG(
-      "destroy buffer; index: {}, handler generation: {}, storage_generation: {}, "
-      "current_timeline_value: {}",
-      buffer_handle.index_, buffer_handle.generation_, buffers_[buffer_handle.index_].generation_,
-      timeline_value_);
+      "destroy buffer; index: {}, generation: {}, current_timeline_value: {}",
+      buffer_handle.index(), buffer_handle.generation(), timeline_value_);
 
-  if (buffers_[buffer_handle.index_].buffer_.buffer_ == VK_NULL_HANDLE) {
+  auto buffer{ buffers_.extract(buffer_handle) };
+  if (!buffer) {
     LOG_TRACE("destroy buffer buffer already destroyed");
     co_return Error::OK;
   }
 
-  assert(buffer_handle.generation_ == buffers_[buffer_handle.index_].generation_);
-
-  buffers_[buffer_handle.index_].generation_++;
-
   pending_destroy_buffers_.emplace_back(
-      PendingDestroy{ .index_ = buffer_handle.index_, .fence_value_ = timeline_value_ });
+      PendingDestroy<Buffer>{ .resource_ = *buffer, .fence_value_ = timeline_value_ });
 
   co_return Error::OK;
 }
 
 auto VulkanRenderingDevice::doCreateImage(ImageDescriptor descriptor)
     -> boost::asio::awaitable<std::expected<ImageHandle, std::error_code>> {
-  ImageSlot* image_slot{ nullptr };
-
-  if (!buffer_free_list_.empty()) {
-    auto index = image_free_list_.back();
-    image_free_list_.pop_back();
-    image_slot = &images_.at(index);
-  } else {
-    image_slot = &images_.emplace_back();
-    image_slot->index_ = images_.size() - 1;
-  }
-
-  auto& image{ image_slot->image_ };
+  Image image{};
 
   auto& image_create_info{ image.image_create_info_ };
 
@@ -1266,27 +1646,183 @@ auto VulkanRenderingDevice::doCreateImage(ImageDescriptor descriptor)
   auto image_view_expect{ device_->createImageView(image_view_create_info) };
   if (!image_view_expect) {
     LOG_ERROR("unable to create image view");
+    freeImage(image);
     co_return std::unexpected(Error::InternalError);
   }
   image.image_view_ = image_view_expect->release();
 
-  co_return ImageHandle{ .index_ = image_slot->index_, .generation_ = image_slot->generation_ };
+  auto image_handle{ images_.emplace(image) };
+  if (!image_handle) [[unlikely]] {
+    LOG_ERROR("unable to create image, out of image slots");
+    freeImage(image);
+    co_return std::unexpected(Error::UnavailableError);
+  }
+
+  co_return *image_handle;
 }
 
 auto VulkanRenderingDevice::doDestroyImage(ImageHandle image_handle)
     -> boost::asio::awaitable<std::error_code> {
   LOG_DEBUG(
-      "destroy image; index: {}, handler generation: {}, storage_generation: {}, "
-      "current_timeline_value: {}",
-      image_handle.index_, image_handle.generation_, images_[image_handle.index_].generation_,
-      timeline_value_);
+      "destroy image; index: {}, generation: {}, current_timeline_value: {}", image_handle.index(),
+      image_handle.generation(), timeline_value_);
 
-  assert(image_handle.generation_ == images_[image_handle.index_].generation_);
-
-  images_[image_handle.index_].generation_++;
+  auto image{ images_.extract(image_handle) };
+  if (!image) {
+    LOG_TRACE("destroy image image already destroyed");
+    co_return Error::OK;
+  }
 
   pending_destroy_images_.emplace_back(
-      PendingDestroy{ .index_ = image_handle.index_, .fence_value_ = timeline_value_ });
+      PendingDestroy<Image>{ .resource_ = *image, .fence_value_ = timeline_value_ });
+
+  co_return Error::OK;
+}
+
+auto VulkanRenderingDevice::doUploadBuffer(
+    BufferHandle buffer_handle, std::span<const std::byte> data, size_t offset)
+    -> boost::asio::awaitable<std::error_code> {
+  constexpr size_t Alignment{ 16 };
+
+  const auto* buffer = buffers_.get(buffer_handle);
+  if (buffer == nullptr) {
+    co_return Error::NotFoundError;
+  }
+
+  if (offset > buffer->size_ || data.size() > buffer->size_ - offset) {
+    LOG_ERROR(
+        "buffer upload out of bounds; index: {}, size: {}, offset: {}, buffer_size: {}",
+        buffer_handle.index(), data.size(), offset, buffer->size_);
+    co_return Error::InvalidArgumentError;
+  }
+
+  // large uploads go through in chunks so they can stream across frames
+  auto chunk_size = staging_ring_->capacity() / 4;
+  auto* staging_data = static_cast<std::byte*>(staging_buffer_.allocation_info_.pMappedData);
+
+  while (!data.empty()) {
+    auto chunk = data.first(std::min(data.size(), chunk_size));
+
+    auto staging_offset = co_await allocateStaging(chunk.size(), Alignment);
+    if (!staging_offset) {
+      co_return staging_offset.error();
+    }
+
+    std::memcpy(staging_data + *staging_offset, chunk.data(), chunk.size());
+    vmaFlushAllocation(
+        memory_allocator_, staging_buffer_.allocation_, *staging_offset, chunk.size());
+
+    // looked up again, the slot map may have moved while waiting for staging space
+    const auto* target = buffers_.get(buffer_handle);
+    auto on_transfer_queue = transfer_queue_ && target != nullptr && !target->uploaded_;
+
+    auto& uploads = on_transfer_queue ? transfer_buffer_uploads_ : pending_buffer_uploads_;
+    uploads.emplace_back(
+        BufferUpload{ .buffer_handle_ = buffer_handle,
+                      .region_ = vk::BufferCopy{ *staging_offset, offset, chunk.size() } });
+
+    if (on_transfer_queue) {
+      transfer_staged_bytes_ += chunk.size();
+      if (transfer_staged_bytes_ >= TransferBatchSize) {
+        if (auto error = submitTransferUploads(); error) {
+          co_return error;
+        }
+      }
+    }
+
+    offset += chunk.size();
+    data = data.subspan(chunk.size());
+  }
+
+  co_return Error::OK;
+}
+
+auto VulkanRenderingDevice::doUploadImage(
+    ImageHandle image_handle, std::span<const std::byte> data, uint32_t mip_level, uint32_t layer)
+    -> boost::asio::awaitable<std::error_code> {
+  constexpr size_t Alignment{ 16 };
+
+  const auto* image = images_.get(image_handle);
+  if (image == nullptr) {
+    co_return Error::NotFoundError;
+  }
+
+  const auto& create_info = image->image_create_info_;
+  auto texel_size = texelSize(create_info.format);
+  if (texel_size == 0) {
+    LOG_ERROR(
+        "image upload to an unsupported format; format: {}",
+        vk::to_string(static_cast<vk::Format>(create_info.format)));
+    co_return Error::FeatureNotSupported;
+  }
+
+  if (mip_level >= create_info.mipLevels || layer >= create_info.arrayLayers) {
+    LOG_ERROR(
+        "image upload to a missing subresource; index: {}, mip_level: {}, layer: {}",
+        image_handle.index(), mip_level, layer);
+    co_return Error::InvalidArgumentError;
+  }
+
+  vk::Extent3D extent{ std::max(create_info.extent.width >> mip_level, 1U),
+                       std::max(create_info.extent.height >> mip_level, 1U),
+                       std::max(create_info.extent.depth >> mip_level, 1U) };
+  auto expected_size = size_t{ extent.width } * extent.height * extent.depth * texel_size;
+
+  if (data.size() != expected_size) {
+    LOG_ERROR(
+        "image upload does not match the image; index: {}, mip_level: {}, layer: {}, size: {}, "
+        "expected_size: {}",
+        image_handle.index(), mip_level, layer, data.size(), expected_size);
+    co_return Error::InvalidArgumentError;
+  }
+
+  // large subresources go through in bands of rows, like buffer uploads go through in chunks
+  auto row_size = size_t{ extent.width } * texel_size;
+  auto band_rows = static_cast<uint32_t>(
+      std::clamp<size_t>(staging_ring_->capacity() / 4 / row_size, 1, extent.height));
+  auto* staging_data = static_cast<std::byte*>(staging_buffer_.allocation_info_.pMappedData);
+
+  for (uint32_t z = 0; z < extent.depth; ++z) {
+    for (uint32_t y = 0; y < extent.height; y += band_rows) {
+      auto rows = std::min(band_rows, extent.height - y);
+      auto band = data.first(rows * row_size);
+
+      auto staging_offset = co_await allocateStaging(band.size(), Alignment);
+      if (!staging_offset) {
+        co_return staging_offset.error();
+      }
+
+      std::memcpy(staging_data + *staging_offset, band.data(), band.size());
+      vmaFlushAllocation(
+          memory_allocator_, staging_buffer_.allocation_, *staging_offset, band.size());
+
+      // an image still in its initial layout has no contents to hand over from the graphics
+      // queue; looked up again, the slot map may have moved while waiting for staging space
+      image = images_.get(image_handle);
+      auto on_transfer_queue =
+          transfer_queue_ && image != nullptr && image->layout_ == VK_IMAGE_LAYOUT_UNDEFINED;
+
+      auto& uploads = on_transfer_queue ? transfer_image_uploads_ : pending_image_uploads_;
+      uploads.emplace_back(ImageUpload{
+          .image_handle_ = image_handle,
+          .region_ = vk::BufferImageCopy{
+              *staging_offset, 0, 0,
+              vk::ImageSubresourceLayers{ vk::ImageAspectFlagBits::eColor, mip_level, layer, 1 },
+              vk::Offset3D{ 0, static_cast<int32_t>(y), static_cast<int32_t>(z) },
+              vk::Extent3D{ extent.width, rows, 1 } } });
+
+      if (on_transfer_queue) {
+        transfer_staged_bytes_ += band.size();
+        if (transfer_staged_bytes_ >= TransferBatchSize) {
+          if (auto error = submitTransferUploads(); error) {
+            co_return error;
+          }
+        }
+      }
+
+      data = data.subspan(band.size());
+    }
+  }
 
   co_return Error::OK;
 }
@@ -1326,17 +1862,30 @@ auto VulkanRenderingDevice::doCreateSampler(SamplerDescriptor descriptor)
     co_return std::unexpected(Error::InternalError);
   }
 
-  auto& sampler_slot{ samplers_.emplace_back(
-      SamplerSlot{ .sampler_ = { .sampler_ = std::move(*sampler_expect),
-                                 .sampler_create_info_ = sampler_create_info } }) };
-
-  sampler_slot.index_ = samplers_.size() - 1;
+  auto sampler_handle{ samplers_.emplace(Sampler{ .sampler_ = std::move(*sampler_expect),
+                                                   .sampler_create_info_ = sampler_create_info }) };
+  if (!sampler_handle) [[unlikely]] {
+    LOG_ERROR("unable to create sampler, out of sampler slots");
+    co_return std::unexpected(Error::UnavailableError);
+  }
 
-  co_return SamplerHandle{ .index_ = sampler_slot.index_, .generation_ = 0 };
+  co_return *sampler_handle;
 }
 
-auto VulkanRenderingDevice::doDestroySampler(SamplerHandle image_handle)
+auto VulkanRenderingDevice::doDestroySampler(SamplerHandle sampler_handle)
     -> boost::asio::awaitable<std::error_code> {
+  LOG_DEBUG(
+      "destroy sampler; index: {}, generation: {}, current_timeline_value: {}",
+      sampler_handle.index(), sampler_handle.generation(), timeline_value_);
+
+  auto sampler{ samplers_.extract(sampler_handle) };
+  if (!sampler) {
+    LOG_TRACE("destroy sampler sampler already destroyed");
+    co_return Error::OK;
+  }
+
+  pending_destroy_samplers_.emplace_back(
+      PendingDestroy<Sampler>{ .resource_ = std::move(*sampler), .fence_value_ = timeline_value_ });
 
   co_return Error::OK;
 }
@@ -1344,50 +1893,62 @@ auto VulkanRenderingDevice::doDestroySampler(SamplerHandle image_handle)
 auto VulkanRenderingDevice::doCreateShader(ShaderModuleDescriptor descriptor)
     -> boost::asio::awaitable<std::expected<ShaderModuleHandle, std::error_code>> {
 
-  constexpr std::chrono::microseconds WaitDuration{ 50 };
-  auto executor = co_await boost::asio::this_coro::executor;
-
   if (auto iterator = shader_module_cache_.find(descriptor);
       iterator != shader_module_cache_.end()) {
-    assert(iterator->second.generation_ == shader_modules_[iterator->second.index_].generation_);
-    shader_modules_[iterator->second.index_].reference_counter_++;
+    // the cache may rehash while we wait for a loading module, keep a copy of the handle
+    auto cached_handle = iterator->second;
 
-    while (shader_modules_[iterator->second.index_].loading_) {
-      co_await boost::asio::steady_timer(executor, WaitDuration)
-          .async_wait(boost::asio::use_awaitable);
+    auto* shader_slot = shader_modules_.get(cached_handle);
+    assert(shader_slot != nullptr);
+    shader_slot->reference_counter_++;
+
+    if (shader_slot->loading_) {
+      co_await shader_slot->load_finished_->wait();
+      // a failed load erases the slot, look it up again
+      shader_slot = shader_modules_.get(cached_handle);
+    }
+
+    if (shader_slot == nullptr || !shader_slot->loaded_) {
+      LOG_DEBUG("create shader cache hit on a module that failed to load");
+      if (shader_slot != nullptr) {
+        shader_slot->reference_counter_--;
+      }
+      co_return std::unexpected(Error::InternalError);
     }
-    assert(shader_modules_[iterator->second.index_].loaded_);
+
     LOG_DEBUG(
         "create shader cache hit; shader_type: {}, index: {}, generation: {}, "
         "shader_module_allocator_size: {}",
-        magic_enum::enum_name(shader_modules_[iterator->second.index_].shader_->stage_),
-        shader_modules_[iterator->second.index_].index_,
-        shader_modules_[iterator->second.index_].generation_, shader_modules_.size());
-    co_return iterator->second;
+        magic_enum::enum_name(shader_slot->shader_->stage_), cached_handle.index(),
+        cached_handle.generation(), shader_modules_.size());
+    co_return cached_handle;
   }
 
-  size_t slot_index{ 0 };
-  if (!shader_module_free_list_.empty()) {
-    slot_index = shader_module_free_list_.back();
-    shader_module_free_list_.pop_back();
-  } else {
-    shader_modules_.emplace_back();
-    slot_index = shader_modules_.size() - 1;
+  auto shader_handle_expect{ shader_modules_.emplace() };
+  if (!shader_handle_expect) [[unlikely]] {
+    LOG_ERROR("unable to create shader, out of shader module slots");
+    co_return std::unexpected(Error::UnavailableError);
   }
+  auto shader_handle{ *shader_handle_expect };
 
   auto guard = gsl::finally([&] {
-    if (shader_modules_[slot_index].loading_) {
+    auto* shader_slot = shader_modules_.get(shader_handle);
+    if (shader_slot != nullptr && shader_slot->loading_) {
       LOG_DEBUG("creating shader aborted");
+      shader_slot->loading_ = false;
+      shader_slot->load_finished_->set();
       shader_module_cache_.erase(descriptor);
-      shader_module_free_list_.push_back(slot_index);
+      shader_modules_.erase(shader_handle);
     }
   });
-  shader_modules_[slot_index].index_ = slot_index;
-  shader_modules_[slot_index].loading_ = true;
 
-  auto [iter, inserted] = shader_module_cache_.emplace(
-      descriptor, ShaderModuleHandle{ .index_ = shader_modules_[slot_index].index_,
-                                      .generation_ = shader_modules_[slot_index].generation_ });
+  auto* shader_slot = shader_modules_.get(shader_handle);
+  shader_slot->description_ = ShaderModuleDescriptor{ .stage_ = descriptor.stage_,
+                                                      .spirv_ = {},
+                                                      .hash_ = descriptor.hash_ };
+  shader_slot->loading_ = true;
+
+  shader_module_cache_.emplace(descriptor, shader_handle);
 
   LOG_DEBUG(
       "create shader; shader_type: {}, shader_module_allocator_size: {}",
@@ -1404,103 +1965,497 @@ auto VulkanRenderingDevice::doCreateShader(ShaderModuleDescriptor descriptor)
     co_return std::unexpected(Error::InternalError);
   }
 
-  shader_modules_[slot_index].shader_ =
+  shader_slot->shader_ =
       std::make_unique<ShaderModule>(std::move(*shader_module_expect), descriptor.stage_);
-  shader_modules_[slot_index].reference_counter_++;
-  shader_modules_[slot_index].loaded_ = true;
-  shader_modules_[slot_index].loading_ = false;
+  shader_slot->reference_counter_++;
+  shader_slot->loaded_ = true;
+  shader_slot->loading_ = false;
+  shader_slot->load_finished_->set();
 
   LOG_DEBUG(
       "created shader success; shader_type: {}, index: {}, generation: {}, "
       "shader_module_allocator_size: {}",
-      magic_enum::enum_name(shader_modules_[slot_index].shader_->stage_),
-      shader_modules_[slot_index].index_, shader_modules_[slot_index].generation_,
-      shader_modules_.size());
+      magic_enum::enum_name(shader_slot->shader_->stage_), shader_handle.index(),
+      shader_handle.generation(), shader_modules_.size());
 
-  co_return ShaderModuleHandle{ .index_ = shader_modules_[slot_index].index_,
-                                .generation_ = shader_modules_[slot_index].generation_ };
+  co_return shader_handle;
 }
 
 auto VulkanRenderingDevice::doDestroyShader(ShaderModuleHandle shader_handle)
     -> boost::asio::awaitable<std::error_code> {
   LOG_DEBUG(
-      "destroy shader; index: {}, handler generation: {}, storage_generation: {}, "
-      "current_timeline_value: {}",
-      shader_handle.index_, shader_handle.generation_,
-      shader_modules_[shader_handle.index_].generation_, timeline_value_);
+      "destroy shader; index: {}, generation: {}, current_timeline_value: {}",
+      shader_handle.index(), shader_handle.generation(), timeline_value_);
 
-  assert(shader_handle.generation_ == shader_modules_[shader_handle.index_].generation_);
+  auto* shader_slot = shader_modules_.get(shader_handle);
+  if (shader_slot == nullptr) {
+    LOG_TRACE("destroy shader shader already destroyed");
+    co_return Error::OK;
+  }
 
-  if (shader_modules_[shader_handle.index_].reference_counter_-- == 0) {
-    shader_modules_[shader_handle.index_].generation_++;
-    shader_modules_[shader_handle.index_].loaded_ = false;
+  if (--shader_slot->reference_counter_ == 0) {
+    shader_module_cache_.erase(shader_slot->description_);
 
-    pending_destroy_shader_modules_.emplace_back(
-        PendingDestroy{ .index_ = shader_handle.index_, .fence_value_ = timeline_value_ });
+    auto shader{ shader_modules_.extract(shader_handle) };
+    pending_destroy_shader_modules_.emplace_back(PendingDestroy<std::unique_ptr<ShaderModule>>{
+        .resource_ = std::move(shader->shader_), .fence_value_ = timeline_value_ });
   }
 
   co_return Error::OK;
 }
 
-auto VulkanRenderingDevice::initializeVulkanInstance() -> boost::asio::awaitable<std::error_code> {
-  if (supported_vulkan_version() < VK_API_VERSION_1_3) {
-    LOG_ERROR("platform does not support vulkan 1.3 and up");
-    co_return Error::InternalError;
+auto VulkanRenderingDevice::doCreatePipeline(PipelineDescriptor descriptor)
+    -> boost::asio::awaitable<std::expected<PipelineHandle, std::error_code>> {
+  auto error = std::visit([](const auto& value) { return validatePipeline(value); }, descriptor);
+  if (error) {
+    co_return std::unexpected(error);
   }
 
-  // const auto& application_config{gravity::ApplicationConfig::getInstance()};
-  // const auto& engine_config{gravity::EngineConfig::getInstance()};
+  if (std::holds_alternative<GraphicsPipelineDescriptor>(descriptor) &&
+      device_features_.vulkan_13_features_.dynamicRendering == VK_FALSE) {
+    co_return std::unexpected(Error::FeatureNotSupported);
+  }
 
-  vk::ApplicationInfo application_info{
-    // application_config.applicationName().c_str(), application_config.applicationVersion(),
-    // engine_config.engineName().c_str(), engine_config.engineVersion(),
-    "Gravity Engine", VK_MAKE_VERSION(0, 1, 0), "Gravity Engine", VK_MAKE_VERSION(0, 1, 0),
-    VK_API_VERSION_1_3
-  };
+  auto key = std::visit([](const auto& value) { return pipelineKey(value); }, descriptor);
 
-  auto required_layers{ getRequiredInstanceLayers() };
+  auto cached = pipeline_cache_lookup_.find(key);
+  if (cached != pipeline_cache_lookup_.end()) {
+    auto cached_handle = cached->second;
+    auto* pipeline_slot = pipelines_.get(cached_handle);
+    assert(pipeline_slot != nullptr);
 
-  auto enumerate_layer_properties{ vk::enumerateInstanceLayerProperties() };
-  if (enumerate_layer_properties.result != vk::Result::eSuccess) {
-    LOG_ERROR("unable to enumerate instance layer properties");
-    co_return Error::InternalError;
+    if (pipeline_slot->descriptor_ == descriptor) {
+      pipeline_slot->reference_counter_++;
+      pipeline_slot->orphaned_ = false;
+
+      LOG_DEBUG(
+          "create pipeline cache hit; index: {}, generation: {}, status: {}",
+          cached_handle.index(), cached_handle.generation(),
+          magic_enum::enum_name(pipeline_slot->status_));
+      co_return cached_handle;
+    }
+
+    LOG_DEBUG("pipeline key collision, compiling without de-duplication; key: {}", key);
   }
 
-  std::unordered_set<std::string> available_instance_layer_names;
-  for (const auto& available_layer : enumerate_layer_properties.value) {
-    available_instance_layer_names.insert(available_layer.layerName);
-    // TODO(jerbdroid): clang-cl does not build same spdlog as msvc check defines
-    // LOG_INFO(available_layer.descriptor);
+  auto pipeline_handle_expect{ pipelines_.emplace() };
+  if (!pipeline_handle_expect) [[unlikely]] {
+    LOG_ERROR("unable to create pipeline, out of pipeline slots");
+    co_return std::unexpected(Error::UnavailableError);
   }
+  auto pipeline_handle{ *pipeline_handle_expect };
 
-  for (const auto& required_layer : required_layers) {
-    if (available_instance_layer_names.find(required_layer.first) ==
-        available_instance_layer_names.end()) {
-      if (required_layer.second) {
-        LOG_ERROR("required vulkan layer ({}) is not supported", required_layer.first);
-        co_return Error::InternalError;
-      }
-      LOG_WARN("failed to enable a requested vulkan layer ({})", required_layer.first);
-    } else {
-      enabled_instance_layer_names_.insert(required_layer.first);
-    }
+  auto* pipeline_slot = pipelines_.get(pipeline_handle);
+  pipeline_slot->descriptor_ = descriptor;
+  pipeline_slot->key_ = key;
+  pipeline_slot->reference_counter_ = 1;
+
+  // registered before the first suspension so identical requests arriving meanwhile share it
+  if (cached == pipeline_cache_lookup_.end()) {
+    pipeline_cache_lookup_.emplace(key, pipeline_handle);
   }
 
-  auto required_extensions{ getRequiredInstanceExtensions() };
-  auto enumerate_extension_properties{ vk::enumerateInstanceExtensionProperties() };
-  if (enumerate_extension_properties.result != vk::Result::eSuccess) {
-    LOG_ERROR("unable to enumerate instance layer properties");
-    co_return Error::InternalError;
+  if (pipelines_compiling_++ == 0) {
+    pipelines_idle_->reset();
   }
 
-  std::unordered_set<std::string> available_instance_extension_names;
-  for (const auto& available_extension : enumerate_extension_properties.value) {
-    available_instance_extension_names.insert(available_extension.extensionName);
+  auto shaders = co_await co_spawn(
+      strands_.getStrand(StrandLanes::Shader),
+      acquirePipelineShaders(std::visit(
+          [](const auto& value) { return pipelineShaders(value); }, descriptor)),
+      boost::asio::use_awaitable);
+  if (!shaders) {
+    finishPipeline(pipeline_handle, std::unexpected(shaders.error()));
+    co_return pipeline_handle;
   }
 
-  for (const auto& required_extension : required_extensions) {
-    if (available_instance_extension_names.find(required_extension.first) ==
-        available_instance_extension_names.end()) {
+  uint32_t stage_mask{ 0 };
+  bool duplicate_stage{ false };
+  for (const auto& shader : *shaders) {
+    duplicate_stage |= (stage_mask & static_cast<uint32_t>(shader.stage_)) != 0;
+    stage_mask |= static_cast<uint32_t>(shader.stage_);
+  }
+
+  auto is_compute = std::holds_alternative<ComputePipelineDescriptor>(descriptor);
+  auto compute_stage = static_cast<uint32_t>(ShaderStage::Compute);
+  auto vertex_stage = static_cast<uint32_t>(ShaderStage::Vertex);
+  if (duplicate_stage || (is_compute && stage_mask != compute_stage) ||
+      (!is_compute && ((stage_mask & vertex_stage) == 0 || (stage_mask & compute_stage) != 0))) {
+    LOG_ERROR("pipeline shader stages do not form a valid pipeline; stage_mask: {}", stage_mask);
+    co_await co_spawn(
+        strands_.getStrand(StrandLanes::Shader), releasePipelineShaders(std::move(*shaders)),
+        boost::asio::use_awaitable);
+    finishPipeline(pipeline_handle, std::unexpected(Error::InvalidArgumentError));
+    co_return pipeline_handle;
+  }
+
+  LOG_DEBUG(
+      "create pipeline; index: {}, generation: {}, compute: {}, pipeline_allocator_size: {}",
+      pipeline_handle.index(), pipeline_handle.generation(), is_compute, pipelines_.size());
+
+  co_spawn(
+      strands_.getWorkExecutor(),
+      compilePipeline(pipeline_handle, std::move(descriptor), std::move(*shaders)),
+      boost::asio::detached);
+
+  co_return pipeline_handle;
+}
+
+auto VulkanRenderingDevice::doWaitPipeline(PipelineHandle pipeline_handle)
+    -> boost::asio::awaitable<std::error_code> {
+  auto* pipeline_slot = pipelines_.get(pipeline_handle);
+  if (pipeline_slot == nullptr) {
+    co_return Error::NotFoundError;
+  }
+
+  if (pipeline_slot->status_ == PipelineStatus::Compiling) {
+    co_await pipeline_slot->compiled_->wait();
+    pipeline_slot = pipelines_.get(pipeline_handle);
+    if (pipeline_slot == nullptr) {
+      co_return Error::AbortedError;
+    }
+  }
+
+  if (pipeline_slot->status_ == PipelineStatus::Failed) {
+    co_return pipeline_slot->error_;
+  }
+  co_return Error::OK;
+}
+
+auto VulkanRenderingDevice::doDestroyPipeline(PipelineHandle pipeline_handle)
+    -> boost::asio::awaitable<std::error_code> {
+  LOG_DEBUG(
+      "destroy pipeline; index: {}, generation: {}, current_timeline_value: {}",
+      pipeline_handle.index(), pipeline_handle.generation(), timeline_value_);
+
+  auto* pipeline_slot = pipelines_.get(pipeline_handle);
+  if (pipeline_slot == nullptr) {
+    LOG_TRACE("destroy pipeline pipeline already destroyed");
+    co_return Error::OK;
+  }
+
+  if (--pipeline_slot->reference_counter_ > 0) {
+    co_return Error::OK;
+  }
+
+  if (pipeline_slot->status_ == PipelineStatus::Compiling) {
+    // the worker still writes into the slot, finishPipeline releases it
+    pipeline_slot->orphaned_ = true;
+    co_return Error::OK;
+  }
+
+  releasePipelineSlot(pipeline_handle);
+  co_return Error::OK;
+}
+
+auto VulkanRenderingDevice::acquirePipelineShaders(std::vector<ShaderModuleHandle> shader_handles)
+    -> boost::asio::awaitable<std::expected<std::vector<PipelineShader>, std::error_code>> {
+  std::vector<PipelineShader> shaders;
+  shaders.reserve(shader_handles.size());
+
+  for (auto shader_handle : shader_handles) {
+    auto* shader_slot = shader_modules_.get(shader_handle);
+    if (shader_slot == nullptr || !shader_slot->loaded_) {
+      LOG_ERROR(
+          "pipeline references a missing shader module; index: {}, generation: {}",
+          shader_handle.index(), shader_handle.generation());
+      co_await releasePipelineShaders(std::move(shaders));
+      co_return std::unexpected(Error::NotFoundError);
+    }
+
+    shader_slot->reference_counter_++;
+    shaders.emplace_back(PipelineShader{ .handle_ = shader_handle,
+                                         .stage_ = shader_slot->shader_->stage_,
+                                         .module_ = *shader_slot->shader_->module_ });
+  }
+
+  co_return shaders;
+}
+
+auto VulkanRenderingDevice::releasePipelineShaders(std::vector<PipelineShader> shaders)
+    -> boost::asio::awaitable<void> {
+  for (const auto& shader : shaders) {
+    co_await doDestroyShader(shader.handle_);
+  }
+}
+
+auto VulkanRenderingDevice::compilePipeline(
+    PipelineHandle pipeline_handle, PipelineDescriptor descriptor,
+    std::vector<PipelineShader> shaders) -> boost::asio::awaitable<void> {
+  auto start = std::chrono::steady_clock::now();
+  auto pipeline = buildPipeline(descriptor, shaders);
+  auto duration = std::chrono::steady_clock::now() - start;
+
+  if (pipeline) {
+    pipeline_statistics_.record(duration);
+  }
+
+  LOG_DEBUG(
+      "compiled pipeline; index: {}, generation: {}, success: {}, duration_us: {}",
+      pipeline_handle.index(), pipeline_handle.generation(), pipeline.has_value(),
+      std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+
+  // modules are only needed while compiling
+  co_await co_spawn(
+      strands_.getStrand(StrandLanes::Shader), releasePipelineShaders(std::move(shaders)),
+      boost::asio::use_awaitable);
+
+  co_await co_spawn(
+      strands_.getStrand(StrandLanes::Pipeline),
+      [this, pipeline_handle, &pipeline] -> boost::asio::awaitable<void> {
+        finishPipeline(pipeline_handle, std::move(pipeline));
+        co_return;
+      },
+      boost::asio::use_awaitable);
+}
+
+auto VulkanRenderingDevice::buildPipeline(
+    const PipelineDescriptor& descriptor, std::span<const PipelineShader> shaders) const
+    -> std::expected<std::unique_ptr<Pipeline>, std::error_code> {
+  auto push_constant_size =
+      std::visit([](const auto& value) { return value.push_constant_size_; }, descriptor);
+
+  vk::PushConstantRange push_constant_range{ vk::ShaderStageFlagBits::eAll, 0,
+                                             push_constant_size };
+  vk::PipelineLayoutCreateInfo layout_create_info{};
+  if (push_constant_size > 0) {
+    layout_create_info.setPushConstantRanges(push_constant_range);
+  }
+
+  auto layout_expect{ device_->createPipelineLayout(layout_create_info) };
+  if (!layout_expect) {
+    LOG_ERROR("unable to create pipeline layout: {}", vk::to_string(layout_expect.error()));
+    return std::unexpected(Error::InternalError);
+  }
+
+  std::vector<vk::PipelineShaderStageCreateInfo> stages;
+  stages.reserve(shaders.size());
+  for (const auto& shader : shaders) {
+    stages.emplace_back(
+        vk::PipelineShaderStageCreateFlags(),
+        static_cast<vk::ShaderStageFlagBits>(toVulkan(shader.stage_)), shader.module_, "main");
+  }
+
+  if (const auto* compute = std::get_if<ComputePipelineDescriptor>(&descriptor)) {
+    vk::ComputePipelineCreateInfo create_info{};
+    create_info.setStage(stages.front()).setLayout(**layout_expect);
+
+    auto pipeline_expect{ device_->createComputePipeline(*pipeline_cache_, create_info) };
+    if (!pipeline_expect) {
+      LOG_ERROR("unable to create compute pipeline: {}", vk::to_string(pipeline_expect.error()));
+      return std::unexpected(Error::InternalError);
+    }
+
+    return std::make_unique<Pipeline>(
+        Pipeline{ .layout_ = std::move(*layout_expect), .pipeline_ = std::move(*pipeline_expect) });
+  }
+
+  const auto& graphics = std::get<GraphicsPipelineDescriptor>(descriptor);
+  const auto& render_targets = graphics.render_targets_;
+
+  std::vector<vk::VertexInputBindingDescription> bindings;
+  for (const auto& binding : graphics.vertex_layout_.bindings) {
+    bindings.emplace_back(
+        binding.binding, binding.stride,
+        static_cast<vk::VertexInputRate>(toVulkan(binding.input_rate)));
+  }
+
+  std::vector<vk::VertexInputAttributeDescription> attributes;
+  for (const auto& attribute : graphics.vertex_layout_.attributes) {
+    attributes.emplace_back(
+        attribute.location, attribute.binding,
+        static_cast<vk::Format>(toVulkan(attribute.format)), attribute.offset);
+  }
+
+  vk::PipelineVertexInputStateCreateInfo vertex_input{};
+  vertex_input.setVertexBindingDescriptions(bindings).setVertexAttributeDescriptions(attributes);
+
+  vk::PipelineInputAssemblyStateCreateInfo input_assembly{};
+  input_assembly.setTopology(static_cast<vk::PrimitiveTopology>(toVulkan(graphics.topology_)));
+
+  vk::PipelineViewportStateCreateInfo viewport{};
+  viewport.setViewportCount(1).setScissorCount(1);
+
+  vk::PipelineRasterizationStateCreateInfo rasterization{};
+  rasterization.setPolygonMode(vk::PolygonMode::eFill)
+      .setCullMode(static_cast<vk::CullModeFlags>(toVulkan(graphics.cull_mode_)))
+      .setFrontFace(static_cast<vk::FrontFace>(toVulkan(graphics.front_face_)))
+      .setLineWidth(1.0F);
+
+  vk::PipelineMultisampleStateCreateInfo multisample{};
+  multisample.setRasterizationSamples(
+      static_cast<vk::SampleCountFlagBits>(toVulkan(render_targets.samples_)));
+
+  const auto& depth = graphics.depth_state_;
+  vk::PipelineDepthStencilStateCreateInfo depth_stencil{};
+  depth_stencil.setDepthTestEnable(depth.test_enabled_ ? VK_TRUE : VK_FALSE)
+      .setDepthWriteEnable(depth.write_enabled_ ? VK_TRUE : VK_FALSE)
+      .setDepthCompareOp(static_cast<vk::CompareOp>(toVulkan(depth.compare_operation_)));
+
+  std::vector<vk::PipelineColorBlendAttachmentState> blend_attachments;
+  std::vector<vk::Format> color_formats;
+  for (size_t index = 0; index < render_targets.color_formats_.size(); ++index) {
+    color_formats.emplace_back(
+        static_cast<vk::Format>(toVulkan(render_targets.color_formats_[index])));
+
+    auto blend = render_targets.blend_states_.empty() ? BlendState{}
+                                                      : render_targets.blend_states_[index];
+    blend_attachments.emplace_back(
+        blend.enabled_ ? VK_TRUE : VK_FALSE,
+        static_cast<vk::BlendFactor>(toVulkan(blend.source_color_)),
+        static_cast<vk::BlendFactor>(toVulkan(blend.destination_color_)),
+        static_cast<vk::BlendOp>(toVulkan(blend.color_operation_)),
+        static_cast<vk::BlendFactor>(toVulkan(blend.source_alpha_)),
+        static_cast<vk::BlendFactor>(toVulkan(blend.destination_alpha_)),
+        static_cast<vk::BlendOp>(toVulkan(blend.alpha_operation_)),
+        vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
+            vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA);
+  }
+
+  vk::PipelineColorBlendStateCreateInfo color_blend{};
+  color_blend.setAttachments(blend_attachments);
+
+  std::array dynamic_states{ vk::DynamicState::eViewport, vk::DynamicState::eScissor };
+  vk::PipelineDynamicStateCreateInfo dynamic_state{};
+  dynamic_state.setDynamicStates(dynamic_states);
+
+  auto depth_format = static_cast<vk::Format>(toVulkan(render_targets.depth_format_));
+  vk::PipelineRenderingCreateInfo rendering{};
+  rendering.setColorAttachmentFormats(color_formats)
+      .setDepthAttachmentFormat(depth_format)
+      .setStencilAttachmentFormat(
+          hasStencil(render_targets.depth_format_) ? depth_format : vk::Format::eUndefined);
+
+  vk::GraphicsPipelineCreateInfo create_info{};
+  create_info.setPNext(&rendering)
+      .setStages(stages)
+      .setPVertexInputState(&vertex_input)
+      .setPInputAssemblyState(&input_assembly)
+      .setPViewportState(&viewport)
+      .setPRasterizationState(&rasterization)
+      .setPMultisampleState(&multisample)
+      .setPDepthStencilState(&depth_stencil)
+      .setPColorBlendState(&color_blend)
+      .setPDynamicState(&dynamic_state)
+      .setLayout(**layout_expect);
+
+  auto pipeline_expect{ device_->createGraphicsPipeline(*pipeline_cache_, create_info) };
+  if (!pipeline_expect) {
+    LOG_ERROR("unable to create graphics pipeline: {}", vk::to_string(pipeline_expect.error()));
+    return std::unexpected(Error::InternalError);
+  }
+
+  return std::make_unique<Pipeline>(
+      Pipeline{ .layout_ = std::move(*layout_expect), .pipeline_ = std::move(*pipeline_expect) });
+}
+
+void VulkanRenderingDevice::finishPipeline(
+    PipelineHandle pipeline_handle,
+    std::expected<std::unique_ptr<Pipeline>, std::error_code> pipeline) {
+  // compiling slots are never erased, see doDestroyPipeline
+  auto* pipeline_slot = pipelines_.get(pipeline_handle);
+  assert(pipeline_slot != nullptr);
+
+  if (pipeline) {
+    pipeline_slot->pipeline_ = std::move(*pipeline);
+    pipeline_slot->status_ = PipelineStatus::Ready;
+  } else {
+    pipeline_slot->error_ = pipeline.error();
+    pipeline_slot->status_ = PipelineStatus::Failed;
+
+    // later requests for the same state try again
+    if (auto cached = pipeline_cache_lookup_.find(pipeline_slot->key_);
+        cached != pipeline_cache_lookup_.end() && cached->second == pipeline_handle) {
+      pipeline_cache_lookup_.erase(cached);
+    }
+  }
+  pipelines_.publish(pipeline_handle, pipeline_slot->status_);
+  pipeline_slot->compiled_->set();
+
+  if (pipeline_slot->orphaned_) {
+    releasePipelineSlot(pipeline_handle);
+  }
+
+  if (--pipelines_compiling_ == 0) {
+    pipelines_idle_->set();
+  }
+}
+
+void VulkanRenderingDevice::releasePipelineSlot(PipelineHandle pipeline_handle) {
+  auto* pipeline_slot = pipelines_.get(pipeline_handle);
+
+  if (auto cached = pipeline_cache_lookup_.find(pipeline_slot->key_);
+      cached != pipeline_cache_lookup_.end() && cached->second == pipeline_handle) {
+    pipeline_cache_lookup_.erase(cached);
+  }
+
+  if (pipeline_slot->pipeline_) {
+    pending_destroy_pipelines_.emplace_back(PendingDestroy<std::unique_ptr<Pipeline>>{
+        .resource_ = std::move(pipeline_slot->pipeline_), .fence_value_ = timeline_value_ });
+  }
+
+  pipelines_.erase(pipeline_handle);
+}
+
+auto VulkanRenderingDevice::initializeVulkanInstance() -> boost::asio::awaitable<std::error_code> {
+  if (supported_vulkan_version() < VK_API_VERSION_1_3) {
+    LOG_ERROR("platform does not support vulkan 1.3 and up");
+    co_return Error::InternalError;
+  }
+
+  // const auto& application_config{gravity::ApplicationConfig::getInstance()};
+  // const auto& engine_config{gravity::EngineConfig::getInstance()};
+
+  vk::ApplicationInfo application_info{
+    // application_config.applicationName().c_str(), application_config.applicationVersion(),
+    // engine_config.engineName().c_str(), engine_config.engineVersion(),
+    "Gravity Engine", VK_MAKE_VERSION(0, 1, 0), "Gravity Engine", VK_MAKE_VERSION(0, 1, 0),
+    VK_API_VERSION_1_3
+  };
+
+  auto required_layers{ getRequiredInstanceLayers() };
+
+  auto enumerate_layer_properties{ vk::enumerateInstanceLayerProperties() };
+  if (enumerate_layer_properties.result != vk::Result::eSuccess) {
+    LOG_ERROR("unable to enumerate instance layer properties");
+    co_return Error::InternalError;
+  }
+
+  std::unordered_set<std::string> available_instance_layer_names;
+  for (const auto& available_layer : enumerate_layer_properties.value) {
+    available_instance_layer_names.insert(available_layer.layerName);
+    // TODO(jerbdroid): clang-cl does not build same spdlog as msvc check defines
+    // LOG_INFO(available_layer.descriptor);
+  }
+
+  for (const auto& required_layer : required_layers) {
+    if (available_instance_layer_names.find(required_layer.first) ==
+        available_instance_layer_names.end()) {
+      if (required_layer.second) {
+        LOG_ERROR("required vulkan layer ({}) is not supported", required_layer.first);
+        co_return Error::InternalError;
+      }
+      LOG_WARN("failed to enable a requested vulkan layer ({})", required_layer.first);
+    } else {
+      enabled_instance_layer_names_.insert(required_layer.first);
+    }
+  }
+
+  auto required_extensions{ getRequiredInstanceExtensions() };
+  auto enumerate_extension_properties{ vk::enumerateInstanceExtensionProperties() };
+  if (enumerate_extension_properties.result != vk::Result::eSuccess) {
+    LOG_ERROR("unable to enumerate instance layer properties");
+    co_return Error::InternalError;
+  }
+
+  std::unordered_set<std::string> available_instance_extension_names;
+  for (const auto& available_extension : enumerate_extension_properties.value) {
+    available_instance_extension_names.insert(available_extension.extensionName);
+  }
+
+  for (const auto& required_extension : required_extensions) {
+    if (available_instance_extension_names.find(required_extension.first) ==
+        available_instance_extension_names.end()) {
       if (required_extension.second) {
         LOG_ERROR("required vulkan extension ({}) is not supported", required_extension.first);
         co_return Error::InternalError;
@@ -1584,6 +2539,12 @@ auto VulkanRenderingDevice::initializeQueueIndex() -> boost::asio::awaitable<std
   } else {
     co_return result.error();
   }
+  separate_queues_ = graphics_family_queue_index_ != present_family_queue_index_;
+
+  transfer_family_queue_index_ = findTransferQueueFamilyIndex(
+                                     physical_device_->getQueueFamilyProperties(),
+                                     graphics_family_queue_index_, present_family_queue_index_)
+                                     .value_or(graphics_family_queue_index_);
   co_return Error::OK;
 }
 
@@ -1599,6 +2560,11 @@ auto VulkanRenderingDevice::initializeLogicalDevice() -> boost::asio::awaitable<
         vk::DeviceQueueCreateInfo({}, present_family_queue_index_, 1, &queue_priority));
   }
 
+  if (transfer_family_queue_index_ != graphics_family_queue_index_) {
+    device_queue_create_info.emplace_back(
+        vk::DeviceQueueCreateInfo({}, transfer_family_queue_index_, 1, &queue_priority));
+  }
+
   auto enumerate_extension_properties{ physical_device_->enumerateDeviceExtensionProperties() };
 
   std::unordered_set<std::string> available_device_extension_names;
@@ -1634,6 +2600,7 @@ auto VulkanRenderingDevice::initializeLogicalDevice() -> boost::asio::awaitable<
       nullptr);
 
   device_create_info.pNext = &device_features_.vulkan_12_features_;
+  device_features_.vulkan_12_features_.pNext = &device_features_.vulkan_13_features_;
 
   auto deviceExpect{ physical_device_->createDevice(device_create_info) };
 
@@ -1669,6 +2636,26 @@ auto VulkanRenderingDevice::initializeAllocator() -> boost::asio::awaitable<std:
   co_return Error::OK;
 }
 
+auto VulkanRenderingDevice::initializeStagingRing() -> boost::asio::awaitable<std::error_code> {
+  constexpr uint32_t StagingRingSize{ 32U * 1024 * 1024 };
+
+  auto create_info{ buildBufferCreateInfo(
+      StagingRingSize, BufferUsage::TransferSource, Visibility::Host) };
+
+  staging_buffer_.size_ = StagingRingSize;
+  if (vmaCreateBuffer(
+          memory_allocator_, &create_info.buffer_create_info_,
+          &create_info.vma_allocation_create_info_, &staging_buffer_.buffer_,
+          &staging_buffer_.allocation_, &staging_buffer_.allocation_info_) != VK_SUCCESS) {
+    LOG_ERROR("unable to create staging ring buffer; size: {}", StagingRingSize);
+    co_return Error::InternalError;
+  }
+
+  staging_ring_.emplace(StagingRingSize);
+
+  co_return Error::OK;
+}
+
 auto VulkanRenderingDevice::initializeDescriptorSetAllocator()
     -> boost::asio::awaitable<std::error_code> {
   descriptor_allocator_static_ = DescriptorAllocatorPool::create(**device_, 1);
@@ -1696,6 +2683,19 @@ auto VulkanRenderingDevice::initializeQueues() -> boost::asio::awaitable<std::er
   }
   present_queue_ = std::move(*present_queue_expect);
 
+  if (transfer_family_queue_index_ == graphics_family_queue_index_) {
+    LOG_INFO("no separate transfer queue family, uploads share the graphics queue");
+    co_return Error::OK;
+  }
+
+  auto transfer_queue_expect{ device_->getQueue(transfer_family_queue_index_, 0) };
+  if (!transfer_queue_expect) {
+    LOG_ERROR("unable to get transfer queue from logical device");
+    co_return Error::InternalError;
+  }
+  transfer_queue_ = std::move(*transfer_queue_expect);
+  LOG_INFO("uploads use a separate transfer queue; family: {}", transfer_family_queue_index_);
+
   co_return Error::OK;
 }
 
@@ -1708,6 +2708,7 @@ auto VulkanRenderingDevice::initializeSynchronization() -> boost::asio::awaitabl
       co_return Error::InternalError;
     }
     frame.in_flight_ = std::move(*fence_expect);
+    frame.in_flight_signaled_->set();
 
     auto semaphore_expect{ device_->createSemaphore(vk::SemaphoreCreateInfo()) };
     if (!semaphore_expect) {
@@ -1717,7 +2718,7 @@ auto VulkanRenderingDevice::initializeSynchronization() -> boost::asio::awaitabl
     frame.render_finished_ = std::move(*semaphore_expect);
   }
 
-  vk::SemaphoreTypeCreateInfo timeline_info{ vk::SemaphoreType::eTimeline, timeline_value_ };
+  vk::SemaphoreTypeCreateInfo timeline_info{ vk::SemaphoreType::eTimeline, timeline_value_ - 1 };
   vk::SemaphoreCreateInfo semaphore_info;
   semaphore_info.pNext = &timeline_info;
   auto semaphore_expect{ device_->createSemaphore(semaphore_info) };
@@ -1728,6 +2729,19 @@ auto VulkanRenderingDevice::initializeSynchronization() -> boost::asio::awaitabl
   }
   timeline_semaphore_ = std::move(*semaphore_expect);
 
+  if (transfer_queue_) {
+    vk::SemaphoreTypeCreateInfo transfer_timeline_info{ vk::SemaphoreType::eTimeline,
+                                                        transfer_value_ };
+    vk::SemaphoreCreateInfo transfer_semaphore_info;
+    transfer_semaphore_info.pNext = &transfer_timeline_info;
+    auto transfer_semaphore_expect{ device_->createSemaphore(transfer_semaphore_info) };
+    if (!transfer_semaphore_expect) {
+      LOG_ERROR("unable to create transfer semaphore");
+      co_return Error::InternalError;
+    }
+    transfer_semaphore_ = std::move(*transfer_semaphore_expect);
+  }
+
   co_return Error::OK;
 }
 
@@ -1910,16 +2924,40 @@ auto VulkanRenderingDevice::initializeSwapchain() -> boost::asio::awaitable<std:
 }
 
 auto VulkanRenderingDevice::initializePipelineCache() -> boost::asio::awaitable<std::error_code> {
-  vk::PipelineCacheCreateInfo pipeline_cache_create_Info{};
+  std::vector<std::byte> initial_data;
+  if (!pipeline_cache_path_.empty()) {
+    initial_data = loadPipelineCacheData(pipeline_cache_path_, physical_device_->getProperties());
+  }
+
+  vk::PipelineCacheCreateInfo pipeline_cache_create_Info{ {},
+                                                          initial_data.size(),
+                                                          initial_data.data() };
 
   auto pipeline_cache_expect{ device_->createPipelineCache(pipeline_cache_create_Info) };
 
+  if (!pipeline_cache_expect && !initial_data.empty()) {
+    LOG_WARN("driver rejected the saved pipeline cache, starting cold");
+    initial_data.clear();
+    pipeline_cache_expect = device_->createPipelineCache(vk::PipelineCacheCreateInfo{});
+  }
+
   if (!pipeline_cache_expect) {
     LOG_ERROR("unable to create pipeline cache");
     co_return Error::InternalError;
   }
 
   pipeline_cache_ = std::move(*pipeline_cache_expect);
+  pipeline_cache_warm_ = !initial_data.empty();
+
+  LOG_INFO(
+      "pipeline cache created; cache: {}, size: {}", pipeline_cache_warm_ ? "warm" : "cold",
+      initial_data.size());
+
+  if (!pipeline_cache_path_.empty()) {
+    co_spawn(
+        strands_.getStrand(StrandLanes::Cleanup), savePipelineCachePeriodically(),
+        boost::asio::detached);
+  }
 
   co_return Error::OK;
 }
@@ -1940,6 +2978,16 @@ auto VulkanRenderingDevice::initializeCommandPool() -> boost::asio::awaitable<st
     frame.command_pool_ = std::move(*command_pool_expect);
   }
 
+  if (transfer_queue_) {
+    auto command_pool_expect{ device_->createCommandPool(vk::CommandPoolCreateInfo{
+        vk::CommandPoolCreateFlagBits::eTransient, transfer_family_queue_index_ }) };
+    if (!command_pool_expect) {
+      LOG_ERROR("unable to create transfer command pool");
+      co_return Error::InternalError;
+    }
+    transfer_command_pool_ = std::move(*command_pool_expect);
+  }
+
   co_return Error::OK;
 }
 
@@ -1990,53 +3038,557 @@ void VulkanRenderingDevice::cleanupRenderPass() {
   render_pass_.reset();
 }
 
-void VulkanRenderingDevice::collectPendingDestroy() {
-  uint64_t completed;
-  auto result = (**device_).getSemaphoreCounterValueKHR(
-      **timeline_semaphore_, &completed, dynamic_dispatcher_);
+void VulkanRenderingDevice::signalWhenComplete(FrameSync& frame) {
+  boost::asio::post(fence_waiter_, [this, &frame] {
+    auto result =
+        device_->waitForFences({ *frame.in_flight_ }, VK_TRUE, std::numeric_limits<uint64_t>::max());
+    if (result != vk::Result::eSuccess) {
+      LOG_ERROR("waiting for frame fence failed: {}", vk::to_string(result));
+    }
+    frame.in_flight_signaled_->set();
+    timeline_advanced_->set();
+  });
+}
+
+auto VulkanRenderingDevice::savePipelineCachePeriodically() -> boost::asio::awaitable<void> {
+  constexpr std::chrono::seconds SaveInterval{ 60 };
+
+  auto guard = gsl::finally([this] {
+    pipeline_cache_timer_.reset();
+    pipeline_cache_saver_stopped_->set();
+  });
+
+  pipeline_cache_timer_.emplace(co_await boost::asio::this_coro::executor);
+
+  while (!pipeline_cache_saver_stopping_) {
+    pipeline_cache_timer_->expires_after(SaveInterval);
+    auto [error] =
+        co_await pipeline_cache_timer_->async_wait(boost::asio::as_tuple(use_awaitable));
+    if (error || pipeline_cache_saver_stopping_) {
+      break;
+    }
+
+    savePipelineCache();
+  }
+}
+
+auto VulkanRenderingDevice::stopPipelineCacheSaver() -> boost::asio::awaitable<void> {
+  // the saver is started on the Cleanup strand before this is posted there, so it is either
+  // waiting on its timer or has already exited
+  co_await co_spawn(
+      strands_.getStrand(StrandLanes::Cleanup),
+      [this] -> boost::asio::awaitable<void> {
+        pipeline_cache_saver_stopping_ = true;
+        if (pipeline_cache_timer_) {
+          pipeline_cache_timer_->cancel();
+          co_await pipeline_cache_saver_stopped_->wait();
+        }
+      },
+      use_awaitable);
+}
+
+void VulkanRenderingDevice::savePipelineCache() {
+  if (pipeline_cache_path_.empty() || !pipeline_cache_) {
+    return;
+  }
+
+  // only pipeline creation adds to the cache, though not necessarily to the size of its data
+  auto created = pipeline_statistics_.count();
+  if (created == pipeline_cache_saved_count_) {
+    return;
+  }
+
+  size_t size{ 0 };
+  auto result = (**device_).getPipelineCacheData(
+      **pipeline_cache_, &size, nullptr, dynamic_dispatcher_);
   if (result != vk::Result::eSuccess) {
-    LOG_ERROR("pending deleted buffer collector failed to get semaphore counter value");
+    LOG_ERROR("unable to query pipeline cache size: {}", vk::to_string(result));
+    return;
+  }
+
+  if (size > PipelineCacheMaxSize) {
+    LOG_WARN(
+        "pipeline cache exceeds the size cap, not saving; size: {}, cap: {}", size,
+        PipelineCacheMaxSize);
+    pipeline_cache_saved_count_ = created;
+    return;
+  }
+
+  std::vector<std::byte> data(size);
+  result = (**device_).getPipelineCacheData(
+      **pipeline_cache_, &size, data.data(), dynamic_dispatcher_);
+  if (result != vk::Result::eSuccess) {
+    LOG_ERROR("unable to read pipeline cache data: {}", vk::to_string(result));
     return;
   }
+  data.resize(size);
+
+  if (!savePipelineCacheData(pipeline_cache_path_, data)) {
+    pipeline_cache_saved_count_ = created;
+  }
+}
+
+auto VulkanRenderingDevice::allocateStaging(size_t size, size_t alignment)
+    -> boost::asio::awaitable<std::expected<size_t, std::error_code>> {
+  if (size > staging_ring_->capacity()) {
+    LOG_ERROR(
+        "upload does not fit the staging ring; size: {}, capacity: {}", size,
+        staging_ring_->capacity());
+    co_return std::unexpected(Error::InvalidArgumentError);
+  }
 
-  std::erase_if(pending_destroy_buffers_, [&completed, this](auto& pending_destroy) {
-    if (pending_destroy.fence_value_ <= completed) {
-      if (buffers_[pending_destroy.index_].buffer_.buffer_ != VK_NULL_HANDLE) {
-        vmaDestroyBuffer(
-            memory_allocator_, buffers_[pending_destroy.index_].buffer_.buffer_,
-            buffers_[pending_destroy.index_].buffer_.allocation_);
+  while (true) {
+    // reset before looking, so a timeline advance from here on ends the wait below
+    timeline_advanced_->reset();
+
+    if (auto offset = staging_ring_->allocate(size, alignment); offset) {
+      co_return *offset;
+    }
+
+    uint64_t completed;
+    auto result = (**device_).getSemaphoreCounterValueKHR(
+        **timeline_semaphore_, &completed, dynamic_dispatcher_);
+    if (result != vk::Result::eSuccess) {
+      LOG_ERROR("staging ring failed to get semaphore counter value");
+      co_return std::unexpected(Error::InternalError);
+    }
+
+    auto used = staging_ring_->used();
+    staging_ring_->retire(completed);
+    if (staging_ring_->used() < used) {
+      continue;
+    }
+
+    // The rest is in flight or waits for the next frame to be submitted. Before the first frame
+    // nothing would ever submit it.
+    if (!uploads_recorded_) {
+      LOG_ERROR(
+          "staging ring is full before the first frame; size: {}, pending: {}", size,
+          staging_ring_->pending());
+      co_return std::unexpected(Error::FailedPreconditionError);
+    }
+
+    co_await timeline_advanced_->wait();
+  }
+}
+
+auto VulkanRenderingDevice::submitTransferUploads() -> std::error_code {
+  if (transfer_buffer_uploads_.empty() && transfer_image_uploads_.empty()) {
+    return Error::OK;
+  }
+
+  vk::CommandBufferAllocateInfo command_buffer_info{ **transfer_command_pool_,
+                                                     vk::CommandBufferLevel::ePrimary, 1 };
+  auto command_buffers_expect{ device_->allocateCommandBuffers(command_buffer_info) };
+  if (!command_buffers_expect) {
+    LOG_ERROR("unable to allocate transfer command buffer");
+    return Error::InternalError;
+  }
+  auto& command_buffer = command_buffers_expect->front();
+
+  command_buffer.begin(vk::CommandBufferBeginInfo{
+      vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+
+  LOG_TRACE(
+      "submit transfer uploads; buffer_uploads: {}, image_uploads: {}, staging_bytes: {}",
+      transfer_buffer_uploads_.size(), transfer_image_uploads_.size(), transfer_staged_bytes_);
+
+  std::vector<vk::BufferMemoryBarrier> buffer_releases;
+  std::vector<vk::ImageMemoryBarrier> image_releases;
+  recordBufferUploads(command_buffer, transfer_buffer_uploads_, &buffer_releases);
+  recordImageUploads(command_buffer, transfer_image_uploads_, &image_releases);
+
+  command_buffer.pipelineBarrier(
+      vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe, {}, {},
+      buffer_releases, image_releases);
+
+  command_buffer.end();
 
-        buffers_[pending_destroy.index_].buffer_.buffer_ = {};
-        buffer_free_list_.emplace_back(pending_destroy.index_);
+  ++transfer_value_;
+
+  vk::CommandBuffer submitted = *command_buffer;
+  vk::Semaphore transfer_semaphore = **transfer_semaphore_;
+  vk::TimelineSemaphoreSubmitInfo timeline_submit_info{ 0, nullptr, 1, &transfer_value_ };
+  vk::SubmitInfo submit_info{ {}, {}, submitted, transfer_semaphore };
+  submit_info.pNext = &timeline_submit_info;
+  transfer_queue_->submit(submit_info);
+
+  // the graphics queue repeats each release as an acquire before touching the resource
+  auto& batch = submitted_transfers_.emplace_back(TransferBatch{
+      .command_buffer_ = std::move(command_buffer),
+      .transfer_value_ = transfer_value_,
+      .buffer_acquires_ = std::move(buffer_releases),
+      .image_acquires_ = std::move(image_releases) });
+  for (auto& acquire : batch.buffer_acquires_) {
+    acquire.srcAccessMask = {};
+    acquire.dstAccessMask = vk::AccessFlagBits::eMemoryRead;
+  }
+  for (auto& acquire : batch.image_acquires_) {
+    acquire.srcAccessMask = {};
+    acquire.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+  }
+
+  transfer_buffer_uploads_.clear();
+  transfer_image_uploads_.clear();
+  transfer_staged_bytes_ = 0;
+
+  return Error::OK;
+}
+
+auto VulkanRenderingDevice::recordUploads(FrameSync& frame)
+    -> boost::asio::awaitable<std::error_code> {
+  frame.transfer_wait_value_ = 0;
+  uploads_recorded_ = true;
+
+  if (transfer_queue_) {
+    if (auto error = submitTransferUploads(); error) {
+      co_return error;
+    }
+
+    if (!pending_destroy_transfer_command_buffers_.empty()) {
+      uint64_t completed;
+      auto result = (**device_).getSemaphoreCounterValueKHR(
+          **timeline_semaphore_, &completed, dynamic_dispatcher_);
+      if (result == vk::Result::eSuccess) {
+        std::erase_if(pending_destroy_transfer_command_buffers_, [completed](const auto& pending) {
+          return pending.fence_value_ <= completed;
+        });
       }
-      return true;
     }
-    return false;
+  }
+
+  if (pending_buffer_uploads_.empty() && pending_image_uploads_.empty() &&
+      submitted_transfers_.empty()) {
+    co_return Error::OK;
+  }
+
+  vk::CommandBufferAllocateInfo command_buffer_info{ **frame.command_pool_,
+                                                     vk::CommandBufferLevel::ePrimary, 1 };
+  auto command_buffers_expect{ device_->allocateCommandBuffers(command_buffer_info) };
+  if (!command_buffers_expect) {
+    LOG_ERROR("unable to allocate upload command buffer");
+    co_return Error::InternalError;
+  }
+  auto& command_buffer = command_buffers_expect->front();
+
+  command_buffer.begin(vk::CommandBufferBeginInfo{
+      vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+
+  LOG_TRACE(
+      "record uploads; buffer_uploads: {}, image_uploads: {}, transfer_batches: {}, "
+      "staging_bytes: {}",
+      pending_buffer_uploads_.size(), pending_image_uploads_.size(), submitted_transfers_.size(),
+      staging_ring_->pending());
+
+  if (!submitted_transfers_.empty()) {
+    // the submit waits for the transfer queue before anything runs, acquires come first
+    std::vector<vk::BufferMemoryBarrier> buffer_acquires;
+    std::vector<vk::ImageMemoryBarrier> image_acquires;
+    for (auto& batch : submitted_transfers_) {
+      buffer_acquires.insert(
+          buffer_acquires.end(), batch.buffer_acquires_.begin(), batch.buffer_acquires_.end());
+      image_acquires.insert(
+          image_acquires.end(), batch.image_acquires_.begin(), batch.image_acquires_.end());
+      pending_destroy_transfer_command_buffers_.emplace_back(
+          PendingDestroy<vk::raii::CommandBuffer>{ std::move(batch.command_buffer_),
+                                                   timeline_value_ });
+    }
+    command_buffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eAllCommands, {}, {},
+        buffer_acquires, image_acquires);
+
+    frame.transfer_wait_value_ = submitted_transfers_.back().transfer_value_;
+    submitted_transfers_.clear();
+  }
+
+  recordBufferUploads(command_buffer, pending_buffer_uploads_);
+  recordImageUploads(command_buffer, pending_image_uploads_);
+
+  // the frame's own commands follow in the same submission
+  vk::MemoryBarrier visible{ vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eMemoryRead };
+  command_buffer.pipelineBarrier(
+      vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, visible,
+      {}, {});
+
+  command_buffer.end();
+
+  frame.command_buffers_.insert(frame.command_buffers_.begin(), std::move(command_buffer));
+
+  // read by the submit that signals timeline_value_
+  staging_ring_->close(timeline_value_);
+  pending_buffer_uploads_.clear();
+  pending_image_uploads_.clear();
+
+  co_return Error::OK;
+}
+
+void VulkanRenderingDevice::recordBufferUploads(
+    const vk::raii::CommandBuffer& command_buffer, std::vector<BufferUpload>& uploads,
+    std::vector<vk::BufferMemoryBarrier>* releases) {
+  // one copy call per destination; uploads keep their order within a destination
+  std::ranges::stable_sort(uploads, {}, [](const BufferUpload& upload) {
+    return upload.buffer_handle_.value();
   });
 
-  std::erase_if(pending_destroy_images_, [&completed, this](auto& pending_destroy) {
-    if (pending_destroy.fence_value_ <= completed) {
-      if (images_[pending_destroy.index_].image_.image_ != VK_NULL_HANDLE) {
-        vmaDestroyImage(
-            memory_allocator_, images_[pending_destroy.index_].image_.image_,
-            images_[pending_destroy.index_].image_.allocation_);
-        images_[pending_destroy.index_].image_.image_ = {};
-        image_free_list_.emplace_back(pending_destroy.index_);
+  std::vector<vk::BufferCopy> regions;
+  for (auto group = uploads.begin(); group != uploads.end();) {
+    auto group_end =
+        std::ranges::find_if(group, uploads.end(), [&group](const BufferUpload& upload) {
+          return upload.buffer_handle_ != group->buffer_handle_;
+        });
+
+    auto* buffer = buffers_.get(group->buffer_handle_);
+    if (buffer == nullptr) {
+      // destroyed while waiting for this frame
+      group = group_end;
+      continue;
+    }
+
+    buffer->uploaded_ = true;
+    if (releases != nullptr) {
+      releases->emplace_back(
+          vk::AccessFlagBits::eTransferWrite, vk::AccessFlags{}, transfer_family_queue_index_,
+          graphics_family_queue_index_, buffer->buffer_, 0, VK_WHOLE_SIZE);
+    }
+
+    regions.clear();
+    for (auto upload = group; upload != group_end; ++upload) {
+      regions.push_back(upload->region_);
+    }
+
+    std::ranges::stable_sort(regions, {}, &vk::BufferCopy::dstOffset);
+
+    auto overlapping = std::ranges::adjacent_find(
+                           regions, [](const vk::BufferCopy& left, const vk::BufferCopy& right) {
+                             return left.dstOffset + left.size > right.dstOffset;
+                           }) != regions.end();
+
+    if (overlapping) {
+      // regions of one call run in no particular order, later writes have to land last
+      vk::MemoryBarrier ordered{ vk::AccessFlagBits::eTransferWrite,
+                                 vk::AccessFlagBits::eTransferWrite };
+      for (auto upload = group; upload != group_end; ++upload) {
+        if (upload != group) {
+          command_buffer.pipelineBarrier(
+              vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, {},
+              ordered, {}, {});
+        }
+        command_buffer.copyBuffer(staging_buffer_.buffer_, buffer->buffer_, upload->region_);
+      }
+      group = group_end;
+      continue;
+    }
+
+    // uploads written back to back in both buffers become one region
+    size_t merged = 0;
+    for (size_t index = 1; index < regions.size(); ++index) {
+      auto& last = regions[merged];
+      const auto& region = regions[index];
+      if (last.srcOffset + last.size == region.srcOffset &&
+          last.dstOffset + last.size == region.dstOffset) {
+        last.size += region.size;
+      } else {
+        regions[++merged] = region;
       }
-      return true;
     }
-    return false;
+    regions.resize(merged + 1);
+
+    command_buffer.copyBuffer(staging_buffer_.buffer_, buffer->buffer_, regions);
+    group = group_end;
+  }
+}
+
+void VulkanRenderingDevice::recordImageUploads(
+    const vk::raii::CommandBuffer& command_buffer, std::vector<ImageUpload>& uploads,
+    std::vector<vk::ImageMemoryBarrier>* releases) {
+  std::ranges::stable_sort(uploads, {}, [](const ImageUpload& upload) {
+    return upload.image_handle_.value();
   });
 
-  std::erase_if(pending_destroy_shader_modules_, [&completed, this](auto& pending_destroy) {
-    if (pending_destroy.fence_value_ <= completed) {
-      shader_modules_[pending_destroy.index_].shader_.release();
-      shader_modules_[pending_destroy.index_].index_ = 0;
-      shader_module_free_list_.emplace_back(pending_destroy.index_);
-      return true;
+  std::vector<vk::BufferImageCopy> regions;
+  for (auto group = uploads.begin(); group != uploads.end();) {
+    auto group_end =
+        std::ranges::find_if(group, uploads.end(), [&group](const ImageUpload& upload) {
+          return upload.image_handle_ != group->image_handle_;
+        });
+
+    auto* image = images_.get(group->image_handle_);
+    if (image == nullptr) {
+      group = group_end;
+      continue;
+    }
+
+    // a subresource always splits into the same bands, so a band uploaded again replaces the
+    // earlier copy of it; only the last one per band matters
+    regions.clear();
+    for (auto upload = group_end; upload != group;) {
+      --upload;
+      const auto& band = upload->region_;
+      auto replaced = std::ranges::any_of(regions, [&band](const auto& region) {
+        return region.imageSubresource.mipLevel == band.imageSubresource.mipLevel &&
+               region.imageSubresource.baseArrayLayer == band.imageSubresource.baseArrayLayer &&
+               region.imageOffset == band.imageOffset && region.imageExtent == band.imageExtent;
+      });
+      if (!replaced) {
+        regions.push_back(upload->region_);
+      }
+    }
+
+    vk::ImageSubresourceRange all_subresources{ vk::ImageAspectFlagBits::eColor, 0,
+                                                VK_REMAINING_MIP_LEVELS, 0,
+                                                VK_REMAINING_ARRAY_LAYERS };
+
+    // the transfer queue only sees images without contents, there is nothing to wait for
+    auto first_use = image->layout_ == VK_IMAGE_LAYOUT_UNDEFINED;
+    vk::ImageMemoryBarrier to_transfer{ first_use ? vk::AccessFlags{}
+                                                  : vk::AccessFlagBits::eShaderRead,
+                                        vk::AccessFlagBits::eTransferWrite,
+                                        static_cast<vk::ImageLayout>(image->layout_),
+                                        vk::ImageLayout::eTransferDstOptimal,
+                                        VK_QUEUE_FAMILY_IGNORED,
+                                        VK_QUEUE_FAMILY_IGNORED,
+                                        image->image_,
+                                        all_subresources };
+    command_buffer.pipelineBarrier(
+        first_use ? vk::PipelineStageFlagBits::eTopOfPipe : vk::PipelineStageFlagBits::eAllCommands,
+        vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, to_transfer);
+
+    command_buffer.copyBufferToImage(
+        staging_buffer_.buffer_, image->image_, vk::ImageLayout::eTransferDstOptimal, regions);
+
+    vk::ImageMemoryBarrier to_sampled{ vk::AccessFlagBits::eTransferWrite,
+                                       vk::AccessFlagBits::eShaderRead,
+                                       vk::ImageLayout::eTransferDstOptimal,
+                                       vk::ImageLayout::eShaderReadOnlyOptimal,
+                                       VK_QUEUE_FAMILY_IGNORED,
+                                       VK_QUEUE_FAMILY_IGNORED,
+                                       image->image_,
+                                       all_subresources };
+    if (releases != nullptr) {
+      // the layout transition happens once, as part of the ownership transfer
+      to_sampled.dstAccessMask = {};
+      to_sampled.srcQueueFamilyIndex = transfer_family_queue_index_;
+      to_sampled.dstQueueFamilyIndex = graphics_family_queue_index_;
+      releases->push_back(to_sampled);
+    } else {
+      command_buffer.pipelineBarrier(
+          vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, {},
+          {}, to_sampled);
     }
-    return false;
+
+    image->layout_ = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    group = group_end;
+  }
+}
+
+auto VulkanRenderingDevice::collectPendingDestroyIncrementally() -> boost::asio::awaitable<void> {
+  // bounds the frame-time cost of a burst of destroys, the rest waits for the next frames
+  constexpr size_t MaxCollectedPerFrame{ 64 };
+
+  collector_idle_->reset();
+  auto guard = gsl::finally([this] {
+    collection_scheduled_ = false;
+    collector_idle_->set();
   });
+
+  uint64_t completed;
+  auto result = (**device_).getSemaphoreCounterValueKHR(
+      **timeline_semaphore_, &completed, dynamic_dispatcher_);
+  if (result != vk::Result::eSuccess) {
+    LOG_ERROR("pending destroy collector failed to get semaphore counter value");
+    co_return;
+  }
+
+  size_t budget = MaxCollectedPerFrame;
+  size_t reclaimed_bytes = 0;
+
+  // each pending list belongs to the strand that destroys into it
+  co_await co_spawn(
+      strands_.getStrand(StrandLanes::Buffer),
+      [&] -> boost::asio::awaitable<void> {
+        collectCompleted(pending_destroy_buffers_, completed, budget, [&](const Buffer& buffer) {
+          reclaimed_bytes += buffer.allocation_info_.size;
+          freeBuffer(buffer);
+        });
+        collectCompleted(pending_destroy_images_, completed, budget, [&](const Image& image) {
+          reclaimed_bytes += image.allocation_info_.size;
+          freeImage(image);
+        });
+        GRAVITY_RENDERING_TRACE_COUNTER(
+            "vulkan pending destroy buffers", pending_destroy_buffers_.size());
+        GRAVITY_RENDERING_TRACE_COUNTER(
+            "vulkan pending destroy images", pending_destroy_images_.size());
+
+        // uploads waiting for staging space look at the ring again
+        staging_ring_->retire(completed);
+        timeline_advanced_->set();
+        co_return;
+      },
+      boost::asio::use_awaitable);
+
+  co_await co_spawn(
+      strands_.getStrand(StrandLanes::Sampler),
+      [&] -> boost::asio::awaitable<void> {
+        collectCompleted(pending_destroy_samplers_, completed, budget, [](const auto&) {});
+        GRAVITY_RENDERING_TRACE_COUNTER(
+            "vulkan pending destroy samplers", pending_destroy_samplers_.size());
+        co_return;
+      },
+      boost::asio::use_awaitable);
+
+  co_await co_spawn(
+      strands_.getStrand(StrandLanes::Shader),
+      [&] -> boost::asio::awaitable<void> {
+        collectCompleted(pending_destroy_shader_modules_, completed, budget, [](const auto&) {});
+        GRAVITY_RENDERING_TRACE_COUNTER(
+            "vulkan pending destroy shader modules", pending_destroy_shader_modules_.size());
+        co_return;
+      },
+      boost::asio::use_awaitable);
+
+  co_await co_spawn(
+      strands_.getStrand(StrandLanes::Pipeline),
+      [&] -> boost::asio::awaitable<void> {
+        collectCompleted(pending_destroy_pipelines_, completed, budget, [](const auto&) {});
+        GRAVITY_RENDERING_TRACE_COUNTER(
+            "vulkan pending destroy pipelines", pending_destroy_pipelines_.size());
+        co_return;
+      },
+      boost::asio::use_awaitable);
+
+  GRAVITY_RENDERING_TRACE_COUNTER("vulkan reclaimed bytes", reclaimed_bytes);
+}
+
+void VulkanRenderingDevice::collectPendingDestroy() {
+  uint64_t completed;
+  auto result = (**device_).getSemaphoreCounterValueKHR(
+      **timeline_semaphore_, &completed, dynamic_dispatcher_);
+  if (result != vk::Result::eSuccess) {
+    LOG_ERROR("pending deleted buffer collector failed to get semaphore counter value");
+    return;
+  }
+
+  auto budget = std::numeric_limits<size_t>::max();
+  collectCompleted(
+      pending_destroy_buffers_, completed, budget, [this](const Buffer& buffer) {
+        freeBuffer(buffer);
+      });
+  collectCompleted(
+      pending_destroy_images_, completed, budget, [this](const Image& image) { freeImage(image); });
+  collectCompleted(pending_destroy_samplers_, completed, budget, [](const auto&) {});
+  collectCompleted(pending_destroy_shader_modules_, completed, budget, [](const auto&) {});
+  collectCompleted(pending_destroy_pipelines_, completed, budget, [](const auto&) {});
+}
+
+void VulkanRenderingDevice::freeBuffer(const Buffer& buffer) {
+  vmaDestroyBuffer(memory_allocator_, buffer.buffer_, buffer.allocation_);
+}
+
+void VulkanRenderingDevice::freeImage(const Image& image) {
+  if (image.image_view_ != VK_NULL_HANDLE) {
+    (**device_).destroyImageView(image.image_view_);
+  }
+  vmaDestroyImage(memory_allocator_, image.image_, image.allocation_);
 }
 
 void VulkanRenderingDevice::sync() {
@@ -1,7 +1,11 @@
 #pragma once
 
 #include "descriptor_allocator.hpp"
+#include "pipeline_cache.hpp"
+#include "staging_ring.hpp"
+#include "source/common/event/async_event.hpp"
 #include "source/common/scheduler/scheduler.hpp"
+#include "source/common/templates/slot_map.hpp"
 #include "source/platform/window/window_context.hpp"
 #include "source/rendering/device/rendering_device.hpp"
 
@@ -12,11 +16,18 @@
 #include "vulkan/vulkan_handles.hpp"
 #include "vulkan/vulkan_structs.hpp"
 
+#include "boost/asio/steady_timer.hpp"
+#include "boost/asio/thread_pool.hpp"
+
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <optional>
+#include <span>
+#include <string>
 #include <unordered_set>
+#include <variant>
 #include <vector>
 
 namespace gravity {
@@ -24,17 +35,29 @@ namespace gravity {
 struct DeviceFeaturesWithTimeline {
   vk::PhysicalDeviceFeatures core_features_;
   vk::PhysicalDeviceVulkan12Features vulkan_12_features_;
+  vk::PhysicalDeviceVulkan13Features vulkan_13_features_;
 };
 
 class VulkanRenderingDevice : public RenderingDevice {
  public:
-  enum class StrandLanes : uint8_t { Initialize, Buffer, Sampler, Shader, Cleanup, _Count };
+  enum class StrandLanes : uint8_t {
+    Initialize,
+    Buffer,
+    Sampler,
+    Shader,
+    Pipeline,
+    Cleanup,
+    _Count
+  };
   using StrandGroup = StrandGroup<VulkanRenderingDevice>;
 
   ~VulkanRenderingDevice();
-  VulkanRenderingDevice(WindowContext& window_context, StrandGroup strands);
+  // An empty pipeline_cache_path keeps the pipeline cache in memory only.
+  VulkanRenderingDevice(
+      WindowContext& window_context, StrandGroup strands, std::string pipeline_cache_path = {});
 
   auto initialize() -> boost::asio::awaitable<std::error_code> override;
+  auto shutdown() -> boost::asio::awaitable<void> override;
   auto prepareBuffers() -> boost::asio::awaitable<std::error_code>;
   auto swapBuffers() -> boost::asio::awaitable<std::error_code>;
 
@@ -42,10 +65,15 @@ class VulkanRenderingDevice : public RenderingDevice {
       -> boost::asio::awaitable<std::expected<BufferHandle, std::error_code>> override;
   auto destroyBuffer(BufferHandle buffer_handle)
       -> boost::asio::awaitable<std::error_code> override;
+  auto upload(BufferHandle buffer_handle, std::span<const std::byte> data, size_t offset)
+      -> boost::asio::awaitable<std::error_code> override;
 
   auto createImage(const ImageDescriptor& descriptor)
       -> boost::asio::awaitable<std::expected<ImageHandle, std::error_code>> override;
   auto destroyImage(ImageHandle image_handle) -> boost::asio::awaitable<std::error_code> override;
+  auto upload(
+      ImageHandle image_handle, std::span<const std::byte> data, uint32_t mip_level,
+      uint32_t layer) -> boost::asio::awaitable<std::error_code> override;
 
   auto createSampler(const SamplerDescriptor& descriptor)
       -> boost::asio::awaitable<std::expected<SamplerHandle, std::error_code>> override;
@@ -57,13 +85,28 @@ class VulkanRenderingDevice : public RenderingDevice {
   auto destroyShaderModule(ShaderModuleHandle shader_handle)
       -> boost::asio::awaitable<std::error_code> override;
 
+  auto createGraphicsPipeline(const GraphicsPipelineDescriptor& descriptor)
+      -> boost::asio::awaitable<std::expected<PipelineHandle, std::error_code>> override;
+  auto createComputePipeline(const ComputePipelineDescriptor& descriptor)
+      -> boost::asio::awaitable<std::expected<PipelineHandle, std::error_code>> override;
+  auto waitPipeline(PipelineHandle pipeline_handle)
+      -> boost::asio::awaitable<std::error_code> override;
+  [[nodiscard]] auto tryGetPipeline(PipelineHandle pipeline_handle) const
+      -> PipelineStatus override;
+  auto destroyPipeline(PipelineHandle pipeline_handle)
+      -> boost::asio::awaitable<std::error_code> override;
+
  private:
   struct FrameSync {
     std::optional<vk::raii::Semaphore> image_available_;
     std::optional<vk::raii::Semaphore> render_finished_;
     std::optional<vk::raii::Fence> in_flight_;
+    // Mirrors in_flight_ on the CPU side so frame pacing can await the fence instead of polling it.
+    std::unique_ptr<AsyncEvent> in_flight_signaled_ = std::make_unique<AsyncEvent>();
     std::optional<vk::raii::CommandPool> command_pool_;
     std::vector<vk::raii::CommandBuffer> command_buffers_;
+    // transfer_semaphore_ value the frame's submit waits for, 0 when it waits for none
+    uint64_t transfer_wait_value_ = 0;
   };
 
   struct SwapchainResources {
@@ -79,20 +122,18 @@ class VulkanRenderingDevice : public RenderingDevice {
     VmaAllocation allocation_ = VK_NULL_HANDLE;
     VmaAllocationInfo allocation_info_ = {};
     VkDeviceSize size_ = 0;
+    // set once an upload has been recorded, later uploads stay on the graphics queue
+    bool uploaded_ = false;
   };
 
+  // Resources leave their slot map as soon as they are destroyed and wait here until the GPU is
+  // done with them, so their slots can be reused right away.
+  template <typename T>
   struct PendingDestroy {
-    size_t index_;
+    T resource_;
     size_t fence_value_;
   };
 
-  struct BufferSlot {
-    Buffer buffer_;
-    size_t generation_ = 0;
-    bool alive_ = true;
-    size_t index_ = 0;
-  };
-
   struct Image {
     VkImage image_ = VK_NULL_HANDLE;
     VkImageView image_view_ = VK_NULL_HANDLE;
@@ -101,12 +142,27 @@ class VulkanRenderingDevice : public RenderingDevice {
 
     VkImageCreateInfo image_create_info_ = {};
     VkImageViewCreateInfo image_view_create_info_ = {};
+
+    // every subresource is kept in this layout between uploads
+    VkImageLayout layout_ = VK_IMAGE_LAYOUT_UNDEFINED;
   };
 
-  struct ImageSlot {
-    Image image_ = {};
-    size_t generation_ = 0;
-    size_t index_ = 0;
+  struct BufferUpload {
+    BufferHandle buffer_handle_;
+    vk::BufferCopy region_;
+  };
+
+  struct ImageUpload {
+    ImageHandle image_handle_;
+    vk::BufferImageCopy region_;
+  };
+
+  // Uploads submitted on the transfer queue, acquired by the graphics queue in the next frame.
+  struct TransferBatch {
+    vk::raii::CommandBuffer command_buffer_;
+    uint64_t transfer_value_;
+    std::vector<vk::BufferMemoryBarrier> buffer_acquires_;
+    std::vector<vk::ImageMemoryBarrier> image_acquires_;
   };
 
   struct Sampler {
@@ -114,25 +170,21 @@ class VulkanRenderingDevice : public RenderingDevice {
     vk::SamplerCreateInfo sampler_create_info_;
   };
 
-  struct SamplerSlot {
-    Sampler sampler_;
-    size_t index_ = 0;
-  };
-
   struct ShaderModule {
     vk::raii::ShaderModule module_;
     ShaderStage stage_ = ShaderStage::Vertex;
   };
 
   struct ShaderSlot {
+    // only stage_ and hash_ are kept, spirv_ is cleared once the module is created
     ShaderModuleDescriptor description_;
 
     std::unique_ptr<ShaderModule> shader_;
 
-    uint32_t generation_ = 0;
-    size_t index_ = 0;
     size_t reference_counter_ = 0;
 
+    std::unique_ptr<AsyncEvent> load_finished_ = std::make_unique<AsyncEvent>();
+
     bool loading_ = false;
     bool loaded_ = false;
   };
@@ -141,6 +193,38 @@ class VulkanRenderingDevice : public RenderingDevice {
     auto operator()(const ShaderModuleDescriptor& descriptor) const -> HashType;
   };
 
+  using PipelineDescriptor = std::variant<GraphicsPipelineDescriptor, ComputePipelineDescriptor>;
+
+  struct Pipeline {
+    vk::raii::PipelineLayout layout_;
+    vk::raii::Pipeline pipeline_;
+  };
+
+  // a shader module referenced by a compiling pipeline, holds a reference until it is compiled
+  struct PipelineShader {
+    ShaderModuleHandle handle_;
+    ShaderStage stage_ = ShaderStage::Vertex;
+    vk::ShaderModule module_;
+  };
+
+  struct PipelineSlot {
+    PipelineDescriptor descriptor_;
+    HashType key_ = 0;
+
+    std::unique_ptr<Pipeline> pipeline_;
+
+    // also published in pipelines_ for tryGetPipeline, which runs on any thread
+    PipelineStatus status_ = PipelineStatus::Compiling;
+    std::error_code error_;
+
+    size_t reference_counter_ = 0;
+
+    std::unique_ptr<AsyncEvent> compiled_ = std::make_unique<AsyncEvent>();
+
+    // every reference was dropped while compiling, the slot goes away once compilation lands
+    bool orphaned_ = false;
+  };
+
   WindowContext& window_context_;
 
   StrandGroup strands_;
@@ -173,50 +257,100 @@ class VulkanRenderingDevice : public RenderingDevice {
   uint32_t present_family_queue_index_{ std::numeric_limits<uint32_t>::max() };
   std::optional<vk::raii::Queue> graphics_queue_;
   std::optional<vk::raii::Queue> present_queue_;
+  // equals graphics_family_queue_index_ and transfer_queue_ stays empty without a separate family
+  uint32_t transfer_family_queue_index_{ std::numeric_limits<uint32_t>::max() };
+  std::optional<vk::raii::Queue> transfer_queue_;
 
   // synchronization
   std::array<FrameSync, 2> frames_;
-  std::array<vk::raii::Fence*, 2> frames_in_flight_;
+  std::array<FrameSync*, 2> frames_in_flight_{};
   size_t current_frame_{ 0 };
 
   std::optional<vk::raii::Semaphore> timeline_semaphore_;
-  size_t timeline_value_{ 0 };
+  // value signaled by the next submit, the semaphore starts one below it
+  size_t timeline_value_{ 1 };
 
   // cache
   std::optional<vk::raii::PipelineCache> pipeline_cache_;
+  std::string pipeline_cache_path_;
+  bool pipeline_cache_warm_{ false };
+  // pipeline_statistics_.count() when the cache was last saved
+  size_t pipeline_cache_saved_count_{ 0 };
+  PipelineCreationStatistics pipeline_statistics_;
+  // saves the pipeline cache periodically on the Cleanup strand until the device shuts down
+  std::optional<boost::asio::steady_timer> pipeline_cache_timer_;
+  std::unique_ptr<AsyncEvent> pipeline_cache_saver_stopped_ = std::make_unique<AsyncEvent>();
+  bool pipeline_cache_saver_stopping_{ false };
 
   // descriptor allocator
   std::unique_ptr<DescriptorAllocatorPool> descriptor_allocator_static_;
 
   // memory
-  VmaAllocator memory_allocator_;
+  VmaAllocator memory_allocator_ = nullptr;
 
   // dynamic loader for EXT
   vk::detail::DispatchLoaderDynamic dynamic_dispatcher_;
 
   // Buffers
-  std::vector<BufferSlot> buffers_;
-  std::vector<PendingDestroy> pending_destroy_buffers_;
-  std::vector<size_t> buffer_free_list_;
+  SlotMap<Buffer, BufferTag> buffers_;
+  std::vector<PendingDestroy<Buffer>> pending_destroy_buffers_;
 
   // Images
-  std::vector<ImageSlot> images_;
-  std::vector<PendingDestroy> pending_destroy_images_;
-  std::vector<size_t> image_free_list_;
+  SlotMap<Image, ImageTag> images_;
+  std::vector<PendingDestroy<Image>> pending_destroy_images_;
+
+  // Uploads, owned by the Buffer strand and recorded into the next submitted frame
+  std::optional<StagingRing> staging_ring_;
+  Buffer staging_buffer_;
+  // set whenever the graphics timeline is seen to advance, by the fence waiter and the collector;
+  // uploads waiting for staging space wait on it
+  std::unique_ptr<AsyncEvent> timeline_advanced_ = std::make_unique<AsyncEvent>();
+  // a frame has recorded uploads, before that no submit closes the staging ring
+  bool uploads_recorded_{ false };
+  std::vector<BufferUpload> pending_buffer_uploads_;
+  std::vector<ImageUpload> pending_image_uploads_;
+
+  // First uploads of a resource, copied on the transfer queue when there is one. Submitted once
+  // enough is staged or at the next frame, whose submit waits for transfer_semaphore_.
+  std::optional<vk::raii::CommandPool> transfer_command_pool_;
+  std::optional<vk::raii::Semaphore> transfer_semaphore_;
+  uint64_t transfer_value_{ 0 };
+  size_t transfer_staged_bytes_{ 0 };
+  std::vector<BufferUpload> transfer_buffer_uploads_;
+  std::vector<ImageUpload> transfer_image_uploads_;
+  std::vector<TransferBatch> submitted_transfers_;
+  std::vector<PendingDestroy<vk::raii::CommandBuffer>> pending_destroy_transfer_command_buffers_;
 
   // Samplers
-  std::vector<SamplerSlot> samplers_;
+  SlotMap<Sampler, SamplerTag> samplers_;
+  std::vector<PendingDestroy<Sampler>> pending_destroy_samplers_;
 
   // Shader Modules
-  std::vector<ShaderSlot> shader_modules_;
-  std::vector<PendingDestroy> pending_destroy_shader_modules_;
-  std::vector<size_t> shader_module_free_list_;
+  SlotMap<ShaderSlot, ShaderModuleTag> shader_modules_;
+  std::vector<PendingDestroy<std::unique_ptr<ShaderModule>>> pending_destroy_shader_modules_;
   std::unordered_map<ShaderModuleDescriptor, ShaderModuleHandle, ShaderHash> shader_module_cache_;
 
+  // Pipelines
+  // publishes each slot's status, PipelineStatus{} is Compiling
+  SlotMap<PipelineSlot, PipelineTag, false, PipelineHandle, PipelineStatus> pipelines_;
+  std::vector<PendingDestroy<std::unique_ptr<Pipeline>>> pending_destroy_pipelines_;
+  // keyed by a hash of the whole descriptor, hits are confirmed against the slot's descriptor
+  std::unordered_map<HashType, PipelineHandle> pipeline_cache_lookup_;
+  size_t pipelines_compiling_{ 0 };
+  std::unique_ptr<AsyncEvent> pipelines_idle_ = std::make_unique<AsyncEvent>();
+
   std::unordered_set<std::string> enabled_instance_extension_names_;
   std::unordered_set<std::string> enabled_instance_layer_names_;
   std::unordered_set<std::string> enabled_device_extension_names_;
 
+  // Frees destroyed resources the GPU is done with, a bounded amount per frame. Scheduled by
+  // swapBuffers() on the Cleanup strand, never more than one collection at a time.
+  std::atomic<bool> collection_scheduled_{ false };
+  std::unique_ptr<AsyncEvent> collector_idle_ = std::make_unique<AsyncEvent>();
+
+  // blocks on submitted frame fences and signals the matching in_flight_signaled_ event
+  boost::asio::thread_pool fence_waiter_{ 1 };
+
   auto doInitialize() -> boost::asio::awaitable<std::error_code>;
   auto doCreateBuffer(BufferDescriptor descriptor)
       -> boost::asio::awaitable<std::expected<BufferHandle, std::error_code>>;
@@ -224,12 +358,37 @@ class VulkanRenderingDevice : public RenderingDevice {
   auto doCreateImage(ImageDescriptor descriptor)
       -> boost::asio::awaitable<std::expected<ImageHandle, std::error_code>>;
   auto doDestroyImage(ImageHandle image_handle) -> boost::asio::awaitable<std::error_code>;
+  auto doUploadBuffer(BufferHandle buffer_handle, std::span<const std::byte> data, size_t offset)
+      -> boost::asio::awaitable<std::error_code>;
+  auto doUploadImage(
+      ImageHandle image_handle, std::span<const std::byte> data, uint32_t mip_level,
+      uint32_t layer) -> boost::asio::awaitable<std::error_code>;
   auto doCreateSampler(SamplerDescriptor descriptor)
       -> boost::asio::awaitable<std::expected<SamplerHandle, std::error_code>>;
-  auto doDestroySampler(SamplerHandle image_handle) -> boost::asio::awaitable<std::error_code>;
+  auto doDestroySampler(SamplerHandle sampler_handle) -> boost::asio::awaitable<std::error_code>;
   auto doCreateShader(ShaderModuleDescriptor descriptor)
       -> boost::asio::awaitable<std::expected<ShaderModuleHandle, std::error_code>>;
   auto doDestroyShader(ShaderModuleHandle shader_handle) -> boost::asio::awaitable<std::error_code>;
+  auto doCreatePipeline(PipelineDescriptor descriptor)
+      -> boost::asio::awaitable<std::expected<PipelineHandle, std::error_code>>;
+  auto doWaitPipeline(PipelineHandle pipeline_handle) -> boost::asio::awaitable<std::error_code>;
+  auto doDestroyPipeline(PipelineHandle pipeline_handle)
+      -> boost::asio::awaitable<std::error_code>;
+
+  auto acquirePipelineShaders(std::vector<ShaderModuleHandle> shader_handles)
+      -> boost::asio::awaitable<std::expected<std::vector<PipelineShader>, std::error_code>>;
+  auto releasePipelineShaders(std::vector<PipelineShader> shaders)
+      -> boost::asio::awaitable<void>;
+  auto compilePipeline(
+      PipelineHandle pipeline_handle, PipelineDescriptor descriptor,
+      std::vector<PipelineShader> shaders) -> boost::asio::awaitable<void>;
+  [[nodiscard]] auto buildPipeline(
+      const PipelineDescriptor& descriptor, std::span<const PipelineShader> shaders) const
+      -> std::expected<std::unique_ptr<Pipeline>, std::error_code>;
+  void finishPipeline(
+      PipelineHandle pipeline_handle,
+      std::expected<std::unique_ptr<Pipeline>, std::error_code> pipeline);
+  void releasePipelineSlot(PipelineHandle pipeline_handle);
 
   auto initializeVulkanInstance() -> boost::asio::awaitable<std::error_code>;
   auto initializeSurface() -> boost::asio::awaitable<std::error_code>;
@@ -238,6 +397,7 @@ class VulkanRenderingDevice : public RenderingDevice {
   auto initializeLogicalDevice() -> boost::asio::awaitable<std::error_code>;
   auto initializeDynamicDispatcher() -> boost::asio::awaitable<std::error_code>;
   auto initializeAllocator() -> boost::asio::awaitable<std::error_code>;
+  auto initializeStagingRing() -> boost::asio::awaitable<std::error_code>;
   auto initializeDescriptorSetAllocator() -> boost::asio::awaitable<std::error_code>;
   auto initializeQueues() -> boost::asio::awaitable<std::error_code>;
   auto initializeSynchronization() -> boost::asio::awaitable<std::error_code>;
@@ -252,7 +412,29 @@ class VulkanRenderingDevice : public RenderingDevice {
   void cleanupSwapchain();
   void cleanupRenderPass();
 
+  void signalWhenComplete(FrameSync& frame);
+
+  auto allocateStaging(size_t size, size_t alignment)
+      -> boost::asio::awaitable<std::expected<size_t, std::error_code>>;
+  auto submitTransferUploads() -> std::error_code;
+  auto recordUploads(FrameSync& frame) -> boost::asio::awaitable<std::error_code>;
+  // Without releases the uploads end visible on the graphics queue, with releases the caller
+  // records the returned queue family ownership releases to the graphics queue.
+  void recordBufferUploads(
+      const vk::raii::CommandBuffer& command_buffer, std::vector<BufferUpload>& uploads,
+      std::vector<vk::BufferMemoryBarrier>* releases = nullptr);
+  void recordImageUploads(
+      const vk::raii::CommandBuffer& command_buffer, std::vector<ImageUpload>& uploads,
+      std::vector<vk::ImageMemoryBarrier>* releases = nullptr);
+
+  auto savePipelineCachePeriodically() -> boost::asio::awaitable<void>;
+  auto stopPipelineCacheSaver() -> boost::asio::awaitable<void>;
+  void savePipelineCache();
+
+  auto collectPendingDestroyIncrementally() -> boost::asio::awaitable<void>;
   void collectPendingDestroy();
+  void freeBuffer(const Buffer& buffer);
+  void freeImage(const Image& image);
 
   void sync();
 };
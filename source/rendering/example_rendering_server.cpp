@@ -49,13 +49,23 @@ auto main() -> int {
   }
 
   VulkanRenderingDevice vulkan_rendering_device{ window_context,
-                                                 scheduler.makeStrands<VulkanRenderingDevice>() };
+                                                 scheduler.makeStrands<VulkanRenderingDevice>(),
+                                                 "pipeline_cache.bin" };
+  // the device's destructor does not wait for its background work, shutdown() does
+  auto shutdown_device = [&] {
+    co_spawn(
+        scheduler.getStrand(Scheduler::StrandLanes::Main), vulkan_rendering_device.shutdown(),
+        boost::asio::use_future)
+        .wait();
+  };
+
   auto future = co_spawn(
       scheduler.getStrand(Scheduler::StrandLanes::Main), vulkan_rendering_device.initialize(),
       boost::asio::use_future);
   future.wait();
   if (auto err = future.get(); err) {
     LOG_ERROR("failed to initialize rendering device: {}", err.value());
+    shutdown_device();
     return err.value();
   }
   RenderingServer rendering_server{
@@ -69,6 +79,7 @@ auto main() -> int {
   future.wait();
   if (auto err = future.get(); err) {
     LOG_ERROR("failed to initialize rendering device: {}", err.value());
+    shutdown_device();
     return err.value();
   }
 
@@ -78,5 +89,6 @@ auto main() -> int {
 
   std::this_thread::sleep_for(15s);
 
+  shutdown_device();
   LOG_INFO("end");
 }
\ No newline at end of file
@@ -2,21 +2,96 @@
 
 #include "common/asset_types.hpp"
 #include "source/common/error.hpp"
+#include "source/common/event/async_latch.hpp"
 #include "source/common/logging/logger.hpp"
+#include "source/common/utilities.hpp"
+#include "source/rendering/common/cooked_format.hpp"
 #include "source/rendering/common/rendering_type.hpp"
 
 #include "boost/asio/awaitable.hpp"
+#include "boost/asio/co_spawn.hpp"
+#include "boost/asio/post.hpp"
+#include "boost/asio/this_coro.hpp"
 #include "boost/asio/use_awaitable.hpp"
 #include "gsl/gsl"
 
+#include <algorithm>
+#include <exception>
 #include <expected>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
 #include <system_error>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <variant>
 #include <vector>
 
 namespace gravity {
 
+namespace {
+
+// Position of a type in the dependency chain: materials use textures, meshes use materials.
+auto dependencyDepth(AssetType type) -> int {
+  switch (type) {
+    case AssetType::Material:
+      return 1;
+    case AssetType::Mesh:
+      return 2;
+    default:
+      return 0;
+  }
+}
+
+// Files an asset's load reads through the ResourceManager, normalized like the changed paths a
+// reload matches them against.
+auto resourcePaths(const AssetDescriptor& descriptor) -> std::vector<std::string> {
+  std::vector<std::string> paths;
+  if (const auto* shader = std::get_if<ShaderDescriptor>(&descriptor.data_); shader) {
+    for (auto shader_stage : magic_enum::enum_values<ShaderStage>()) {
+      if (auto stage = shader->find(shader_stage); stage) {
+        paths.push_back(normalizePath(std::string{ stage->spirv_path_ }));
+      }
+    }
+  } else if (const auto* texture = std::get_if<TextureDescriptor>(&descriptor.data_); texture) {
+    paths.push_back(normalizePath(std::string{ texture->image_path_ }));
+  } else if (const auto* mesh = std::get_if<MeshDescriptor>(&descriptor.data_); mesh) {
+    paths.push_back(normalizePath(std::string{ mesh->source() }));
+  }
+  return paths;
+}
+
+// Moves the elements of a table to their indices in a renumbered catalog.
+template <typename T>
+void remapTable(DenseTable<T>& table, const std::vector<uint32_t>& indices, size_t size) {
+  if (indices.empty()) {
+    return;
+  }
+
+  DenseTable<T> remapped{ size };
+  table.forEach([&remapped, &indices](size_t index, T& element) {
+    if (indices[index] != AssetIndexRemap::Unmapped) {
+      remapped.emplace(indices[index], std::move(element));
+    }
+  });
+  table = std::move(remapped);
+}
+
+}  // namespace
+
 auto RenderingServer::initialize() -> boost::asio::awaitable<std::error_code> {
-  co_return co_await assets_.initialize();
+  if (auto error = co_await assets_.initialize(); error) {
+    co_return error;
+  }
+
+  shader_resource_cache_.resize(assets_.getAssetCount(AssetType::Shader));
+  material_resource_cache_.resize(assets_.getAssetCount(AssetType::Material));
+  mesh_resource_cache_.resize(assets_.getAssetCount(AssetType::Mesh));
+  texture_resource_cache_.resize(assets_.getAssetCount(AssetType::Texture));
+  co_return Error::OK;
 }
 
 auto RenderingServer::draw() -> boost::asio::awaitable<void> {
@@ -31,6 +106,11 @@ auto RenderingServer::draw() -> boost::asio::awaitable<void> {
 }
 
 auto RenderingServer::loadAsset(AssetId asset_id) -> boost::asio::awaitable<std::error_code> {
+  co_return co_await co_spawn(
+      strands_.getStrand(StrandLanes::Main), doLoadAsset(asset_id), boost::asio::use_awaitable);
+}
+
+auto RenderingServer::doLoadAsset(AssetId asset_id) -> boost::asio::awaitable<std::error_code> {
 
   auto asset{ assets_.getAsset(asset_id) };
 
@@ -39,27 +119,46 @@ auto RenderingServer::loadAsset(AssetId asset_id) -> boost::asio::awaitable<std:
     co_return asset.error();
   }
 
+  const auto& asset_descriptor = asset.value();
   auto loadAndCache = [&](auto&& load_coroutine,
                           auto& cache) -> boost::asio::awaitable<std::error_code> {
-    if (cache.contains(asset_id)) {
+    if (cache.contains(asset_descriptor.index_)) {
       LOG_DEBUG("asset already loaded");
       co_return Error::OK;
     }
 
-    auto resource = co_await co_spawn(
-        strands_.getStrand(StrandLanes::Main), std::move(load_coroutine),
-        boost::asio::use_awaitable);
+    if (auto pending = pending_loads_.find(asset_id); pending != pending_loads_.end()) {
+      // keep the load alive, the loader drops its table entry before waking us
+      auto load = pending->second;
+      LOG_DEBUG("joining in-flight asset load; id: {}", asset_id);
+      co_await load->done_.wait();
+      co_return load->result_;
+    }
 
-    if (!resource) {
+    auto load = std::make_shared<PendingLoad>();
+    pending_loads_.emplace(asset_id, load);
+
+    // Joiners and doReloadAssets wait for the entry to go away, so it has to go even when the
+    // load throws or its coroutine is destroyed before finishing.
+    load->result_ = Error::InternalError;
+    auto finish = gsl::finally([this, asset_id, load] {
+      pending_loads_.erase(asset_id);
+      load->done_.set();
+    });
+
+    auto resource = co_await std::move(load_coroutine);
+    if (resource) {
+      cache.emplace(asset_descriptor.index_, std::move(*resource));
+      trackLoaded(asset_id, asset_descriptor);
+      load->result_ = Error::OK;
+    } else {
       LOG_ERROR("failed to load resource");
-      co_return resource.error();
+      load->result_ = resource.error();
     }
 
-    cache.emplace(asset_id, std::move(*resource));
-    co_return Error::OK;
+    co_return load->result_;
   };
 
-  const auto& asset_descriptor = *asset.value();
   switch (asset_descriptor.type) {
     case AssetType::Shader:
       co_return co_await loadAndCache(
@@ -80,69 +179,470 @@ auto RenderingServer::loadAsset(AssetId asset_id) -> boost::asio::awaitable<std:
   }
 }
 
+auto RenderingServer::loadAssetTree(AssetId root_id) -> boost::asio::awaitable<std::error_code> {
+  co_return co_await co_spawn(
+      strands_.getStrand(StrandLanes::Main), doLoadAssetTree(root_id), boost::asio::use_awaitable);
+}
+
+auto RenderingServer::doLoadAssetTree(AssetId root_id)
+    -> boost::asio::awaitable<std::error_code> {
+  struct TreeNode {
+    AssetId id_;
+    size_t pending_ = 0;
+    bool blocked_ = false;
+    std::vector<size_t> dependents_;
+  };
+
+  std::vector<TreeNode> nodes;
+  std::unordered_map<AssetId, size_t> node_index;
+  std::vector<size_t> unvisited;
+
+  auto visit = [&](AssetId asset_id) {
+    auto [entry, inserted] = node_index.try_emplace(asset_id, nodes.size());
+    if (inserted) {
+      nodes.push_back(TreeNode{ .id_ = asset_id });
+      unvisited.push_back(entry->second);
+    }
+    return entry->second;
+  };
+
+  visit(root_id);
+  while (!unvisited.empty()) {
+    auto node = unvisited.back();
+    unvisited.pop_back();
+
+    auto dependencies = assets_.getDependencies(nodes[node].id_);
+    if (!dependencies) {
+      LOG_ERROR("asset not found; id: {}", nodes[node].id_);
+      co_return dependencies.error();
+    }
+
+    nodes[node].pending_ = dependencies->size();
+    for (auto dependency_id : *dependencies) {
+      auto dependency = visit(dependency_id);
+      nodes[dependency].dependents_.push_back(node);
+    }
+  }
+
+  // everything below runs on the Main strand, completions included, so the bookkeeping is not
+  // shared with any other thread
+  auto executor = co_await boost::asio::this_coro::executor;
+  std::error_code first_error = Error::OK;
+  AsyncLatch latch{ nodes.size() };
+
+  std::function<void(size_t)> start;
+  std::function<void(size_t, std::error_code)> finish;
+
+  start = [&](size_t node) {
+    co_spawn(
+        executor, doLoadAsset(nodes[node].id_),
+        [&finish, node](const std::exception_ptr& exception, std::error_code error) {
+          finish(node, exception ? make_error_code(Error::InternalError) : error);
+        });
+  };
+
+  finish = [&](size_t node, std::error_code error) {
+    if (error && !first_error) {
+      first_error = error;
+    }
+
+    for (auto dependent : nodes[node].dependents_) {
+      auto& dependent_node = nodes[dependent];
+      dependent_node.blocked_ = dependent_node.blocked_ || static_cast<bool>(error);
+      if (--dependent_node.pending_ != 0) {
+        continue;
+      }
+
+      if (dependent_node.blocked_) {
+        LOG_DEBUG("skipping asset, a dependency failed; id: {}", dependent_node.id_);
+        finish(dependent, make_error_code(Error::AbortedError));
+      } else {
+        start(dependent);
+      }
+    }
+
+    latch.countDown();
+  };
+
+  std::vector<size_t> leaves;
+  for (size_t node = 0; node < nodes.size(); ++node) {
+    if (nodes[node].pending_ == 0) {
+      leaves.push_back(node);
+    }
+  }
+  for (auto leaf : leaves) {
+    start(leaf);
+  }
+
+  co_await latch.wait();
+
+  LOG_DEBUG("asset tree loaded; root: {}, assets: {}", root_id, nodes.size());
+  co_return first_error;
+}
+
+auto RenderingServer::reloadAssets(std::vector<std::string> changed_paths)
+    -> boost::asio::awaitable<std::error_code> {
+  co_return co_await co_spawn(
+      strands_.getStrand(StrandLanes::Main), doReloadAssets(std::move(changed_paths)),
+      boost::asio::use_awaitable);
+}
+
+auto RenderingServer::watchAssets(std::vector<std::string> resource_directories)
+    -> boost::asio::awaitable<std::error_code> {
+  co_return co_await co_spawn(
+      strands_.getStrand(StrandLanes::Main), doWatchAssets(std::move(resource_directories)),
+      boost::asio::use_awaitable);
+}
+
+void RenderingServer::stopWatchingAssets() {
+  boost::asio::post(strands_.getStrand(StrandLanes::Main), [this] {
+    if (watcher_) {
+      watcher_->cancel();
+    }
+  });
+}
+
+auto RenderingServer::doReloadAssets(std::vector<std::string> changed_paths)
+    -> boost::asio::awaitable<std::error_code> {
+  for (auto& path : changed_paths) {
+    path = normalizePath(path);
+  }
+
+  auto staged = co_await assets_.stageReload(changed_paths);
+  if (!staged) {
+    LOG_ERROR(
+        "asset catalog reload failed, keeping the live catalog; error: {}",
+        staged.error().message());
+    co_return staged.error();
+  }
+
+  auto invalidated = co_await resources_.invalidateResources(changed_paths);
+
+  // entries that changed or went away, and loaded assets that read a changed file
+  std::vector<AssetId> affected;
+  if (*staged) {
+    const auto& diff = (*staged)->diff_;
+    affected.insert(affected.end(), diff.changed_.begin(), diff.changed_.end());
+    affected.insert(affected.end(), diff.removed_.begin(), diff.removed_.end());
+  }
+
+  std::string_view cooked_extension{ CookedExtension };
+  for (const auto& path : changed_paths) {
+    auto source = std::string_view{ path };
+    if (source.ends_with(cooked_extension)) {
+      source.remove_suffix(cooked_extension.size());
+    }
+    if (auto users = resource_users_.find(std::string{ source }); users != resource_users_.end()) {
+      affected.insert(affected.end(), users->second.begin(), users->second.end());
+    }
+  }
+
+  // the caches are rewritten below without suspending, a load finishing in between would land at
+  // an index of the old numbering
+  while (!pending_loads_.empty()) {
+    auto load = pending_loads_.begin()->second;
+    co_await load->done_.wait();
+  }
+
+  // whatever is loaded on top of an affected asset has to go as well
+  std::unordered_set<AssetId> visited{ affected.begin(), affected.end() };
+  for (size_t next = 0; next < affected.size(); ++next) {
+    auto dependents = loaded_dependents_.find(affected[next]);
+    if (dependents == loaded_dependents_.end()) {
+      continue;
+    }
+    for (auto dependent : dependents->second) {
+      if (visited.insert(dependent).second) {
+        affected.push_back(dependent);
+      }
+    }
+  }
+
+  std::vector<ShaderResource> retired_shaders;
+  std::vector<std::pair<int, AssetId>> evicted;
+  for (auto asset_id : affected) {
+    auto asset = assets_.getAsset(asset_id);
+    if (asset && evictAsset(asset_id, retired_shaders)) {
+      evicted.emplace_back(dependencyDepth(asset->type), asset_id);
+    }
+  }
+
+  if (*staged) {
+    auto& reload = **staged;
+    const auto& remap = reload.remap_.indices_;
+    const auto& catalog = reload.catalog_;
+    remapTable(
+        shader_resource_cache_, remap[static_cast<size_t>(AssetType::Shader)],
+        catalog.count(AssetType::Shader));
+    remapTable(
+        texture_resource_cache_, remap[static_cast<size_t>(AssetType::Texture)],
+        catalog.count(AssetType::Texture));
+    remapTable(
+        mesh_resource_cache_, remap[static_cast<size_t>(AssetType::Mesh)],
+        catalog.count(AssetType::Mesh));
+    remapTable(
+        material_resource_cache_, remap[static_cast<size_t>(AssetType::Material)],
+        catalog.count(AssetType::Material));
+    assets_.applyReload(std::move(reload));
+  }
+
+  for (auto& shader : retired_shaders) {
+    for (size_t stage = 0; stage < ShaderStageCount; ++stage) {
+      if (shader.present_.test(stage)) {
+        co_await device_.destroyShaderModule(std::move(shader.stages_[stage]));
+      }
+    }
+  }
+
+  // dependencies first, so a reloaded material finds its textures loaded
+  std::ranges::sort(evicted);
+
+  std::error_code first_error = Error::OK;
+  size_t reloaded = 0;
+  for (auto [depth, asset_id] : evicted) {
+    if (!assets_.getAsset(asset_id)) {
+      continue;
+    }
+
+    if (auto error = co_await doLoadAsset(asset_id); error) {
+      LOG_ERROR("asset failed to reload; id: {}, error: {}", asset_id, error.message());
+      first_error = first_error ? first_error : error;
+      continue;
+    }
+    ++reloaded;
+  }
+
+  // loads that could hold a descriptor of a replaced catalog were drained before it was
+  // replaced, later loads take theirs from the live one
+  assets_.releaseRetiredCatalogs();
+
+  LOG_INFO(
+      "assets reloaded; files: {}, invalidated resources: {}, evicted: {}, reloaded: {}",
+      changed_paths.size(), invalidated, evicted.size(), reloaded);
+  co_return first_error;
+}
+
+auto RenderingServer::doWatchAssets(std::vector<std::string> resource_directories)
+    -> boost::asio::awaitable<std::error_code> {
+  auto shard_files = assets_.shardFiles();
+
+  auto directories = std::move(resource_directories);
+  for (const auto& file : shard_files) {
+    auto directory = std::filesystem::path{ file }.parent_path();
+    directories.push_back(directory.empty() ? "." : directory.string());
+  }
+  std::ranges::sort(directories);
+  auto duplicates = std::ranges::unique(directories);
+  directories.erase(duplicates.begin(), duplicates.end());
+
+  auto watcher = FileWatcher::create(co_await boost::asio::this_coro::executor, directories);
+  if (!watcher) {
+    co_return watcher.error();
+  }
+  watcher_ = std::move(*watcher);
+  resources_.setWatched(true);
+  LOG_INFO("watching assets for changes; directories: {}", directories.size());
+
+  while (true) {
+    auto changes = co_await watcher_->next();
+    if (!changes) {
+      watcher_.reset();
+      resources_.setWatched(false);
+      if (changes.error() == std::errc::operation_canceled) {
+        co_return Error::OK;
+      }
+      LOG_ERROR("asset watcher failed; error: {}", changes.error().message());
+      co_return changes.error();
+    }
+
+    auto paths = std::move(changes->paths_);
+    if (changes->overflow_) {
+      // events were lost, recheck everything a change could have touched
+      LOG_WARN("asset watcher overflowed, reloading all shards and loaded resources");
+      paths.insert(paths.end(), shard_files.begin(), shard_files.end());
+      for (const auto& [path, users] : resource_users_) {
+        paths.push_back(path);
+      }
+    }
+
+    // a failed reload leaves the previous state in place, the next change gets another chance
+    co_await doReloadAssets(std::move(paths));
+  }
+}
+
+void RenderingServer::trackLoaded(AssetId asset_id, const AssetDescriptor& descriptor) {
+  if (auto dependencies = assets_.getDependencies(asset_id); dependencies) {
+    for (auto dependency : *dependencies) {
+      loaded_dependents_[dependency].push_back(asset_id);
+    }
+  }
+  for (auto& path : resourcePaths(descriptor)) {
+    resource_users_[std::move(path)].push_back(asset_id);
+  }
+}
+
+void RenderingServer::untrackLoaded(AssetId asset_id, const AssetDescriptor& descriptor) {
+  auto drop = [asset_id](auto& users, const auto& key) {
+    auto entry = users.find(key);
+    if (entry == users.end()) {
+      return;
+    }
+    std::erase(entry->second, asset_id);
+    if (entry->second.empty()) {
+      users.erase(entry);
+    }
+  };
+
+  if (auto dependencies = assets_.getDependencies(asset_id); dependencies) {
+    for (auto dependency : *dependencies) {
+      drop(loaded_dependents_, dependency);
+    }
+  }
+  for (const auto& path : resourcePaths(descriptor)) {
+    drop(resource_users_, path);
+  }
+}
+
+auto RenderingServer::evictAsset(AssetId asset_id, std::vector<ShaderResource>& retired_shaders)
+    -> bool {
+  auto asset = assets_.getAsset(asset_id);
+  if (!asset) {
+    return false;
+  }
+
+  auto evict = [index = asset->index_](auto& cache, auto&& retire) {
+    auto* element = cache.find(index);
+    if (element == nullptr) {
+      return false;
+    }
+    retire(*element);
+    cache.erase(index);
+    return true;
+  };
+  auto keep = [](auto& /*element*/) {};
+
+  bool evicted = false;
+  switch (asset->type) {
+    case AssetType::Shader:
+      evicted = evict(shader_resource_cache_, [&retired_shaders](ShaderResource& shader) {
+        retired_shaders.push_back(std::move(shader));
+      });
+      break;
+    case AssetType::Texture:
+      evicted = evict(texture_resource_cache_, keep);
+      break;
+    case AssetType::Mesh:
+      evicted = evict(mesh_resource_cache_, keep);
+      break;
+    case AssetType::Material:
+      evicted = evict(material_resource_cache_, keep);
+      break;
+  }
+
+  if (evicted) {
+    LOG_DEBUG("asset evicted; id: {}", asset_id);
+    untrackLoaded(asset_id, *asset);
+  }
+  return evicted;
+}
+
 auto RenderingServer::loadShader(const ShaderDescriptor& shader_descriptor)
     -> boost::asio::awaitable<std::expected<ShaderResource, std::error_code>> {
 
-  ShaderResource shader_resource{};
-
+  std::vector<ShaderStage> stages;
+  std::vector<ResourceDescriptor> resource_descriptors;
   for (auto shader_stage : magic_enum::enum_values<ShaderStage>()) {
-    if (!shader_descriptor.stages_.contains(shader_stage)) {
+    auto stage_descriptor = shader_descriptor.find(shader_stage);
+    if (!stage_descriptor) {
       LOG_TRACE("stage assets not found skipping; stage: {}", magic_enum::enum_name(shader_stage));
       continue;
     }
-    const auto& stage_descriptor = shader_descriptor.stages_.at(shader_stage);
 
-    auto shader_handle_expect = co_await loadShaderStage(shader_stage, stage_descriptor);
-    if (!shader_handle_expect) {
-      for (auto index = 0; index < shader_resource.stages_.size(); ++index) {
-        if (shader_resource.present_.test(index)) {
-          co_await device_.destroyShaderModule(std::move(shader_resource.stages_[index]));
-        }
-      }
-      shader_resource.present_.reset();
+    stages.push_back(shader_stage);
+    resource_descriptors.push_back(ResourceDescriptor{
+        .type_ = ResourceType::Shader, .path_ = std::string{ stage_descriptor->spirv_path_ } });
+  }
+
+  // every stage's file is read concurrently, the leases keep the bytes alive until the modules
+  // are created
+  auto leases = co_await resources_.acquireResources(resource_descriptors);
+  for (size_t stage = 0; stage < stages.size(); ++stage) {
+    if (!leases[stage]) {
+      LOG_ERROR(
+          "failed to load shader resource; stage: {}, spirv_path: {}",
+          magic_enum::enum_name(stages[stage]), resource_descriptors[stage].path_);
+      co_return std::unexpected(leases[stage].error());
+    }
+  }
+
+  std::vector<std::expected<ShaderModuleHandle, std::error_code>> modules;
+  modules.reserve(stages.size());
+  for (size_t stage = 0; stage < stages.size(); ++stage) {
+    modules.emplace_back(std::unexpected(Error::InternalError));
+  }
 
-      LOG_ERROR("failed to load shader; stage: {}", magic_enum::enum_name(shader_stage));
-      co_return std::unexpected(shader_handle_expect.error());
+  auto executor = co_await boost::asio::this_coro::executor;
+  AsyncLatch latch{ stages.size() };
+  for (size_t stage = 0; stage < stages.size(); ++stage) {
+    co_spawn(
+        executor, loadShaderStage(stages[stage], *leases[stage]->resource_),
+        [&latch, &module = modules[stage]](
+            const std::exception_ptr& exception,
+            std::expected<ShaderModuleHandle, std::error_code> created) {
+          if (!exception) {
+            module = std::move(created);
+          }
+          latch.countDown();
+        });
+  }
+  co_await latch.wait();
+
+  // all or nothing, a shader missing a stage is never cached
+  auto failed = std::ranges::find_if(modules, [](const auto& module) { return !module; });
+  if (failed != modules.end()) {
+    for (auto& module : modules) {
+      if (module) {
+        co_await device_.destroyShaderModule(std::move(*module));
+      }
     }
 
-    auto index_opt = magic_enum::enum_index(shader_stage);
+    auto stage = stages[static_cast<size_t>(failed - modules.begin())];
+    LOG_ERROR("failed to load shader; stage: {}", magic_enum::enum_name(stage));
+    co_return std::unexpected(failed->error());
+  }
+
+  ShaderResource shader_resource{};
+  for (size_t stage = 0; stage < stages.size(); ++stage) {
+    auto index_opt = magic_enum::enum_index(stages[stage]);
     if (!index_opt) {
-      LOG_ERROR("Invalid shader stage enum value {}", magic_enum::enum_name(shader_stage));
+      LOG_ERROR("Invalid shader stage enum value {}", magic_enum::enum_name(stages[stage]));
       co_return std::unexpected(make_error_code(Error::InternalError));
     }
     const auto index = *index_opt;
 
-    shader_resource.stages_[index] = shader_handle_expect.value();
+    shader_resource.stages_[index] = *modules[stage];
     shader_resource.present_.set(index);
   }
 
   co_return shader_resource;
 }
 
-auto RenderingServer::loadShaderStage(
-    ShaderStage stage, const ShaderStageDescriptor& shader_stage_descriptor)
+auto RenderingServer::loadShaderStage(ShaderStage stage, const Resource& shader)
     -> boost::asio::awaitable<std::expected<ShaderModuleHandle, std::error_code>> {
 
-  ResourceDescriptor resource_descriptor{ .type_ = ResourceType::Shader,
-                                          .path_ = shader_stage_descriptor.spirv_path_ };
-
-  auto expect_lease = co_await resources_.acquireResource(resource_descriptor);
-  if (!expect_lease) {
+  if (shader.data_.size() % sizeof(uint32_t) != 0) {
     LOG_ERROR(
-        "failed to load shader resource; stage: {}, spirv_path: {}", magic_enum::enum_name(stage),
-        resource_descriptor.path_);
-    co_return std::unexpected(expect_lease.error());
+        "shader resource is not a whole number of spirv words; stage: {}, size: {}",
+        magic_enum::enum_name(stage), shader.data_.size());
+    co_return std::unexpected(Error::SchemaError);
   }
 
-  const auto& shader = *(co_await resources_.getResource(expect_lease.value()));
-
-  std::vector<uint32_t> spirv;
-  spirv.resize(shader.data_.size() / sizeof(uint32_t));
-  std::memcpy(spirv.data(), shader.data_.data(), shader.data_.size());
-
+  // resource data is ResourceDataAlignment aligned, the words are read in place
+  static_assert(ResourceDataAlignment % alignof(uint32_t) == 0);
   ShaderModuleDescriptor descriptor{
     .stage_ = stage,
-    .spirv_ = spirv,
+    .spirv_ = { reinterpret_cast<const uint32_t*>(shader.data_.data()),  // NOLINT
+                shader.data_.size() / sizeof(uint32_t) },
     .hash_ = shader.hash_,
   };
 
@@ -159,14 +659,20 @@ auto RenderingServer::loadMesh(const MeshDescriptor& mesh_descriptor)
   co_return std::unexpected(Error::UnimplementedError);
 }
 
-auto RenderingServer::loadTexture(const TextureDescriptor& mesh_descriptor)
+auto RenderingServer::loadTexture(const TextureDescriptor& texture_descriptor)
     -> boost::asio::awaitable<std::expected<TextureResource, std::error_code>> {
 
-  // ShaderSourceResourceDescriptor resource_descriptor{ .path = shader_stage_descriptor.spirv_path_
-  // };
-
-  // auto handle_expect = co_await resources_.acquireShaderSourceResource(resource_descriptor);
+  // the cook options select which cooked image is current, see cookedImageOptionsKey()
+  auto image = co_await resources_.acquireResource(ResourceDescriptor{
+      .type_ = ResourceType::Image,
+      .path_ = std::string{ texture_descriptor.image_path_ },
+      .cook_options_ = cookedImageOptionsKey(texture_descriptor) });
+  if (!image) {
+    LOG_ERROR("failed to load image resource; image_path: {}", texture_descriptor.image_path_);
+    co_return std::unexpected(image.error());
+  }
 
+  // the image stays parked in the resource cache, device textures are not created yet
   co_return std::unexpected(Error::UnimplementedError);
 }
 
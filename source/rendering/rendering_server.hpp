@@ -2,15 +2,25 @@
 
 #include "asset_manager.hpp"
 #include "common/asset_types.hpp"
+#include "source/common/event/async_event.hpp"
+#include "source/common/io/file_watcher.hpp"
 #include "source/common/scheduler/scheduler.hpp"
+#include "source/common/templates/dense_table.hpp"
 #include "source/rendering/asset_manager.hpp"
+#include "source/rendering/common/cooked_format.hpp"
 #include "source/rendering/device/rendering_device.hpp"
 #include "source/rendering/resource_manager.hpp"
 
 #include "magic_enum.hpp"
 
+#include <array>
+#include <bitset>
 #include <cstdint>
+#include <memory>
+#include <string>
+#include <system_error>
 #include <unordered_map>
+#include <vector>
 
 namespace gravity {
 
@@ -39,28 +49,84 @@ class RenderingServer {
   RenderingServer(Scheduler& scheduler, RenderingDevice& device)
       : device_{ device },
         strands_{ scheduler.makeStrands<RenderingServer>() },
-        resources_{ scheduler.makeStrands<ResourceManager>() } {}
+        assets_{ scheduler.makeStrands<AssetManager>() },
+        // the cook tool's index of the default shard, cooked resources are picked without reading
+        // their unchanged sources
+        resources_{ scheduler.makeStrands<ResourceManager>(), ResourceLoadMode::Mapped,
+                    DefaultResidencyBudgets,
+                    std::string{ AssetManager::DefaultShard } + CookIndexExtension } {}
 
   auto initialize() -> boost::asio::awaitable<std::error_code>;
 
   auto draw() -> boost::asio::awaitable<void>;
 
+  // Concurrent loads of one asset share a single load, later callers wait for the first one and
+  // get its result.
   auto loadAsset(AssetId asset_id) -> boost::asio::awaitable<std::error_code>;
 
+  // Loads an asset and everything it transitively depends on. Each asset starts as soon as its
+  // own dependencies are loaded, independent branches are in flight together; an asset whose
+  // dependency failed is not attempted. Returns the first error.
+  auto loadAssetTree(AssetId root_id) -> boost::asio::awaitable<std::error_code>;
+
+  // Picks up changed catalog shards and resource files without a restart. The catalog is rebuilt
+  // from the changed shards only and diffed against the live one; loaded assets that were changed
+  // or removed, or that read one of the changed files, are evicted together with the loaded
+  // assets depending on them, then the ones still in the catalog are loaded again, dependencies
+  // first. Everything else stays cached. A catalog that fails to rebuild leaves all in place.
+  auto reloadAssets(std::vector<std::string> changed_paths)
+      -> boost::asio::awaitable<std::error_code>;
+
+  // Watches the shard directories and resource_directories and calls reloadAssets() for every
+  // batch of changes, until stopWatchingAssets() or a watcher error. Resource files are read
+  // rather than mapped while watched, so start watching before loading assets.
+  auto watchAssets(std::vector<std::string> resource_directories)
+      -> boost::asio::awaitable<std::error_code>;
+  void stopWatchingAssets();
+
  private:
   RenderingDevice& device_;
   StrandGroup strands_;
   AssetManager assets_;
   ResourceManager resources_;
 
-  std::unordered_map<AssetId, ShaderResource> shader_resource_cache_;
-  std::unordered_map<AssetId, MaterialResource> material_resource_cache_;
-  std::unordered_map<AssetId, MeshResource> mesh_resource_cache_;
-  std::unordered_map<AssetId, TextureResource> texture_resource_cache_;
+  struct PendingLoad {
+    AsyncEvent done_;
+    std::error_code result_;
+  };
+
+  // loads in flight on the Main strand, of any asset type
+  std::unordered_map<AssetId, std::shared_ptr<PendingLoad>> pending_loads_;
+
+  // Reverse edges of the loaded assets, kept up to date as assets are loaded and evicted so a
+  // reload finds what it affects without scanning the caches: loaded dependents of an asset, and
+  // loaded assets that read a resource file.
+  std::unordered_map<AssetId, std::vector<AssetId>> loaded_dependents_;
+  std::unordered_map<std::string, std::vector<AssetId>> resource_users_;
+
+  std::unique_ptr<FileWatcher> watcher_;
+
+  // indexed by AssetDescriptor::index_, sized once the asset catalog is loaded
+  DenseTable<ShaderResource> shader_resource_cache_;
+  DenseTable<MaterialResource> material_resource_cache_;
+  DenseTable<MeshResource> mesh_resource_cache_;
+  DenseTable<TextureResource> texture_resource_cache_;
+
+  auto doLoadAsset(AssetId asset_id) -> boost::asio::awaitable<std::error_code>;
+  auto doLoadAssetTree(AssetId root_id) -> boost::asio::awaitable<std::error_code>;
+  auto doReloadAssets(std::vector<std::string> changed_paths)
+      -> boost::asio::awaitable<std::error_code>;
+  auto doWatchAssets(std::vector<std::string> resource_directories)
+      -> boost::asio::awaitable<std::error_code>;
+
+  void trackLoaded(AssetId asset_id, const AssetDescriptor& descriptor);
+  void untrackLoaded(AssetId asset_id, const AssetDescriptor& descriptor);
+  // Takes a loaded asset out of its cache, its GPU objects are appended to retired_shaders.
+  auto evictAsset(AssetId asset_id, std::vector<ShaderResource>& retired_shaders) -> bool;
 
   auto loadShader(const ShaderDescriptor& shader_descriptor)
       -> boost::asio::awaitable<std::expected<ShaderResource, std::error_code>>;
-  auto loadShaderStage(ShaderStage stage, const ShaderStageDescriptor& shader_stage_descriptor)
+  auto loadShaderStage(ShaderStage stage, const Resource& shader)
       -> boost::asio::awaitable<std::expected<ShaderModuleHandle, std::error_code>>;
 
   auto loadMaterial(const MaterialDescriptor& material_descriptor)
@@ -69,7 +135,7 @@ class RenderingServer {
   auto loadMesh(const MeshDescriptor& mesh_descriptor)
       -> boost::asio::awaitable<std::expected<MeshResource, std::error_code>>;
 
-  auto loadTexture(const TextureDescriptor& mesh_descriptor)
+  auto loadTexture(const TextureDescriptor& texture_descriptor)
       -> boost::asio::awaitable<std::expected<TextureResource, std::error_code>>;
 };
 
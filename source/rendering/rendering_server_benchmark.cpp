@@ -0,0 +1,242 @@
+#include "source/rendering/rendering_server.hpp"
+
+#include "source/common/error.hpp"
+#include "source/common/logging/logger.hpp"
+#include "source/common/scheduler/scheduler.hpp"
+#include "source/rendering/common/synthetic_catalog.hpp"
+#include "source/rendering/device/rendering_device.hpp"
+
+#include "benchmark/benchmark.h"
+#include "boost/asio/co_spawn.hpp"
+#include "boost/asio/steady_timer.hpp"
+#include "boost/asio/this_coro.hpp"
+#include "boost/asio/use_awaitable.hpp"
+#include "boost/asio/use_future.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <latch>
+#include <span>
+#include <string>
+#include <system_error>
+#include <vector>
+
+// Contention on a single asset: N requesters call RenderingServer::loadAsset for the same shader
+// at once, and should share one load. Each iteration takes a shader that was never loaded, reads
+// its two stage files through the ResourceManager and creates its modules on a stub device that
+// takes ShaderModuleCompileTime per module. shader_modules_per_load stays at two however many
+// requesters there are. The argument is the number of requesters.
+//
+// The server reads its catalog from resources/assetsdb.json under the working directory, so the
+// benchmark runs inside a scratch directory holding ShaderCount shaders.
+
+namespace gravity {
+
+namespace {
+
+constexpr size_t ShaderCount{ 1024 };
+constexpr size_t SpirvSize{ 16 * 1024 };
+constexpr std::chrono::microseconds ShaderModuleCompileTime{ 200 };
+
+struct BenchmarkSystem {
+  enum class StrandLanes : uint8_t { Main, _Count };
+};
+
+class StubRenderingDevice final : public RenderingDevice {
+ public:
+  auto initialize() -> boost::asio::awaitable<std::error_code> override { co_return Error::OK; }
+  auto shutdown() -> boost::asio::awaitable<void> override { co_return; }
+
+  auto createBuffer(const BufferDescriptor& /*descriptor*/)
+      -> boost::asio::awaitable<std::expected<BufferHandle, std::error_code>> override {
+    co_return std::unexpected(Error::UnimplementedError);
+  }
+  auto destroyBuffer(BufferHandle /*buffer_handle*/)
+      -> boost::asio::awaitable<std::error_code> override {
+    co_return Error::UnimplementedError;
+  }
+  auto upload(
+      BufferHandle /*buffer_handle*/, std::span<const std::byte> /*data*/, size_t /*offset*/)
+      -> boost::asio::awaitable<std::error_code> override {
+    co_return Error::UnimplementedError;
+  }
+
+  auto createImage(const ImageDescriptor& /*descriptor*/)
+      -> boost::asio::awaitable<std::expected<ImageHandle, std::error_code>> override {
+    co_return std::unexpected(Error::UnimplementedError);
+  }
+  auto destroyImage(ImageHandle /*image_handle*/)
+      -> boost::asio::awaitable<std::error_code> override {
+    co_return Error::UnimplementedError;
+  }
+  auto upload(
+      ImageHandle /*image_handle*/, std::span<const std::byte> /*data*/, uint32_t /*mip_level*/,
+      uint32_t /*layer*/) -> boost::asio::awaitable<std::error_code> override {
+    co_return Error::UnimplementedError;
+  }
+
+  auto createSampler(const SamplerDescriptor& /*descriptor*/)
+      -> boost::asio::awaitable<std::expected<SamplerHandle, std::error_code>> override {
+    co_return std::unexpected(Error::UnimplementedError);
+  }
+  auto destroySampler(SamplerHandle /*sampler_handler*/)
+      -> boost::asio::awaitable<std::error_code> override {
+    co_return Error::UnimplementedError;
+  }
+
+  auto createShaderModule(ShaderModuleDescriptor /*descriptor*/)
+      -> boost::asio::awaitable<std::expected<ShaderModuleHandle, std::error_code>> override {
+    boost::asio::steady_timer compile{ co_await boost::asio::this_coro::executor };
+    compile.expires_after(ShaderModuleCompileTime);
+    co_await compile.async_wait(boost::asio::use_awaitable);
+
+    auto index = created_.fetch_add(1, std::memory_order_relaxed);
+    co_return ShaderModuleHandle{ index, 0 };
+  }
+  auto destroyShaderModule(ShaderModuleHandle /*shader_handle*/)
+      -> boost::asio::awaitable<std::error_code> override {
+    co_return Error::OK;
+  }
+
+  auto createGraphicsPipeline(const GraphicsPipelineDescriptor& /*descriptor*/)
+      -> boost::asio::awaitable<std::expected<PipelineHandle, std::error_code>> override {
+    co_return std::unexpected(Error::UnimplementedError);
+  }
+  auto createComputePipeline(const ComputePipelineDescriptor& /*descriptor*/)
+      -> boost::asio::awaitable<std::expected<PipelineHandle, std::error_code>> override {
+    co_return std::unexpected(Error::UnimplementedError);
+  }
+  auto waitPipeline(PipelineHandle /*pipeline_handle*/)
+      -> boost::asio::awaitable<std::error_code> override {
+    co_return Error::UnimplementedError;
+  }
+  [[nodiscard]] auto tryGetPipeline(PipelineHandle /*pipeline_handle*/) const
+      -> PipelineStatus override {
+    return PipelineStatus::Failed;
+  }
+  auto destroyPipeline(PipelineHandle /*pipeline_handle*/)
+      -> boost::asio::awaitable<std::error_code> override {
+    co_return Error::UnimplementedError;
+  }
+
+  [[nodiscard]] auto created() const -> size_t { return created_.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<size_t> created_{ 0 };
+};
+
+// A scratch directory with the catalog and every stage file; it is the working directory for as
+// long as the object lives.
+class ShaderTree {
+ public:
+  ShaderTree()
+      : previous_{ std::filesystem::current_path() },
+        directory_{ std::filesystem::temp_directory_path() / "gravity_loadasset_benchmark" } {
+    std::filesystem::create_directories(directory_ / "resources");
+    std::filesystem::create_directories(directory_ / "shaders");
+    std::filesystem::current_path(directory_);
+
+    // syntheticAssetJson() makes every fourth id a shader
+    for (size_t shader = 1; shader <= ShaderCount; ++shader) {
+      shader_ids_.push_back(static_cast<AssetId>(shader * 4));
+    }
+    std::ofstream{ std::string{ AssetManager::DefaultShard } + AssetShard::JsonExtension }
+        << syntheticCatalogJson(shader_ids_);
+
+    std::string spirv(SpirvSize, '\x07');
+    for (auto id : shader_ids_) {
+      for (const char* stage : { ".vert.spv", ".frag.spv" }) {
+        std::ofstream{ "shaders/" + std::to_string(id) + stage, std::ios::binary } << spirv;
+      }
+    }
+  }
+
+  ShaderTree(const ShaderTree&) = delete;
+  auto operator=(const ShaderTree&) -> ShaderTree& = delete;
+
+  ~ShaderTree() {
+    std::error_code error_code;
+    std::filesystem::current_path(previous_, error_code);
+    std::filesystem::remove_all(directory_, error_code);
+  }
+
+  [[nodiscard]] auto shaderIds() const -> const std::vector<AssetId>& { return shader_ids_; }
+
+ private:
+  std::filesystem::path previous_;
+  std::filesystem::path directory_;
+  std::vector<AssetId> shader_ids_;
+};
+
+void BM_ConcurrentLoadAsset(benchmark::State& state) {
+  for (const char* module : { "default", "resource_manager", "asset_database", "scheduler" }) {
+    getOrCreateLogger(module)->set_level(spdlog::level::err);
+  }
+
+  ShaderTree tree;
+  auto requesters = static_cast<size_t>(state.range(0));
+
+  Scheduler scheduler{};
+  StubRenderingDevice device;
+  RenderingServer server{ scheduler, device };
+
+  auto requester_executor = scheduler.makeStrands<BenchmarkSystem>().getWorkExecutor();
+  if (boost::asio::co_spawn(
+          scheduler.getStrand(Scheduler::StrandLanes::Main), server.initialize(),
+          boost::asio::use_future)
+          .get()) {
+    state.SkipWithError("initializing the rendering server failed");
+    return;
+  }
+
+  size_t next_shader{ 0 };
+  std::atomic<size_t> failed{ 0 };
+  for (auto _ : state) {
+    if (next_shader == tree.shaderIds().size()) {
+      state.SkipWithError("ran out of shaders that were never loaded");
+      return;
+    }
+    auto shader_id = tree.shaderIds()[next_shader++];
+
+    std::latch done{ static_cast<std::ptrdiff_t>(requesters) };
+    for (size_t requester = 0; requester < requesters; ++requester) {
+      boost::asio::co_spawn(
+          requester_executor, server.loadAsset(shader_id),
+          [&](const std::exception_ptr& exception, std::error_code error) {
+            if (exception || error) {
+              failed.fetch_add(1, std::memory_order_relaxed);
+            }
+            done.count_down();
+          });
+    }
+    done.wait();
+  }
+
+  if (failed.load() > 0) {
+    state.SkipWithError("a load failed");
+    return;
+  }
+  state.counters["shader_modules_per_load"] =
+      static_cast<double>(device.created()) / static_cast<double>(state.iterations());
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * requesters));
+}
+
+BENCHMARK(BM_ConcurrentLoadAsset)
+    ->ArgName("requesters")
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(64)
+    ->Arg(512)
+    ->Iterations(ShaderCount / 2)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace gravity
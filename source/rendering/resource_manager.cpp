@@ -1,12 +1,26 @@
 #include "resource_manager.hpp"
 
+#include "source/common/diagnostics/trace.hpp"
+#include "source/common/event/async_latch.hpp"
 #include "source/common/logging/logger.hpp"
+#include "source/common/utilities.hpp"
 
+#include "boost/asio/bind_executor.hpp"
+#include "boost/asio/this_coro.hpp"
 #include "boost/asio/use_awaitable.hpp"
+#include "gsl/gsl"
 #include "magic_enum.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <deque>
 #include <expected>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #undef GRAVITY_MODULE_NAME
 #define GRAVITY_MODULE_NAME "resource_manager"
@@ -15,9 +29,48 @@ namespace asio = boost::asio;
 
 namespace gravity {
 
+namespace {
+
+// reads are issued and hashed in chunks of this size, so each chunk is hashed while still in cache
+constexpr size_t ResourceReadChunkSize{ size_t{ 1 } * 1024 * 1024 };
+// io_uring chunk reads in flight per resource, the engine's queue is shared by all loads
+constexpr size_t ResourceReadWindow{ 8 };
+
+struct ResourceCounterNames {
+  const char* hits_;
+  const char* misses_;
+  const char* evictions_;
+  const char* resident_bytes_;
+};
+
+// indexed by toIndex(), counter tracks need names with static storage
+constexpr std::array<ResourceCounterNames, magic_enum::enum_count<ResourceType>()> CounterNames{ {
+    { "Shader Cache Hits", "Shader Cache Misses", "Shader Evictions", "Shader Resident Bytes" },
+    { "Image Cache Hits", "Image Cache Misses", "Image Evictions", "Image Resident Bytes" },
+    { "Mesh Cache Hits", "Mesh Cache Misses", "Mesh Evictions", "Mesh Resident Bytes" },
+    { "Material Cache Hits", "Material Cache Misses", "Material Evictions",
+      "Material Resident Bytes" },
+} };
+
+auto cookedPath(const ResourceDescriptor& descriptor) -> std::optional<std::string> {
+  if (descriptor.type_ != ResourceType::Image && descriptor.type_ != ResourceType::Mesh) {
+    return std::nullopt;
+  }
+
+  auto path = descriptor.path_ + CookedExtension;
+  std::error_code error;
+  if (!std::filesystem::exists(path, error)) {
+    return std::nullopt;
+  }
+  return path;
+}
+
+}  // namespace
+
 auto operator==(const ResourceDescriptor& descriptor, const ResourceDescriptor& other_description)
     -> bool {
-  return descriptor.path_ == other_description.path_;
+  return descriptor.path_ == other_description.path_ &&
+         descriptor.cook_options_ == other_description.cook_options_;
 }
 
 auto toIndex(ResourceType type) -> size_t {
@@ -35,12 +88,14 @@ auto toIndex(ResourceType type) -> size_t {
   std::unreachable();
 }
 
-ResourceLease::ResourceLease(ResourceManager* resource_manager, ResourceHandle handle)
-    : resource_manager_{ resource_manager }, handle_{ handle } {}
+ResourceLease::ResourceLease(
+    ResourceManager* resource_manager, ResourceHandle handle, const Resource* resource)
+    : resource_manager_{ resource_manager }, handle_{ handle }, resource_{ resource } {}
 
 ResourceLease::ResourceLease(ResourceLease&& other) noexcept {
   std::swap(handle_, other.handle_);
   std::swap(resource_manager_, other.resource_manager_);
+  std::swap(resource_, other.resource_);
 }
 
 auto ResourceLease::operator=(ResourceLease&& other) noexcept -> ResourceLease& {
@@ -49,6 +104,7 @@ auto ResourceLease::operator=(ResourceLease&& other) noexcept -> ResourceLease&
 
     std::swap(handle_, other.handle_);
     std::swap(resource_manager_, other.resource_manager_);
+    std::swap(resource_, other.resource_);
   }
   return *this;
 }
@@ -62,90 +118,225 @@ void ResourceLease::release() {
     resource_manager_->releaseResource(handle_);
   }
   resource_manager_ = nullptr;
+  resource_ = nullptr;
 }
 
-ResourceManager::ResourceManager(StrandGroup strands) : strands_{ std::move(strands) } {}
+ResourceManager::ResourceManager(
+    StrandGroup strands, ResourceLoadMode load_mode, const ResidencyBudgets& budgets,
+    const std::string& content_hash_index_path)
+    : strands_{ std::move(strands) }, load_mode_{ load_mode } {
+  for (size_t i = 0; i < contexts_.size(); ++i) {
+    contexts_[i].budget_ = budgets[i];
+  }
+
+  if (load_mode_ == ResourceLoadMode::IoUring) {
+    auto engine = IoUringEngine::create();
+    if (engine) {
+      io_uring_ = std::move(*engine);
+    } else {
+      LOG_WARN(
+          "io_uring is not available, falling back to stream reads; error: {}",
+          engine.error().message());
+      load_mode_ = ResourceLoadMode::Stream;
+    }
+  }
+
+  if (!content_hash_index_path.empty()) {
+    auto index = ContentHashIndex::open(content_hash_index_path);
+    if (index) {
+      content_hash_index_ = std::move(*index);
+    } else {
+      LOG_WARN(
+          "unable to open content hash index, every load will be hashed; path: {}, error: {}",
+          content_hash_index_path, index.error().message());
+    }
+  }
+}
 
 auto ResourceManager::acquireResource(const ResourceDescriptor& descriptor)
-    -> asio::awaitable<std::expected<ResourceLease, std::error_code>> {
+    -> asio::awaitable<AcquireResult> {
   assert(static_cast<size_t>(descriptor.type_) != 0);
   co_return co_await asio::co_spawn(
       strands_.getStrand(descriptor.type_), doAcquireResource(descriptor), asio::use_awaitable);
 }
 
+auto ResourceManager::acquireResources(std::span<const ResourceDescriptor> descriptors)
+    -> asio::awaitable<std::vector<AcquireResult>> {
+  // anything a group fails to fill in is reported as a failure rather than an empty lease
+  std::vector<AcquireResult> results;
+  results.reserve(descriptors.size());
+  for (size_t i = 0; i < descriptors.size(); ++i) {
+    results.emplace_back(std::unexpected(Error::InternalError));
+  }
+
+  std::array<std::vector<size_t>, magic_enum::enum_count<ResourceType>()> groups;
+  for (size_t i = 0; i < descriptors.size(); ++i) {
+    assert(static_cast<size_t>(descriptors[i].type_) != 0);
+    groups[toIndex(descriptors[i].type_)].push_back(i);
+  }
+
+  AsyncLatch latch{ static_cast<size_t>(
+      std::ranges::count_if(groups, [](const auto& group) { return !group.empty(); })) };
+
+  for (const auto& group : groups) {
+    if (group.empty()) {
+      continue;
+    }
+
+    asio::co_spawn(
+        strands_.getStrand(descriptors[group.front()].type_),
+        doAcquireResources(descriptors, group, results), [&latch](const std::exception_ptr&) {
+          latch.countDown();
+        });
+  }
+
+  co_await latch.wait();
+  co_return results;
+}
+
 void ResourceManager::releaseResource(ResourceHandle handle) {
   asio::co_spawn(
       strands_.getStrand(handle.type_),
       [this, handle]() -> asio::awaitable<void> {
-        auto& resource_storage = contexts_[toIndex(handle.type_)].resources_;
-        auto& cache = contexts_[toIndex(handle.type_)].cache_;
-        auto& free_list = contexts_[toIndex(handle.type_)].free_list_;
+        auto& context = contexts_[toIndex(handle.type_)];
+        auto* slot = context.resources_.get(handle.slot_);
+        assert(slot != nullptr);
 
-        auto& resource_slot = resource_storage[handle.index_];
-
-        assert(resource_slot.generation_ == handle.generation_);
+        auto& resource_slot = *slot;
         assert(resource_slot.reference_counter_ > 0);
 
-        if (--resource_slot.reference_counter_ == 0) {
-          LOG_DEBUG("releasing shader resource; path: {}", resource_slot.descriptor_.path_);
+        if (--resource_slot.reference_counter_ != 0) {
+          co_return;
+        }
 
-          cache.erase(resource_slot.descriptor_);
+        if (!resource_slot.loaded_ || resource_slot.stale_) {
+          LOG_DEBUG(
+              "releasing {} resource; path: {}", magic_enum::enum_name(handle.type_),
+              resource_slot.descriptor_.path_);
+          freeSlot(context, handle.slot_);
+          co_return;
+        }
 
-          resource_slot.generation_++;
-          resource_slot.resource_.reset();
-          resource_slot.loaded_ = false;
+        // keep the bytes around so the next acquire can revive them without touching the disk
+        LOG_DEBUG(
+            "parking {} resource; path: {}", magic_enum::enum_name(handle.type_),
+            resource_slot.descriptor_.path_);
+        context.lru_.push_front(handle.slot_);
+        resource_slot.lru_position_ = context.lru_.begin();
 
-          free_list.emplace_back(handle.index_);
-        }
+        trimResidency(handle.type_);
 
         co_return;
       },
       asio::detached);
 }
 
-auto ResourceManager::getResource(const ResourceLease& lease) const
-    -> boost::asio::awaitable<const Resource*> {
-  co_return co_await asio::co_spawn(
-      strands_.getStrand(lease.handle_.type_),
-      [this, handle = lease.handle_]() -> asio::awaitable<const Resource*> {
-        const auto& resource_storage = contexts_[toIndex(handle.type_)].resources_;
-        co_return resource_storage[handle.index_].resource_.get();
-      },
-      asio::use_awaitable);
+auto ResourceManager::invalidateResources(std::span<const std::string> paths)
+    -> asio::awaitable<size_t> {
+  std::vector<std::string> keys;
+  std::string_view cooked_extension{ CookedExtension };
+  for (const auto& path : paths) {
+    if (path.ends_with(cooked_extension)) {
+      keys.push_back(normalizePath(path.substr(0, path.size() - cooked_extension.size())));
+    } else {
+      keys.push_back(normalizePath(path));
+    }
+  }
+
+  std::atomic<size_t> invalidated = 0;
+  AsyncLatch latch{ contexts_.size() };
+
+  for (auto type : magic_enum::enum_values<ResourceType>()) {
+    asio::co_spawn(
+        strands_.getStrand(type),
+        [this, type, &keys, &invalidated]() -> asio::awaitable<void> {
+          auto& context = contexts_[toIndex(type)];
+          for (const auto& key : keys) {
+            auto options = context.cached_options_.find(key);
+            if (options == context.cached_options_.end()) {
+              continue;
+            }
+
+            // a copy, eraseCached() removes from the list
+            auto cook_options = options->second;
+            for (auto cook_option : cook_options) {
+              auto cached = context.cache_.find(
+                  ResourceDescriptor{ .type_ = type, .path_ = key, .cook_options_ = cook_option });
+              assert(cached != context.cache_.end());
+
+              auto slot_handle = cached->second.slot_;
+              auto& resource_slot = *context.resources_.get(slot_handle);
+              eraseCached(context, cached);
+              invalidated.fetch_add(1, std::memory_order_relaxed);
+
+              LOG_DEBUG(
+                  "invalidating {} resource; path: {}, references: {}",
+                  magic_enum::enum_name(type), key, resource_slot.reference_counter_);
+
+              if (resource_slot.reference_counter_ == 0) {
+                context.lru_.erase(resource_slot.lru_position_);
+                freeSlot(context, slot_handle);
+              } else {
+                resource_slot.stale_ = true;
+              }
+            }
+          }
+          traceStatistics(type);
+          co_return;
+        },
+        [&latch](const std::exception_ptr&) { latch.countDown(); });
+  }
+
+  co_await latch.wait();
+  co_return invalidated.load(std::memory_order_relaxed);
+}
+
+void ResourceManager::setWatched(bool watched) {
+  watched_.store(watched, std::memory_order_relaxed);
+}
+
+auto ResourceManager::getResource(const ResourceLease& lease) const -> const Resource* {
+  const auto& handle = lease.handle_;
+  if (lease.resource_manager_ != this) {
+    return nullptr;
+  }
+
+  const auto& resources = contexts_[toIndex(handle.type_)].resources_;
+
+  // reads only slot storage that outlives the slot's element, freeSlot may run concurrently
+  return resources.findConcurrent(handle.slot_).value_or(nullptr);
 }
 
 /*
  *  Private
  */
 
-auto ResourceManager::doAcquireResource(const ResourceDescriptor& descriptor)
-    -> asio::awaitable<std::expected<ResourceLease, std::error_code>> {
-  constexpr std::chrono::microseconds WaitDuration{ 50 };
+auto ResourceManager::doAcquireResource(const ResourceDescriptor& requested)
+    -> asio::awaitable<AcquireResult> {
+  // cached under the normalized path, the spelling invalidateResources() matches changed files in
+  auto descriptor = requested;
+  descriptor.path_ = normalizePath(requested.path_);
 
-  auto& resource_storage{ contexts_[toIndex(descriptor.type_)].resources_ };
-  auto& cache{ contexts_[toIndex(descriptor.type_)].cache_ };
-  auto& free_list{ contexts_[toIndex(descriptor.type_)].free_list_ };
-
-  auto executor = co_await asio::this_coro::executor;
+  auto& context{ contexts_[toIndex(descriptor.type_)] };
+  auto& resource_storage{ context.resources_ };
+  auto& cache{ context.cache_ };
 
   LOG_DEBUG("loading {}; path: {}", magic_enum::enum_name(descriptor.type_), descriptor.path_);
 
   if (auto iterator = cache.find(descriptor); iterator != cache.end()) {
-    auto& cached_handle = iterator->second;
-    auto* resource_slot = &resource_storage[cached_handle.index_];
-
-    assert(cached_handle.generation_ == resource_slot->generation_);
-    resource_slot->reference_counter_++;
-
-    while (resource_slot->loading_) {
-      co_await asio::steady_timer(executor, WaitDuration).async_wait(asio::use_awaitable);
-
-      // we need to reload resource slot because the vector may have resized while we were awaiting
-      // async read.
-      auto* resource_slot = &resource_storage[cached_handle.index_];
+    auto cached_handle = iterator->second;
+    auto* resource_slot = resource_storage.get(cached_handle.slot_);
+
+    assert(resource_slot != nullptr);
+    if (resource_slot->reference_counter_++ == 0) {
+      // only loaded resources are left in the cache without references
+      assert(resource_slot->loaded_);
+      context.lru_.erase(resource_slot->lru_position_);
     }
 
-    assert(resource_slot->loaded_);
+    if (resource_slot->loading_) {
+      co_await resource_slot->load_finished_->wait();
+    }
 
     if (!resource_slot->loaded_) {
       LOG_DEBUG(
@@ -159,78 +350,441 @@ auto ResourceManager::doAcquireResource(const ResourceDescriptor& descriptor)
     LOG_DEBUG(
         "loading {} resource using cached value; path {}", magic_enum::enum_name(descriptor.type_),
         descriptor.path_);
-    co_return ResourceLease{ this, cached_handle };
-  }
 
-  auto file = std::make_shared<asio::stream_file>(
-      strands_.getExecutor(), descriptor.path_, asio::stream_file::read_only);
-  auto dynamic_buffer = std::make_shared<asio::streambuf>();
+    context.statistics_.hits_++;
+    traceStatistics(descriptor.type_);
 
-  size_t slot_index = 0;
+    co_return ResourceLease{ this, cached_handle, resource_slot->resource_.get() };
+  }
 
-  if (free_list.empty()) {
-    resource_storage.emplace_back();
-    slot_index = resource_storage.size() - 1;
-  } else {
-    slot_index = free_list.back();
-    free_list.pop_back();
+  auto slot_handle = resource_storage.emplace();
+  if (!slot_handle) {
+    LOG_ERROR(
+        "out of {} resource slots; path: {}", magic_enum::enum_name(descriptor.type_),
+        descriptor.path_);
+    co_return std::unexpected(Error::UnavailableError);
   }
 
-  auto* resource_slot = &resource_storage[slot_index];
+  context.statistics_.misses_++;
+
+  // slot addresses are stable, the pointer stays valid across the awaits below
+  auto* resource_slot = resource_storage.get(*slot_handle);
+  resource_slot->descriptor_ = descriptor;
   resource_slot->reference_counter_++;
-  resource_slot->index_ = slot_index;
   resource_slot->loading_ = true;
 
   auto [iterator, inserted] = cache.emplace(
-      descriptor, ResourceHandle{ .type_ = descriptor.type_,
-                                  .index_ = slot_index,
-                                  .generation_ = resource_slot->generation_ });
+      descriptor, ResourceHandle{ .type_ = descriptor.type_, .slot_ = *slot_handle });
 
   // It's not possible for another strand to create a same cache entry. Reused slots would have been
   // removed from cache.
   assert(inserted);
+  context.cached_options_[descriptor.path_].push_back(descriptor.cook_options_);
 
-  auto& handle = iterator->second;
-
-  auto [error_code, bytes] = co_await asio::async_read(
-      *file, *dynamic_buffer, asio::transfer_all(), asio::as_tuple(asio::use_awaitable));
-
-  // we need to reload resource slot because the vector may have resized while we were awaiting
-  // async read.
-  resource_slot = &resource_storage[slot_index];
+  // a copy, invalidateResources() may drop the cache entry while the load is suspended
+  auto handle = iterator->second;
 
-  if (error_code == asio::error::eof || !error_code) {
-    std::istream input_stream(dynamic_buffer.get());
-    std::vector<char> buffer(
-        (std::istreambuf_iterator<char>(input_stream)), std::istreambuf_iterator<char>());
+  std::unique_ptr<Resource> resource;
+  auto error_code = co_await loadCookedOrSource(descriptor, resource);
 
-    auto resource = std::make_unique<Resource>();
-    resource->data_.resize(buffer.size());
-    std::memcpy(resource->data_.data(), buffer.data(), buffer.size());
-    resource->hash_ = hash(resource->data_);
+  if (!error_code) {
+    context.resident_bytes_ += resource->data_.size();
 
     resource_slot->resource_ = std::move(resource);
+    resource_storage.publish(*slot_handle, resource_slot->resource_.get());
     resource_slot->loaded_ = true;
 
     LOG_DEBUG(
         "loading {} resource was successful; path: {}, index: {}, generation: {}",
-        magic_enum::enum_name(descriptor.type_), descriptor.path_, slot_index,
-        resource_slot->generation_);
+        magic_enum::enum_name(descriptor.type_), descriptor.path_, slot_handle->index(),
+        slot_handle->generation());
 
   } else {
     LOG_ERROR(
         "failed to read {} resource; path: {}; error: {}", magic_enum::enum_name(descriptor.type_),
         descriptor.path_, error_code.message());
     resource_slot->loading_ = false;
+    resource_slot->load_finished_->set();
     releaseResource(handle);
 
     co_return std::unexpected(Error::InternalError);
   }
 
-  resource_slot->descriptor_ = descriptor;
   resource_slot->loading_ = false;
+  resource_slot->load_finished_->set();
+
+  trimResidency(descriptor.type_);
+
+  co_return ResourceLease{ this, handle, resource_slot->resource_.get() };
+}
+
+auto ResourceManager::doAcquireResources(
+    std::span<const ResourceDescriptor> descriptors, std::span<const size_t> indices,
+    std::span<AcquireResult> results) -> asio::awaitable<void> {
+  if (indices.size() == 1) {
+    results[indices.front()] = co_await doAcquireResource(descriptors[indices.front()]);
+    co_return;
+  }
+
+  // already on the type's strand; the children interleave on it while their reads are in flight
+  auto executor = co_await asio::this_coro::executor;
+
+  AsyncLatch latch{ indices.size() };
+  for (auto index : indices) {
+    asio::co_spawn(
+        executor, doAcquireResource(descriptors[index]),
+        [&latch, &result = results[index]](
+            const std::exception_ptr& exception, AcquireResult acquired) {
+          if (!exception) {
+            result = std::move(acquired);
+          }
+          latch.countDown();
+        });
+  }
+
+  co_await latch.wait();
+}
+
+void ResourceManager::eraseCached(ResourceContext& context, ResourceCache::iterator cached) {
+  auto options = context.cached_options_.find(cached->first.path_);
+  assert(options != context.cached_options_.end());
+  std::erase(options->second, cached->first.cook_options_);
+  if (options->second.empty()) {
+    context.cached_options_.erase(options);
+  }
+  context.cache_.erase(cached);
+}
+
+void ResourceManager::freeSlot(ResourceContext& context, ResourceSlotHandle slot_handle) {
+  auto& resource_slot = *context.resources_.get(slot_handle);
+
+  if (resource_slot.loaded_) {
+    context.resident_bytes_ -= resource_slot.resource_->data_.size();
+  }
+
+  // a stale slot's path may already be cached again by a newer slot
+  if (auto cached = context.cache_.find(resource_slot.descriptor_);
+      cached != context.cache_.end() && cached->second.slot_ == slot_handle) {
+    eraseCached(context, cached);
+  }
+
+  // erase unpublishes before the element is destroyed
+  context.resources_.erase(slot_handle);
+}
 
-  co_return ResourceLease{ this, handle };
+void ResourceManager::trimResidency(ResourceType type) {
+  auto& context = contexts_[toIndex(type)];
+
+  // leased resources cannot be dropped, so the budget may stay exceeded until they are released
+  while (context.resident_bytes_ > context.budget_ && !context.lru_.empty()) {
+    auto slot_handle = context.lru_.back();
+    context.lru_.pop_back();
+
+    LOG_DEBUG(
+        "evicting {} resource; path: {}, resident bytes: {}, budget: {}",
+        magic_enum::enum_name(type), context.resources_.get(slot_handle)->descriptor_.path_,
+        context.resident_bytes_, context.budget_);
+
+    freeSlot(context, slot_handle);
+    context.statistics_.evictions_++;
+  }
+
+  traceStatistics(type);
+}
+
+void ResourceManager::traceStatistics(ResourceType type) const {
+  const auto& context = contexts_[toIndex(type)];
+  const auto& names = CounterNames[toIndex(type)];
+
+  GRAVITY_TRACE_COUNTER(
+      "resource", perfetto::CounterTrack(perfetto::StaticString{ names.hits_ }),
+      context.statistics_.hits_);
+  GRAVITY_TRACE_COUNTER(
+      "resource", perfetto::CounterTrack(perfetto::StaticString{ names.misses_ }),
+      context.statistics_.misses_);
+  GRAVITY_TRACE_COUNTER(
+      "resource", perfetto::CounterTrack(perfetto::StaticString{ names.evictions_ }),
+      context.statistics_.evictions_);
+  GRAVITY_TRACE_COUNTER(
+      "resource", perfetto::CounterTrack(perfetto::StaticString{ names.resident_bytes_ }),
+      context.resident_bytes_);
+}
+
+auto ResourceManager::loadCookedOrSource(
+    const ResourceDescriptor& descriptor, std::unique_ptr<Resource>& resource)
+    -> asio::awaitable<std::error_code> {
+  auto source = std::make_unique<Resource>();
+  auto cooked_path = cookedPath(descriptor);
+  if (!cooked_path) {
+    auto error_code = co_await loadResource(descriptor.path_, *source);
+    resource = std::move(source);
+    co_return error_code;
+  }
+
+  // the source's content hash, from the index while its file is unchanged; otherwise the source
+  // is read for it and kept in case the cooked file is stale. A cooked file shipped without its
+  // source is used as is.
+  std::optional<HashType> content_hash;
+  bool source_loaded = false;
+  if (auto identity = FileIdentity::of(descriptor.path_); identity) {
+    if (content_hash_index_) {
+      content_hash = content_hash_index_->find(descriptor.path_, *identity);
+    }
+    if (!content_hash) {
+      if (auto error_code = co_await loadResource(descriptor.path_, *source); error_code) {
+        co_return error_code;
+      }
+      content_hash = source->hash_;
+      source_loaded = true;
+    }
+  }
+
+  auto cooked = std::make_unique<Resource>();
+  if (auto error_code = co_await loadResource(*cooked_path, *cooked); error_code) {
+    LOG_WARN(
+        "unable to read cooked {} resource, loading its source; path: {}, error: {}",
+        magic_enum::enum_name(descriptor.type_), *cooked_path, error_code.message());
+  } else if (auto parsed = parseCookedResource(cooked->data_); !parsed) {
+    LOG_WARN(
+        "invalid cooked {} resource, loading its source; path: {}, error: {}",
+        magic_enum::enum_name(descriptor.type_), *cooked_path, parsed.error().message());
+  } else if (
+      content_hash &&
+      parsed->header_->source_key_ != cookedSourceKey(*content_hash, descriptor.cook_options_)) {
+    LOG_DEBUG(
+        "stale cooked {} resource, loading its source; path: {}",
+        magic_enum::enum_name(descriptor.type_), *cooked_path);
+  } else {
+    cooked->cooked_ = *parsed;
+    resource = std::move(cooked);
+    co_return std::error_code{};
+  }
+
+  if (!source_loaded) {
+    if (auto error_code = co_await loadResource(descriptor.path_, *source); error_code) {
+      co_return error_code;
+    }
+  }
+  resource = std::move(source);
+  co_return std::error_code{};
+}
+
+auto ResourceManager::loadResource(const std::string& path, Resource& resource)
+    -> asio::awaitable<std::error_code> {
+  // the hash of an unchanged file is known before its bytes are read
+  std::optional<FileIdentity> identity;
+  std::optional<HashType> known_hash;
+  if (content_hash_index_) {
+    if (auto file_identity = FileIdentity::of(path); file_identity) {
+      identity = *file_identity;
+      known_hash = content_hash_index_->find(path, *identity);
+    }
+  }
+
+  auto load_mode = load_mode_;
+  if (load_mode == ResourceLoadMode::Mapped && watched_.load(std::memory_order_relaxed)) {
+    load_mode = ResourceLoadMode::Stream;
+  }
+
+  std::error_code error_code;
+  switch (load_mode) {
+    case ResourceLoadMode::Stream:
+      error_code = co_await readResource(path, resource, !known_hash);
+      break;
+    case ResourceLoadMode::Mapped:
+      error_code = mapResource(path, resource, !known_hash);
+      break;
+    case ResourceLoadMode::IoUring:
+      error_code = co_await readResourceIoUring(path, resource, !known_hash);
+      break;
+  }
+
+  if (error_code) {
+    co_return error_code;
+  }
+
+  // the identity was taken before the read, it only vouches for the bytes read if the file still
+  // has it afterwards; a file replaced in between is hashed from what was read
+  if (identity) {
+    if (auto after_read = FileIdentity::of(path); !after_read || *after_read != *identity) {
+      if (known_hash) {
+        resource.hash_ = hash(resource.data_);
+        known_hash.reset();
+      }
+      identity.reset();
+    }
+  }
+
+  if (known_hash) {
+    resource.hash_ = *known_hash;
+  } else if (identity && identity->size_ == resource.data_.size()) {
+    content_hash_index_->store(path, *identity, resource.hash_);
+  }
+  co_return error_code;
+}
+
+auto ResourceManager::mapResource(const std::string& path, Resource& resource, bool compute_hash)
+    -> std::error_code {
+  auto mapping = MappedFile::open(path);
+  if (!mapping) {
+    return mapping.error();
+  }
+
+  resource.mapping_ = std::move(*mapping);
+  resource.data_ = resource.mapping_.data();
+  if (compute_hash) {
+    resource.hash_ = hash(resource.data_);
+  }
+  return Error::OK;
+}
+
+auto ResourceManager::readResource(const std::string& path, Resource& resource, bool compute_hash)
+    -> asio::awaitable<std::error_code> {
+  asio::stream_file file{ strands_.getIoExecutor() };
+
+  boost::system::error_code error_code;
+  file.open(path, asio::stream_file::read_only, error_code);
+  if (error_code) {
+    co_return error_code;
+  }
+
+  auto size = file.size(error_code);
+  if (error_code) {
+    co_return error_code;
+  }
+
+  // read straight into the final aligned storage, no staging buffers
+  resource.storage_.reset(
+      static_cast<std::byte*>(::operator new[](size, std::align_val_t{ ResourceDataAlignment })));
+
+  std::span<std::byte> storage{ resource.storage_.get(), size };
+
+  Hasher hasher;
+  size_t offset = 0;
+  while (offset < storage.size()) {
+    auto chunk = storage.subspan(offset, std::min(ResourceReadChunkSize, storage.size() - offset));
+    auto [read_error, bytes] = co_await asio::async_read(
+        file, asio::buffer(chunk.data(), chunk.size()), asio::transfer_all(),
+        asio::as_tuple(asio::use_awaitable));
+
+    if (read_error && read_error != asio::error::eof) {
+      co_return read_error;
+    }
+
+    if (compute_hash) {
+      hasher.update(chunk.first(bytes));
+    }
+    offset += bytes;
+
+    if (bytes < chunk.size()) {
+      break;
+    }
+  }
+
+  resource.data_ = storage.first(offset);
+  if (compute_hash) {
+    resource.hash_ = hasher.digest();
+  }
+  co_return Error::OK;
+}
+
+auto ResourceManager::readResourceIoUring(
+    const std::string& path, Resource& resource, bool compute_hash)
+    -> asio::awaitable<std::error_code> {
+  auto file = IoUringEngine::openForRead(path);
+  if (!file) {
+    co_return file.error();
+  }
+
+  auto close_file = gsl::finally([&file] { IoUringEngine::close(*file); });
+
+  resource.storage_.reset(static_cast<std::byte*>(
+      ::operator new[](file->size_, std::align_val_t{ ResourceDataAlignment })));
+  std::span<std::byte> storage{ resource.storage_.get(), file->size_ };
+
+  // A window of chunk reads is kept in flight and hashed in file order as the front of the window
+  // completes. Completions run on this coroutine's executor, so the window needs no locking.
+  struct ChunkRead {
+    size_t begin_;
+    size_t end_;
+    size_t filled_ = 0;
+    bool in_flight_ = false;
+    bool eof_ = false;
+  };
+
+  auto executor = co_await asio::this_coro::executor;
+  std::deque<ChunkRead> window;
+  AsyncEvent completed;
+  boost::system::error_code error_code;
+
+  // the engine may return short reads, the rest of a chunk is read again
+  std::function<void(ChunkRead&)> issue = [&](ChunkRead& chunk) {
+    chunk.in_flight_ = true;
+    auto begin = chunk.begin_ + chunk.filled_;
+    io_uring_->read(
+        IoUringRead{ .file_ = file->descriptor_,
+                     .buffer_ = storage.subspan(begin, chunk.end_ - begin),
+                     .offset_ = begin },
+        asio::bind_executor(
+            executor, [&](boost::system::error_code read_error, size_t bytes) {
+              chunk.in_flight_ = false;
+              if (read_error) {
+                error_code = read_error;
+              } else if (bytes == 0) {
+                chunk.eof_ = true;
+              } else {
+                chunk.filled_ += bytes;
+                if (!error_code && chunk.begin_ + chunk.filled_ < chunk.end_) {
+                  issue(chunk);
+                }
+              }
+              completed.set();
+            }));
+  };
+
+  Hasher hasher;
+  size_t offset = 0;
+  size_t next_offset = 0;
+  bool eof = false;
+  while (true) {
+    while (!error_code && !eof && next_offset < storage.size() &&
+           window.size() < ResourceReadWindow) {
+      auto end = std::min(next_offset + ResourceReadChunkSize, storage.size());
+      issue(window.emplace_back(ChunkRead{ .begin_ = next_offset, .end_ = end }));
+      next_offset = end;
+    }
+
+    // after an error or eof the remaining reads are only drained, their buffers must outlive them
+    while (!window.empty() && !window.front().in_flight_) {
+      const auto& chunk = window.front();
+      if (!error_code && !eof) {
+        auto bytes = storage.subspan(chunk.begin_, chunk.filled_);
+        if (compute_hash) {
+          hasher.update(bytes);
+        }
+        offset += bytes.size();
+        eof = chunk.eof_;
+      }
+      window.pop_front();
+    }
+
+    if (window.empty() && (error_code || eof || next_offset == storage.size())) {
+      break;
+    }
+
+    completed.reset();
+    co_await completed.wait();
+  }
+
+  if (error_code) {
+    co_return error_code;
+  }
+
+  resource.data_ = storage.first(offset);
+  if (compute_hash) {
+    resource.hash_ = hasher.digest();
+  }
+  co_return Error::OK;
 }
 
-}  // namespace gravity
\ No newline at end of file
+}  // namespace gravity
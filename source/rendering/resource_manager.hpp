@@ -1,13 +1,27 @@
 #pragma once
 
+#include "source/common/event/async_event.hpp"
+#include "source/common/hash.hpp"
+#include "source/common/io/content_hash_index.hpp"
+#include "source/common/io/io_uring_engine.hpp"
+#include "source/common/mapped_file.hpp"
 #include "source/common/scheduler/scheduler.hpp"
+#include "source/common/templates/slot_map.hpp"
+#include "source/rendering/common/cooked_format.hpp"
 
 #include "boost/asio.hpp"
 #include "magic_enum.hpp"
 
+#include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <expected>
+#include <list>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -18,41 +32,99 @@ class ResourceManager;
 
 enum class ResourceType : uint8_t { Shader = 1, Image, Mesh, Material };
 
+// Mapped serves resource bytes straight from a read-only file mapping, Stream reads them into
+// owned storage. IoUring also reads into owned storage, but batches the reads of all in-flight
+// loads into shared io_uring submissions; it falls back to Stream where io_uring is unavailable.
+//
+// A mapped file must only be replaced by renaming a new file over it: truncating or rewriting it
+// in place faults (SIGBUS) on the next touch of a page past its new end. Mapped therefore reads
+// like Stream while files are watched for changes, see ResourceManager::setWatched().
+enum class ResourceLoadMode : uint8_t { Stream, Mapped, IoUring };
+
+// Resource::data_ starts on at least this boundary in every load mode, so consumers may view it as
+// wider types (SPIR-V words, vertex data) without copying.
+constexpr size_t ResourceDataAlignment{ 64 };
+
+// Bytes each resource type may keep resident, counting leased resources as well as released ones
+// parked in the LRU. Only parked resources are evicted to get back under budget.
+using ResidencyBudgets = std::array<size_t, magic_enum::enum_count<ResourceType>()>;
+
+constexpr size_t DefaultResidencyBudget{ size_t{ 64 } * 1024 * 1024 };
+constexpr ResidencyBudgets DefaultResidencyBudgets = [] {
+  ResidencyBudgets budgets{};
+  budgets.fill(DefaultResidencyBudget);
+  return budgets;
+}();
+
 struct ResourceDescriptor {
   ResourceType type_;
 
   std::string path_;
+
+  // cookedImageOptionsKey() for images, a cooked sibling cooked with other options is stale. Part
+  // of the cache key, the same path acquired with other options is loaded separately.
+  HashType cook_options_ = 0;
 };
 
+struct ResourceSlot;
+using ResourceSlotHandle = SlotHandle<ResourceSlot>;
+
 struct ResourceHandle {
   ResourceType type_;
 
-  size_t index_;
-  size_t generation_;
+  ResourceSlotHandle slot_;
+};
+
+struct AlignedStorageDeleter {
+  void operator()(std::byte* storage) const {
+    ::operator delete[](storage, std::align_val_t{ ResourceDataAlignment });
+  }
 };
 
+using AlignedStorage = std::unique_ptr<std::byte[], AlignedStorageDeleter>;
+
 struct Resource {
-  std::vector<uint8_t> data_;
+  std::span<const std::byte> data_;
   HashType hash_;
+
+  // exactly one of these backs data_, depending on the load mode
+  MappedFile mapping_;
+  AlignedStorage storage_;
+
+  // set when data_ holds a cooked file rather than the source, see cooked_format.hpp
+  std::optional<CookedResource> cooked_;
 };
 
+// slots of released but still loaded resources, most recently released first
+using ResourceLru = std::list<ResourceSlotHandle>;
+
 struct ResourceSlot {
   ResourceDescriptor descriptor_;
   std::unique_ptr<Resource> resource_;
 
-  size_t index_ = 0;
-  size_t generation_ = 0;
-
   size_t reference_counter_ = 0;
 
+  // valid while the slot is loaded and unreferenced
+  ResourceLru::iterator lru_position_;
+
+  // Set once loading finishes, successfully or not; cache hits on a loading slot wait on it.
+  std::unique_ptr<AsyncEvent> load_finished_ = std::make_unique<AsyncEvent>();
+
   bool loading_ = false;
   bool loaded_ = false;
+
+  // dropped from the cache by invalidateResources() while leased, freed on its last release
+  bool stale_ = false;
 };
 
 struct ResourceLease {
   ResourceManager* resource_manager_ = nullptr;
   ResourceHandle handle_ = {};
-  ResourceLease(ResourceManager* resource_manager, ResourceHandle handle);
+
+  // stays valid for the lifetime of the lease, leased resources are never evicted
+  const Resource* resource_ = nullptr;
+
+  ResourceLease(ResourceManager* resource_manager, ResourceHandle handle, const Resource* resource);
 
   ResourceLease() = default;
 
@@ -70,7 +142,7 @@ struct ResourceLease {
 
 struct ResourceDescriptorHash {
   auto operator()(const ResourceDescriptor& key) const -> HashType {
-    return std::hash<std::string>()(key.path_);
+    return hashCombine(std::hash<std::string>()(key.path_), key.cook_options_);
   }
 };
 
@@ -79,34 +151,104 @@ class ResourceManager {
   using StrandLanes = ResourceType;
   using StrandGroup = StrandGroup<ResourceManager>;
 
-  ResourceManager(StrandGroup strands);
+  // A non-empty content_hash_index_path persists content hashes there, so resources whose file
+  // identity is unchanged since an earlier run are not hashed again. Without it, a cooked resource
+  // is only used after reading its source to check that the cooked file is current.
+  ResourceManager(
+      StrandGroup strands, ResourceLoadMode load_mode = ResourceLoadMode::Mapped,
+      const ResidencyBudgets& budgets = DefaultResidencyBudgets,
+      const std::string& content_hash_index_path = {});
+
+  using AcquireResult = std::expected<ResourceLease, std::error_code>;
 
   auto acquireResource(const ResourceDescriptor& resource_descriptor)
-      -> boost::asio::awaitable<std::expected<ResourceLease, std::error_code>>;
+      -> boost::asio::awaitable<AcquireResult>;
+
+  // Acquires all descriptors with a single strand hop per resource type; loads of the same type
+  // run concurrently on that strand. Results are in descriptor order.
+  auto acquireResources(std::span<const ResourceDescriptor> descriptors)
+      -> boost::asio::awaitable<std::vector<AcquireResult>>;
 
   void releaseResource(ResourceHandle resource_handle);
 
-  [[nodiscard]] auto getResource(const ResourceLease& lease) const
-      -> boost::asio::awaitable<const Resource*>;
+  // Drops the cached copies of the given files so the next acquire reads them again, returns how
+  // many were cached. Parked resources are freed right away, leased ones stay valid for their
+  // holders and are freed on their last release. A cooked file invalidates its source's entry.
+  // Paths match however they are spelled, both sides are compared in normalizePath() form.
+  auto invalidateResources(std::span<const std::string> paths) -> boost::asio::awaitable<size_t>;
+
+  // While watched, resource files may be rewritten in place by tools outside our control, so
+  // Mapped mode stops mapping and reads files like Stream does. Resources mapped before stay
+  // mapped until they are invalidated.
+  void setWatched(bool watched);
+
+  // Callable from any thread without a strand hop. Returns nullptr for a lease whose slot has been
+  // recycled, which can only happen for a lease that was moved from or already released.
+  [[nodiscard]] auto getResource(const ResourceLease& lease) const -> const Resource*;
 
  private:
-  using ResourceList = std::vector<ResourceSlot>;
+  // publishes resource_.get() once loaded, the lock-free view used by getResource
+  using ResourceList =
+      SlotMap<ResourceSlot, ResourceSlot, false, ResourceSlotHandle, const Resource*>;
   using ResourceCache =
       std::unordered_map<ResourceDescriptor, ResourceHandle, ResourceDescriptorHash>;
-  using ResourceFreeList = std::vector<size_t>;
+
+  struct ResourceStatistics {
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    uint64_t evictions_ = 0;
+  };
 
   struct ResourceContext {
     ResourceList resources_;
     ResourceCache cache_;
-    ResourceFreeList free_list_;
+    // cook options each cached path is cached with, invalidating a path drops all of them
+    std::unordered_map<std::string, std::vector<HashType>> cached_options_;
+
+    ResourceLru lru_;
+    size_t resident_bytes_ = 0;
+    size_t budget_ = 0;
+
+    ResourceStatistics statistics_;
   };
 
   StrandGroup strands_;
+  ResourceLoadMode load_mode_;
+  std::atomic<bool> watched_ = false;
+  std::unique_ptr<IoUringEngine> io_uring_;
+  std::unique_ptr<ContentHashIndex> content_hash_index_;
 
   std::array<ResourceContext, magic_enum::enum_count<ResourceType>()> contexts_;
 
-  auto doAcquireResource(const ResourceDescriptor& descriptor)
-      -> boost::asio::awaitable<std::expected<ResourceLease, std::error_code>>;
+  auto doAcquireResource(const ResourceDescriptor& requested)
+      -> boost::asio::awaitable<AcquireResult>;
+  auto doAcquireResources(
+      std::span<const ResourceDescriptor> descriptors, std::span<const size_t> indices,
+      std::span<AcquireResult> results) -> boost::asio::awaitable<void>;
+
+  static void eraseCached(ResourceContext& context, ResourceCache::iterator cached);
+  static void freeSlot(ResourceContext& context, ResourceSlotHandle slot_handle);
+  void trimResidency(ResourceType type);
+  void traceStatistics(ResourceType type) const;
+
+  // Image and mesh sources are superseded by a cooked sibling whose source key matches the
+  // source's content and descriptor.cook_options_, see cookedSourceKey(); the source is loaded
+  // when there is none or it is stale or invalid.
+  auto loadCookedOrSource(const ResourceDescriptor& descriptor, std::unique_ptr<Resource>& resource)
+      -> boost::asio::awaitable<std::error_code>;
+
+  // reads path in the configured load mode and fills Resource::hash_, from the content hash index
+  // when the file is unchanged
+  auto loadResource(const std::string& path, Resource& resource)
+      -> boost::asio::awaitable<std::error_code>;
+
+  // the readers fill Resource::hash_ only when compute_hash is set
+  static auto mapResource(const std::string& path, Resource& resource, bool compute_hash)
+      -> std::error_code;
+  auto readResource(const std::string& path, Resource& resource, bool compute_hash)
+      -> boost::asio::awaitable<std::error_code>;
+  auto readResourceIoUring(const std::string& path, Resource& resource, bool compute_hash)
+      -> boost::asio::awaitable<std::error_code>;
 };
 
 }  // namespace gravity
\ No newline at end of file
@@ -0,0 +1,224 @@
+#include "source/rendering/resource_manager.hpp"
+
+#include "source/common/hash.hpp"
+#include "source/common/io/content_hash_index.hpp"
+#include "source/common/scheduler/scheduler.hpp"
+#include "source/rendering/common/asset_types.hpp"
+#include "source/rendering/common/cooked_format.hpp"
+
+#include "boost/asio/co_spawn.hpp"
+#include "boost/asio/thread_pool.hpp"
+#include "boost/asio/use_future.hpp"
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace gravity {
+
+namespace {
+
+template <typename T>
+void append(std::vector<std::byte>& bytes, const T& value) {
+  auto size = bytes.size();
+  bytes.resize(size + sizeof(T));
+  std::memcpy(bytes.data() + size, &value, sizeof(T));
+}
+
+void writeFile(const std::string& path, std::span<const std::byte> bytes) {
+  std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+  file.write(
+      reinterpret_cast<const char*>(bytes.data()),  // NOLINT
+      static_cast<std::streamsize>(bytes.size()));
+}
+
+// a single 4x4 level, cooked from a source with the given content hash and options key
+auto cookedImage(HashType content_hash, HashType options_key) -> std::vector<std::byte> {
+  std::vector<std::byte> metadata;
+  append(metadata, CookedImageHeader{ .width_ = 4,
+                                      .height_ = 4,
+                                      .mip_count_ = 1,
+                                      .format_ = CookedImageFormat::Rgba8Srgb,
+                                      .padding_ = {} });
+  append(metadata, CookedMipRecord{ .offset_ = 0, .size_ = 64, .width_ = 4, .height_ = 4 });
+  std::vector<std::byte> payload(64, std::byte{ 0x7f });
+  return assembleCookedFile(
+      CookedKind::Image, cookedSourceKey(content_hash, options_key), metadata, payload);
+}
+
+// what the catalog's default texture entry asks for, and what the cook tool cooks by default
+constexpr TextureDescriptor DefaultTexture{ .image_path_ = {},
+                                            .color_space_ = "srgb",
+                                            .mipmaps_ = true };
+constexpr TextureDescriptor LinearTexture{ .image_path_ = {},
+                                           .color_space_ = "linear",
+                                           .mipmaps_ = false };
+
+class ResourceManagerCookedTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    directory_ = std::filesystem::temp_directory_path() /
+                 ("gravity_resource_manager_test_" +
+                  std::string{ ::testing::UnitTest::GetInstance()->current_test_info()->name() });
+    std::filesystem::remove_all(directory_);
+    std::filesystem::create_directories(directory_);
+
+    source_path_ = (directory_ / "albedo.png").string();
+    source_.assign(100, std::byte{ 0x42 });
+    writeFile(source_path_, source_);
+    // outside ContentHashIndex::RacyWindow, so its hash may be persisted
+    std::filesystem::last_write_time(
+        source_path_, std::filesystem::file_time_type::clock::now() - std::chrono::hours{ 1 });
+  }
+
+  void TearDown() override { std::filesystem::remove_all(directory_); }
+
+  void cook(HashType options_key) { cook(hash(source_), options_key); }
+
+  void cook(HashType content_hash, HashType options_key) {
+    writeFile(source_path_ + CookedExtension, cookedImage(content_hash, options_key));
+  }
+
+  auto open(const std::string& content_hash_index_path = {}) -> std::unique_ptr<ResourceManager> {
+    return std::make_unique<ResourceManager>(
+        scheduler_.makeStrands<ResourceManager>(), ResourceLoadMode::Mapped,
+        DefaultResidencyBudgets, content_hash_index_path);
+  }
+
+  auto image(const TextureDescriptor& texture) const -> ResourceDescriptor {
+    return { .type_ = ResourceType::Image,
+             .path_ = source_path_,
+             .cook_options_ = cookedImageOptionsKey(texture) };
+  }
+
+  template <typename T>
+  auto run(boost::asio::awaitable<T> coroutine) -> T {
+    return boost::asio::co_spawn(pool_, std::move(coroutine), boost::asio::use_future).get();
+  }
+
+  // releases are posted to the type strands, wait for them before the manager goes away
+  void settle(ResourceManager& resources) { run(resources.invalidateResources({})); }
+
+  Scheduler scheduler_{ 2 };
+  boost::asio::thread_pool pool_{ 1 };
+  std::filesystem::path directory_;
+  std::string source_path_;
+  std::vector<std::byte> source_;
+};
+
+TEST_F(ResourceManagerCookedTest, DefaultCookedImageIsUsed) {
+  cook(cookedImageOptionsKey(true, true));
+  auto resources = open();
+
+  {
+    auto lease = run(resources->acquireResource(image(DefaultTexture)));
+    ASSERT_TRUE(lease) << lease.error().message();
+    ASSERT_TRUE(lease->resource_->cooked_);
+    EXPECT_EQ(lease->resource_->cooked_->payload_.size(), 64U);
+  }
+  settle(*resources);
+}
+
+TEST_F(ResourceManagerCookedTest, CookIndexSparesReadingTheSource) {
+  // only the index knows this hash, the cooked file matches only if the source is not read
+  constexpr HashType IndexedHash{ 0x5eed };
+  cook(IndexedHash, cookedImageOptionsKey(true, true));
+
+  // the cook tool records the source's identity and hash, a loader sharing the index trusts it
+  auto index_path = (directory_ / "assetsdb").string() + CookIndexExtension;
+  {
+    auto index = ContentHashIndex::open(index_path);
+    ASSERT_TRUE(index);
+    auto identity = FileIdentity::of(source_path_);
+    ASSERT_TRUE(identity);
+    (*index)->store(source_path_, *identity, IndexedHash);
+  }
+
+  auto resources = open(index_path);
+  {
+    auto lease = run(resources->acquireResource(image(DefaultTexture)));
+    ASSERT_TRUE(lease) << lease.error().message();
+    EXPECT_TRUE(lease->resource_->cooked_);
+  }
+  settle(*resources);
+}
+
+TEST_F(ResourceManagerCookedTest, OtherOptionsLoadTheSource) {
+  cook(cookedImageOptionsKey(true, true));
+  auto resources = open();
+
+  {
+    auto cooked = run(resources->acquireResource(image(DefaultTexture)));
+    auto source = run(resources->acquireResource(image(LinearTexture)));
+    ASSERT_TRUE(cooked);
+    ASSERT_TRUE(source);
+
+    // one cache entry per options, neither gets the other's bytes
+    EXPECT_TRUE(cooked->resource_->cooked_);
+    EXPECT_FALSE(source->resource_->cooked_);
+    EXPECT_EQ(source->resource_->data_.size(), source_.size());
+    EXPECT_NE(cooked->resource_, source->resource_);
+  }
+  settle(*resources);
+}
+
+TEST_F(ResourceManagerCookedTest, StaleCookedImageLoadsTheSource) {
+  cook(cookedImageOptionsKey(false, true));
+  auto resources = open();
+
+  {
+    auto lease = run(resources->acquireResource(image(DefaultTexture)));
+    ASSERT_TRUE(lease);
+    EXPECT_FALSE(lease->resource_->cooked_);
+  }
+  settle(*resources);
+}
+
+TEST_F(ResourceManagerCookedTest, InvalidatingAPathDropsEveryOptions) {
+  cook(cookedImageOptionsKey(true, true));
+  auto resources = open();
+
+  {
+    auto cooked = run(resources->acquireResource(image(DefaultTexture)));
+    auto source = run(resources->acquireResource(image(LinearTexture)));
+    ASSERT_TRUE(cooked);
+    ASSERT_TRUE(source);
+  }
+
+  std::vector<std::string> paths{ source_path_ + CookedExtension };
+  EXPECT_EQ(run(resources->invalidateResources(paths)), 2U);
+  EXPECT_EQ(run(resources->invalidateResources(paths)), 0U);
+  settle(*resources);
+}
+
+TEST_F(ResourceManagerCookedTest, PathSpellingsShareOneEntry) {
+  auto resources = open();
+  auto descriptor = image(LinearTexture);
+  auto dotted = descriptor;
+  dotted.path_ = (directory_ / "." / "textures" / ".." / "albedo.png").string();
+
+  {
+    auto lease = run(resources->acquireResource(descriptor));
+    auto same = run(resources->acquireResource(dotted));
+    ASSERT_TRUE(lease);
+    ASSERT_TRUE(same);
+    EXPECT_EQ(lease->resource_, same->resource_);
+  }
+
+  // a watcher reports the file under yet another spelling
+  std::vector<std::string> paths{ (directory_ / "." / "albedo.png").string() };
+  EXPECT_EQ(run(resources->invalidateResources(paths)), 1U);
+  settle(*resources);
+}
+
+}  // namespace
+
+}  // namespace gravity